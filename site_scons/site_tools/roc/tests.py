@@ -2,17 +2,17 @@ import SCons.Script
 import os
 import re
 
-def _is_test_enabled(testname):
-    for target in ['test', testname]:
+def _is_target_enabled(alias, name):
+    for target in [alias, name]:
         if target in SCons.Script.COMMAND_LINE_TARGETS:
             return True
 
 def _get_non_test_targets(env):
     if SCons.Script.COMMAND_LINE_TARGETS:
         for target in SCons.Script.COMMAND_LINE_TARGETS:
-            if target == 'test':
+            if target in ['test', 'bench']:
                 yield env.Dir('#')
-            elif not re.match('^test/.+', target):
+            elif not re.match('^(test|bench)/.+', target):
                 yield target
     else:
         yield env.Dir('#')
@@ -26,7 +26,7 @@ def _with_timeout(env, cmd, timeout):
 def AddTest(env, name, exe, cmd=None, timeout=5*60):
     testname = 'test/%s' % name
 
-    if not _is_test_enabled(testname):
+    if not _is_target_enabled('test', testname):
         return
 
     if not cmd:
@@ -57,7 +57,42 @@ def AddTest(env, name, exe, cmd=None, timeout=5*60):
     # 'test' target depends on this target.
     env.Depends('test', target)
 
+def AddBench(env, name, exe, cmd=None):
+    benchname = 'bench/%s' % name
+
+    if not _is_target_enabled('bench', benchname):
+        return
+
+    if not cmd:
+        cmd = env.File(exe).path
+
+    comstr = env.PrettyCommand('BENCH', name, 'green')
+    target = env.Alias(benchname, [], env.Action(cmd, comstr))
+
+    # This target produces no files.
+    env.AlwaysBuild(target)
+
+    # This target depends on benchmark executable that it should run.
+    env.Depends(target, env.File(exe))
+
+    # This target should be run after all build targets.
+    for t in _get_non_test_targets(env):
+        env.Requires(target, t)
+
+    # Benchmarks should not run concurrently with each other.
+    for t in env['_ROC_BENCHMARKS']:
+        env.Requires(target, t)
+
+    # Add target to benchmark list.
+    env['_ROC_BENCHMARKS'] += [benchname]
+
+    # 'bench' target depends on this target.
+    env.Depends('bench', target)
+
 def init(env):
     env['_ROC_TESTS'] = []
+    env['_ROC_BENCHMARKS'] = []
     env.AlwaysBuild(env.Alias('test', [], env.Action('')))
+    env.AlwaysBuild(env.Alias('bench', [], env.Action('')))
     env.AddMethod(AddTest, 'AddTest')
+    env.AddMethod(AddBench, 'AddBench')
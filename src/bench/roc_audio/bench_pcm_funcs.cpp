@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+
+#include "roc_audio/pcm_funcs.h"
+#include "roc_audio/pcm_kernel.h"
+#include "roc_core/helpers.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { NumCh = 2, PacketSamples = 320, NumPackets = 50000 };
+
+const PcmKernel Kernels[] = { PcmKernel_Scalar, PcmKernel_SSE, PcmKernel_AVX2,
+                              PcmKernel_NEON };
+
+sample_t samples[PacketSamples * NumCh];
+int16_t payload[PacketSamples * NumCh];
+
+void init_samples() {
+    for (size_t n = 0; n < PacketSamples * NumCh; n++) {
+        samples[n] = (sample_t)std::sin(2 * M_PI / 128 * double(n));
+    }
+}
+
+void print_result(const char* name, const char* op, core::nanoseconds_t elapsed) {
+    const double num_samples = double(NumPackets) * PacketSamples * NumCh;
+
+    printf("%-10s %-8s %12.3f %12.1f\n", name, op, double(elapsed) / num_samples,
+           num_samples * sizeof(int16_t) / (double(elapsed) / core::Second) / 1e6);
+}
+
+} // namespace
+
+TEST_GROUP(pcm_funcs) {};
+
+TEST(pcm_funcs, kernels) {
+    printf("\n%-10s %-8s %12s %12s\n", "kernel", "op", "ns/sample", "MB/s");
+
+    init_samples();
+
+    for (size_t nk = 0; nk < ROC_ARRAY_SIZE(Kernels); nk++) {
+        const PcmKernelFuncs* funcs = pcm_kernel_funcs(Kernels[nk]);
+        if (!funcs) {
+            printf("%-10s not supported by cpu\n", pcm_kernel_to_str(Kernels[nk]));
+            continue;
+        }
+
+        core::nanoseconds_t start = core::timestamp();
+
+        for (size_t np = 0; np < NumPackets; np++) {
+            funcs->encode_int16_be(payload, samples, PacketSamples * NumCh);
+        }
+
+        print_result(pcm_kernel_to_str(Kernels[nk]), "encode", core::timestamp() - start);
+
+        start = core::timestamp();
+
+        for (size_t np = 0; np < NumPackets; np++) {
+            funcs->decode_int16_be(samples, payload, PacketSamples * NumCh);
+        }
+
+        print_result(pcm_kernel_to_str(Kernels[nk]), "decode", core::timestamp() - start);
+    }
+}
+
+// Compares the fast path used when channel masks match with the generic path
+// used for remapping.
+TEST(pcm_funcs, channel_masks) {
+    printf("\n%-10s %-8s %12s %12s\n", "mask", "op", "ns/sample", "MB/s");
+
+    init_samples();
+
+    struct Mask {
+        packet::channel_mask_t mask;
+        const char* name;
+    };
+
+    const Mask masks[] = { { 0x3, "same" }, { 0x1, "remap" } };
+
+    for (size_t nm = 0; nm < ROC_ARRAY_SIZE(masks); nm++) {
+        core::nanoseconds_t start = core::timestamp();
+
+        for (size_t np = 0; np < NumPackets; np++) {
+            PCM_int16_2ch.encode_samples(payload, sizeof(payload), 0, samples,
+                                         PacketSamples, masks[nm].mask);
+        }
+
+        print_result(masks[nm].name, "encode", core::timestamp() - start);
+
+        start = core::timestamp();
+
+        for (size_t np = 0; np < NumPackets; np++) {
+            PCM_int16_2ch.decode_samples(payload, sizeof(payload), 0, samples,
+                                         PacketSamples, masks[nm].mask);
+        }
+
+        print_result(masks[nm].name, "decode", core::timestamp() - start);
+    }
+}
+
+} // namespace audio
+} // namespace roc
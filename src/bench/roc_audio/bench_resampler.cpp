@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <stdio.h>
+
+#include "roc_audio/resampler_profile.h"
+#include "roc_audio/resampler_reader.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { SampleRate = 44100, FrameSize = 1024, MaxBufSize = 4096, NumFrames = 2000 };
+
+const ResamplerKernel Kernels[] = { ResamplerKernel_Scalar, ResamplerKernel_SSE,
+                                     ResamplerKernel_AVX2, ResamplerKernel_NEON };
+
+struct Profile {
+    ResamplerProfile profile;
+    const char* name;
+};
+
+const Profile Profiles[] = { { ResamplerProfile_Low, "low" },
+                             { ResamplerProfile_Medium, "medium" },
+                             { ResamplerProfile_High, "high" } };
+
+const packet::channel_mask_t ChMasks[] = { 0x1, 0x3 };
+
+core::HeapAllocator allocator;
+core::BufferPool<sample_t> buffer_pool(allocator, MaxBufSize, true);
+
+// Returns the same precomputed sine frame, to keep input generation out of
+// the measurements.
+class SineReader : public IReader {
+public:
+    SineReader() {
+        for (size_t n = 0; n < MaxBufSize; n++) {
+            samples_[n] = (sample_t)std::sin(2 * M_PI / 128 * double(n));
+        }
+    }
+
+    virtual void read(Frame& frame) {
+        CHECK(frame.size() <= MaxBufSize);
+        memcpy(frame.data(), samples_, frame.size() * sizeof(sample_t));
+    }
+
+private:
+    sample_t samples_[MaxBufSize];
+};
+
+} // namespace
+
+TEST_GROUP(resampler) {};
+
+TEST(resampler, kernels) {
+    printf("\n%-8s %-8s %8s %8s %12s %10s\n", "kernel", "profile", "channels", "scaling",
+           "ns/sample", "realtime");
+
+    core::Slice<sample_t> buf = new (buffer_pool) core::Buffer<sample_t>(buffer_pool);
+    CHECK(buf);
+    buf.resize(FrameSize);
+
+    for (size_t nk = 0; nk < ROC_ARRAY_SIZE(Kernels); nk++) {
+        if (!resampler_kernel_funcs(Kernels[nk])) {
+            printf("%-8s not supported by cpu\n", resampler_kernel_to_str(Kernels[nk]));
+            continue;
+        }
+
+        for (size_t np = 0; np < ROC_ARRAY_SIZE(Profiles); np++) {
+            for (size_t nc = 0; nc < ROC_ARRAY_SIZE(ChMasks); nc++) {
+                ResamplerConfig config = resampler_profile(Profiles[np].profile);
+                config.kernel = Kernels[nk];
+
+                const float scaling = 1.001f;
+
+                SineReader reader;
+                ResamplerReader rr(reader, buffer_pool, allocator, config, ChMasks[nc]);
+                CHECK(rr.valid());
+                CHECK(rr.set_scaling(scaling));
+
+                const core::nanoseconds_t start = core::timestamp();
+
+                for (size_t nf = 0; nf < NumFrames; nf++) {
+                    Frame frame(buf.data(), buf.size());
+                    rr.read(frame);
+                }
+
+                const core::nanoseconds_t elapsed = core::timestamp() - start;
+
+                const size_t num_ch = packet::num_channels(ChMasks[nc]);
+                const double num_samples = double(NumFrames) * FrameSize / num_ch;
+
+                printf("%-8s %-8s %8lu %8.3f %12.2f %9.1fx\n",
+                       resampler_kernel_to_str(Kernels[nk]), Profiles[np].name,
+                       (unsigned long)num_ch, (double)scaling,
+                       double(elapsed) / num_samples,
+                       num_samples / SampleRate / (double(elapsed) / core::Second));
+            }
+        }
+    }
+}
+
+// Compares variable-ratio and polyphase engines on a fixed 48000 to 44100
+// conversion, which is a typical sender setup.
+TEST(resampler, fixed_ratio) {
+    printf("\n%-8s %-10s %8s %8s %12s %10s\n", "kernel", "profile", "channels",
+           "scaling", "ns/sample", "realtime");
+
+    core::Slice<sample_t> buf = new (buffer_pool) core::Buffer<sample_t>(buffer_pool);
+    CHECK(buf);
+    buf.resize(FrameSize);
+
+    const Profile profiles[] = { { ResamplerProfile_Medium, "medium" },
+                                 { ResamplerProfile_Polyphase, "polyphase" } };
+
+    const float scaling = 48000.0f / 44100.0f;
+
+    for (size_t nk = 0; nk < ROC_ARRAY_SIZE(Kernels); nk++) {
+        if (!resampler_kernel_funcs(Kernels[nk])) {
+            continue;
+        }
+
+        for (size_t np = 0; np < ROC_ARRAY_SIZE(profiles); np++) {
+            for (size_t nc = 0; nc < ROC_ARRAY_SIZE(ChMasks); nc++) {
+                ResamplerConfig config = resampler_profile(profiles[np].profile);
+                config.kernel = Kernels[nk];
+
+                SineReader reader;
+                ResamplerReader rr(reader, buffer_pool, allocator, config, ChMasks[nc]);
+                CHECK(rr.valid());
+                CHECK(rr.set_scaling(scaling));
+
+                const core::nanoseconds_t start = core::timestamp();
+
+                for (size_t nf = 0; nf < NumFrames; nf++) {
+                    Frame frame(buf.data(), buf.size());
+                    rr.read(frame);
+                }
+
+                const core::nanoseconds_t elapsed = core::timestamp() - start;
+
+                const size_t num_ch = packet::num_channels(ChMasks[nc]);
+                const double num_samples = double(NumFrames) * FrameSize / num_ch;
+
+                printf("%-8s %-10s %8lu %8.3f %12.2f %9.1fx\n",
+                       resampler_kernel_to_str(Kernels[nk]), profiles[np].name,
+                       (unsigned long)num_ch, (double)scaling,
+                       double(elapsed) / num_samples,
+                       num_samples / SampleRate / (double(elapsed) / core::Second));
+            }
+        }
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <algorithm>
+#include <stdio.h>
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
+#include "roc_core/random.h"
+#include "roc_core/time.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_fec/codec_map.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { MaxPayloadSize = 1280, MinBlocks = 4, BytesPerRun = 4 * 1024 * 1024 };
+
+enum LossPattern { Loss_Random, Loss_Burst };
+
+struct Scheme {
+    packet::FECScheme scheme;
+    const char* name;
+};
+
+const Scheme Schemes[] = { { packet::FEC_ReedSolomon_M8, "rs8m" },
+                           { packet::FEC_LDPC_Staircase, "ldpc" },
+                           { packet::FEC_XOR_Parity, "xor" } };
+
+const size_t BlockSizes[] = { 10, 20, 100, 1000 };
+
+// Number of repair packets, in percents of source packets.
+const size_t RepairRatios[] = { 10, 25, 50 };
+
+const size_t PayloadSizes[] = { 320, 1280 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxPayloadSize, true);
+
+CodecMap codec_map;
+
+struct Result {
+    size_t n_blocks;
+    core::nanoseconds_t elapsed;
+    size_t n_lost;
+    size_t n_repaired;
+
+    Result()
+        : n_blocks(0)
+        , elapsed(0)
+        , n_lost(0)
+        , n_repaired(0) {
+    }
+};
+
+class Bench {
+public:
+    Bench(IBlockEncoder& encoder,
+          IBlockDecoder& decoder,
+          size_t sblen,
+          size_t rblen,
+          size_t payload_size)
+        : encoder_(encoder)
+        , decoder_(decoder)
+        , sblen_(sblen)
+        , rblen_(rblen)
+        , payload_size_(payload_size)
+        , n_blocks_(std::max((size_t)MinBlocks, BytesPerRun / (sblen * payload_size)))
+        , buffers_(allocator)
+        , repaired_(allocator)
+        , lost_(allocator) {
+        CHECK(buffers_.resize(sblen_ + rblen_));
+        CHECK(repaired_.resize(sblen_));
+        CHECK(lost_.resize(sblen_ + rblen_));
+
+        for (size_t i = 0; i < sblen_ + rblen_; i++) {
+            buffers_[i] = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+            CHECK(buffers_[i]);
+            buffers_[i].resize(payload_size_);
+
+            if (i < sblen_) {
+                for (size_t j = 0; j < payload_size_; j++) {
+                    buffers_[i].data()[j] = (uint8_t)core::random(0, 0xff);
+                }
+            }
+        }
+    }
+
+    bool encode(Result& result) {
+        for (size_t n = 0; n < n_blocks_; n++) {
+            const core::nanoseconds_t start = core::timestamp();
+
+            if (!encoder_.begin(sblen_, rblen_, payload_size_)) {
+                return false;
+            }
+            for (size_t i = 0; i < sblen_ + rblen_; i++) {
+                encoder_.set(i, buffers_[i]);
+            }
+            encoder_.fill();
+            encoder_.end();
+
+            result.elapsed += core::timestamp() - start;
+            result.n_blocks++;
+        }
+
+        return true;
+    }
+
+    // Should be called after encode(), which fills repair buffers.
+    bool decode(LossPattern pattern, Result& result) {
+        for (size_t n = 0; n < n_blocks_; n++) {
+            make_losses_(pattern);
+
+            const core::nanoseconds_t start = core::timestamp();
+
+            if (!decoder_.begin(sblen_, rblen_, payload_size_)) {
+                return false;
+            }
+            for (size_t i = 0; i < sblen_ + rblen_; i++) {
+                if (!lost_[i]) {
+                    decoder_.set(i, buffers_[i]);
+                }
+            }
+            for (size_t i = 0; i < sblen_; i++) {
+                if (lost_[i]) {
+                    repaired_[i] = decoder_.repair(i);
+                }
+            }
+            decoder_.end();
+
+            result.elapsed += core::timestamp() - start;
+            result.n_blocks++;
+
+            for (size_t i = 0; i < sblen_; i++) {
+                if (!lost_[i]) {
+                    continue;
+                }
+                result.n_lost++;
+                if (check_repaired_(i)) {
+                    result.n_repaired++;
+                }
+                repaired_[i] = NULL;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    // The number of lost packets per block is equal to the number of repair
+    // packets, which is the most a maximum distance separable code can restore.
+    void make_losses_(LossPattern pattern) {
+        const size_t block_len = sblen_ + rblen_;
+
+        for (size_t i = 0; i < block_len; i++) {
+            lost_[i] = false;
+        }
+
+        switch (pattern) {
+        case Loss_Random: {
+            for (size_t n = 0; n < rblen_;) {
+                const size_t i = core::random(0, (unsigned)block_len - 1);
+                if (!lost_[i]) {
+                    lost_[i] = true;
+                    n++;
+                }
+            }
+        } break;
+
+        case Loss_Burst: {
+            const size_t first = core::random(0, (unsigned)(block_len - rblen_));
+            for (size_t i = first; i < first + rblen_; i++) {
+                lost_[i] = true;
+            }
+        } break;
+        }
+    }
+
+    bool check_repaired_(size_t index) const {
+        if (!repaired_[index] || repaired_[index].size() != payload_size_) {
+            return false;
+        }
+        return memcmp(repaired_[index].data(), buffers_[index].data(), payload_size_)
+            == 0;
+    }
+
+    IBlockEncoder& encoder_;
+    IBlockDecoder& decoder_;
+
+    const size_t sblen_;
+    const size_t rblen_;
+    const size_t payload_size_;
+    const size_t n_blocks_;
+
+    core::Array<core::Slice<uint8_t> > buffers_;
+    core::Array<core::Slice<uint8_t> > repaired_;
+    core::Array<bool> lost_;
+};
+
+void print_header() {
+    printf("\n%-6s %6s %6s %8s %-6s %10s %12s %9s\n", "scheme", "source", "repair",
+           "payload", "op", "MB/s", "us/block", "repaired");
+}
+
+void print_result(const char* scheme,
+                  size_t sblen,
+                  size_t rblen,
+                  size_t payload_size,
+                  const char* op,
+                  const Result& result) {
+    const double seconds = double(result.elapsed) / core::Second;
+    const double megabytes =
+        double(result.n_blocks * sblen * payload_size) / (1024 * 1024);
+
+    printf("%-6s %6lu %6lu %8lu %-6s %10.2f %12.2f", scheme, (unsigned long)sblen,
+           (unsigned long)rblen, (unsigned long)payload_size, op,
+           seconds > 0 ? megabytes / seconds : 0.,
+           double(result.elapsed) / core::Microsecond / result.n_blocks);
+
+    if (result.n_lost != 0) {
+        printf(" %8.2f%%", double(result.n_repaired) * 100 / result.n_lost);
+    } else {
+        printf(" %9s", "-");
+    }
+
+    printf("\n");
+}
+
+void print_skipped(const char* scheme,
+                   size_t sblen,
+                   size_t rblen,
+                   size_t payload_size,
+                   const char* reason) {
+    printf("%-6s %6lu %6lu %8lu %s\n", scheme, (unsigned long)sblen,
+           (unsigned long)rblen, (unsigned long)payload_size, reason);
+}
+
+} // namespace
+
+TEST_GROUP(codecs) {};
+
+TEST(codecs, encode_decode) {
+    print_header();
+
+    for (size_t ns = 0; ns < ROC_ARRAY_SIZE(Schemes); ns++) {
+        CodecConfig config;
+        config.scheme = Schemes[ns].scheme;
+
+        core::UniquePtr<IBlockEncoder> encoder(
+            codec_map.new_encoder(config, buffer_pool, allocator), allocator);
+        core::UniquePtr<IBlockDecoder> decoder(
+            codec_map.new_decoder(config, buffer_pool, allocator), allocator);
+
+        if (!encoder || !decoder) {
+            printf("%-6s not supported in this build\n", Schemes[ns].name);
+            continue;
+        }
+
+        for (size_t nb = 0; nb < ROC_ARRAY_SIZE(BlockSizes); nb++) {
+            for (size_t nr = 0; nr < ROC_ARRAY_SIZE(RepairRatios); nr++) {
+                for (size_t np = 0; np < ROC_ARRAY_SIZE(PayloadSizes); np++) {
+                    const size_t sblen = BlockSizes[nb];
+                    const size_t rblen =
+                        std::max((size_t)1, BlockSizes[nb] * RepairRatios[nr] / 100);
+                    const size_t payload_size = PayloadSizes[np];
+
+                    if (sblen + rblen > encoder->max_block_length()
+                        || sblen + rblen > decoder->max_block_length()) {
+                        print_skipped(Schemes[ns].name, sblen, rblen, payload_size,
+                                      "block too long for scheme");
+                        continue;
+                    }
+
+                    Bench bench(*encoder, *decoder, sblen, rblen, payload_size);
+
+                    Result enc_result;
+                    if (!bench.encode(enc_result)) {
+                        print_skipped(Schemes[ns].name, sblen, rblen, payload_size,
+                                      "can't encode block");
+                        continue;
+                    }
+                    print_result(Schemes[ns].name, sblen, rblen, payload_size, "enc",
+                                 enc_result);
+
+                    Result rand_result;
+                    if (bench.decode(Loss_Random, rand_result)) {
+                        print_result(Schemes[ns].name, sblen, rblen, payload_size,
+                                     "random", rand_result);
+                    }
+
+                    Result burst_result;
+                    if (bench.decode(Loss_Burst, burst_result)) {
+                        print_result(Schemes[ns].name, sblen, rblen, payload_size,
+                                     "burst", burst_result);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace fec
+} // namespace roc
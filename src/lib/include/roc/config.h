@@ -31,7 +31,14 @@ typedef enum roc_port_type {
      * If FEC is used, this type of port is used to send or receive FEC repair packets
      * containing redundant data for audio plus some FEC headers.
      */
-    ROC_PORT_AUDIO_REPAIR = 2
+    ROC_PORT_AUDIO_REPAIR = 2,
+
+    /** Network port for retransmitted audio packets.
+     * If set, sender keeps recently sent source packets and retransmits them
+     * when receiver reports a loss, and receiver reports losses to sender.
+     * May be used alongside or instead of FEC.
+     */
+    ROC_PORT_AUDIO_RETRANSMISSION = 3
 } roc_port_type;
 
 /** Network protocol. */
@@ -50,7 +57,18 @@ typedef enum roc_protocol {
     ROC_PROTO_RTP_LDPC_SOURCE = 4,
 
     /** FEC repair packet + FECFRAME LDPC-Staircase header (RFC 6816). */
-    ROC_PROTO_LDPC_REPAIR = 5
+    ROC_PROTO_LDPC_REPAIR = 5,
+
+    /** RTP source packet (RFC 3550) + FECFRAME XOR parity footer. */
+    ROC_PROTO_RTP_XOR_SOURCE = 6,
+
+    /** FEC repair packet + FECFRAME XOR parity header. */
+    ROC_PROTO_XOR_REPAIR = 7,
+
+    /** RTP retransmission packet (RFC 4588) of a source packet.
+     * Lost packets are reported using RTCP Generic NACK (RFC 4585).
+     */
+    ROC_PROTO_RTP_RTX = 8
 } roc_protocol;
 
 /** Forward Error Correction code. */
@@ -77,7 +95,15 @@ typedef enum roc_fec_code {
      * Compatible with @c ROC_PROTO_RTP_LDPC_SOURCE and @c ROC_PROTO_LDPC_REPAIR
      * protocols for source and repair ports.
      */
-    ROC_FEC_LDPC_STAIRCASE = 2
+    ROC_FEC_LDPC_STAIRCASE = 2,
+
+    /** XOR parity FEC code.
+     * Cheapest code, good for low-power devices. Repairs a burst of up to
+     * repair block length consecutive losses per block.
+     * Compatible with @c ROC_PROTO_RTP_XOR_SOURCE and @c ROC_PROTO_XOR_REPAIR
+     * protocols for source and repair ports.
+     */
+    ROC_FEC_XOR = 3
 } roc_fec_code;
 
 /** Packet encoding. */
@@ -124,9 +150,23 @@ typedef enum roc_resampler_profile {
     ROC_RESAMPLER_MEDIUM = 2,
 
     /** Low quality, high speed. */
-    ROC_RESAMPLER_LOW = 3
+    ROC_RESAMPLER_LOW = 3,
+
+    /** Polyphase resampler for fixed rate conversion, high speed.
+     * Supported only by sender, since receiver needs to compensate clock drift.
+     */
+    ROC_RESAMPLER_POLYPHASE = 4
 } roc_resampler_profile;
 
+/** Asynchronous queue overflow policy. */
+typedef enum roc_async_overflow {
+    /** Block writer until there is free space in the queue. */
+    ROC_ASYNC_OVERFLOW_BLOCK = 0,
+
+    /** Drop frames that don't fit into the queue. */
+    ROC_ASYNC_OVERFLOW_DROP = 1
+} roc_async_overflow;
+
 /** Context configuration.
  * @see roc_context
  */
@@ -144,6 +184,16 @@ typedef struct roc_context_config {
      * If zero, default value is used.
      */
     unsigned int max_frame_size;
+
+    /** Number of worker threads.
+     * If non-zero, the context starts a pool of background threads which is used
+     * by attached senders and receivers to encode and decode FEC blocks outside
+     * of roc_sender_write() and roc_receiver_read(). Blocks are processed in order
+     * of their deadline.
+     * If zero, no worker threads are started and FEC blocks are processed in the
+     * calling thread.
+     */
+    unsigned int worker_threads;
 } roc_context_config;
 
 /** Sender configuration.
@@ -231,6 +281,49 @@ typedef struct roc_sender_config {
      * If zero, default value is used.
      */
     unsigned int fec_block_repair_packets;
+
+    /** Minimum number of repair packets per FEC block.
+     * Used if @c fec_block_max_repair_packets is non-zero.
+     * If zero, a block may have no repair packets when the link is clean.
+     */
+    unsigned int fec_block_min_repair_packets;
+
+    /** Maximum number of repair packets per FEC block.
+     * If non-zero, the sender adjusts the number of repair packets per block
+     * between @c fec_block_min_repair_packets and this value, according to the
+     * loss reports from receivers, starting from @c fec_block_repair_packets.
+     * Requires receiver to enable @c fec_feedback_interval.
+     * If zero, the number of repair packets is fixed.
+     */
+    unsigned int fec_block_max_repair_packets;
+
+    /** Retransmission buffer length, in nanoseconds.
+     * Used if @c ROC_PORT_AUDIO_RETRANSMISSION port is connected.
+     * Defines how long sent packets are kept for retransmission. Should not
+     * be lower than the receiver latency.
+     * If zero, default value is used.
+     */
+    unsigned long long retransmission_buffer_length;
+
+    /** Enable asynchronous sending.
+     * If non-zero, roc_sender_write() only copies samples into a queue, and
+     * encoding and sending is performed by a dedicated sender thread. This
+     * keeps the capture thread free from packet processing and network delays.
+     */
+    unsigned int async_sending;
+
+    /** Number of frames in the asynchronous queue.
+     * Used if @c async_sending is enabled.
+     * Larger frames written by user are split into several queue frames.
+     * If zero, default value is used.
+     */
+    unsigned int async_queue_size;
+
+    /** What to do when the asynchronous queue is full.
+     * Used if @c async_sending is enabled.
+     * If zero, the writer is blocked until the sender thread frees some space.
+     */
+    roc_async_overflow async_overflow;
 } roc_sender_config;
 
 /** Receiver configuration.
@@ -274,6 +367,15 @@ typedef struct roc_receiver_config {
      */
     unsigned long long target_latency;
 
+    /** Fast start latency, in nanoseconds.
+     * If non-zero and less than the target latency, the session starts playing as
+     * soon as it accumulates this latency instead of the target latency. Then it
+     * slowly grows the latency to the target latency by slowing down playback.
+     * Requires resampler_profile to be enabled.
+     * If zero, the session starts playing after accumulating the target latency.
+     */
+    unsigned long long start_latency;
+
     /** Maximum delta between current and target latency, in nanoseconds.
      * If current latency becomes larger than the target latency plus this value, the
      * session is terminated.
@@ -313,6 +415,113 @@ typedef struct roc_receiver_config {
      * @see broken_playback_timeout.
      */
     unsigned long long breakage_detection_window;
+
+    /** Interval between FEC loss reports, in nanoseconds.
+     * If non-zero, the receiver periodically reports the loss rate and burst
+     * length to every sender that uses FEC, so that the sender may adjust the
+     * number of repair packets. Reports are sent from a separate port bound
+     * to the same address family as the first bound receiver port.
+     * If zero, loss reports are not sent.
+     */
+    unsigned long long fec_feedback_interval;
+
+    /** Process sessions in parallel.
+     * If non-zero and the context has worker threads, every session renders its
+     * frame in a worker thread during roc_receiver_read(), and the results are
+     * mixed in the calling thread. The output is the same as without this option.
+     * Useful when a receiver handles many sessions.
+     * If zero, sessions are processed one by one in the calling thread.
+     */
+    unsigned int parallel_sessions;
+
+    /** Adapt target latency to network jitter.
+     * If non-zero, every session measures jitter and late packets and moves its
+     * target latency within the [min_target_latency; max_target_latency] range.
+     * The latency is changed smoothly by adjusting the playback speed, so
+     * resampler_profile should not be disabled.
+     * If zero, target_latency is used during the whole session.
+     */
+    unsigned int adaptive_latency;
+
+    /** Minimum adaptive target latency, in nanoseconds.
+     * If zero, default value is used.
+     */
+    unsigned long long min_target_latency;
+
+    /** Maximum adaptive target latency, in nanoseconds.
+     * Should not exceed target_latency plus max_latency_overrun. When the target
+     * latency is raised, the latency at which the session is terminated is raised
+     * by the same amount, so that jitter above the new target is tolerated.
+     * If zero, target_latency plus half of max_latency_overrun is used.
+     */
+    unsigned long long max_target_latency;
+
+    /** Quickly correct large latency deviations by time stretching.
+     * If non-zero, when the session latency differs from the target latency by
+     * more than 100ms, the audio is compressed or expanded by up to 10% without
+     * changing its pitch, until the latency is close to the target again.
+     * If zero, the latency is corrected only by resampler.
+     */
+    unsigned int time_stretching;
+
+    /** Number of sessions to construct in advance.
+     * If non-zero, the receiver keeps this number of idle sessions constructed
+     * in advance for the parameters of the last connected sender, and binds
+     * them to new senders. Idle sessions are constructed in background, by the
+     * context worker threads if they are enabled, and by a thread started by
+     * the receiver otherwise. This avoids constructing a session in the thread
+     * calling roc_receiver_read() when a new sender connects. If zero, sessions
+     * are constructed on demand.
+     */
+    unsigned int session_pool_size;
+
+    /** Read sessions separately instead of mixing them.
+     * If non-zero, sessions are not mixed, roc_receiver_read() produces silence,
+     * and every session should be read using roc_receiver_read_session().
+     * Sessions can be enumerated using roc_receiver_get_sessions().
+     * If zero, all sessions are mixed into the stream returned by
+     * roc_receiver_read().
+     */
+    unsigned int separate_sessions;
+
+    /** Parse and route packets in the network thread.
+     * If non-zero, received packets are parsed and put to the queues of their
+     * sessions in the network thread, and roc_receiver_read() only passes queued
+     * packets to sessions. This reduces the work done in the thread calling
+     * roc_receiver_read() when many packets arrive at once.
+     * If zero, packets are parsed and routed in roc_receiver_read().
+     */
+    unsigned int network_routing;
+
+    /** Maximum number of sessions.
+     * If non-zero, packets from new senders are rejected when this number of
+     * sessions is reached.
+     * If zero, the number of sessions is not limited.
+     */
+    unsigned int max_sessions;
+
+    /** Maximum number of packets per second accepted from a single sender.
+     * If non-zero, packets exceeding this rate are dropped.
+     * If zero, the rate is not limited.
+     */
+    unsigned int max_packet_rate;
+
+    /** Maximum time spent in a single roc_receiver_read(), in nanoseconds.
+     * If non-zero and a read takes longer, the most recently created session is
+     * removed, so that established sessions keep playing. The last remaining
+     * session is never removed. Not used if @c separate_sessions is set.
+     * If zero, the time is not limited.
+     */
+    unsigned long long read_budget;
+
+    /** Time during which rejected senders are ignored, in nanoseconds.
+     * Used for senders rejected because of @c max_sessions and senders which
+     * session was removed because of @c read_budget. If a sender is removed
+     * because of @c read_budget again soon after it was re-admitted, the time
+     * is doubled for it, up to a limit.
+     * If zero, default value is used.
+     */
+    unsigned long long reject_timeout;
 } roc_receiver_config;
 
 #ifdef __cplusplus
@@ -72,6 +72,12 @@ extern "C" {
  * destroyed on other events like a large latency underrun or overrun or broken playback,
  * but if the sender continues to send packets, it will be created again shortly.
  *
+ * The number of sessions, the packet rate of every sender, and the time spent in
+ * roc_receiver_read() may be limited in the receiver config. Senders rejected because
+ * of the session limit and senders which sessions were removed because of the time
+ * limit are ignored for a while. They are counted in the receiver metrics, which can
+ * be retrieved using roc_receiver_get_metrics().
+ *
  * @b Mixing
  *
  * Receiver mixes audio streams from all currently active sessions into a single output
@@ -80,6 +86,10 @@ extern "C" {
  * with all zeros. Sessions can be added and removed from the output stream at any time,
  * probably in the middle of a frame.
  *
+ * Alternatively, if @c separate_sessions is set in the receiver config, sessions are not
+ * mixed. The user enumerates sessions using roc_receiver_get_sessions() and reads every
+ * session stream using roc_receiver_read_session().
+ *
  * @b Resampling
  *
  * Every session may have a different sample rate. And even if nominally all of them are
@@ -116,6 +126,24 @@ extern "C" {
  */
 typedef struct roc_receiver roc_receiver;
 
+/** Receiver session identifier.
+ *
+ * Identifies a session within a receiver. Identifiers are not reused: if a sender
+ * reconnects, a new session with a new identifier is created.
+ */
+typedef unsigned int roc_session_id;
+
+/** Receiver metrics.
+ * @see roc_receiver_get_metrics
+ */
+typedef struct roc_receiver_metrics {
+    /** Number of senders rejected because @c max_sessions was reached. */
+    unsigned long long rejected_sessions;
+
+    /** Number of sessions removed because @c read_budget was exceeded. */
+    unsigned long long shed_sessions;
+} roc_receiver_metrics;
+
 /** Open a new receiver.
  *
  * Allocates and initializes a new receiver, and attaches it to the context.
@@ -179,6 +207,64 @@ ROC_API int roc_receiver_bind(roc_receiver* receiver,
  */
 ROC_API int roc_receiver_read(roc_receiver* receiver, roc_frame* frame);
 
+/** Get identifiers of active sessions.
+ *
+ * Stores identifiers of currently active sessions to @p sessions array. Sessions can
+ * appear and disappear at any time, so the result is a snapshot.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p sessions should point to an array of at least @p count elements
+ *  - @p count should point to the array size; it is set to the total number of
+ *    active sessions, which may be larger than the array size, in which case only
+ *    the first elements are stored
+ *
+ * @b Returns
+ *  - returns zero if the identifiers were successfully stored
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int
+roc_receiver_get_sessions(roc_receiver* receiver, roc_session_id* sessions, size_t* count);
+
+/** Read samples from a single session.
+ *
+ * Reads network packets received on bound ports, routes packets to sessions, and
+ * then repairs lost packets, decodes samples, and resamples them for the given
+ * session only, and finally stores samples into the provided frame.
+ *
+ * Should be used only if @c separate_sessions is set in the receiver config. Doesn't
+ * block even if the automatic timing is enabled; the user is responsible to read
+ * every session at the configured sample rate.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p session should be an identifier returned by roc_receiver_get_sessions()
+ *  - @p frame should point to an initialized frame which will be filled with samples;
+ *    the number of samples is defined by the frame size
+ *
+ * @b Returns
+ *  - returns zero if all samples were successfully decoded
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if there is no such session, e.g. if it was terminated
+ */
+ROC_API int
+roc_receiver_read_session(roc_receiver* receiver, roc_session_id session, roc_frame* frame);
+
+/** Get receiver metrics.
+ *
+ * Stores the current values of receiver counters to @p metrics.
+ *
+ * @b Parameters
+ *  - @p receiver should point to an opened receiver
+ *  - @p metrics should point to a metrics struct to be filled
+ *
+ * @b Returns
+ *  - returns zero if the metrics were successfully stored
+ *  - returns a negative value if the arguments are invalid
+ */
+ROC_API int roc_receiver_get_metrics(roc_receiver* receiver,
+                                     roc_receiver_metrics* metrics);
+
 /** Close the receiver.
  *
  * Deinitializes and deallocates the receiver, and detaches it from the context. The user
@@ -64,6 +64,11 @@ extern "C" {
  *    @c ROC_FEC_RS8M is used, the corresponding protocols would be
  *    @c ROC_PROTO_RTP_RSM8_SOURCE and @c ROC_PROTO_RSM8_REPAIR.
  *
+ * @b Destinations
+ *
+ * The same stream can be sent to multiple receivers using roc_sender_add_destination().
+ * Packets are encoded once, and then the same packets are sent to every destination.
+ *
  * @b Resampling
  *
  * If the sample rate of the user frames and the sample rate of the network packets are
@@ -155,6 +160,36 @@ ROC_API int roc_sender_connect(roc_sender* sender,
                                roc_protocol proto,
                                const roc_address* address);
 
+/** Send the stream to one more receiver.
+ *
+ * Adds another pair of receiver addresses, in addition to the addresses passed to
+ * roc_sender_connect(). The receiver should use the same port types and protocols as
+ * the receiver passed to roc_sender_connect(). Should be called after connecting the
+ * ports and before calling roc_sender_write() first time.
+ *
+ * Encoding and FEC are performed once for all destinations. Retransmission is not
+ * supported when the stream is sent to multiple receivers, so this function fails
+ * if @c ROC_PORT_AUDIO_RETRANSMISSION port is connected, and connecting this port
+ * fails if a destination was added.
+ *
+ * @b Parameters
+ *  - @p sender should point to an opened sender
+ *  - @p source_address should point to a properly initialized address of the receiver
+ *    @c ROC_PORT_AUDIO_SOURCE port
+ *  - @p repair_address should point to a properly initialized address of the receiver
+ *    @c ROC_PORT_AUDIO_REPAIR port if FEC is enabled, and is ignored otherwise
+ *
+ * @b Returns
+ *  - returns zero if the destination was successfully added
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if retransmission port is connected
+ *  - returns a negative value if roc_sender_write() was already called
+ *  - returns a negative value if there are not enough resources
+ */
+ROC_API int roc_sender_add_destination(roc_sender* sender,
+                                       const roc_address* source_address,
+                                       const roc_address* repair_address);
+
 /** Encode samples to packets and transmit them to the receiver.
  *
  * Encodes samples to packets and enqueues them for transmission by the context network
@@ -27,6 +27,8 @@ bool make_context_config(roc_context_config& out, const roc_context_config& in)
         out.max_frame_size = 4096;
     }
 
+    out.worker_threads = in.worker_threads;
+
     return true;
 }
 
@@ -87,6 +89,9 @@ bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in
     case ROC_RESAMPLER_HIGH:
         out.resampler = audio::resampler_profile(audio::ResamplerProfile_High);
         break;
+    case ROC_RESAMPLER_POLYPHASE:
+        out.resampler = audio::resampler_profile(audio::ResamplerProfile_Polyphase);
+        break;
     default:
         roc_log(LogError, "roc_config: invalid resampler_profile");
         return false;
@@ -103,6 +108,9 @@ bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in
     case ROC_FEC_LDPC_STAIRCASE:
         out.fec_encoder.scheme = packet::FEC_LDPC_Staircase;
         break;
+    case ROC_FEC_XOR:
+        out.fec_encoder.scheme = packet::FEC_XOR_Parity;
+        break;
     default:
         roc_log(LogError, "roc_config: invalid fec_scheme");
         return false;
@@ -113,6 +121,40 @@ bool make_sender_config(pipeline::SenderConfig& out, const roc_sender_config& in
         out.fec_writer.n_repair_packets = in.fec_block_repair_packets;
     }
 
+    if (in.fec_block_max_repair_packets != 0) {
+        if (in.fec_block_min_repair_packets > in.fec_block_max_repair_packets) {
+            roc_log(LogError,
+                    "roc_config: fec_block_min_repair_packets should not be greater"
+                    " than fec_block_max_repair_packets");
+            return false;
+        }
+        out.fec_adapter.min_repair_packets = in.fec_block_min_repair_packets;
+        out.fec_adapter.max_repair_packets = in.fec_block_max_repair_packets;
+    }
+
+    if (in.retransmission_buffer_length != 0) {
+        out.retransmission_buffer_length =
+            (core::nanoseconds_t)in.retransmission_buffer_length;
+    }
+
+    out.async = in.async_sending;
+
+    if (in.async_queue_size != 0) {
+        out.async_queue_size = in.async_queue_size;
+    }
+
+    switch ((int)in.async_overflow) {
+    case ROC_ASYNC_OVERFLOW_BLOCK:
+        out.async_overflow = pipeline::AsyncOverflow_Block;
+        break;
+    case ROC_ASYNC_OVERFLOW_DROP:
+        out.async_overflow = pipeline::AsyncOverflow_Drop;
+        break;
+    default:
+        roc_log(LogError, "roc_config: invalid async_overflow");
+        return false;
+    }
+
     return true;
 }
 
@@ -154,6 +196,10 @@ bool make_receiver_config(pipeline::ReceiverConfig& out, const roc_receiver_conf
         out.default_session.resampler =
             audio::resampler_profile(audio::ResamplerProfile_High);
         break;
+    case ROC_RESAMPLER_POLYPHASE:
+        roc_log(LogError,
+                "roc_config: polyphase resampler_profile is not supported by receiver");
+        return false;
     default:
         roc_log(LogError, "roc_config: invalid resampler_profile");
         return false;
@@ -181,14 +227,16 @@ bool make_receiver_config(pipeline::ReceiverConfig& out, const roc_receiver_conf
         }
     }
 
+    out.default_session.start_latency = (core::nanoseconds_t)in.start_latency;
+
     if (in.max_latency_overrun != 0) {
-        out.default_session.latency_monitor.min_latency =
+        out.default_session.latency_monitor.max_latency =
             out.default_session.target_latency
             + (core::nanoseconds_t)in.max_latency_overrun;
     }
 
     if (in.max_latency_underrun != 0) {
-        out.default_session.latency_monitor.max_latency =
+        out.default_session.latency_monitor.min_latency =
             out.default_session.target_latency
             - (core::nanoseconds_t)in.max_latency_underrun;
     }
@@ -210,6 +258,46 @@ bool make_receiver_config(pipeline::ReceiverConfig& out, const roc_receiver_conf
             (core::nanoseconds_t)in.breakage_detection_window;
     }
 
+    out.default_session.fec_feedback_interval =
+        (core::nanoseconds_t)in.fec_feedback_interval;
+
+    out.common.parallel_sessions = in.parallel_sessions;
+
+    out.default_session.latency_monitor.adaptive_latency = in.adaptive_latency;
+
+    if (in.min_target_latency != 0) {
+        out.default_session.latency_monitor.min_target_latency =
+            (core::nanoseconds_t)in.min_target_latency;
+    }
+
+    if (in.max_target_latency != 0) {
+        out.default_session.latency_monitor.max_target_latency =
+            (core::nanoseconds_t)in.max_target_latency;
+    } else {
+        // leave room for jitter above the largest target
+        out.default_session.latency_monitor.max_target_latency =
+            out.default_session.target_latency
+            + (out.default_session.latency_monitor.max_latency
+               - out.default_session.target_latency)
+                / 2;
+    }
+
+    out.default_session.time_stretching = in.time_stretching;
+
+    out.common.session_pool_size = in.session_pool_size;
+
+    out.common.mixing = !in.separate_sessions;
+
+    out.common.route_on_write = in.network_routing;
+
+    out.common.max_sessions = in.max_sessions;
+    out.common.max_packet_rate = in.max_packet_rate;
+    out.common.read_budget = (core::nanoseconds_t)in.read_budget;
+
+    if (in.reject_timeout != 0) {
+        out.common.reject_timeout = (core::nanoseconds_t)in.reject_timeout;
+    }
+
     return true;
 }
 
@@ -229,6 +317,9 @@ bool make_port_config(pipeline::PortConfig& out,
         case ROC_PROTO_RTP_LDPC_SOURCE:
             out.protocol = pipeline::Proto_RTP_LDPC_Source;
             break;
+        case ROC_PROTO_RTP_XOR_SOURCE:
+            out.protocol = pipeline::Proto_RTP_XOR_Source;
+            break;
         default:
             roc_log(LogError, "roc_config: invalid protocol for audio source port");
             return false;
@@ -243,12 +334,27 @@ bool make_port_config(pipeline::PortConfig& out,
         case ROC_PROTO_LDPC_REPAIR:
             out.protocol = pipeline::Proto_LDPC_Repair;
             break;
+        case ROC_PROTO_XOR_REPAIR:
+            out.protocol = pipeline::Proto_XOR_Repair;
+            break;
         default:
             roc_log(LogError, "roc_config: invalid protocol for audio repair port");
             return false;
         }
         break;
 
+    case ROC_PORT_AUDIO_RETRANSMISSION:
+        switch ((int)proto) {
+        case ROC_PROTO_RTP_RTX:
+            out.protocol = pipeline::Proto_RTP_RTX;
+            break;
+        default:
+            roc_log(LogError,
+                    "roc_config: invalid protocol for audio retransmission port");
+            return false;
+        }
+        break;
+
     default:
         roc_log(LogError, "roc_config: invalid port type");
         return false;
@@ -18,6 +18,10 @@ roc_context::roc_context(const roc_context_config& cfg)
     , sample_buffer_pool(allocator, cfg.max_frame_size / sizeof(audio::sample_t), false)
     , trx(packet_pool, byte_buffer_pool, allocator)
     , counter(0) {
+    if (cfg.worker_threads != 0) {
+        worker_pool.reset(new (allocator) core::WorkerPool(cfg.worker_threads, allocator),
+                          allocator);
+    }
 }
 
 roc_context* roc_context_open(const roc_context_config* config) {
@@ -47,6 +51,14 @@ roc_context* roc_context_open(const roc_context_config* config) {
         return NULL;
     }
 
+    if (private_config.worker_threads != 0
+        && (!context->worker_pool || !context->worker_pool->valid())) {
+        roc_log(LogError, "roc_context_open: can't initialize worker pool");
+
+        delete context;
+        return NULL;
+    }
+
     return context;
 }
 
@@ -15,13 +15,16 @@
 #include "roc/sender.h"
 
 #include "roc_audio/units.h"
+#include "roc_core/array.h"
 #include "roc_core/atomic.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/mutex.h"
 #include "roc_core/unique_ptr.h"
+#include "roc_core/worker_pool.h"
 #include "roc_netio/transceiver.h"
 #include "roc_packet/address.h"
+#include "roc_packet/concurrent_queue.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_pipeline/receiver.h"
@@ -53,6 +56,8 @@ struct roc_context {
 
     roc::netio::Transceiver trx;
 
+    roc::core::UniquePtr<roc::core::WorkerPool> worker_pool;
+
     roc::core::Atomic counter;
 };
 
@@ -68,10 +73,17 @@ struct roc_sender {
 
     roc::pipeline::PortConfig source_port;
     roc::pipeline::PortConfig repair_port;
+    roc::pipeline::PortConfig rtx_port;
+
+    roc::core::Array<roc::packet::Address> source_addresses;
+    roc::core::Array<roc::packet::Address> repair_addresses;
 
     roc::core::UniquePtr<roc::pipeline::Sender> sender;
     roc::packet::IWriter* writer;
 
+    roc::packet::ConcurrentQueue feedback_queue;
+    bool feedback_enabled;
+
     roc::packet::Address address;
 
     roc::core::Mutex mutex;
@@ -89,6 +101,10 @@ struct roc_receiver {
 
     roc::pipeline::Receiver receiver;
 
+    bool feedback_enabled;
+    roc::packet::Address feedback_address;
+    roc::packet::IWriter* feedback_writer;
+
     size_t num_channels;
 };
 
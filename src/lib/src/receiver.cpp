@@ -9,6 +9,7 @@
 #include "private.h"
 
 #include "roc_core/log.h"
+#include "roc_packet/address_to_str.h"
 #include "roc_pipeline/port_to_str.h"
 
 using namespace roc;
@@ -22,6 +23,67 @@ void receiver_close_port(void* arg, const pipeline::PortConfig& port) {
     receiver->context.trx.remove_port(port.address);
 }
 
+bool receiver_init_feedback(roc_receiver* receiver, const packet::Address& addr) {
+    bool ok = false;
+    if (addr.version() == 6) {
+        ok = receiver->feedback_address.set_ipv6("::", 0);
+    } else {
+        ok = receiver->feedback_address.set_ipv4("0.0.0.0", 0);
+    }
+    if (!ok) {
+        roc_log(LogError, "roc_receiver: can't initialize feedback address");
+        return false;
+    }
+
+    receiver->feedback_writer =
+        receiver->context.trx.add_udp_sender(receiver->feedback_address);
+    if (!receiver->feedback_writer) {
+        roc_log(LogError, "roc_receiver: can't bind feedback port");
+        return false;
+    }
+
+    receiver->receiver.set_feedback_writer(*receiver->feedback_writer);
+
+    roc_log(LogInfo, "roc_receiver: sending feedback from %s",
+            packet::address_to_str(receiver->feedback_address).c_str());
+
+    return true;
+}
+
+struct SessionList {
+    roc_session_id* sessions;
+    size_t size;
+    size_t count;
+};
+
+void receiver_list_session(void* arg, pipeline::session_id_t id, const packet::Address&) {
+    roc_panic_if_not(arg);
+    SessionList* list = (SessionList*)arg;
+
+    if (list->count < list->size) {
+        list->sessions[list->count] = (roc_session_id)id;
+    }
+    list->count++;
+}
+
+bool receiver_check_frame(roc_receiver* receiver, roc_frame* frame, const char* func) {
+    const size_t step = receiver->num_channels * sizeof(float);
+
+    if (frame->samples_size % step != 0) {
+        roc_log(LogError,
+                "%s: invalid arguments: # of samples should be multiple of # of %u",
+                func, (unsigned)step);
+        return false;
+    }
+
+    if (!frame->samples) {
+        roc_log(LogError, "%s: invalid arguments: samples is null", func);
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace
 
 roc_receiver::roc_receiver(roc_context& ctx, pipeline::ReceiverConfig& cfg)
@@ -29,10 +91,13 @@ roc_receiver::roc_receiver(roc_context& ctx, pipeline::ReceiverConfig& cfg)
     , receiver(cfg,
                codec_map,
                format_map,
+               context.worker_pool.get(),
                context.packet_pool,
                context.byte_buffer_pool,
                context.sample_buffer_pool,
                context.allocator)
+    , feedback_enabled(cfg.default_session.fec_feedback_interval != 0)
+    , feedback_writer(NULL)
     , num_channels(packet::num_channels(cfg.common.output_channels)) {
 }
 
@@ -94,6 +159,15 @@ int roc_receiver_bind(roc_receiver* receiver,
         return -1;
     }
 
+    // retransmission requests are sent over the feedback port as well
+    if ((receiver->feedback_enabled || type == ROC_PORT_AUDIO_RETRANSMISSION)
+        && !receiver->feedback_writer) {
+        if (!receiver_init_feedback(receiver, addr)) {
+            roc_log(LogError, "roc_receiver_bind: can't initialize feedback");
+            return -1;
+        }
+    }
+
     if (!receiver->context.trx.add_udp_receiver(addr, receiver->receiver)) {
         roc_log(LogError, "roc_receiver_bind: bind failed");
         return -1;
@@ -131,23 +205,93 @@ int roc_receiver_read(roc_receiver* receiver, roc_frame* frame) {
         return 0;
     }
 
-    const size_t step = receiver->num_channels * sizeof(float);
+    if (!receiver_check_frame(receiver, frame, "roc_receiver_read")) {
+        return -1;
+    }
 
-    if (frame->samples_size % step != 0) {
+    audio::Frame audio_frame((float*)frame->samples, frame->samples_size / sizeof(float));
+    receiver->receiver.read(audio_frame);
+
+    return 0;
+}
+
+int roc_receiver_get_sessions(roc_receiver* receiver,
+                              roc_session_id* sessions,
+                              size_t* count) {
+    if (!receiver) {
         roc_log(LogError,
-                "roc_receiver_read: invalid arguments: # of samples should be "
-                "multiple of # of %u",
-                (unsigned)step);
+                "roc_receiver_get_sessions: invalid arguments: receiver is null");
         return -1;
     }
 
-    if (!frame->samples) {
-        roc_log(LogError, "roc_receiver_read: invalid arguments: samples is null");
+    if (!count) {
+        roc_log(LogError, "roc_receiver_get_sessions: invalid arguments: count is null");
+        return -1;
+    }
+
+    if (!sessions && *count != 0) {
+        roc_log(LogError,
+                "roc_receiver_get_sessions: invalid arguments: sessions is null");
+        return -1;
+    }
+
+    SessionList list;
+    list.sessions = sessions;
+    list.size = *count;
+    list.count = 0;
+
+    receiver->receiver.iterate_sessions(receiver_list_session, &list);
+
+    *count = list.count;
+
+    return 0;
+}
+
+int roc_receiver_read_session(roc_receiver* receiver,
+                              roc_session_id session,
+                              roc_frame* frame) {
+    if (!receiver) {
+        roc_log(LogError,
+                "roc_receiver_read_session: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!frame) {
+        roc_log(LogError, "roc_receiver_read_session: invalid arguments: frame is null");
+        return -1;
+    }
+
+    if (frame->samples_size == 0) {
+        return 0;
+    }
+
+    if (!receiver_check_frame(receiver, frame, "roc_receiver_read_session")) {
         return -1;
     }
 
     audio::Frame audio_frame((float*)frame->samples, frame->samples_size / sizeof(float));
-    receiver->receiver.read(audio_frame);
+    if (!receiver->receiver.read_session((pipeline::session_id_t)session, audio_frame)) {
+        roc_log(LogDebug, "roc_receiver_read_session: can't read session: id=%u",
+                (unsigned)session);
+        return -1;
+    }
+
+    return 0;
+}
+
+int roc_receiver_get_metrics(roc_receiver* receiver, roc_receiver_metrics* metrics) {
+    if (!receiver) {
+        roc_log(LogError, "roc_receiver_get_metrics: invalid arguments: receiver is null");
+        return -1;
+    }
+
+    if (!metrics) {
+        roc_log(LogError, "roc_receiver_get_metrics: invalid arguments: metrics is null");
+        return -1;
+    }
+
+    metrics->rejected_sessions = receiver->receiver.num_rejected_sessions();
+    metrics->shed_sessions = receiver->receiver.num_shed_sessions();
 
     return 0;
 }
@@ -161,6 +305,9 @@ int roc_receiver_close(roc_receiver* receiver) {
     roc_context& context = receiver->context;
 
     receiver->receiver.iterate_ports(receiver_close_port, receiver);
+    if (receiver->feedback_writer) {
+        receiver->context.trx.remove_port(receiver->feedback_address);
+    }
     receiver->context.allocator.destroy(*receiver);
     --context.counter;
 
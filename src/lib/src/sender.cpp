@@ -17,13 +17,18 @@ using namespace roc;
 
 namespace {
 
+// Maximum number of loss reports and retransmission requests queued between writes.
+const size_t MaxFeedbackPackets = 16;
+
 bool sender_init_pipeline(roc_sender* sender) {
     sender->sender.reset(
         new (sender->context.allocator) pipeline::Sender(
             sender->config, sender->source_port, *sender->writer, sender->repair_port,
-            *sender->writer, sender->codec_map, sender->format_map,
-            sender->context.packet_pool, sender->context.byte_buffer_pool,
-            sender->context.sample_buffer_pool, sender->context.allocator),
+            *sender->writer, sender->rtx_port, *sender->writer, sender->codec_map,
+            sender->format_map,
+            sender->context.worker_pool.get(), sender->context.packet_pool,
+            sender->context.byte_buffer_pool, sender->context.sample_buffer_pool,
+            sender->context.allocator),
         sender->context.allocator);
 
     if (!sender->sender) {
@@ -36,6 +41,57 @@ bool sender_init_pipeline(roc_sender* sender) {
         return false;
     }
 
+    if (sender->feedback_enabled) {
+        sender->sender->set_feedback_reader(sender->feedback_queue);
+    }
+
+    for (size_t n = 0; n < sender->source_addresses.size(); n++) {
+        if (!sender->sender->add_destination(sender->source_addresses[n],
+                                             sender->repair_addresses[n])) {
+            roc_log(LogError, "roc_sender: can't add destination");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool sender_needs_feedback(const roc_sender* sender) {
+    return sender->config.fec_adapter.max_repair_packets != 0
+        || sender->rtx_port.protocol != pipeline::Proto_None;
+}
+
+bool sender_bind_port(roc_sender* sender, packet::Address& addr) {
+    sender->feedback_enabled = sender_needs_feedback(sender);
+
+    if (sender->feedback_enabled) {
+        sender->writer =
+            sender->context.trx.add_udp_sender(addr, sender->feedback_queue);
+    } else {
+        sender->writer = sender->context.trx.add_udp_sender(addr);
+    }
+
+    return sender->writer;
+}
+
+bool sender_enable_feedback(roc_sender* sender) {
+    if (!sender->writer || sender->feedback_enabled) {
+        return true;
+    }
+
+    // retransmission port was connected after bind, so rebind the same port
+    // with the receive path enabled
+    sender->context.trx.remove_port(sender->address);
+
+    if (!sender_bind_port(sender, sender->address)) {
+        roc_log(LogError, "roc_sender: can't rebind to %s to receive feedback",
+                packet::address_to_str(sender->address).c_str());
+        return false;
+    }
+
+    roc_log(LogDebug, "roc_sender: receiving feedback on %s",
+            packet::address_to_str(sender->address).c_str());
+
     return true;
 }
 
@@ -94,6 +150,36 @@ bool sender_set_port(roc_sender* sender,
                 pipeline::port_to_str(port_config).c_str());
 
         return true;
+
+    case ROC_PORT_AUDIO_RETRANSMISSION:
+        if (sender->rtx_port.protocol != pipeline::Proto_None) {
+            roc_log(LogError, "roc_sender: audio retransmission port is already set");
+            return false;
+        }
+
+        if (!pipeline::validate_port(sender->config.fec_encoder.scheme,
+                                     port_config.protocol,
+                                     pipeline::Port_AudioRetransmission)) {
+            return false;
+        }
+
+        if (sender->source_addresses.size() != 0) {
+            roc_log(LogError,
+                    "roc_sender: retransmission is not supported with multiple "
+                    "destinations");
+            return false;
+        }
+
+        sender->rtx_port = port_config;
+
+        if (!sender_enable_feedback(sender)) {
+            return false;
+        }
+
+        roc_log(LogInfo, "roc_sender: set audio retransmission port to %s",
+                pipeline::port_to_str(port_config).c_str());
+
+        return true;
     }
 
     roc_log(LogError, "roc_sender: invalid protocol");
@@ -120,7 +206,11 @@ bool sender_check_connected(roc_sender* sender) {
 roc_sender::roc_sender(roc_context& ctx, pipeline::SenderConfig& cfg)
     : context(ctx)
     , config(cfg)
+    , source_addresses(ctx.allocator)
+    , repair_addresses(ctx.allocator)
     , writer(NULL)
+    , feedback_queue(MaxFeedbackPackets, false)
+    , feedback_enabled(false)
     , num_channels(packet::num_channels(cfg.input_channels)) {
 }
 
@@ -183,8 +273,9 @@ int roc_sender_bind(roc_sender* sender, roc_address* address) {
         return -1;
     }
 
-    sender->writer = sender->context.trx.add_udp_sender(addr);
-    if (!sender->writer) {
+    // feedback is received only if adaptive FEC or retransmission is used;
+    // if retransmission port is connected later, the port is rebound
+    if (!sender_bind_port(sender, addr)) {
         roc_log(LogError, "roc_sender_bind: bind failed");
         return -1;
     }
@@ -237,6 +328,77 @@ int roc_sender_connect(roc_sender* sender,
     return 0;
 }
 
+int roc_sender_add_destination(roc_sender* sender,
+                               const roc_address* source_address,
+                               const roc_address* repair_address) {
+    if (!sender) {
+        roc_log(LogError, "roc_sender_add_destination: invalid arguments: sender is null");
+        return -1;
+    }
+
+    if (!source_address) {
+        roc_log(LogError,
+                "roc_sender_add_destination: invalid arguments: source address is null");
+        return -1;
+    }
+
+    const packet::Address& source_addr = get_address(source_address);
+    if (!source_addr.valid()) {
+        roc_log(LogError,
+                "roc_sender_add_destination: invalid arguments: invalid source address");
+        return -1;
+    }
+
+    core::Mutex::Lock lock(sender->mutex);
+
+    if (sender->sender) {
+        roc_log(LogError, "roc_sender_add_destination: can't be called after first write");
+        return -1;
+    }
+
+    if (sender->rtx_port.protocol != pipeline::Proto_None) {
+        roc_log(LogError,
+                "roc_sender_add_destination: multiple destinations are not supported "
+                "with retransmission");
+        return -1;
+    }
+
+    packet::Address repair_addr;
+
+    if (sender->config.fec_encoder.scheme != packet::FEC_None) {
+        if (!repair_address) {
+            roc_log(LogError,
+                    "roc_sender_add_destination: invalid arguments: repair address is "
+                    "null");
+            return -1;
+        }
+
+        repair_addr = get_address(repair_address);
+        if (!repair_addr.valid()) {
+            roc_log(LogError,
+                    "roc_sender_add_destination: invalid arguments: invalid repair "
+                    "address");
+            return -1;
+        }
+    }
+
+    const size_t n_addrs = sender->source_addresses.size() + 1;
+
+    if (!sender->source_addresses.grow(n_addrs)
+        || !sender->repair_addresses.grow(n_addrs)) {
+        roc_log(LogError, "roc_sender_add_destination: can't allocate destination");
+        return -1;
+    }
+
+    sender->source_addresses.push_back(source_addr);
+    sender->repair_addresses.push_back(repair_addr);
+
+    roc_log(LogInfo, "roc_sender: added destination %s",
+            packet::address_to_str(source_addr).c_str());
+
+    return 0;
+}
+
 int roc_sender_write(roc_sender* sender, const roc_frame* frame) {
     if (!sender) {
         roc_log(LogError, "roc_sender_write: invalid arguments: sender is null");
@@ -303,6 +465,10 @@ int roc_sender_close(roc_sender* sender) {
         return -1;
     }
 
+    // pipeline may write packets from its own thread until it's destroyed,
+    // so destroy it before removing the port that owns the writer
+    sender->sender.reset();
+
     if (sender->writer) {
         sender->context.trx.remove_port(sender->address);
     }
@@ -61,6 +61,10 @@ packet::timestamp_t Depacketizer::timestamp() const {
     return timestamp_;
 }
 
+size_t Depacketizer::dropped_packets() const {
+    return dropped_packets_;
+}
+
 void Depacketizer::read(Frame& frame) {
     const size_t prev_dropped_packets = dropped_packets_;
     const packet::timestamp_t prev_packet_samples = packet_samples_;
@@ -247,6 +251,10 @@ void Depacketizer::set_frame_flags_(Frame& frame,
         flags |= Frame::FlagBlank;
     }
 
+    if (beep_ && packet_samples != frame.size()) {
+        flags |= Frame::FlagBeep;
+    }
+
     if (prev_dropped_packets != dropped_packets_) {
         flags |= Frame::FlagDrops;
     }
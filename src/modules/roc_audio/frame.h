@@ -35,7 +35,13 @@ public:
         FlagIncomplete = (1 << 1),
 
         //! Set if some late packets were dropped while the frame was being built.
-        FlagDrops = (1 << 2)
+        FlagDrops = (1 << 2),
+
+        //! Set if missing data was replaced with a beep instead of zeros.
+        //! @remarks
+        //!  Frames with both FlagBlank and FlagBeep are not zeros and should not
+        //!  be skipped by processing stages.
+        FlagBeep = (1 << 3)
     };
 
     //! Set flags.
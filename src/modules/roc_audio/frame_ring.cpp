@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/frame_ring.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+FrameRing::FrameRing(core::IAllocator& allocator, size_t num_frames, size_t frame_size)
+    : num_frames_(num_frames)
+    , frame_size_(frame_size)
+    , samples_(allocator)
+    , sizes_(allocator)
+    , valid_(false) {
+    if (num_frames == 0 || frame_size == 0) {
+        roc_log(LogError,
+                "frame ring: invalid size: num_frames=%lu frame_size=%lu",
+                (unsigned long)num_frames, (unsigned long)frame_size);
+        return;
+    }
+
+    if (!samples_.resize(num_frames * frame_size)) {
+        roc_log(LogError, "frame ring: can't allocate samples");
+        return;
+    }
+
+    if (!sizes_.resize(num_frames)) {
+        roc_log(LogError, "frame ring: can't allocate frames");
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool FrameRing::valid() const {
+    return valid_;
+}
+
+size_t FrameRing::frame_size() const {
+    return frame_size_;
+}
+
+size_t FrameRing::size() const {
+    // read position is loaded first, so that concurrent pop() can only
+    // make the result smaller, but never negative
+    const long read_pos = read_pos_;
+    const long write_pos = write_pos_;
+
+    return size_t(write_pos - read_pos);
+}
+
+bool FrameRing::empty() const {
+    return size() == 0;
+}
+
+bool FrameRing::full() const {
+    return size() >= num_frames_;
+}
+
+bool FrameRing::push(const sample_t* samples, size_t n_samples) {
+    roc_panic_if(!valid_);
+
+    if (n_samples > frame_size_) {
+        roc_panic("frame ring: frame too large: n_samples=%lu frame_size=%lu",
+                  (unsigned long)n_samples, (unsigned long)frame_size_);
+    }
+
+    if (full()) {
+        return false;
+    }
+
+    const size_t index = size_t((long)write_pos_) % num_frames_;
+
+    memcpy(&samples_[index * frame_size_], samples, n_samples * sizeof(sample_t));
+    sizes_[index] = n_samples;
+
+    // publish the frame only after it's filled
+    ++write_pos_;
+
+    return true;
+}
+
+sample_t* FrameRing::front(size_t& n_samples) {
+    roc_panic_if(!valid_);
+
+    if (empty()) {
+        return NULL;
+    }
+
+    const size_t index = size_t((long)read_pos_) % num_frames_;
+
+    n_samples = sizes_[index];
+    return &samples_[index * frame_size_];
+}
+
+void FrameRing::pop() {
+    roc_panic_if(!valid_);
+
+    if (empty()) {
+        roc_panic("frame ring: attempting to pop from empty ring");
+    }
+
+    // release the frame only after it's consumed
+    ++read_pos_;
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/frame_ring.h
+//! @brief Lock-free frame ring.
+
+#ifndef ROC_AUDIO_FRAME_RING_H_
+#define ROC_AUDIO_FRAME_RING_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/array.h"
+#include "roc_core/atomic.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Lock-free frame ring.
+//! @remarks
+//!  Fixed-size queue of sample buffers, each holding up to frame_size()
+//!  samples. Memory is allocated once in constructor. Safe to use from one
+//!  writer thread and one reader thread concurrently without locks.
+class FrameRing : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p num_frames defines maximum number of frames in ring
+    //!  - @p frame_size defines maximum number of samples in frame
+    FrameRing(core::IAllocator& allocator, size_t num_frames, size_t frame_size);
+
+    //! Check if the object was successfully constructed.
+    bool valid() const;
+
+    //! Get maximum number of samples in frame.
+    size_t frame_size() const;
+
+    //! Get number of frames in ring.
+    size_t size() const;
+
+    //! Check if ring is empty.
+    bool empty() const;
+
+    //! Check if ring is full.
+    bool full() const;
+
+    //! Copy samples to the end of ring.
+    //! @remarks
+    //!  Should be called only by writer thread.
+    //!  @p n_samples should not exceed frame_size().
+    //! @returns
+    //!  false if ring is full.
+    bool push(const sample_t* samples, size_t n_samples);
+
+    //! Get frame from the beginning of ring.
+    //! @remarks
+    //!  Should be called only by reader thread. The frame is valid until pop().
+    //! @returns
+    //!  pointer to samples and sets @p n_samples to their number, or NULL if
+    //!  ring is empty.
+    sample_t* front(size_t& n_samples);
+
+    //! Remove frame from the beginning of ring.
+    //! @remarks
+    //!  Should be called only by reader thread.
+    void pop();
+
+private:
+    const size_t num_frames_;
+    const size_t frame_size_;
+
+    core::Array<sample_t> samples_;
+    core::Array<size_t> sizes_;
+
+    core::Atomic write_pos_;
+    core::Atomic read_pos_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_FRAME_RING_H_
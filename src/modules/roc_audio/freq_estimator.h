@@ -35,11 +35,17 @@ public:
     //! Compute new value of frequency coefficient.
     void update(packet::timestamp_t current_latency);
 
+    //! Change target latency.
+    //! @remarks
+    //!  The controller starts steering towards the new target on the next update.
+    //!  Large jumps cause large error, so the target should be changed gradually.
+    void set_target_latency(packet::timestamp_t target_latency);
+
 private:
     bool run_decimators_(packet::timestamp_t current, float& filtered);
     float run_controller_(float current);
 
-    const float target_; // Target latency.
+    float target_; // Target latency.
 
     float dec1_casc_buff_[fe_decim_len];
     size_t dec1_ind_;
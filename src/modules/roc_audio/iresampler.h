@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/iresampler.h
+//! @brief Audio resampler interface.
+
+#ifndef ROC_AUDIO_IRESAMPLER_H_
+#define ROC_AUDIO_IRESAMPLER_H_
+
+#include "roc_audio/frame.h"
+#include "roc_audio/units.h"
+#include "roc_core/slice.h"
+
+namespace roc {
+namespace audio {
+
+//! Audio resampler interface.
+//! @remarks
+//!  Resampler consumes input stream as a FIFO of three frames of the same size,
+//!  previous, current, and next, and produces output samples which time position
+//!  lies inside the current frame.
+class IResampler {
+public:
+    virtual ~IResampler();
+
+    //! Check if object is successfully constructed.
+    virtual bool valid() const = 0;
+
+    //! Set new resample factor.
+    //! @returns
+    //!  false if the factor is not supported by resampler.
+    virtual bool set_scaling(float) = 0;
+
+    //! Resamples the whole output frame.
+    //! @remarks
+    //!  If @p out has Frame::FlagBlank, the caller guarantees that all three
+    //!  input frames are filled with zeros. In this case the resampler only
+    //!  advances its position and fills the output with zeros.
+    //! @returns
+    //!  false if the current input frame was exhausted before the output frame
+    //!  was filled; in this case the caller should call renew_buffers() and
+    //!  resample_buff() again with the same output frame.
+    virtual bool resample_buff(Frame& out) = 0;
+
+    //! Push new buffer on the front of the internal FIFO, which comprises three frames.
+    virtual void renew_buffers(core::Slice<sample_t>& prev,
+                               core::Slice<sample_t>& cur,
+                               core::Slice<sample_t>& next) = 0;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_IRESAMPLER_H_
@@ -9,6 +9,7 @@
 #include "roc_audio/latency_monitor.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
 
 namespace roc {
 namespace audio {
@@ -22,15 +23,28 @@ const core::nanoseconds_t LogInterval = 5 * core::Second;
 LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
                                const Depacketizer& depacketizer,
                                ResamplerReader* resampler,
+                               TimeStretchReader* stretcher,
                                const LatencyMonitorConfig& config,
                                core::nanoseconds_t target_latency,
+                               core::nanoseconds_t start_latency,
                                size_t input_sample_rate,
-                               size_t output_sample_rate)
+                               size_t output_sample_rate,
+                               core::IAllocator& allocator)
     : queue_(queue)
     , depacketizer_(depacketizer)
     , resampler_(resampler)
-    , fe_((packet::timestamp_t)packet::timestamp_from_ns(target_latency,
-                                                         input_sample_rate))
+    , stretcher_(stretcher)
+    , fe_((packet::timestamp_t)packet::timestamp_from_ns(
+          start_latency > 0 && start_latency < target_latency ? start_latency
+                                                              : target_latency,
+          input_sample_rate))
+    , lsq_receiver_time_(0)
+    , lsq_sender_time_(0)
+    , lsq_last_tail_(0)
+    , lsq_arrival_origin_(0)
+    , lsq_sample_rate_(0)
+    , lsq_use_arrival_(false)
+    , lsq_started_(false)
     , rate_limiter_(LogInterval)
     , update_interval_((packet::timestamp_t)packet::timestamp_from_ns(
           config.fe_update_interval, input_sample_rate))
@@ -38,9 +52,16 @@ LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
     , has_update_pos_(false)
     , target_latency_((packet::timestamp_t)packet::timestamp_from_ns(target_latency,
                                                                      input_sample_rate))
+    , base_target_latency_(target_latency_)
+    , current_target_(0)
     , min_latency_(packet::timestamp_from_ns(config.min_latency, input_sample_rate))
     , max_latency_(packet::timestamp_from_ns(config.max_latency, input_sample_rate))
     , max_scaling_delta_(config.max_scaling_delta)
+    , stretch_threshold_(
+          packet::timestamp_from_ns(config.stretch_threshold, input_sample_rate))
+    , max_stretch_delta_(config.max_stretch_delta)
+    , stretching_(false)
+    , max_target_step_(max_scaling_delta_ / 2 * update_interval_)
     , sample_rate_coeff_(0.f)
     , valid_(false) {
     roc_log(LogDebug,
@@ -63,11 +84,46 @@ LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
         return;
     }
 
+    if (stretcher_) {
+        if (stretch_threshold_ <= 0 || max_stretch_delta_ <= 0) {
+            roc_log(LogError,
+                    "latency monitor: invalid config: stretch_threshold=%ld"
+                    " max_stretch_delta=%.5f",
+                    (long)config.stretch_threshold, (double)max_stretch_delta_);
+            return;
+        }
+    }
+
+    const bool fast_start = start_latency > 0 && start_latency < target_latency;
+
+    current_target_ = (float)(packet::timestamp_t)packet::timestamp_from_ns(
+        fast_start ? start_latency : target_latency, input_sample_rate);
+
     if (resampler_) {
         if (!init_resampler_(input_sample_rate, output_sample_rate)) {
             return;
         }
+        if (config.fe_engine == FreqEstimatorEngine_LeastSquares) {
+            if (!init_lsq_fe_(config, input_sample_rate, allocator)) {
+                return;
+            }
+        }
+        if (config.adaptive_latency) {
+            if (!init_tuner_(config, input_sample_rate, allocator)) {
+                return;
+            }
+        }
     } else {
+        if (config.adaptive_latency) {
+            roc_log(LogError,
+                    "latency monitor: adaptive latency requires resampling to be enabled");
+            return;
+        }
+        if (fast_start) {
+            roc_log(LogError,
+                    "latency monitor: fast start requires resampling to be enabled");
+            return;
+        }
         if (input_sample_rate != output_sample_rate) {
             roc_log(LogError,
                     "latency monitor: input and output sample rates must be equal"
@@ -84,6 +140,10 @@ bool LatencyMonitor::valid() const {
     return valid_;
 }
 
+packet::timestamp_t LatencyMonitor::target_latency() const {
+    return (packet::timestamp_t)(current_target_ + 0.5f);
+}
+
 bool LatencyMonitor::update(packet::timestamp_t pos) {
     packet::timestamp_diff_t latency = 0;
 
@@ -95,6 +155,12 @@ bool LatencyMonitor::update(packet::timestamp_t pos) {
         return false;
     }
 
+    if (stretcher_) {
+        if (!update_stretcher_(latency)) {
+            return false;
+        }
+    }
+
     if (resampler_) {
         if (latency < 0) {
             latency = 0;
@@ -134,9 +200,17 @@ bool LatencyMonitor::check_latency_(packet::timestamp_diff_t latency) const {
         return false;
     }
 
-    if (latency > max_latency_) {
+    // when adaptive latency raises the target, jitter above the new target
+    // should not terminate the session, so the bound is raised too
+    packet::timestamp_diff_t max_latency = max_latency_;
+    if (target_latency() > base_target_latency_) {
+        max_latency +=
+            (packet::timestamp_diff_t)(target_latency() - base_target_latency_);
+    }
+
+    if (latency > max_latency) {
         roc_log(LogDebug, "latency monitor: latency out of bounds: latency=%ld max=%ld",
-                (long)latency, (long)max_latency_);
+                (long)latency, (long)max_latency);
         return false;
     }
 
@@ -177,6 +251,74 @@ bool LatencyMonitor::init_resampler_(size_t input_sample_rate,
     return true;
 }
 
+bool LatencyMonitor::init_lsq_fe_(const LatencyMonitorConfig& config,
+                                  size_t input_sample_rate,
+                                  core::IAllocator& allocator) {
+    if (config.fe_window <= config.fe_update_interval) {
+        roc_log(LogError,
+                "latency monitor: invalid config: fe_window=%ld fe_update_interval=%ld",
+                (long)config.fe_window, (long)config.fe_update_interval);
+        return false;
+    }
+
+    const packet::timestamp_t window = (packet::timestamp_t)packet::timestamp_from_ns(
+        config.fe_window, input_sample_rate);
+
+    lsq_sample_rate_ = (double)input_sample_rate;
+
+    lsq_fe_.reset(new (allocator) LsqFreqEstimator(
+                      (packet::timestamp_t)(current_target_ + 0.5f), update_interval_,
+                      window),
+                  allocator);
+    if (!lsq_fe_) {
+        return false;
+    }
+
+    return true;
+}
+
+bool LatencyMonitor::init_tuner_(const LatencyMonitorConfig& config,
+                                 size_t input_sample_rate,
+                                 core::IAllocator& allocator) {
+    if (config.min_target_latency <= 0
+        || config.min_target_latency > config.max_target_latency
+        || config.max_target_latency > config.max_latency
+        || config.jitter_window < config.fe_update_interval) {
+        roc_log(LogError,
+                "latency monitor: invalid config: min_target_latency=%ld"
+                " max_target_latency=%ld max_latency=%ld jitter_window=%ld",
+                (long)config.min_target_latency, (long)config.max_target_latency,
+                (long)config.max_latency, (long)config.jitter_window);
+        return false;
+    }
+
+    const packet::timestamp_t min_target = (packet::timestamp_t)packet::timestamp_from_ns(
+        config.min_target_latency, input_sample_rate);
+    const packet::timestamp_t max_target = (packet::timestamp_t)packet::timestamp_from_ns(
+        config.max_target_latency, input_sample_rate);
+
+    if (target_latency_ < min_target || target_latency_ > max_target) {
+        roc_log(LogError,
+                "latency monitor: invalid config: target latency out of adaptive range:"
+                " target_latency=%lu min_target_latency=%lu max_target_latency=%lu",
+                (unsigned long)target_latency_, (unsigned long)min_target,
+                (unsigned long)max_target);
+        return false;
+    }
+
+    const size_t window = (size_t)(config.jitter_window / config.fe_update_interval);
+
+    tuner_.reset(new (allocator)
+                     LatencyTuner(target_latency_, min_target, max_target, window,
+                                  max_target_step_),
+                 allocator);
+    if (!tuner_) {
+        return false;
+    }
+
+    return true;
+}
+
 bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
                                        packet::timestamp_t latency) {
     if (!has_update_pos_) {
@@ -185,11 +327,24 @@ bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
     }
 
     while (pos >= update_pos_) {
-        fe_.update(latency);
+        if (tuner_) {
+            tuner_->update((packet::timestamp_diff_t)latency,
+                           depacketizer_.dropped_packets());
+            target_latency_ = tuner_->target_latency();
+        }
+        update_target_();
+        if (lsq_fe_) {
+            // fit doesn't depend on playback speed, so it's never frozen
+            update_lsq_fe_(latency);
+        } else if (!stretching_) {
+            // while stretcher corrects latency, freeze estimator, so that it
+            // doesn't accumulate the error that stretcher is already handling
+            fe_.update(latency);
+        }
         update_pos_ += update_interval_;
     }
 
-    const float freq_coeff = fe_.freq_coeff();
+    const float freq_coeff = lsq_fe_ ? lsq_fe_->freq_coeff() : fe_.freq_coeff();
     const float trimmed_coeff = trim_scaling_(freq_coeff);
     const float adjusted_coeff = sample_rate_coeff_ * trimmed_coeff;
 
@@ -197,7 +352,7 @@ bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
         roc_log(
             LogDebug,
             "latency monitor: latency=%lu target=%lu fe=%.5f trim_fe=%.5f adj_fe=%.5f",
-            (unsigned long)latency, (unsigned long)target_latency_, (double)freq_coeff,
+            (unsigned long)latency, (unsigned long)target_latency(), (double)freq_coeff,
             (double)trimmed_coeff, (double)adjusted_coeff);
     }
 
@@ -211,6 +366,96 @@ bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
     return true;
 }
 
+void LatencyMonitor::update_target_() {
+    const float target = (float)target_latency_;
+
+    if (current_target_ < target) {
+        current_target_ = std::min(current_target_ + max_target_step_, target);
+    } else if (current_target_ > target) {
+        current_target_ = std::max(current_target_ - max_target_step_, target);
+    } else {
+        return;
+    }
+
+    fe_.set_target_latency((packet::timestamp_t)(current_target_ + 0.5f));
+
+    if (lsq_fe_) {
+        lsq_fe_->set_target_latency((packet::timestamp_t)(current_target_ + 0.5f));
+    }
+}
+
+void LatencyMonitor::update_lsq_fe_(packet::timestamp_t latency) {
+    const packet::PacketPtr latest = queue_.latest();
+    const packet::timestamp_t tail = latest->end();
+
+    const core::nanoseconds_t arrival =
+        latest->udp() ? latest->udp()->receive_timestamp : 0;
+
+    if (!lsq_started_) {
+        // Packets received from network carry their arrival time, which is
+        // not quantized by update ticks and packet size. It's measured by the
+        // system clock instead of the output clock, and the difference
+        // between the two is left to the latency correction.
+        lsq_use_arrival_ = arrival != 0;
+        lsq_arrival_origin_ = arrival;
+    } else {
+        // Sender time is unwrapped from the latest packet timestamp.
+        lsq_sender_time_ += (double)packet::timestamp_diff(tail, lsq_last_tail_);
+        if (!lsq_use_arrival_) {
+            // Every update corresponds to update_interval_ samples of the
+            // receiver clock.
+            lsq_receiver_time_ += (double)update_interval_ * (double)sample_rate_coeff_;
+        }
+    }
+    lsq_last_tail_ = tail;
+    lsq_started_ = true;
+
+    if (lsq_use_arrival_) {
+        // packets restored by FEC were not received and have no arrival time
+        if (arrival != 0) {
+            lsq_fe_->add_arrival((double)(arrival - lsq_arrival_origin_)
+                                     * lsq_sample_rate_ / (double)core::Second,
+                                 lsq_sender_time_);
+        }
+    } else {
+        lsq_fe_->add_sample(lsq_receiver_time_, lsq_sender_time_);
+    }
+
+    lsq_fe_->update(latency);
+}
+
+bool LatencyMonitor::update_stretcher_(packet::timestamp_diff_t latency) {
+    const packet::timestamp_diff_t deviation =
+        latency - (packet::timestamp_diff_t)target_latency();
+
+    const packet::timestamp_diff_t abs_deviation = deviation < 0 ? -deviation : deviation;
+
+    if (!stretching_ && abs_deviation > stretch_threshold_) {
+        roc_log(LogDebug,
+                "latency monitor: starting time stretching: latency=%ld target=%lu",
+                (long)latency, (unsigned long)target_latency());
+        stretching_ = true;
+    } else if (stretching_ && abs_deviation < stretch_threshold_ / 2) {
+        roc_log(LogDebug,
+                "latency monitor: stopping time stretching: latency=%ld target=%lu",
+                (long)latency, (unsigned long)target_latency());
+        stretching_ = false;
+    }
+
+    float scaling = 1.0f;
+    if (stretching_) {
+        scaling = deviation > 0 ? 1.0f + max_stretch_delta_ : 1.0f - max_stretch_delta_;
+    }
+
+    if (!stretcher_->set_scaling(scaling)) {
+        roc_log(LogDebug, "latency monitor: stretch factor out of bounds: scaling=%.5f",
+                (double)scaling);
+        return false;
+    }
+
+    return true;
+}
+
 void LatencyMonitor::report_latency_(packet::timestamp_t latency) {
     if (rate_limiter_.allow()) {
         roc_log(LogDebug, "latency monitor: latency=%lu target=%lu",
@@ -14,28 +14,53 @@
 
 #include "roc_audio/depacketizer.h"
 #include "roc_audio/freq_estimator.h"
+#include "roc_audio/latency_tuner.h"
+#include "roc_audio/lsq_freq_estimator.h"
 #include "roc_audio/resampler_reader.h"
+#include "roc_audio/time_stretch_reader.h"
+#include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/rate_limiter.h"
 #include "roc_core/time.h"
+#include "roc_core/unique_ptr.h"
 #include "roc_packet/sorted_queue.h"
 #include "roc_packet/units.h"
 
 namespace roc {
 namespace audio {
 
+//! Frequency estimator algorithms.
+enum FreqEstimatorEngine {
+    //! PI controller driven by latency, see FreqEstimator.
+    FreqEstimatorEngine_PI,
+
+    //! Least squares fit of sender timestamps, see LsqFreqEstimator.
+    FreqEstimatorEngine_LeastSquares
+};
+
 //! Parameters for latency monitor.
 struct LatencyMonitorConfig {
     //! FreqEstimator update interval, nanoseconds.
     //! How often to run FreqEstimator and update Resampler scaling.
     core::nanoseconds_t fe_update_interval;
 
+    //! Frequency estimator algorithm.
+    FreqEstimatorEngine fe_engine;
+
+    //! Least squares estimator window, nanoseconds.
+    //! Older measurements are forgotten exponentially with this time constant.
+    //! Longer window gives more accurate estimate, shorter window follows
+    //! clock changes faster.
+    core::nanoseconds_t fe_window;
+
     //! Minimum allowed latency, nanoseconds.
     //! If the latency goes out of bounds, the session is terminated.
     core::nanoseconds_t min_latency;
 
     //! Maximum allowed latency, nanoseconds.
     //! If the latency goes out of bounds, the session is terminated.
+    //! With adaptive latency, when the target latency is raised above its
+    //! initial value, this bound is raised by the same amount.
     core::nanoseconds_t max_latency;
 
     //! Maximum allowed freq_coeff delta around one.
@@ -43,11 +68,45 @@ struct LatencyMonitorConfig {
     //! For example, 0.01 allows freq_coeff values in range [0.99; 1.01].
     float max_scaling_delta;
 
+    //! Adjust target latency to the measured network jitter.
+    //! If enabled, the target latency is moved within the
+    //! [min_target_latency; max_target_latency] range. Requires resampler.
+    bool adaptive_latency;
+
+    //! Minimum adaptive target latency, nanoseconds.
+    core::nanoseconds_t min_target_latency;
+
+    //! Maximum adaptive target latency, nanoseconds.
+    //! Should not exceed max_latency.
+    core::nanoseconds_t max_target_latency;
+
+    //! Window for measuring network jitter, nanoseconds.
+    core::nanoseconds_t jitter_window;
+
+    //! Latency deviation that enables time stretching, nanoseconds.
+    //! If the latency differs from the target by more than this value, the
+    //! time stretcher is used to quickly bring it back. Once the deviation
+    //! drops below half of this value, the stretcher is disabled and the
+    //! resampler continues fine tuning.
+    core::nanoseconds_t stretch_threshold;
+
+    //! Maximum time stretch factor delta around one.
+    //! For example, 0.1 allows stretch factor values in range [0.9; 1.1].
+    float max_stretch_delta;
+
     LatencyMonitorConfig()
         : fe_update_interval(5 * core::Millisecond)
+        , fe_engine(FreqEstimatorEngine_PI)
+        , fe_window(30 * core::Second)
         , min_latency(0)
         , max_latency(0)
-        , max_scaling_delta(0.005f) {
+        , max_scaling_delta(0.005f)
+        , adaptive_latency(false)
+        , min_target_latency(0)
+        , max_target_latency(0)
+        , jitter_window(2 * core::Second)
+        , stretch_threshold(100 * core::Millisecond)
+        , max_stretch_delta(0.1f) {
     }
 };
 
@@ -56,6 +115,9 @@ struct LatencyMonitorConfig {
 //!  - calculates session scaling factor
 //!  - trims scaling factor to the allowed range
 //!  - updates resampler scaling
+//!  - adjusts target latency to the network jitter, if enabled
+//!  - grows latency to the target after fast start, if enabled
+//!  - time stretches the stream when latency is far from the target, if enabled
 //!  - shutdowns session if the latency goes out of bounds
 class LatencyMonitor : public core::NonCopyable<> {
 public:
@@ -64,17 +126,32 @@ public:
     //! @b Parameters
     //!  - @p queue and @p depacketizer are used to calculate the latency
     //!  - @p resampler is used to set the scaling factor, may be null
+    //!  - @p stretcher is used to quickly correct large deviations, may be null
     //!  - @p config defines various miscellaneous parameters
-    //!  - @p target_latency defines FreqEstimator target latency, in samples
+    //!  - @p target_latency defines FreqEstimator target latency, in nanoseconds;
+    //!    with adaptive latency, it is only the initial value
+    //!  - @p start_latency defines the latency at which playback was started, in
+    //!    nanoseconds; if it is non-zero and less than @p target_latency, the
+    //!    latency is gradually grown from @p start_latency to @p target_latency
+    //!  - @p allocator is used to allocate latency tuner
     //!  - @p input_sample_rate is the sample rate of the input packets
     //!  - @p output_sample_rate is the sample rate of the output frames
     LatencyMonitor(const packet::SortedQueue& queue,
                    const Depacketizer& depacketizer,
                    ResamplerReader* resampler,
+                   TimeStretchReader* stretcher,
                    const LatencyMonitorConfig& config,
                    core::nanoseconds_t target_latency,
+                   core::nanoseconds_t start_latency,
                    size_t input_sample_rate,
-                   size_t output_sample_rate);
+                   size_t output_sample_rate,
+                   core::IAllocator& allocator);
+
+    //! Get current target latency, in samples.
+    //! @remarks
+    //!  Differs from the configured target latency while the latency is being
+    //!  grown after fast start or adjusted by adaptive latency.
+    packet::timestamp_t target_latency() const;
 
     //! Check if the object was initialized successfully.
     bool valid() const;
@@ -91,14 +168,35 @@ private:
     float trim_scaling_(float scaling) const;
 
     bool init_resampler_(size_t input_sample_rate, size_t output_sample_rate);
+    bool init_lsq_fe_(const LatencyMonitorConfig& config,
+                      size_t input_sample_rate,
+                      core::IAllocator& allocator);
+    bool init_tuner_(const LatencyMonitorConfig& config,
+                     size_t input_sample_rate,
+                     core::IAllocator& allocator);
     bool update_resampler_(packet::timestamp_t time, packet::timestamp_t latency);
 
+    void update_target_();
+    void update_lsq_fe_(packet::timestamp_t latency);
+
+    bool update_stretcher_(packet::timestamp_diff_t latency);
+
     void report_latency_(packet::timestamp_t latency);
 
     const packet::SortedQueue& queue_;
     const Depacketizer& depacketizer_;
     ResamplerReader* resampler_;
+    TimeStretchReader* stretcher_;
     FreqEstimator fe_;
+    core::UniquePtr<LsqFreqEstimator> lsq_fe_;
+    double lsq_receiver_time_;
+    double lsq_sender_time_;
+    packet::timestamp_t lsq_last_tail_;
+    core::nanoseconds_t lsq_arrival_origin_;
+    double lsq_sample_rate_;
+    bool lsq_use_arrival_;
+    bool lsq_started_;
+    core::UniquePtr<LatencyTuner> tuner_;
 
     core::RateLimiter rate_limiter_;
 
@@ -106,11 +204,20 @@ private:
     packet::timestamp_t update_pos_;
     bool has_update_pos_;
 
-    const packet::timestamp_t target_latency_;
+    packet::timestamp_t target_latency_;
+    const packet::timestamp_t base_target_latency_;
+    float current_target_;
     const packet::timestamp_diff_t min_latency_;
     const packet::timestamp_diff_t max_latency_;
 
     const float max_scaling_delta_;
+
+    const packet::timestamp_diff_t stretch_threshold_;
+    const float max_stretch_delta_;
+    bool stretching_;
+    // Target is moved at half of the maximum drift rate, so that
+    // FreqEstimator can keep up with it without hitting the scaling limits.
+    const float max_target_step_;
     float sample_rate_coeff_;
 
     bool valid_;
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/latency_tuner.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Target latency relative to measured peak-to-peak latency variation.
+const float JitterMargin = 2.0f;
+
+// How fast jitter estimate follows decreasing variation.
+// Increasing variation is followed immediately.
+const float JitterDecay = 0.25f;
+
+// How much jitter estimate is increased when late packets are dropped.
+const float DropsFactor = 1.5f;
+
+} // namespace
+
+LatencyTuner::LatencyTuner(packet::timestamp_t target_latency,
+                           packet::timestamp_t min_target_latency,
+                           packet::timestamp_t max_target_latency,
+                           size_t window,
+                           float max_step)
+    : min_target_((float)min_target_latency)
+    , max_target_((float)max_target_latency)
+    , window_(window)
+    , max_step_(max_step)
+    , target_((float)target_latency)
+    , desired_target_((float)target_latency)
+    , jitter_((float)target_latency / JitterMargin)
+    , window_pos_(0)
+    , window_min_(0)
+    , window_max_(0)
+    , dropped_packets_(0)
+    , has_drops_(false) {
+    if (min_target_latency > target_latency || target_latency > max_target_latency) {
+        roc_panic("latency tuner: target latency out of bounds: target=%lu min=%lu "
+                  "max=%lu",
+                  (unsigned long)target_latency, (unsigned long)min_target_latency,
+                  (unsigned long)max_target_latency);
+    }
+    if (window == 0) {
+        roc_panic("latency tuner: window should be non-zero");
+    }
+}
+
+packet::timestamp_t LatencyTuner::target_latency() const {
+    return (packet::timestamp_t)(target_ + 0.5f);
+}
+
+packet::timestamp_t LatencyTuner::jitter() const {
+    return (packet::timestamp_t)(jitter_ + 0.5f);
+}
+
+void LatencyTuner::update(packet::timestamp_diff_t latency, size_t dropped_packets) {
+    if (dropped_packets != dropped_packets_) {
+        dropped_packets_ = dropped_packets;
+        has_drops_ = true;
+    }
+
+    update_window_(latency);
+    move_target_();
+}
+
+void LatencyTuner::update_window_(packet::timestamp_diff_t latency) {
+    if (window_pos_ == 0 || latency < window_min_) {
+        window_min_ = latency;
+    }
+    if (window_pos_ == 0 || latency > window_max_) {
+        window_max_ = latency;
+    }
+
+    if (++window_pos_ < window_) {
+        return;
+    }
+
+    update_jitter_(has_drops_);
+
+    window_pos_ = 0;
+    has_drops_ = false;
+}
+
+void LatencyTuner::update_jitter_(bool has_drops) {
+    const float swing = (float)(window_max_ - window_min_);
+
+    if (swing > jitter_) {
+        jitter_ = swing;
+    } else {
+        jitter_ += (swing - jitter_) * JitterDecay;
+    }
+
+    if (has_drops) {
+        jitter_ = std::max(jitter_, target_ / JitterMargin) * DropsFactor;
+    }
+
+    desired_target_ = std::min(std::max(jitter_ * JitterMargin, min_target_), max_target_);
+
+    roc_log(LogDebug,
+            "latency tuner: swing=%lu jitter=%lu drops=%d target=%lu desired_target=%lu",
+            (unsigned long)swing, (unsigned long)jitter_, (int)has_drops,
+            (unsigned long)target_, (unsigned long)desired_target_);
+}
+
+void LatencyTuner::move_target_() {
+    if (target_ < desired_target_) {
+        target_ = std::min(target_ + max_step_, desired_target_);
+    } else if (target_ > desired_target_) {
+        target_ = std::max(target_ - max_step_, desired_target_);
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/latency_tuner.h
+//! @brief Latency tuner.
+
+#ifndef ROC_AUDIO_LATENCY_TUNER_H_
+#define ROC_AUDIO_LATENCY_TUNER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace audio {
+
+//! Adaptive target latency.
+//!
+//! Estimates network jitter from the latency variation observed during a
+//! window and chooses a target latency large enough to absorb it. Late
+//! packets dropped by the depacketizer mean the target is too small and
+//! push it up immediately.
+//!
+//! The target is moved towards the chosen value by a bounded step on every
+//! update, so that FreqEstimator can follow it by slightly changing playback
+//! speed instead of dropping or inserting samples.
+class LatencyTuner : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p target_latency is the initial target latency
+    //!  - @p min_target_latency and @p max_target_latency define the range
+    //!    in which the target latency may be moved
+    //!  - @p window defines how many updates are used to measure jitter
+    //!  - @p max_step defines how much the target may change per update
+    //!
+    //! All latencies are in samples.
+    LatencyTuner(packet::timestamp_t target_latency,
+                 packet::timestamp_t min_target_latency,
+                 packet::timestamp_t max_target_latency,
+                 size_t window,
+                 float max_step);
+
+    //! Get current target latency.
+    packet::timestamp_t target_latency() const;
+
+    //! Get current jitter estimate.
+    packet::timestamp_t jitter() const;
+
+    //! Update target latency.
+    //!
+    //! @b Parameters
+    //!  - @p latency is the current session latency
+    //!  - @p dropped_packets is the total number of late packets dropped so far
+    void update(packet::timestamp_diff_t latency, size_t dropped_packets);
+
+private:
+    void update_window_(packet::timestamp_diff_t latency);
+    void update_jitter_(bool has_drops);
+    void move_target_();
+
+    const float min_target_;
+    const float max_target_;
+
+    const size_t window_;
+    const float max_step_;
+
+    float target_;
+    float desired_target_;
+    float jitter_;
+
+    size_t window_pos_;
+    packet::timestamp_diff_t window_min_;
+    packet::timestamp_diff_t window_max_;
+
+    size_t dropped_packets_;
+    bool has_drops_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_LATENCY_TUNER_H_
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/lsq_freq_estimator.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Number of samples needed before the fit is trusted.
+const double MinSamples = 16;
+
+// Number of buckets needed before the fit is trusted.
+const double MinBuckets = 4;
+
+// Size of the bucket relative to the window.
+const double BucketFraction = 1.0 / 120;
+
+// Latency is averaged over this fraction of the window to hide the saw
+// caused by packet arrivals.
+const double LatencySmoothingFraction = 1.0 / 30;
+
+// Latency deviation is corrected within this fraction of the window.
+const double LatencyCorrectionFraction = 1.0 / 3;
+
+} // namespace
+
+LsqFreqEstimator::LsqFreqEstimator(packet::timestamp_t target_latency,
+                                   packet::timestamp_t update_interval,
+                                   packet::timestamp_t window)
+    : target_(target_latency)
+    , window_(window)
+    , bucket_size_(std::max((double)update_interval, (double)window * BucketFraction))
+    , latency_smoothing_(std::min(
+          1.0, (double)update_interval / ((double)window * LatencySmoothingFraction)))
+    , latency_gain_(1.0 / ((double)window * LatencyCorrectionFraction))
+    , has_bucket_(false)
+    , bucket_start_(0)
+    , bucket_x_(0)
+    , bucket_y_(0)
+    , bucket_delay_(0)
+    , has_point_(false)
+    , last_x_(0)
+    , last_y_(0)
+    , sum_w_(0)
+    , sum_x_(0)
+    , sum_y_(0)
+    , sum_xx_(0)
+    , sum_xy_(0)
+    , slope_(1)
+    , ratio_(1)
+    , latency_(target_latency)
+    , coeff_(1) {
+    if (update_interval == 0 || window <= update_interval) {
+        roc_panic("lsq freq estimator: invalid window: update_interval=%lu window=%lu",
+                  (unsigned long)update_interval, (unsigned long)window);
+    }
+}
+
+float LsqFreqEstimator::freq_coeff() const {
+    return coeff_;
+}
+
+double LsqFreqEstimator::freq_ratio() const {
+    return ratio_;
+}
+
+void LsqFreqEstimator::set_target_latency(packet::timestamp_t target_latency) {
+    target_ = target_latency;
+}
+
+void LsqFreqEstimator::add_sample(double receiver_time, double sender_time) {
+    update_fit_(receiver_time, sender_time, MinSamples);
+}
+
+void LsqFreqEstimator::add_arrival(double receiver_time, double sender_time) {
+    if (has_bucket_ && receiver_time - bucket_start_ >= bucket_size_) {
+        update_fit_(bucket_x_, bucket_y_, MinBuckets);
+        has_bucket_ = false;
+    }
+
+    // Delay up to a constant, which doesn't change within a bucket.
+    const double delay = receiver_time - sender_time / slope_;
+
+    if (!has_bucket_) {
+        has_bucket_ = true;
+        bucket_start_ = receiver_time;
+    } else if (delay >= bucket_delay_) {
+        return;
+    }
+
+    bucket_x_ = receiver_time;
+    bucket_y_ = sender_time;
+    bucket_delay_ = delay;
+}
+
+void LsqFreqEstimator::update(packet::timestamp_t latency) {
+    latency_ += ((double)latency - latency_) * latency_smoothing_;
+
+    coeff_ = (float)(ratio_ * (1 + (latency_ - target_) * latency_gain_));
+}
+
+void LsqFreqEstimator::update_fit_(double x, double y, double min_points) {
+    if (has_point_) {
+        // Move origin to the new point, so that sums stay small and
+        // don't lose precision as time goes.
+        const double dx = x - last_x_;
+        const double dy = y - last_y_;
+
+        sum_xy_ += -dy * sum_x_ - dx * sum_y_ + dx * dy * sum_w_;
+        sum_xx_ += -2 * dx * sum_x_ + dx * dx * sum_w_;
+        sum_x_ -= dx * sum_w_;
+        sum_y_ -= dy * sum_w_;
+
+        // Older points are forgotten as receiver time goes.
+        const double forgetting = std::min(1.0, std::max(0.0, 1.0 - dx / window_));
+
+        sum_w_ *= forgetting;
+        sum_x_ *= forgetting;
+        sum_y_ *= forgetting;
+        sum_xx_ *= forgetting;
+        sum_xy_ *= forgetting;
+    }
+
+    has_point_ = true;
+    last_x_ = x;
+    last_y_ = y;
+
+    // New point is at origin, so it adds only to weight.
+    sum_w_ += 1;
+
+    const double denom = sum_w_ * sum_xx_ - sum_x_ * sum_x_;
+    if (denom <= 0) {
+        return;
+    }
+
+    slope_ = (sum_w_ * sum_xy_ - sum_x_ * sum_y_) / denom;
+
+    if (sum_w_ >= min_points) {
+        ratio_ = slope_;
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/lsq_freq_estimator.h
+//! @brief Least squares frequency estimator.
+
+#ifndef ROC_AUDIO_LSQ_FREQ_ESTIMATOR_H_
+#define ROC_AUDIO_LSQ_FREQ_ESTIMATOR_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace audio {
+
+//! Evaluates sender's frequency to receivers's frequency ratio.
+//! @remarks
+//!  Unlike FreqEstimator, which steers latency using a PI controller and
+//!  finds the ratio only implicitly, this estimator measures the ratio
+//!  directly. It fits a line to pairs of receiver time and sender timestamp
+//!  of the latest received sample using weighted least squares with
+//!  exponential forgetting. The slope of the line is the frequency ratio.
+//!  Latency deviation from the target is then corrected by a small
+//!  proportional term on top of the measured ratio.
+//!
+//!  When arrival time of packets is known, the fit is not limited by packet
+//!  size and update interval. Network delay has a floor, and jitter only
+//!  adds to it, so arrivals are grouped into short buckets, and only the
+//!  one with the lowest delay in every bucket is fitted. This way the fit
+//!  follows the floor instead of jitter.
+class LsqFreqEstimator : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p target_latency defines latency we want to archive
+    //!  - @p update_interval defines how often update() is called
+    //!  - @p window defines the time constant of forgetting
+    //!
+    //! All values are in samples at the sender rate.
+    LsqFreqEstimator(packet::timestamp_t target_latency,
+                     packet::timestamp_t update_interval,
+                     packet::timestamp_t window);
+
+    //! Get current frequecy coefficient.
+    float freq_coeff() const;
+
+    //! Get measured sender to receiver frequency ratio.
+    double freq_ratio() const;
+
+    //! Change target latency.
+    void set_target_latency(packet::timestamp_t target_latency);
+
+    //! Add receiver time and timestamp of the latest received sample.
+    //!
+    //! @b Parameters
+    //!  - @p receiver_time is the current receiver time, in samples at the
+    //!    nominal sender rate, counted from any fixed point
+    //!  - @p sender_time is the timestamp of the latest received sample,
+    //!    counted from any fixed point
+    //!
+    //! Used when arrival time of packets is unknown. Every pair is fitted.
+    void add_sample(double receiver_time, double sender_time);
+
+    //! Add arrival time and timestamp of a received packet.
+    //!
+    //! @b Parameters
+    //!  - @p receiver_time is the time when the packet was received, in
+    //!    samples at the nominal sender rate, counted from any fixed point
+    //!  - @p sender_time is the timestamp of the packet, counted from any
+    //!    fixed point
+    //!
+    //! Only the pair with the lowest delay in every bucket is fitted.
+    void add_arrival(double receiver_time, double sender_time);
+
+    //! Compute new value of frequency coefficient.
+    //!
+    //! @b Parameters
+    //!  - @p latency is the current session latency
+    void update(packet::timestamp_t latency);
+
+private:
+    void update_fit_(double x, double y, double min_points);
+
+    double target_;
+
+    const double window_;
+    const double bucket_size_;
+    const double latency_smoothing_;
+    const double latency_gain_;
+
+    // Pair with the lowest delay in the current bucket.
+    bool has_bucket_;
+    double bucket_start_;
+    double bucket_x_;
+    double bucket_y_;
+    double bucket_delay_;
+
+    bool has_point_;
+    double last_x_;
+    double last_y_;
+
+    // Weighted sums relative to the last point.
+    double sum_w_;
+    double sum_x_;
+    double sum_y_;
+    double sum_xx_;
+    double sum_xy_;
+
+    // Slope of the fit, known before enough points are collected to report
+    // it as the ratio.
+    double slope_;
+    double ratio_;
+    double latency_;
+
+    float coeff_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_LSQ_FREQ_ESTIMATOR_H_
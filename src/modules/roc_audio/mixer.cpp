@@ -10,27 +10,22 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace audio {
 
-namespace {
-
-sample_t clamp(const sample_t x) {
-    if (x > SampleMax) {
-        return SampleMax;
-    } else if (x < SampleMin) {
-        return SampleMin;
-    } else {
-        return x;
-    }
-}
-
-} // namespace
-
-Mixer::Mixer(core::BufferPool<sample_t>& pool, size_t frame_size)
-    : valid_(false) {
-    roc_log(LogDebug, "mixer: initializing: frame_size=%lu", (unsigned long)frame_size);
+Mixer::Mixer(core::BufferPool<sample_t>& pool,
+             core::IAllocator& allocator,
+             size_t frame_size)
+    : pool_(pool)
+    , allocator_(allocator)
+    , inputs_(allocator)
+    , worker_pool_(NULL)
+    , kernel_funcs_(mixer_kernel_funcs(MixerKernel_Auto))
+    , valid_(false) {
+    roc_log(LogDebug, "mixer: initializing: frame_size=%lu kernel=%s",
+            (unsigned long)frame_size, mixer_kernel_to_str(mixer_kernel_best()));
 
     temp_buf_ = new (pool) core::Buffer<sample_t>(pool);
     if (!temp_buf_) {
@@ -47,27 +42,101 @@ Mixer::Mixer(core::BufferPool<sample_t>& pool, size_t frame_size)
     valid_ = true;
 }
 
+Mixer::~Mixer() {
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        allocator_.destroy(*inputs_[n]);
+    }
+}
+
 bool Mixer::valid() const {
     return valid_;
 }
 
-void Mixer::add(IReader& reader) {
+void Mixer::set_worker_pool(core::WorkerPool& pool) {
+    roc_panic_if(!valid_);
+
+    if (inputs_.size() != 0) {
+        roc_panic("mixer: worker pool should be set before first input");
+    }
+
+    worker_pool_ = &pool;
+}
+
+bool Mixer::add(IReader& reader) {
     roc_panic_if(!valid_);
 
-    readers_.push_back(reader);
+    if (find_(reader) != inputs_.size()) {
+        roc_panic("mixer: reader is already added");
+    }
+
+    if (inputs_.size() == inputs_.max_size()) {
+        if (!inputs_.grow(inputs_.max_size() == 0 ? 4 : inputs_.max_size() * 2)) {
+            roc_log(LogError, "mixer: can't allocate input: num_inputs=%lu",
+                    (unsigned long)inputs_.size());
+            return false;
+        }
+    }
+
+    Input* input = new (allocator_) Input(reader);
+    if (!input) {
+        roc_log(LogError, "mixer: can't allocate input: num_inputs=%lu",
+                (unsigned long)inputs_.size());
+        return false;
+    }
+
+    if (worker_pool_) {
+        input->buf = new (pool_) core::Buffer<sample_t>(pool_);
+        if (!input->buf || input->buf.capacity() < temp_buf_.size()) {
+            roc_log(LogError, "mixer: can't allocate input buffer");
+            allocator_.destroy(*input);
+            return false;
+        }
+        input->buf.resize(temp_buf_.size());
+    }
+
+    inputs_.push_back(input);
+
+    return true;
 }
 
 void Mixer::remove(IReader& reader) {
     roc_panic_if(!valid_);
 
-    readers_.remove(reader);
+    const size_t pos = find_(reader);
+    if (pos == inputs_.size()) {
+        roc_panic("mixer: reader is not added");
+    }
+
+    Input* input = inputs_[pos];
+
+    for (size_t n = pos + 1; n < inputs_.size(); n++) {
+        inputs_[n - 1] = inputs_[n];
+    }
+
+    if (!inputs_.resize(inputs_.size() - 1)) {
+        roc_panic("mixer: can't shrink inputs");
+    }
+
+    allocator_.destroy(*input);
+}
+
+void Mixer::set_gain(IReader& reader, float gain) {
+    roc_panic_if(!valid_);
+
+    const size_t pos = find_(reader);
+    if (pos == inputs_.size()) {
+        roc_panic("mixer: reader is not added");
+    }
+
+    inputs_[pos]->gain = gain;
+    inputs_[pos]->unit_gain = std::fabs(gain - 1.0f) < 1e-6f;
 }
 
 void Mixer::read(Frame& frame) {
     roc_panic_if(!valid_);
 
-    if (readers_.size() == 1) {
-        readers_.front()->read(frame);
+    if (inputs_.size() == 1 && inputs_[0]->unit_gain) {
+        inputs_[0]->reader->read(frame);
         return;
     }
 
@@ -76,35 +145,108 @@ void Mixer::read(Frame& frame) {
     sample_t* samples = frame.data();
     size_t n_samples = frame.size();
 
+    bool blank = true;
+
     while (n_samples != 0) {
         size_t n_read = n_samples;
         if (n_read > max_read) {
             n_read = max_read;
         }
 
-        read_(samples, n_read);
+        if (worker_pool_ && inputs_.size() > 1) {
+            blank &= read_parallel_(samples, n_read);
+        } else {
+            blank &= read_(samples, n_read);
+        }
 
         samples += n_read;
         n_samples -= n_read;
     }
+
+    frame.set_flags(blank ? Frame::FlagBlank : 0);
 }
 
-void Mixer::read_(sample_t* data, size_t size) {
+bool Mixer::is_zero_(unsigned flags) {
+    return (flags & (Frame::FlagBlank | Frame::FlagBeep)) == Frame::FlagBlank;
+}
+
+bool Mixer::read_(sample_t* data, size_t size) {
     roc_panic_if(!data);
     roc_panic_if(size == 0);
 
     memset(data, 0, size * sizeof(sample_t));
 
-    for (IReader* rp = readers_.front(); rp; rp = readers_.nextof(*rp)) {
+    bool blank = true;
+
+    for (size_t n = 0; n < inputs_.size(); n++) {
         sample_t* temp_data = temp_buf_.data();
 
         Frame temp_frame(temp_data, size);
-        rp->read(temp_frame);
+        inputs_[n]->reader->read(temp_frame);
+
+        if (is_zero_(temp_frame.flags())) {
+            continue;
+        }
+
+        kernel_funcs_->add(data, temp_data, size, inputs_[n]->gain);
+        blank = false;
+    }
+
+    // Clamp only once, after all inputs are summed, so that an intermediate
+    // overflow can be compensated by the following inputs.
+    if (!blank) {
+        kernel_funcs_->clamp(data, size);
+    }
+
+    return blank;
+}
+
+bool Mixer::read_parallel_(sample_t* data, size_t size) {
+    roc_panic_if(!data);
+    roc_panic_if(size == 0);
+
+    const core::nanoseconds_t deadline = core::timestamp();
+
+    for (size_t n = 1; n < inputs_.size(); n++) {
+        inputs_[n]->size = size;
+        worker_pool_->schedule(*inputs_[n], deadline);
+    }
+
+    memset(data, 0, size * sizeof(sample_t));
+
+    // Keep one input for the calling thread, it would wait anyway.
+    inputs_[0]->size = size;
+    inputs_[0]->execute();
+
+    bool blank = true;
+
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        if (n != 0) {
+            worker_pool_->wait(*inputs_[n]);
+        }
+
+        if (is_zero_(inputs_[n]->flags)) {
+            continue;
+        }
+
+        kernel_funcs_->add(data, inputs_[n]->buf.data(), size, inputs_[n]->gain);
+        blank = false;
+    }
+
+    if (!blank) {
+        kernel_funcs_->clamp(data, size);
+    }
+
+    return blank;
+}
 
-        for (size_t n = 0; n < size; n++) {
-            data[n] = clamp(data[n] + temp_data[n]);
+size_t Mixer::find_(const IReader& reader) const {
+    for (size_t n = 0; n < inputs_.size(); n++) {
+        if (inputs_[n]->reader == &reader) {
+            return n;
         }
     }
+    return inputs_.size();
 }
 
 } // namespace audio
@@ -13,11 +13,15 @@
 #define ROC_AUDIO_MIXER_H_
 
 #include "roc_audio/ireader.h"
+#include "roc_audio/mixer_kernel.h"
 #include "roc_audio/units.h"
-#include "roc_core/list.h"
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/pool.h"
 #include "roc_core/slice.h"
+#include "roc_core/worker_pool.h"
+#include "roc_core/worker_task.h"
 
 namespace roc {
 namespace audio {
@@ -35,25 +39,62 @@ namespace audio {
 //! @code
 //!  5, 7, 9, ...
 //! @endcode
+//!
+//! Every input may have its own gain, which is applied while mixing. The sum is
+//! clamped once, after all inputs are added.
+//!
+//! Input frames with Frame::FlagBlank are skipped, unless they have Frame::FlagBeep.
+//! If all inputs are skipped, the output frame is filled with zeros and gets
+//! Frame::FlagBlank.
 class Mixer : public IReader, public core::NonCopyable<> {
 public:
     //! Initialize.
     //!
     //! @b Parameters
     //!  - @p pool is used to allocate a temporary buffer of samples
+    //!  - @p allocator is used to allocate the list of inputs
     //!  - @p frame_size defines the temporary buffer size used to read from
     //!    attached readers
-    explicit Mixer(core::BufferPool<sample_t>& pool, size_t frame_size);
+    Mixer(core::BufferPool<sample_t>& pool,
+          core::IAllocator& allocator,
+          size_t frame_size);
+
+    //! Destroy.
+    ~Mixer();
 
     //! Check if the mixer was succefully constructed.
     bool valid() const;
 
+    //! Read inputs in parallel using a worker pool.
+    //!
+    //! @remarks
+    //!  When enabled and there are several inputs, every input reads its frame
+    //!  into its own buffer in a worker thread, and read() waits for all of them.
+    //!  The first input is read in the calling thread. Frames are summed in the
+    //!  order in which inputs were added, so the result is exactly the same as
+    //!  without the pool.
+    //!
+    //! @pre
+    //!  Should be called before the first input is added. Input readers should
+    //!  not share state with each other.
+    void set_worker_pool(core::WorkerPool& pool);
+
     //! Add input reader.
-    void add(IReader&);
+    //! @remarks
+    //!  The reader is added with unit gain.
+    //! @returns
+    //!  false if allocation failed.
+    bool add(IReader&);
 
     //! Remove input reader.
     void remove(IReader&);
 
+    //! Set gain of input reader.
+    //! @remarks
+    //!  Samples read from @p reader are multiplied by @p gain before mixing.
+    //!  The reader should be added to the mixer.
+    void set_gain(IReader& reader, float gain);
+
     //! Read audio frame.
     //! @remarks
     //!  Reads samples from every input reader, mixes them, and fills @p frame
@@ -61,11 +102,47 @@ public:
     virtual void read(Frame& frame);
 
 private:
-    void read_(sample_t* out_data, size_t out_sz);
+    struct Input : core::WorkerTask {
+        Input(IReader& r)
+            : reader(&r)
+            , gain(1.0f)
+            , unit_gain(true)
+            , size(0)
+            , flags(0) {
+        }
 
-    core::List<IReader, core::NoOwnership> readers_;
+        virtual void execute() {
+            Frame frame(buf.data(), size);
+            reader->read(frame);
+            flags = frame.flags();
+        }
+
+        IReader* reader;
+        float gain;
+        bool unit_gain;
+
+        core::Slice<sample_t> buf;
+        size_t size;
+        unsigned flags;
+    };
+
+    static bool is_zero_(unsigned flags);
+
+    bool read_(sample_t* out_data, size_t out_sz);
+    bool read_parallel_(sample_t* out_data, size_t out_sz);
+
+    size_t find_(const IReader& reader) const;
+
+    core::BufferPool<sample_t>& pool_;
+    core::IAllocator& allocator_;
+
+    core::Array<Input*> inputs_;
     core::Slice<sample_t> temp_buf_;
 
+    core::WorkerPool* worker_pool_;
+
+    const MixerKernelFuncs* kernel_funcs_;
+
     bool valid_;
 };
 
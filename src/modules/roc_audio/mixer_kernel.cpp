@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/mixer_kernel.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+const MixerKernelFuncs scalar_funcs = { mixer_add_scalar, mixer_clamp_scalar };
+
+#if defined(ROC_TARGET_GCC) && (defined(__x86_64__) || defined(__i386__))
+
+const MixerKernelFuncs sse_funcs = { mixer_add_sse, mixer_clamp_sse };
+
+const MixerKernelFuncs avx2_funcs = { mixer_add_avx2, mixer_clamp_avx2 };
+
+#endif
+
+#if defined(ROC_TARGET_GCC) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+
+const MixerKernelFuncs neon_funcs = { mixer_add_neon, mixer_clamp_neon };
+
+#endif
+
+// indexed by core::CpuKernel
+const MixerKernelFuncs* const kernel_table[core::CpuKernel_Count] = {
+    NULL,
+    &scalar_funcs,
+#if defined(ROC_TARGET_GCC) && (defined(__x86_64__) || defined(__i386__))
+    &sse_funcs,
+    &avx2_funcs,
+#else
+    NULL,
+    NULL,
+#endif
+#if defined(ROC_TARGET_GCC) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    &neon_funcs,
+#else
+    NULL,
+#endif
+};
+
+} // namespace
+
+MixerKernel mixer_kernel_best() {
+    return (MixerKernel)core::cpu_kernel_best(kernel_table);
+}
+
+const MixerKernelFuncs* mixer_kernel_funcs(MixerKernel kernel) {
+    return core::cpu_kernel_funcs(kernel_table, (core::CpuKernel)kernel);
+}
+
+const char* mixer_kernel_to_str(MixerKernel kernel) {
+    return core::cpu_kernel_to_str((core::CpuKernel)kernel);
+}
+
+void mixer_add_scalar(sample_t* acc, const sample_t* in, size_t n, float gain) {
+    for (size_t i = 0; i < n; i++) {
+        acc[i] += in[i] * gain;
+    }
+}
+
+void mixer_clamp_scalar(sample_t* data, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (data[i] > SampleMax) {
+            data[i] = SampleMax;
+        } else if (data[i] < SampleMin) {
+            data[i] = SampleMin;
+        }
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/mixer_kernel.h
+//! @brief Mixer kernel.
+
+#ifndef ROC_AUDIO_MIXER_KERNEL_H_
+#define ROC_AUDIO_MIXER_KERNEL_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/cpu_kernel.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Mixer kernel implementation.
+enum MixerKernel {
+    //! Select the fastest kernel supported by the CPU.
+    MixerKernel_Auto = core::CpuKernel_Auto,
+
+    //! Portable scalar implementation.
+    MixerKernel_Scalar = core::CpuKernel_Scalar,
+
+    //! x86 SSE2 implementation, 4 samples at once.
+    MixerKernel_SSE = core::CpuKernel_SSE,
+
+    //! x86 AVX2 and FMA implementation, 8 samples at once.
+    MixerKernel_AVX2 = core::CpuKernel_AVX2,
+
+    //! ARM NEON implementation, 4 samples at once.
+    MixerKernel_NEON = core::CpuKernel_NEON
+};
+
+//! Accumulate function.
+//!
+//! @remarks
+//!  Multiplies @p n input samples by @p gain and adds them to @p acc.
+//!  The result is not clamped.
+typedef void (*MixerAddFunc)(sample_t* acc, const sample_t* in, size_t n, float gain);
+
+//! Clamp function.
+//!
+//! @remarks
+//!  Clamps @p n samples to [SampleMin; SampleMax] in-place.
+typedef void (*MixerClampFunc)(sample_t* data, size_t n);
+
+//! Mixer kernel functions.
+struct MixerKernelFuncs {
+    //! Accumulate function.
+    MixerAddFunc add;
+
+    //! Clamp function.
+    MixerClampFunc clamp;
+};
+
+//! Get the fastest kernel supported by the CPU.
+MixerKernel mixer_kernel_best();
+
+//! Get kernel functions.
+//! @returns
+//!  NULL if the kernel is not supported by the build or the CPU.
+const MixerKernelFuncs* mixer_kernel_funcs(MixerKernel kernel);
+
+//! Get kernel name.
+const char* mixer_kernel_to_str(MixerKernel kernel);
+
+//! Scalar accumulate.
+void mixer_add_scalar(sample_t* acc, const sample_t* in, size_t n, float gain);
+
+//! Scalar clamp.
+void mixer_clamp_scalar(sample_t* data, size_t n);
+
+#if defined(__x86_64__) || defined(__i386__)
+
+//! SSE2 accumulate.
+void mixer_add_sse(sample_t* acc, const sample_t* in, size_t n, float gain);
+
+//! SSE2 clamp.
+void mixer_clamp_sse(sample_t* data, size_t n);
+
+//! AVX2 accumulate.
+void mixer_add_avx2(sample_t* acc, const sample_t* in, size_t n, float gain);
+
+//! AVX2 clamp.
+void mixer_clamp_avx2(sample_t* data, size_t n);
+
+#endif // defined(__x86_64__) || defined(__i386__)
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+//! NEON accumulate.
+void mixer_add_neon(sample_t* acc, const sample_t* in, size_t n, float gain);
+
+//! NEON clamp.
+void mixer_clamp_neon(sample_t* data, size_t n);
+
+#endif // defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_MIXER_KERNEL_H_
@@ -7,6 +7,7 @@
  */
 
 #include "roc_audio/pcm_funcs.h"
+#include "roc_audio/pcm_kernel.h"
 #include "roc_core/endian.h"
 
 namespace roc {
@@ -37,6 +38,22 @@ inline float pcm_decode_one_sample(int16_t s) {
     return float((int16_t)core::ntoh16((uint16_t)s)) / 32768.0f;
 }
 
+// Kernel is selected once, since CPU features don't change at run time.
+const PcmKernelFuncs& pcm_kernel() {
+    static const PcmKernelFuncs* funcs = pcm_kernel_funcs(PcmKernel_Auto);
+    return *funcs;
+}
+
+// Fast paths for the case when there is no channel remapping and the whole
+// buffer is a flat sequence of samples.
+inline void pcm_encode_interleaved(int16_t* out, const sample_t* in, size_t n) {
+    pcm_kernel().encode_int16_be(out, in, n);
+}
+
+inline void pcm_decode_interleaved(sample_t* out, const int16_t* in, size_t n) {
+    pcm_kernel().decode_int16_be(out, in, n);
+}
+
 template <class Sample, size_t NumCh>
 size_t pcm_encode_samples(void* out_data,
                           size_t out_size,
@@ -59,6 +76,11 @@ size_t pcm_encode_samples(void* out_data,
 
     Sample* out_samples = (Sample*)out_data + (off * NumCh);
 
+    if (in_chan_mask == out_chan_mask) {
+        pcm_encode_interleaved(out_samples, in_samples, in_n_samples * NumCh);
+        return in_n_samples;
+    }
+
     for (size_t ns = 0; ns < in_n_samples; ns++) {
         for (packet::channel_mask_t ch = 1; ch <= inout_chan_mask && ch != 0; ch <<= 1) {
             if (in_chan_mask & ch) {
@@ -99,6 +121,11 @@ size_t pcm_decode_samples(const void* in_data,
 
     const Sample* in_samples = (const Sample*)in_data + (off * NumCh);
 
+    if (in_chan_mask == out_chan_mask) {
+        pcm_decode_interleaved(out_samples, in_samples, out_n_samples * NumCh);
+        return out_n_samples;
+    }
+
     for (size_t ns = 0; ns < out_n_samples; ns++) {
         for (packet::channel_mask_t ch = 1; ch <= inout_chan_mask && ch != 0; ch <<= 1) {
             sample_t s = 0;
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/pcm_kernel.h"
+#include "roc_core/endian.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+const PcmKernelFuncs scalar_funcs = { pcm_encode_int16_be_scalar,
+                                      pcm_decode_int16_be_scalar };
+
+#if defined(ROC_TARGET_GCC) && (defined(__x86_64__) || defined(__i386__))
+
+const PcmKernelFuncs sse_funcs = { pcm_encode_int16_be_sse,
+                                   pcm_decode_int16_be_sse };
+
+const PcmKernelFuncs avx2_funcs = { pcm_encode_int16_be_avx2,
+                                    pcm_decode_int16_be_avx2 };
+
+#endif
+
+#if defined(ROC_TARGET_GCC) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+
+const PcmKernelFuncs neon_funcs = { pcm_encode_int16_be_neon,
+                                    pcm_decode_int16_be_neon };
+
+#endif
+
+// indexed by core::CpuKernel
+const PcmKernelFuncs* const kernel_table[core::CpuKernel_Count] = {
+    NULL,
+    &scalar_funcs,
+#if defined(ROC_TARGET_GCC) && (defined(__x86_64__) || defined(__i386__))
+    &sse_funcs,
+    &avx2_funcs,
+#else
+    NULL,
+    NULL,
+#endif
+#if defined(ROC_TARGET_GCC) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    &neon_funcs,
+#else
+    NULL,
+#endif
+};
+
+} // namespace
+
+PcmKernel pcm_kernel_best() {
+    return (PcmKernel)core::cpu_kernel_best(kernel_table);
+}
+
+const PcmKernelFuncs* pcm_kernel_funcs(PcmKernel kernel) {
+    return core::cpu_kernel_funcs(kernel_table, (core::CpuKernel)kernel);
+}
+
+const char* pcm_kernel_to_str(PcmKernel kernel) {
+    return core::cpu_kernel_to_str((core::CpuKernel)kernel);
+}
+
+void pcm_encode_int16_be_scalar(int16_t* out, const sample_t* in, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        float s = in[i] * 32768.0f;
+        s = std::min(s, +32767.0f);
+        s = std::max(s, -32768.0f);
+        out[i] = (int16_t)core::hton16((uint16_t)(int16_t)s);
+    }
+}
+
+void pcm_decode_int16_be_scalar(sample_t* out, const int16_t* in, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = float((int16_t)core::ntoh16((uint16_t)in[i])) / 32768.0f;
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/pcm_kernel.h
+//! @brief PCM conversion kernel.
+
+#ifndef ROC_AUDIO_PCM_KERNEL_H_
+#define ROC_AUDIO_PCM_KERNEL_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/cpu_kernel.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! PCM conversion kernel implementation.
+enum PcmKernel {
+    //! Select the fastest kernel supported by the CPU.
+    PcmKernel_Auto = core::CpuKernel_Auto,
+
+    //! Portable scalar implementation.
+    PcmKernel_Scalar = core::CpuKernel_Scalar,
+
+    //! x86 SSE2 implementation, 8 samples at once.
+    PcmKernel_SSE = core::CpuKernel_SSE,
+
+    //! x86 AVX2 implementation, 16 samples at once.
+    //! Used only if the CPU supports FMA as well, like other AVX2 kernels.
+    PcmKernel_AVX2 = core::CpuKernel_AVX2,
+
+    //! ARM NEON implementation, 8 samples at once.
+    PcmKernel_NEON = core::CpuKernel_NEON
+};
+
+//! Encode function.
+//!
+//! @remarks
+//!  Converts @p n samples from @p in to 16-bit big-endian integers and stores
+//!  them to @p out. Samples out of [-1; 1) are saturated. Fractional part is
+//!  truncated towards zero.
+typedef void (*PcmEncodeFunc)(int16_t* out, const sample_t* in, size_t n);
+
+//! Decode function.
+//!
+//! @remarks
+//!  Converts @p n 16-bit big-endian integers from @p in to samples in [-1; 1)
+//!  and stores them to @p out.
+typedef void (*PcmDecodeFunc)(sample_t* out, const int16_t* in, size_t n);
+
+//! PCM kernel functions.
+struct PcmKernelFuncs {
+    //! Encode function.
+    PcmEncodeFunc encode_int16_be;
+
+    //! Decode function.
+    PcmDecodeFunc decode_int16_be;
+};
+
+//! Get the fastest kernel supported by the CPU.
+PcmKernel pcm_kernel_best();
+
+//! Get kernel functions.
+//! @returns
+//!  NULL if the kernel is not supported by the build or the CPU.
+const PcmKernelFuncs* pcm_kernel_funcs(PcmKernel kernel);
+
+//! Get kernel name.
+const char* pcm_kernel_to_str(PcmKernel kernel);
+
+//! Scalar encode.
+void pcm_encode_int16_be_scalar(int16_t* out, const sample_t* in, size_t n);
+
+//! Scalar decode.
+void pcm_decode_int16_be_scalar(sample_t* out, const int16_t* in, size_t n);
+
+#if defined(__x86_64__) || defined(__i386__)
+
+//! SSE2 encode.
+void pcm_encode_int16_be_sse(int16_t* out, const sample_t* in, size_t n);
+
+//! SSE2 decode.
+void pcm_decode_int16_be_sse(sample_t* out, const int16_t* in, size_t n);
+
+//! AVX2 encode.
+void pcm_encode_int16_be_avx2(int16_t* out, const sample_t* in, size_t n);
+
+//! AVX2 decode.
+void pcm_decode_int16_be_avx2(sample_t* out, const int16_t* in, size_t n);
+
+#endif // defined(__x86_64__) || defined(__i386__)
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+//! NEON encode.
+void pcm_encode_int16_be_neon(int16_t* out, const sample_t* in, size_t n);
+
+//! NEON decode.
+void pcm_decode_int16_be_neon(sample_t* out, const int16_t* in, size_t n);
+
+#endif // defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_PCM_KERNEL_H_
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/polyphase_resampler.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Maximum relative difference between requested scaling and M/L.
+const double RatioEpsilon = 1e-6;
+
+// Windowed sinc, x is measured in zero crossings, window is [-size, +size].
+double windowed_sinc(double x, double size) {
+    if (x < 0) {
+        x = -x;
+    }
+    if (x >= size) {
+        return 0;
+    }
+    const double window = 0.54 + 0.46 * std::cos(M_PI * x / size);
+    if (x < 1e-9) {
+        return window;
+    }
+    return std::sin(M_PI * x) / (M_PI * x) * window;
+}
+
+} // namespace
+
+PolyphaseResampler::PolyphaseResampler(core::IAllocator& allocator,
+                                       const ResamplerConfig& config,
+                                       packet::channel_mask_t channels,
+                                       size_t frame_size)
+    : channel_mask_(channels)
+    , channels_num_(packet::num_channels(channel_mask_))
+    , frame_size_(frame_size)
+    , frame_size_ch_(channels_num_ ? frame_size / channels_num_ : 0)
+    , window_size_(config.window_size)
+    , kernel_(config.kernel == ResamplerKernel_Auto ? resampler_kernel_best()
+                                                    : config.kernel)
+    , kernel_funcs_(resampler_kernel_funcs(kernel_))
+    , prev_frame_(NULL)
+    , curr_frame_(NULL)
+    , next_frame_(NULL)
+    , out_frame_pos_(0)
+    , bank_(allocator)
+    , accum_(allocator)
+    , ratio_num_(0)
+    , ratio_den_(0)
+    , n_taps_(0)
+    , half_taps_(0)
+    , in_pos_(0)
+    , phase_(0)
+    , cutoff_freq_(0.9f)
+    , valid_(false) {
+    if (!check_config_()) {
+        return;
+    }
+    if (!init_buffers_()) {
+        return;
+    }
+    if (!set_scaling(1.0f)) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "polyphase resampler: initializing: "
+            "window_size=%lu frame_size=%lu channels_num=%lu kernel=%s",
+            (unsigned long)window_size_, (unsigned long)frame_size_,
+            (unsigned long)channels_num_, resampler_kernel_to_str(kernel_));
+
+    valid_ = true;
+}
+
+bool PolyphaseResampler::valid() const {
+    return valid_;
+}
+
+bool PolyphaseResampler::set_scaling(float new_scaling) {
+    size_t num = 0, den = 0;
+    if (!find_ratio_(new_scaling, num, den)) {
+        roc_log(LogError,
+                "polyphase resampler: scaling is not a supported rational number:"
+                " scaling=%.7f max_phases=%lu",
+                (double)new_scaling, (unsigned long)MaxPhases);
+        return false;
+    }
+
+    if (num == ratio_num_ && den == ratio_den_) {
+        return true;
+    }
+
+    if (!fill_bank_(num, den)) {
+        return false;
+    }
+
+    roc_log(LogDebug,
+            "polyphase resampler: new ratio: ratio=%lu/%lu taps_per_phase=%lu",
+            (unsigned long)num, (unsigned long)den, (unsigned long)n_taps_);
+
+    // Keep time position of the next output sample.
+    if (ratio_den_ != 0) {
+        phase_ = phase_ * den / ratio_den_;
+    }
+
+    ratio_num_ = num;
+    ratio_den_ = den;
+
+    return true;
+}
+
+bool PolyphaseResampler::resample_buff(Frame& out) {
+    roc_panic_if(!prev_frame_);
+    roc_panic_if(!curr_frame_);
+    roc_panic_if(!next_frame_);
+
+    const bool blank = (out.flags() & Frame::FlagBlank);
+
+    for (; out_frame_pos_ < out.size(); out_frame_pos_ += channels_num_) {
+        if (in_pos_ >= frame_size_ch_) {
+            return false;
+        }
+
+        if (blank) {
+            memset(out.data() + out_frame_pos_, 0, channels_num_ * sizeof(sample_t));
+        } else {
+            resample_(out.data() + out_frame_pos_);
+        }
+
+        phase_ += ratio_num_;
+        in_pos_ += phase_ / ratio_den_;
+        phase_ %= ratio_den_;
+    }
+    out_frame_pos_ = 0;
+    return true;
+}
+
+void PolyphaseResampler::renew_buffers(core::Slice<sample_t>& prev,
+                                       core::Slice<sample_t>& cur,
+                                       core::Slice<sample_t>& next) {
+    roc_panic_if(prev.size() != frame_size_);
+    roc_panic_if(cur.size() != frame_size_);
+    roc_panic_if(next.size() != frame_size_);
+
+    if (in_pos_ >= frame_size_ch_) {
+        in_pos_ -= frame_size_ch_;
+    }
+
+    prev_frame_ = prev.data();
+    curr_frame_ = cur.data();
+    next_frame_ = next.data();
+}
+
+bool PolyphaseResampler::check_config_() const {
+    if (channels_num_ < 1) {
+        roc_log(LogError,
+                "polyphase resampler: invalid num_channels: num_channels=%lu",
+                (unsigned long)channels_num_);
+        return false;
+    }
+
+    if (frame_size_ != frame_size_ch_ * channels_num_) {
+        roc_log(LogError,
+                "polyphase resampler: frame_size is not multiple of num_channels:"
+                " frame_size=%lu num_channels=%lu",
+                (unsigned long)frame_size_, (unsigned long)channels_num_);
+        return false;
+    }
+
+    if (window_size_ < 1) {
+        roc_log(LogError, "polyphase resampler: invalid window_size: window_size=%lu",
+                (unsigned long)window_size_);
+        return false;
+    }
+
+    if (!kernel_funcs_) {
+        roc_log(LogError,
+                "polyphase resampler: kernel is not supported by cpu: kernel=%s",
+                resampler_kernel_to_str(kernel_));
+        return false;
+    }
+
+    return true;
+}
+
+bool PolyphaseResampler::init_buffers_() {
+    if (!accum_.resize(channels_num_)) {
+        roc_log(LogError, "polyphase resampler: can't allocate accumulators buffer");
+        return false;
+    }
+
+    return true;
+}
+
+bool PolyphaseResampler::find_ratio_(float scaling, size_t& num, size_t& den) const {
+    if (!(scaling > 0)) {
+        return false;
+    }
+
+    // Smallest denominator gives smallest coefficient bank.
+    for (size_t d = 1; d <= MaxPhases; d++) {
+        const double n = std::floor((double)scaling * (double)d + 0.5);
+        if (n < 1) {
+            continue;
+        }
+        if (std::fabs(n / (double)d - (double)scaling)
+            <= (double)scaling * RatioEpsilon) {
+            num = (size_t)n;
+            den = d;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PolyphaseResampler::fill_bank_(size_t num, size_t den) {
+    const double scaling = (double)num / (double)den;
+
+    // When downsampling, cutoff frequency is lowered and the filter becomes
+    // proportionally longer, same as in the sinc resampler.
+    const double cutoff =
+        (double)cutoff_freq_ * (scaling > 1.0 ? 1.0 / scaling : 1.0);
+
+    const double half_window = (double)window_size_ / cutoff;
+    const size_t half_taps = (size_t)std::ceil(half_window);
+
+    if (half_taps > frame_size_ch_) {
+        roc_log(LogError,
+                "polyphase resampler: scaling does not fit frame size:"
+                " window_size=%lu frame_size=%lu scaling=%.5f",
+                (unsigned long)window_size_, (unsigned long)frame_size_, scaling);
+        return false;
+    }
+
+    const size_t n_taps = half_taps * 2;
+
+    if (!bank_.resize(n_taps * den)) {
+        roc_log(LogError, "polyphase resampler: can't allocate coefficients bank");
+        return false;
+    }
+
+    // Row p holds coefficients for output sample at in_pos_ + p / den, and its
+    // tap k is applied to input sample in_pos_ + k - (half_taps - 1).
+    for (size_t p = 0; p < den; p++) {
+        sample_t* row = &bank_[p * n_taps];
+
+        double sum = 0;
+        for (size_t k = 0; k < n_taps; k++) {
+            const double dist =
+                (double)p / (double)den + (double)(half_taps - 1) - (double)k;
+            const double h = windowed_sinc(dist * cutoff, (double)window_size_);
+            row[k] = (sample_t)h;
+            sum += h;
+        }
+
+        // Normalize every phase to unity gain at DC.
+        for (size_t k = 0; k < n_taps; k++) {
+            row[k] = (sample_t)((double)row[k] / sum);
+        }
+    }
+
+    n_taps_ = n_taps;
+    half_taps_ = half_taps;
+
+    return true;
+}
+
+void PolyphaseResampler::resample_(sample_t* out) {
+    const sample_t* coeffs = &bank_[phase_ * n_taps_];
+
+    // Window spans [in_pos_ - half_taps_ + 1, in_pos_ + half_taps_] in terms of
+    // indexes of the current frame, and may overlap previous and next frames.
+    const size_t n_prev = in_pos_ + 1 < half_taps_ ? half_taps_ - in_pos_ - 1 : 0;
+    const size_t n_next =
+        in_pos_ + half_taps_ >= frame_size_ch_ ? in_pos_ + half_taps_ - frame_size_ch_ + 1
+                                               : 0;
+    const size_t n_cur = n_taps_ - n_prev - n_next;
+
+    roc_panic_if(n_prev > frame_size_ch_);
+    roc_panic_if(n_next > frame_size_ch_);
+
+    const size_t ind_begin_cur = n_prev == 0 ? in_pos_ + 1 - half_taps_ : 0;
+
+    sample_t* accum = &accum_[0];
+    for (size_t ch = 0; ch < channels_num_; ch++) {
+        accum[ch] = 0;
+    }
+
+    kernel_funcs_->dot(accum, coeffs,
+                       prev_frame_ + (frame_size_ch_ - n_prev) * channels_num_,
+                       channels_num_, n_prev);
+    kernel_funcs_->dot(accum, coeffs + n_prev,
+                       curr_frame_ + ind_begin_cur * channels_num_, channels_num_,
+                       n_cur);
+    kernel_funcs_->dot(accum, coeffs + n_prev + n_cur, next_frame_, channels_num_,
+                       n_next);
+
+    for (size_t ch = 0; ch < channels_num_; ch++) {
+        out[ch] = accum[ch];
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/polyphase_resampler.h
+//! @brief Polyphase resampler.
+
+#ifndef ROC_AUDIO_POLYPHASE_RESAMPLER_H_
+#define ROC_AUDIO_POLYPHASE_RESAMPLER_H_
+
+#include "roc_audio/frame.h"
+#include "roc_audio/iresampler.h"
+#include "roc_audio/resampler.h"
+#include "roc_audio/resampler_kernel.h"
+#include "roc_audio/units.h"
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace audio {
+
+//! Resamples audio stream with fixed rational factor.
+//! @remarks
+//!  Scaling factor is represented as a fraction M/L. Output samples lie on a grid
+//!  of L phases between two input samples, and FIR coefficients for every phase
+//!  are computed once in set_scaling(). Then every output sample is a plain dot
+//!  product of the input window and one row of the coefficient bank, without
+//!  table lookups and interpolation.
+class PolyphaseResampler : public IResampler, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    PolyphaseResampler(core::IAllocator& allocator,
+                       const ResamplerConfig& config,
+                       packet::channel_mask_t channels,
+                       size_t frame_size);
+
+    //! Check if object is successfully constructed.
+    virtual bool valid() const;
+
+    //! Set new resample factor.
+    //! @remarks
+    //!  Fails if the factor can't be represented as a fraction with a denominator
+    //!  not greater than MaxPhases, or if the filter doesn't fit into the frame.
+    //!  Rebuilds coefficient bank, so it should not be called frequently.
+    virtual bool set_scaling(float);
+
+    //! Resamples the whole output frame.
+    virtual bool resample_buff(Frame& out);
+
+    //! Push new buffer on the front of the internal FIFO, which comprises three frames.
+    virtual void renew_buffers(core::Slice<sample_t>& prev,
+                               core::Slice<sample_t>& cur,
+                               core::Slice<sample_t>& next);
+
+    //! Maximum number of phases (denominator of scaling factor).
+    static const size_t MaxPhases = 1024;
+
+private:
+    bool check_config_() const;
+    bool init_buffers_();
+
+    bool find_ratio_(float scaling, size_t& num, size_t& den) const;
+    bool fill_bank_(size_t num, size_t den);
+
+    void resample_(sample_t* out);
+
+    const packet::channel_mask_t channel_mask_;
+    const size_t channels_num_;
+
+    const size_t frame_size_;
+    const size_t frame_size_ch_;
+
+    const size_t window_size_;
+
+    const ResamplerKernel kernel_;
+    const ResamplerKernelFuncs* kernel_funcs_;
+
+    sample_t* prev_frame_;
+    sample_t* curr_frame_;
+    sample_t* next_frame_;
+
+    size_t out_frame_pos_;
+
+    // coefficients bank, row per phase
+    core::Array<sample_t> bank_;
+
+    // per-channel sums for the current output sample
+    core::Array<sample_t> accum_;
+
+    // scaling factor is ratio_num_ / ratio_den_
+    size_t ratio_num_;
+    size_t ratio_den_;
+
+    // number of taps per phase and number of taps before output sample
+    size_t n_taps_;
+    size_t half_taps_;
+
+    // time position of output sample, in_pos_ + phase_ / ratio_den_
+    // in terms of input samples indexes of the current frame
+    size_t in_pos_;
+    size_t phase_;
+
+    const sample_t cutoff_freq_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_POLYPHASE_RESAMPLER_H_
@@ -7,6 +7,7 @@
  */
 
 #include "roc_audio/resampler.h"
+#include "roc_audio/sinc_table_cache.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/stddefs.h"
@@ -89,8 +90,14 @@ Resampler::Resampler(core::IAllocator& allocator,
     , qt_half_sinc_window_size_(float_to_fixedpoint(window_size_))
     , window_interp_(config.window_interp)
     , window_interp_bits_(calc_bits(config.window_interp))
-    , sinc_table_(allocator)
+    , sinc_format_(config.sinc_format)
+    , kernel_(config.kernel == ResamplerKernel_Auto ? resampler_kernel_best()
+                                                    : config.kernel)
+    , kernel_funcs_(resampler_kernel_funcs(kernel_))
+    , coeffs_(allocator)
+    , accum_(allocator)
     , sinc_table_ptr_(NULL)
+    , sinc_table_q15_ptr_(NULL)
     , qt_half_window_size_(float_to_fixedpoint((float)window_size_ / scaling_))
     , qt_epsilon_(float_to_fixedpoint(5e-8f))
     , qt_frame_size_(fixedpoint_t(frame_size_ch_ << FRACT_BIT_COUNT))
@@ -101,15 +108,20 @@ Resampler::Resampler(core::IAllocator& allocator,
     if (!check_config_()) {
         return;
     }
-    if (!fill_sinc_()) {
+    if (!init_buffers_()) {
+        return;
+    }
+    if (!init_sinc_()) {
         return;
     }
 
     roc_log(LogDebug,
             "resampler: initializing: "
-            "window_interp=%lu window_size=%lu frame_size=%lu channels_num=%lu",
+            "window_interp=%lu window_size=%lu frame_size=%lu channels_num=%lu "
+            "kernel=%s",
             (unsigned long)window_interp_, (unsigned long)window_size_,
-            (unsigned long)frame_size_, (unsigned long)channels_num_);
+            (unsigned long)frame_size_, (unsigned long)channels_num_,
+            resampler_kernel_to_str(kernel_));
 
     valid_ = true;
 }
@@ -170,6 +182,8 @@ bool Resampler::resample_buff(Frame& out) {
     roc_panic_if(!curr_frame_);
     roc_panic_if(!next_frame_);
 
+    const bool blank = (out.flags() & Frame::FlagBlank);
+
     for (; out_frame_pos_ < out.size(); out_frame_pos_ += channels_num_) {
         if (qt_sample_ >= qt_frame_size_) {
             return false;
@@ -182,9 +196,10 @@ bool Resampler::resample_buff(Frame& out) {
             qt_sample_ += qt_one;
         }
 
-        sample_t* out_data = out.data();
-        for (size_t channel = 0; channel < channels_num_; ++channel) {
-            out_data[out_frame_pos_ + channel] = resample_(channel);
+        if (blank) {
+            memset(out.data() + out_frame_pos_, 0, channels_num_ * sizeof(sample_t));
+        } else {
+            resample_(out.data() + out_frame_pos_);
         }
         qt_sample_ += qt_dt_;
     }
@@ -218,6 +233,12 @@ bool Resampler::check_config_() const {
         return false;
     }
 
+    if (!kernel_funcs_) {
+        roc_log(LogError, "resampler: kernel is not supported by cpu: kernel=%s",
+                resampler_kernel_to_str(kernel_));
+        return false;
+    }
+
     if ((size_t)1 << window_interp_bits_ != window_interp_) {
         roc_log(LogError,
                 "resampler: window_interp is not power of two: window_interp=%lu",
@@ -228,6 +249,21 @@ bool Resampler::check_config_() const {
     return true;
 }
 
+bool Resampler::init_buffers_() {
+    // The window never exceeds three frames, see set_scaling().
+    if (!coeffs_.resize(frame_size_ch_ * 3)) {
+        roc_log(LogError, "resampler: can't allocate coefficients buffer");
+        return false;
+    }
+
+    if (!accum_.resize(channels_num_)) {
+        roc_log(LogError, "resampler: can't allocate accumulators buffer");
+        return false;
+    }
+
+    return true;
+}
+
 void Resampler::renew_buffers(core::Slice<sample_t>& prev,
                               core::Slice<sample_t>& cur,
                               core::Slice<sample_t>& next) {
@@ -249,88 +285,46 @@ void Resampler::renew_buffers(core::Slice<sample_t>& prev,
     next_frame_ = next.data();
 }
 
-bool Resampler::fill_sinc_() {
-    if (!sinc_table_.resize(window_size_ * window_interp_ + 2)) {
-        roc_log(LogError, "resampler: can't allocate sinc table");
+bool Resampler::init_sinc_() {
+    sinc_table_ =
+        SincTableCache::instance().get(window_size_, window_interp_, sinc_format_);
+    if (!sinc_table_) {
+        roc_log(LogError, "resampler: can't get sinc table");
         return false;
     }
 
-    const double sinc_step = 1.0 / (double)window_interp_;
-    double sinc_t = sinc_step;
-
-    sinc_table_[0] = 1.0f;
-    for (size_t i = 1; i < sinc_table_.size(); ++i) {
-        const double window = 0.54
-            - 0.46
-                * std::cos(2 * M_PI
-                           * ((double)(i - 1) / 2.0 / (double)sinc_table_.size() + 0.5));
-        sinc_table_[i] = (float)(std::sin(M_PI * sinc_t) / M_PI / sinc_t * window);
-        sinc_t += sinc_step;
+    if (sinc_format_ == SincTableFormat_Float) {
+        sinc_table_ptr_ = sinc_table_->data();
+    } else {
+        sinc_table_q15_ptr_ = sinc_table_->data_q15();
     }
-    sinc_table_[sinc_table_.size() - 2] = 0;
-    sinc_table_[sinc_table_.size() - 1] = 0;
-
-    sinc_table_ptr_ = &sinc_table_[0];
 
     return true;
 }
 
-// Computes sinc value in x position using linear interpolation between
-// table values from sinc_table.h
-//
-// During going through input signal window only integer part of argument changes,
-// that's why there are two arguments in this function: integer part and fractional
-// part of time coordinate.
-sample_t Resampler::sinc_(const fixedpoint_t x, const float fract_x) {
-    const size_t index = (x >> (FRACT_BIT_COUNT - window_interp_bits_));
-
-    const sample_t hl = sinc_table_ptr_[index];     // table index smaller than x
-    const sample_t hh = sinc_table_ptr_[index + 1]; // table index next to x
-
-    const sample_t result = hl + fract_x * (hh - hl);
-
-    return scaling_ > 1.0f ? result / scaling_ : result;
-}
-
-sample_t Resampler::resample_(const size_t channel_offset) {
-    // Index of first input sample in window.
-    size_t ind_begin_prev;
-
-    // Window lasts till that index.
-    const size_t ind_end_prev = channelize_index(frame_size_ch_, channel_offset);
-
-    size_t ind_begin_cur;
-    size_t ind_end_cur;
-
-    const size_t ind_begin_next = channelize_index(0, channel_offset);
-    size_t ind_end_next;
-
-    ind_begin_prev = (qt_sample_ >= qt_half_window_size_)
+void Resampler::resample_(sample_t* out) {
+    // Index of first input frame in window.
+    const size_t ind_begin_prev = (qt_sample_ >= qt_half_window_size_)
         ? frame_size_ch_
         : fixedpoint_to_size(qceil(qt_sample_ + (qt_frame_size_ - qt_half_window_size_)));
-    // ind_begin_prev is comparable with channel_len_ till we'll convert it to channalyzed
-    // presentation.
     roc_panic_if(ind_begin_prev > frame_size_ch_);
-    ind_begin_prev = channelize_index(ind_begin_prev, channel_offset);
 
-    ind_begin_cur = (qt_sample_ >= qt_half_window_size_)
+    const size_t ind_begin_cur = (qt_sample_ >= qt_half_window_size_)
         ? fixedpoint_to_size(qceil(qt_sample_ - qt_half_window_size_))
         : 0;
     roc_panic_if(ind_begin_cur > frame_size_ch_);
-    ind_begin_cur = channelize_index(ind_begin_cur, channel_offset);
 
-    ind_end_cur = ((qt_sample_ + qt_half_window_size_) > qt_frame_size_)
+    // Window lasts till that index.
+    const size_t ind_end_cur = ((qt_sample_ + qt_half_window_size_) > qt_frame_size_)
         ? frame_size_ch_ - 1
         : fixedpoint_to_size(qfloor(qt_sample_ + qt_half_window_size_));
     roc_panic_if(ind_end_cur > frame_size_ch_);
-    ind_end_cur = channelize_index(ind_end_cur, channel_offset);
 
-    ind_end_next = ((qt_sample_ + qt_half_window_size_) > qt_frame_size_)
+    const size_t ind_end_next = ((qt_sample_ + qt_half_window_size_) > qt_frame_size_)
         ? fixedpoint_to_size(qfloor(qt_sample_ + qt_half_window_size_ - qt_frame_size_))
             + 1
         : 0;
     roc_panic_if(ind_end_next > frame_size_ch_);
-    ind_end_next = channelize_index(ind_end_next, channel_offset);
 
     // Counter inside window.
     // t_sinc = (t_sample - ceil( t_sample - window_len/cutoff*scale )) * sinc_step
@@ -342,34 +336,26 @@ sample_t Resampler::resample_(const size_t channel_offset) {
     // sinc_table defined in positive half-plane, so at the begining of the window
     // qt_sinc_cur starts decreasing and after we cross 0 it will be increasing
     // till the end of the window.
-    fixedpoint_t qt_sinc_inc = qt_sinc_step_;
+    const signed_fixedpoint_t qt_sinc_inc = (signed_fixedpoint_t)qt_sinc_step_;
 
     // Compute fractional part of time position at the begining. It wont change during
     // the run.
     float f_sinc_cur_fract = fractional(qt_sinc_cur << window_interp_bits_);
-    sample_t accumulator = 0;
 
-    size_t i;
+    sample_t* coeffs = &coeffs_[0];
 
     // Run through previous frame.
-    for (i = ind_begin_prev; i < ind_end_prev; i += channels_num_) {
-        accumulator += prev_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
-        qt_sinc_cur -= qt_sinc_inc;
-    }
-
-    // Run through current frame through the left windows side. qt_sinc_cur is decreasing.
-    i = ind_begin_cur;
-
-    accumulator += curr_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
-    while (qt_sinc_cur >= qt_sinc_step_) {
-        i += channels_num_;
-        qt_sinc_cur -= qt_sinc_inc;
-        accumulator += curr_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
-    }
+    const size_t n_prev = frame_size_ch_ - ind_begin_prev;
+    sinc_(coeffs, n_prev, qt_sinc_cur, -qt_sinc_inc, f_sinc_cur_fract);
+    qt_sinc_cur -= fixedpoint_t(n_prev) * qt_sinc_step_;
 
-    i += channels_num_;
+    // Run through current frame through the left windows side. qt_sinc_cur is
+    // decreasing until it becomes less than qt_sinc_step_.
+    const size_t n_left = qt_sinc_cur / qt_sinc_step_ + 1;
+    sinc_(coeffs + n_prev, n_left, qt_sinc_cur, -qt_sinc_inc, f_sinc_cur_fract);
+    qt_sinc_cur -= fixedpoint_t(n_left - 1) * qt_sinc_step_;
 
-    roc_panic_if(i > channelize_index(frame_size_ch_, channel_offset));
+    roc_panic_if(ind_begin_cur + n_left > frame_size_ch_);
 
     // Crossing zero -- we just need to switch qt_sinc_cur.
     // -1 ------------ 0 ------------- +1
@@ -380,18 +366,52 @@ sample_t Resampler::resample_(const size_t channel_offset) {
     f_sinc_cur_fract = fractional(qt_sinc_cur << window_interp_bits_);
 
     // Run through right side of the window, increasing qt_sinc_cur.
-    for (; i <= ind_end_cur; i += channels_num_) {
-        accumulator += curr_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
-        qt_sinc_cur += qt_sinc_inc;
-    }
+    const size_t n_right =
+        ind_begin_cur + n_left <= ind_end_cur ? ind_end_cur - ind_begin_cur - n_left + 1 : 0;
+    sinc_(coeffs + n_prev + n_left, n_right, qt_sinc_cur, qt_sinc_inc, f_sinc_cur_fract);
+    qt_sinc_cur += fixedpoint_t(n_right) * qt_sinc_step_;
 
     // Next frames run.
-    for (i = ind_begin_next; i < ind_end_next; i += channels_num_) {
-        accumulator += next_frame_[i] * sinc_(qt_sinc_cur, f_sinc_cur_fract);
-        qt_sinc_cur += qt_sinc_inc;
+    const size_t n_next = ind_end_next;
+    sinc_(coeffs + n_prev + n_left + n_right, n_next, qt_sinc_cur, qt_sinc_inc,
+          f_sinc_cur_fract);
+
+    // Apply coefficients to all channels. Both sides of the window in the current
+    // frame are contiguous.
+    sample_t* accum = &accum_[0];
+    for (size_t ch = 0; ch < channels_num_; ch++) {
+        accum[ch] = 0;
+    }
+
+    kernel_funcs_->dot(accum, coeffs, prev_frame_ + ind_begin_prev * channels_num_,
+                       channels_num_, n_prev);
+    kernel_funcs_->dot(accum, coeffs + n_prev, curr_frame_ + ind_begin_cur * channels_num_,
+                       channels_num_, n_left + n_right);
+    kernel_funcs_->dot(accum, coeffs + n_prev + n_left + n_right, next_frame_,
+                       channels_num_, n_next);
+
+    // Coefficients are scaled when downsampling, which is done once for the
+    // whole sum instead of every tap.
+    const sample_t gain = scaling_ > 1.0f ? 1.0f / scaling_ : 1.0f;
+
+    for (size_t ch = 0; ch < channels_num_; ch++) {
+        out[ch] = accum[ch] * gain;
     }
+}
+
+void Resampler::sinc_(sample_t* coeffs,
+                      size_t n,
+                      fixedpoint_t pos,
+                      signed_fixedpoint_t step,
+                      float fract) {
+    // Shift which converts position into sinc table index.
+    const size_t shift = FRACT_BIT_COUNT - window_interp_bits_;
 
-    return accumulator;
+    if (sinc_table_ptr_) {
+        kernel_funcs_->sinc(coeffs, sinc_table_ptr_, shift, n, pos, step, fract);
+    } else {
+        kernel_funcs_->sinc_q15(coeffs, sinc_table_q15_ptr_, shift, n, pos, step, fract);
+    }
 }
 
 } // namespace audio
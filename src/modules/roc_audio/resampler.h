@@ -14,9 +14,13 @@
 
 #include "roc_audio/frame.h"
 #include "roc_audio/ireader.h"
+#include "roc_audio/iresampler.h"
+#include "roc_audio/resampler_kernel.h"
+#include "roc_audio/sinc_table.h"
 #include "roc_audio/units.h"
 #include "roc_core/array.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/shared_ptr.h"
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
 #include "roc_packet/units.h"
@@ -24,11 +28,28 @@
 namespace roc {
 namespace audio {
 
+//! Resampler engine.
+enum ResamplerEngine {
+    //! Sinc interpolation with arbitrary, dynamically changing factor.
+    //! @remarks
+    //!  Required for clock drift compensation.
+    ResamplerEngine_Sinc,
+
+    //! Polyphase FIR filter with precomputed coefficients for every phase.
+    //! @remarks
+    //!  Supports only factors which are rational numbers with small denominator,
+    //!  like 48000/44100. Intended for fixed-ratio sample rate conversion.
+    ResamplerEngine_Polyphase
+};
+
 //! Resampler parameters.
 struct ResamplerConfig {
+    //! Resampling algorithm.
+    ResamplerEngine engine;
+
     //! Sinc table precision.
     //! @remarks
-    //!  Affects sync table size.
+    //!  Affects sync table size. Not used by polyphase engine.
     //!  Lower values give lower quality but rarer cache misses.
     size_t window_interp;
 
@@ -38,14 +59,28 @@ struct ResamplerConfig {
     //!  Lower values give lower quality but higher speed and also rarer cache misses.
     size_t window_size;
 
+    //! Sinc table format.
+    //! @remarks
+    //!  Compact format is useful for large tables, which otherwise don't fit
+    //!  into CPU cache. Not used by polyphase engine.
+    SincTableFormat sinc_format;
+
+    //! Inner loop implementation.
+    //! @remarks
+    //!  By default, the fastest one supported by the CPU is selected.
+    ResamplerKernel kernel;
+
     ResamplerConfig()
-        : window_interp(128)
-        , window_size(32) {
+        : engine(ResamplerEngine_Sinc)
+        , window_interp(128)
+        , window_size(32)
+        , sinc_format(SincTableFormat_Float)
+        , kernel(ResamplerKernel_Auto) {
     }
 };
 
 //! Resamples audio stream with non-integer dynamically changing factor.
-class Resampler : public core::NonCopyable<> {
+class Resampler : public IResampler, public core::NonCopyable<> {
 public:
     //! Initialize.
     Resampler(core::IAllocator& allocator,
@@ -54,7 +89,7 @@ public:
               size_t frame_size);
 
     //! Check if object is successfully constructed.
-    bool valid() const;
+    virtual bool valid() const;
 
     //! Set new resample factor.
     //! @remarks
@@ -63,15 +98,15 @@ public:
     //!  depends on current resampling factor. So we choose length of input buffers to let
     //!  it handle maximum length of input. If new scaling factor breaks equation this
     //!  function returns false.
-    bool set_scaling(float);
+    virtual bool set_scaling(float);
 
     //! Resamples the whole output frame.
-    bool resample_buff(Frame& out);
+    virtual bool resample_buff(Frame& out);
 
     //! Push new buffer on the front of the internal FIFO, which comprisesthree window_.
-    void renew_buffers(core::Slice<sample_t>& prev,
-                       core::Slice<sample_t>& cur,
-                       core::Slice<sample_t>& next);
+    virtual void renew_buffers(core::Slice<sample_t>& prev,
+                               core::Slice<sample_t>& cur,
+                               core::Slice<sample_t>& next);
 
 private:
     typedef uint32_t fixedpoint_t;
@@ -82,20 +117,23 @@ private:
     const packet::channel_mask_t channel_mask_;
     const size_t channels_num_;
 
-    inline size_t channelize_index(const size_t i, const size_t ch_offset) const {
-        return i * channels_num_ + ch_offset;
-    }
-
-    //! Computes single sample of the particular audio channel.
+    //! Computes single sample of every audio channel.
     //!
-    //! @param channel_offset a serial number of the channel
-    //!  (e.g. left -- 0, right -- 1, etc.).
-    sample_t resample_(size_t channel_offset);
+    //! @remarks
+    //!  Sinc coefficients depend only on time position of the output sample, so
+    //!  they are computed once and applied to all channels.
+    //!
+    //! @param out points to the output sample of the first channel.
+    void resample_(sample_t* out);
+
+    // Computes n sinc coefficients using the table of configured format.
+    void sinc_(sample_t* coeffs, size_t n, fixedpoint_t pos, signed_fixedpoint_t step,
+               float fract);
 
     bool check_config_() const;
+    bool init_buffers_();
 
-    bool fill_sinc_();
-    sample_t sinc_(fixedpoint_t x, float fract_x);
+    bool init_sinc_();
 
     sample_t* prev_frame_;
     sample_t* curr_frame_;
@@ -114,8 +152,21 @@ private:
     const size_t window_interp_;
     const size_t window_interp_bits_;
 
-    core::Array<sample_t> sinc_table_;
+    const SincTableFormat sinc_format_;
+
+    const ResamplerKernel kernel_;
+    const ResamplerKernelFuncs* kernel_funcs_;
+
+    // sinc coefficients for the current output sample, one per input frame
+    core::Array<sample_t> coeffs_;
+
+    // per-channel sums for the current output sample
+    core::Array<sample_t> accum_;
+
+    // shared between resamplers with the same window parameters
+    core::SharedPtr<SincTable> sinc_table_;
     const sample_t* sinc_table_ptr_;
+    const int16_t* sinc_table_q15_ptr_;
 
     // half window len in Q8.24 in terms of input signal
     fixedpoint_t qt_half_window_size_;
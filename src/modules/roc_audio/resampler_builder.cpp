@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/resampler_builder.h"
+#include "roc_audio/polyphase_resampler.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Cutoff frequency used by both engines.
+const double CutoffFreq = 0.9;
+
+// Relative scaling change allowed without reallocating frames.
+const double ScalingHeadroom = 0.05;
+
+} // namespace
+
+IResampler* new_resampler(core::IAllocator& allocator,
+                          const ResamplerConfig& config,
+                          packet::channel_mask_t channels,
+                          size_t frame_size) {
+    switch (config.engine) {
+    case ResamplerEngine_Sinc:
+        return new (allocator) Resampler(allocator, config, channels, frame_size);
+
+    case ResamplerEngine_Polyphase:
+        return new (allocator)
+            PolyphaseResampler(allocator, config, channels, frame_size);
+    }
+
+    roc_panic("resampler builder: unknown engine: engine=%d", (int)config.engine);
+}
+
+size_t resampler_frame_size(const ResamplerConfig& config,
+                            packet::channel_mask_t channels,
+                            float scaling) {
+    const double max_scaling = std::max(1.0, (double)scaling) * (1 + ScalingHeadroom);
+
+    // Half of the filter window in input samples. When downsampling, cutoff
+    // frequency is lowered and the window becomes proportionally longer.
+    const double half_window = (double)config.window_size / CutoffFreq * max_scaling;
+
+    const size_t frame_size_ch = (size_t)std::ceil(half_window) + 2;
+
+    return frame_size_ch * packet::num_channels(channels);
+}
+
+} // namespace audio
+} // namespace roc
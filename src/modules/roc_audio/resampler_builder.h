@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/resampler_builder.h
+//! @brief Resampler builder.
+
+#ifndef ROC_AUDIO_RESAMPLER_BUILDER_H_
+#define ROC_AUDIO_RESAMPLER_BUILDER_H_
+
+#include "roc_audio/iresampler.h"
+#include "roc_audio/resampler.h"
+#include "roc_core/iallocator.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace audio {
+
+//! Create resampler for engine specified in config.
+//! @returns
+//!  NULL if allocation failed. Otherwise, caller should check valid().
+IResampler* new_resampler(core::IAllocator& allocator,
+                          const ResamplerConfig& config,
+                          packet::channel_mask_t channels,
+                          size_t frame_size);
+
+//! Get input frame size for resampler.
+//! @remarks
+//!  Returns the smallest number of samples per input frame for all channels,
+//!  which lets resampler created by new_resampler() cover its filter window
+//!  with previous, current and next frames for given scaling factor, plus some
+//!  headroom for clock drift compensation.
+size_t resampler_frame_size(const ResamplerConfig& config,
+                            packet::channel_mask_t channels,
+                            float scaling);
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_RESAMPLER_BUILDER_H_
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/resampler_kernel.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+const ResamplerKernelFuncs scalar_funcs = { resampler_sinc_scalar,
+                                            resampler_sinc_q15_scalar,
+                                            resampler_dot_scalar };
+
+#if defined(ROC_TARGET_GCC) && (defined(__x86_64__) || defined(__i386__))
+
+const ResamplerKernelFuncs sse_funcs = { resampler_sinc_sse, resampler_sinc_q15_sse,
+                                         resampler_dot_sse };
+
+const ResamplerKernelFuncs avx2_funcs = { resampler_sinc_avx2, resampler_sinc_q15_avx2,
+                                          resampler_dot_avx2 };
+
+#endif
+
+#if defined(ROC_TARGET_GCC) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+
+const ResamplerKernelFuncs neon_funcs = { resampler_sinc_neon, resampler_sinc_q15_neon,
+                                          resampler_dot_neon };
+
+#endif
+
+// indexed by core::CpuKernel
+const ResamplerKernelFuncs* const kernel_table[core::CpuKernel_Count] = {
+    NULL,
+    &scalar_funcs,
+#if defined(ROC_TARGET_GCC) && (defined(__x86_64__) || defined(__i386__))
+    &sse_funcs,
+    &avx2_funcs,
+#else
+    NULL,
+    NULL,
+#endif
+#if defined(ROC_TARGET_GCC) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    &neon_funcs,
+#else
+    NULL,
+#endif
+};
+
+} // namespace
+
+ResamplerKernel resampler_kernel_best() {
+    return (ResamplerKernel)core::cpu_kernel_best(kernel_table);
+}
+
+const ResamplerKernelFuncs* resampler_kernel_funcs(ResamplerKernel kernel) {
+    return core::cpu_kernel_funcs(kernel_table, (core::CpuKernel)kernel);
+}
+
+const char* resampler_kernel_to_str(ResamplerKernel kernel) {
+    return core::cpu_kernel_to_str((core::CpuKernel)kernel);
+}
+
+void resampler_sinc_scalar(sample_t* coeffs,
+                           const sample_t* table,
+                           size_t shift,
+                           size_t n,
+                           uint32_t pos,
+                           int32_t step,
+                           float fract) {
+    for (size_t i = 0; i < n; i++) {
+        const size_t index = pos >> shift;
+
+        const sample_t hl = table[index];     // table index smaller than pos
+        const sample_t hh = table[index + 1]; // table index next to pos
+
+        coeffs[i] = hl + fract * (hh - hl);
+
+        pos += (uint32_t)step;
+    }
+}
+
+void resampler_sinc_q15_scalar(sample_t* coeffs,
+                               const int16_t* table,
+                               size_t shift,
+                               size_t n,
+                               uint32_t pos,
+                               int32_t step,
+                               float fract) {
+    const float scale = 1.0f / ResamplerSincQ15One;
+
+    for (size_t i = 0; i < n; i++) {
+        const size_t index = pos >> shift;
+
+        const float hl = (float)table[index];
+        const float hh = (float)table[index + 1];
+
+        coeffs[i] = (hl + fract * (hh - hl)) * scale;
+
+        pos += (uint32_t)step;
+    }
+}
+
+void resampler_dot_scalar(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n) {
+    if (num_ch == 1) {
+        sample_t sum = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum += in[i] * coeffs[i];
+        }
+        acc[0] += sum;
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const sample_t coeff = coeffs[i];
+        for (size_t ch = 0; ch < num_ch; ch++) {
+            acc[ch] += in[ch] * coeff;
+        }
+        in += num_ch;
+    }
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/resampler_kernel.h
+//! @brief Resampler kernel.
+
+#ifndef ROC_AUDIO_RESAMPLER_KERNEL_H_
+#define ROC_AUDIO_RESAMPLER_KERNEL_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/cpu_kernel.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Resampler kernel implementation.
+enum ResamplerKernel {
+    //! Select the fastest kernel supported by the CPU.
+    ResamplerKernel_Auto = core::CpuKernel_Auto,
+
+    //! Portable scalar implementation.
+    ResamplerKernel_Scalar = core::CpuKernel_Scalar,
+
+    //! x86 SSE2 implementation, 4 samples at once.
+    ResamplerKernel_SSE = core::CpuKernel_SSE,
+
+    //! x86 AVX2 and FMA implementation, 8 samples at once.
+    ResamplerKernel_AVX2 = core::CpuKernel_AVX2,
+
+    //! ARM NEON implementation, 4 samples at once.
+    ResamplerKernel_NEON = core::CpuKernel_NEON
+};
+
+//! Sinc coefficients function.
+//!
+//! @remarks
+//!  Computes @p n sinc coefficients by interpolating table values.
+//!
+//! @b Parameters
+//!  - @p coeffs is the output array of @p n coefficients
+//!  - @p table is the sinc table
+//!  - @p shift is the shift which converts a fixed point position into a table index
+//!  - @p n is the number of coefficients
+//!  - @p pos is the fixed point sinc table position of the first coefficient
+//!  - @p step is added to the position after every coefficient
+//!  - @p fract is the fractional part used to interpolate between table values
+typedef void (*ResamplerSincFunc)(sample_t* coeffs,
+                                  const sample_t* table,
+                                  size_t shift,
+                                  size_t n,
+                                  uint32_t pos,
+                                  int32_t step,
+                                  float fract);
+
+//! Sinc coefficients function for compact table.
+//!
+//! @remarks
+//!  Same as ResamplerSincFunc, but @p table contains fixed point values,
+//!  where 1.0 is represented as ResamplerSincQ15One.
+typedef void (*ResamplerSincQ15Func)(sample_t* coeffs,
+                                     const int16_t* table,
+                                     size_t shift,
+                                     size_t n,
+                                     uint32_t pos,
+                                     int32_t step,
+                                     float fract);
+
+//! Value of 1.0 in compact sinc table.
+const float ResamplerSincQ15One = 32767.0f;
+
+//! Dot product function.
+//!
+//! @remarks
+//!  Multiplies @p n interleaved input frames by coefficients and adds the result
+//!  to per-channel accumulators. Every coefficient is applied to all channels of
+//!  its frame.
+//!
+//! @b Parameters
+//!  - @p acc is the array of @p num_ch accumulators
+//!  - @p coeffs is the array of @p n coefficients
+//!  - @p in points to the first sample of the first input frame
+//!  - @p num_ch is the number of channels
+//!  - @p n is the number of input frames
+typedef void (*ResamplerDotFunc)(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n);
+
+//! Resampler kernel functions.
+struct ResamplerKernelFuncs {
+    //! Sinc coefficients function.
+    ResamplerSincFunc sinc;
+
+    //! Sinc coefficients function for compact table.
+    ResamplerSincQ15Func sinc_q15;
+
+    //! Dot product function.
+    ResamplerDotFunc dot;
+};
+
+//! Get the fastest kernel supported by the CPU.
+ResamplerKernel resampler_kernel_best();
+
+//! Get kernel functions.
+//! @returns
+//!  NULL if the kernel is not supported by the build or the CPU.
+const ResamplerKernelFuncs* resampler_kernel_funcs(ResamplerKernel kernel);
+
+//! Get kernel name.
+const char* resampler_kernel_to_str(ResamplerKernel kernel);
+
+//! Scalar sinc coefficients.
+void resampler_sinc_scalar(sample_t* coeffs,
+                           const sample_t* table,
+                           size_t shift,
+                           size_t n,
+                           uint32_t pos,
+                           int32_t step,
+                           float fract);
+
+//! Scalar sinc coefficients for compact table.
+void resampler_sinc_q15_scalar(sample_t* coeffs,
+                               const int16_t* table,
+                               size_t shift,
+                               size_t n,
+                               uint32_t pos,
+                               int32_t step,
+                               float fract);
+
+//! Scalar dot product.
+void resampler_dot_scalar(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n);
+
+#if defined(__x86_64__) || defined(__i386__)
+
+//! SSE2 sinc coefficients.
+void resampler_sinc_sse(sample_t* coeffs,
+                        const sample_t* table,
+                        size_t shift,
+                        size_t n,
+                        uint32_t pos,
+                        int32_t step,
+                        float fract);
+
+//! SSE2 sinc coefficients for compact table.
+void resampler_sinc_q15_sse(sample_t* coeffs,
+                            const int16_t* table,
+                            size_t shift,
+                            size_t n,
+                            uint32_t pos,
+                            int32_t step,
+                            float fract);
+
+//! SSE2 dot product.
+void resampler_dot_sse(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n);
+
+//! AVX2 sinc coefficients.
+void resampler_sinc_avx2(sample_t* coeffs,
+                         const sample_t* table,
+                         size_t shift,
+                         size_t n,
+                         uint32_t pos,
+                         int32_t step,
+                         float fract);
+
+//! AVX2 sinc coefficients for compact table.
+void resampler_sinc_q15_avx2(sample_t* coeffs,
+                             const int16_t* table,
+                             size_t shift,
+                             size_t n,
+                             uint32_t pos,
+                             int32_t step,
+                             float fract);
+
+//! AVX2 dot product.
+void resampler_dot_avx2(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n);
+
+#endif // defined(__x86_64__) || defined(__i386__)
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+//! NEON sinc coefficients.
+void resampler_sinc_neon(sample_t* coeffs,
+                         const sample_t* table,
+                         size_t shift,
+                         size_t n,
+                         uint32_t pos,
+                         int32_t step,
+                         float fract);
+
+//! NEON sinc coefficients for compact table.
+void resampler_sinc_q15_neon(sample_t* coeffs,
+                             const int16_t* table,
+                             size_t shift,
+                             size_t n,
+                             uint32_t pos,
+                             int32_t step,
+                             float fract);
+
+//! NEON dot product.
+void resampler_dot_neon(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n);
+
+#endif // defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_RESAMPLER_KERNEL_H_
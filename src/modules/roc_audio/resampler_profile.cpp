@@ -28,6 +28,12 @@ ResamplerConfig resampler_profile(ResamplerProfile profile) {
     case ResamplerProfile_High:
         config.window_interp = 512;
         config.window_size = 64;
+        config.sinc_format = SincTableFormat_Q15;
+        break;
+
+    case ResamplerProfile_Polyphase:
+        config.engine = ResamplerEngine_Polyphase;
+        config.window_size = 32;
         break;
     }
 
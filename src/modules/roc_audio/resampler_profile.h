@@ -26,7 +26,12 @@ enum ResamplerProfile {
     ResamplerProfile_Medium,
 
     //! Hight quality, low speed.
-    ResamplerProfile_High
+    ResamplerProfile_High,
+
+    //! Polyphase engine, fast speed, only fixed rational factor.
+    //! @remarks
+    //!  Can't be used for clock drift compensation.
+    ResamplerProfile_Polyphase
 };
 
 //! Get parameters for given resampler profile.
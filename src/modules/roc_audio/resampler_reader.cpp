@@ -7,6 +7,7 @@
  */
 
 #include "roc_audio/resampler_reader.h"
+#include "roc_audio/resampler_builder.h"
 #include "roc_core/helpers.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
@@ -19,17 +20,20 @@ ResamplerReader::ResamplerReader(IReader& reader,
                                  core::BufferPool<sample_t>& buffer_pool,
                                  core::IAllocator& allocator,
                                  const ResamplerConfig& config,
-                                 packet::channel_mask_t channels,
-                                 size_t frame_size)
-    : resampler_(allocator, config, channels, frame_size)
+                                 packet::channel_mask_t channels)
+    : buffer_pool_(buffer_pool)
+    , allocator_(allocator)
+    , config_(config)
+    , channels_(channels)
     , reader_(reader)
-    , frame_size_(frame_size)
-    , frames_empty_(true)
+    , chunk_size_(0)
+    , chunks_empty_(true)
     , valid_(false) {
-    if (!resampler_.valid()) {
-        return;
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(chunk_blank_); n++) {
+        chunk_blank_[n] = false;
     }
-    if (!init_frames_(buffer_pool)) {
+
+    if (!init_(resampler_frame_size(config_, channels_, 1.0f), 1.0f)) {
         return;
     }
     valid_ = true;
@@ -42,54 +46,133 @@ bool ResamplerReader::valid() const {
 bool ResamplerReader::set_scaling(float scaling) {
     roc_panic_if_not(valid());
 
-    return resampler_.set_scaling(scaling);
+    if (resampler_->set_scaling(scaling)) {
+        return true;
+    }
+
+    const size_t chunk_size = resampler_frame_size(config_, channels_, scaling);
+
+    if (!chunks_empty_ || chunk_size <= chunk_size_) {
+        return false;
+    }
+
+    roc_log(LogDebug, "resampler reader: growing chunks: old_size=%lu new_size=%lu",
+            (unsigned long)chunk_size_, (unsigned long)chunk_size);
+
+    return init_(chunk_size, scaling);
 }
 
 void ResamplerReader::read(Frame& frame) {
     roc_panic_if_not(valid());
 
-    if (frames_empty_) {
-        renew_frames_();
+    if (chunks_empty_) {
+        renew_chunks_();
     }
 
-    while (!resampler_.resample_buff(frame)) {
-        renew_frames_();
+    bool blank = true;
+
+    for (;;) {
+        // Resampler skips filtering if the whole window is zero. Window moves when
+        // chunks are renewed, so every call gets its own frame with its own flags.
+        // Resampler remembers output position and continues where it stopped.
+        Frame out_frame(frame.data(), frame.size());
+
+        if (window_blank_()) {
+            out_frame.set_flags(Frame::FlagBlank);
+        } else {
+            blank = false;
+        }
+
+        if (resampler_->resample_buff(out_frame)) {
+            break;
+        }
+
+        renew_chunks_();
     }
+
+    frame.set_flags(blank ? Frame::FlagBlank : 0);
 }
 
-bool ResamplerReader::init_frames_(core::BufferPool<sample_t>& buffer_pool) {
-    for (size_t n = 0; n < ROC_ARRAY_SIZE(frames_); n++) {
-        frames_[n] = new (buffer_pool) core::Buffer<sample_t>(buffer_pool);
+bool ResamplerReader::init_(size_t chunk_size, float scaling) {
+    // Old resampler and chunks are kept until the new ones are ready, so that
+    // failed set_scaling() doesn't change anything.
+    core::UniquePtr<IResampler> resampler(
+        new_resampler(allocator_, config_, channels_, chunk_size), allocator_);
+    if (!resampler || !resampler->valid()) {
+        return false;
+    }
+
+    if (!resampler->set_scaling(scaling)) {
+        return false;
+    }
+
+    core::Slice<sample_t> chunks[ROC_ARRAY_SIZE(chunks_)];
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(chunks); n++) {
+        chunks[n] = new (buffer_pool_) core::Buffer<sample_t>(buffer_pool_);
 
-        if (!frames_[n]) {
+        if (!chunks[n]) {
             roc_log(LogError, "resampler reader: can't allocate buffer");
             return false;
         }
 
-        frames_[n].resize(frame_size_);
+        if (chunks[n].capacity() < chunk_size) {
+            roc_log(LogError,
+                    "resampler reader: buffer is too small: capacity=%lu chunk_size=%lu",
+                    (unsigned long)chunks[n].capacity(), (unsigned long)chunk_size);
+            return false;
+        }
+
+        chunks[n].resize(chunk_size);
     }
 
+    resampler_.reset(resampler.release(), allocator_);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(chunks_); n++) {
+        chunks_[n] = chunks[n];
+    }
+
+    chunk_size_ = chunk_size;
+
     return true;
 }
 
-void ResamplerReader::renew_frames_() {
-    if (frames_empty_) {
-        for (size_t n = 0; n < ROC_ARRAY_SIZE(frames_); ++n) {
-            Frame frame(frames_[n].data(), frames_[n].size());
+void ResamplerReader::renew_chunks_() {
+    if (chunks_empty_) {
+        for (size_t n = 0; n < ROC_ARRAY_SIZE(chunks_); ++n) {
+            Frame frame(chunks_[n].data(), chunks_[n].size());
             reader_.read(frame);
+            chunk_blank_[n] = is_zero_(frame);
         }
-        frames_empty_ = false;
+        chunks_empty_ = false;
     } else {
-        core::Slice<sample_t> temp = frames_[0];
-        frames_[0] = frames_[1];
-        frames_[1] = frames_[2];
-        frames_[2] = temp;
+        core::Slice<sample_t> temp = chunks_[0];
+        chunks_[0] = chunks_[1];
+        chunks_[1] = chunks_[2];
+        chunks_[2] = temp;
 
-        Frame frame(frames_[2].data(), frames_[2].size());
+        chunk_blank_[0] = chunk_blank_[1];
+        chunk_blank_[1] = chunk_blank_[2];
+
+        Frame frame(chunks_[2].data(), chunks_[2].size());
         reader_.read(frame);
+        chunk_blank_[2] = is_zero_(frame);
     }
 
-    resampler_.renew_buffers(frames_[0], frames_[1], frames_[2]);
+    resampler_->renew_buffers(chunks_[0], chunks_[1], chunks_[2]);
+}
+
+bool ResamplerReader::is_zero_(const Frame& frame) {
+    return (frame.flags() & (Frame::FlagBlank | Frame::FlagBeep)) == Frame::FlagBlank;
+}
+
+bool ResamplerReader::window_blank_() const {
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(chunk_blank_); n++) {
+        if (!chunk_blank_[n]) {
+            return false;
+        }
+    }
+    return true;
 }
 
 } // namespace audio
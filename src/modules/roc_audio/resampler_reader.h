@@ -14,12 +14,14 @@
 
 #include "roc_audio/frame.h"
 #include "roc_audio/ireader.h"
+#include "roc_audio/iresampler.h"
 #include "roc_audio/resampler.h"
 #include "roc_audio/units.h"
 #include "roc_core/array.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/unique_ptr.h"
 #include "roc_packet/units.h"
 
 namespace roc {
@@ -28,6 +30,13 @@ namespace audio {
 //! Resamples audio stream with non-integer dynamically changing factor.
 //! @remarks
 //!  Typicaly being used with factor close to 1 ( 0.9 < factor < 1.1 ).
+//!  Input is pulled in small chunks, which size is derived from the resampler
+//!  window, so the look-ahead latency depends on filter length and not on the
+//!  size of frames requested by the caller.
+//!
+//!  Input chunks with Frame::FlagBlank and without Frame::FlagBeep are tracked,
+//!  and while the whole window is blank, output is filled with zeros without
+//!  filtering and gets Frame::FlagBlank too.
 class ResamplerReader : public IReader, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -35,14 +44,12 @@ public:
     //! @b Parameters
     //!  - @p reader specifies input audio stream used in read()
     //!  - @p buffer_pool is used to allocate temporary buffers
-    //!  - @p frame_size is number of samples per resampler frame per audio channel
     //!  - @p channels is the bitmask of audio channels
     ResamplerReader(IReader& reader,
                     core::BufferPool<sample_t>& buffer_pool,
                     core::IAllocator& allocator,
                     const ResamplerConfig& config,
-                    packet::channel_mask_t channels,
-                    size_t frame_size);
+                    packet::channel_mask_t channels);
 
     //! Check if object is successfully constructed.
     bool valid() const;
@@ -56,21 +63,33 @@ public:
     //! @remarks
     //!  Resampling algorithm needs some window of input samples. The length of the window
     //!  (length of sinc impulse response) is a compromise between SNR and speed. It
-    //!  depends on current resampling factor. So we choose length of input buffers to let
-    //!  it handle maximum length of input. If new scaling factor breaks equation this
-    //!  function returns false.
+    //!  depends on current resampling factor. Input chunks are sized to handle given
+    //!  factor with some headroom. If new scaling factor doesn't fit into chunks, they
+    //!  are reallocated if reading was not started yet, and otherwise this function
+    //!  returns false.
     bool set_scaling(float);
 
 private:
-    bool init_frames_(core::BufferPool<sample_t>&);
-    void renew_frames_();
+    bool init_(size_t chunk_size, float scaling);
+    static bool is_zero_(const Frame& frame);
 
-    Resampler resampler_;
+    void renew_chunks_();
+    bool window_blank_() const;
+
+    core::BufferPool<sample_t>& buffer_pool_;
+    core::IAllocator& allocator_;
+
+    const ResamplerConfig config_;
+    const packet::channel_mask_t channels_;
+
+    core::UniquePtr<IResampler> resampler_;
     IReader& reader_;
 
-    core::Slice<sample_t> frames_[3];
-    const size_t frame_size_;
-    bool frames_empty_;
+    // ring of three chunks: previous, current and next
+    core::Slice<sample_t> chunks_[3];
+    bool chunk_blank_[3];
+    size_t chunk_size_;
+    bool chunks_empty_;
 
     bool valid_;
 };
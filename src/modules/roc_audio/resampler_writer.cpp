@@ -7,6 +7,7 @@
  */
 
 #include "roc_audio/resampler_writer.h"
+#include "roc_audio/resampler_builder.h"
 #include "roc_core/helpers.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
@@ -21,17 +22,35 @@ ResamplerWriter::ResamplerWriter(IWriter& writer,
                                  const ResamplerConfig& config,
                                  packet::channel_mask_t channels,
                                  size_t frame_size)
-    : resampler_(allocator, config, channels, frame_size)
+    : buffer_pool_(buffer_pool)
+    , allocator_(allocator)
+    , config_(config)
+    , channels_(channels)
     , writer_(writer)
-    , frame_pos_(0)
-    , frame_size_(frame_size)
+    , chunk_pos_(0)
+    , chunk_size_(0)
+    , started_(false)
     , valid_(false) {
-    if (!resampler_.valid()) {
+    output_ = new (buffer_pool_) core::Buffer<sample_t>(buffer_pool_);
+
+    if (!output_) {
+        roc_log(LogError, "resampler writer: can't allocate buffer");
         return;
     }
-    if (!init_(buffer_pool)) {
+
+    if (output_.capacity() < frame_size) {
+        roc_log(LogError,
+                "resampler writer: buffer is too small: capacity=%lu frame_size=%lu",
+                (unsigned long)output_.capacity(), (unsigned long)frame_size);
         return;
     }
+
+    output_.resize(frame_size);
+
+    if (!init_(resampler_frame_size(config_, channels_, 1.0f), 1.0f)) {
+        return;
+    }
+
     valid_ = true;
 }
 
@@ -42,7 +61,20 @@ bool ResamplerWriter::valid() const {
 bool ResamplerWriter::set_scaling(float scaling) {
     roc_panic_if_not(valid());
 
-    return resampler_.set_scaling(scaling);
+    if (resampler_->set_scaling(scaling)) {
+        return true;
+    }
+
+    const size_t chunk_size = resampler_frame_size(config_, channels_, scaling);
+
+    if (started_ || chunk_size <= chunk_size_) {
+        return false;
+    }
+
+    roc_log(LogDebug, "resampler writer: growing chunks: old_size=%lu new_size=%lu",
+            (unsigned long)chunk_size_, (unsigned long)chunk_size);
+
+    return init_(chunk_size, scaling);
 }
 
 void ResamplerWriter::write(Frame& input) {
@@ -52,63 +84,82 @@ void ResamplerWriter::write(Frame& input) {
     const size_t input_size = input.size();
     size_t input_pos = 0;
 
-    sample_t* frame0_data = frames_[0].data();
-    for (; frame_pos_ < frame_size_ && input_pos < input_size;
-         ++frame_pos_, ++input_pos) {
-        frame0_data[frame_pos_] = input_data[input_pos];
-    }
-
-    sample_t* frame1_data = frames_[1].data();
-    for (; frame_pos_ < frame_size_ * 2 && input_pos < input_size;
-         ++frame_pos_, ++input_pos) {
-        frame1_data[frame_pos_ - frame_size_] = input_data[input_pos];
+    if (input_size != 0) {
+        started_ = true;
     }
 
     while (input_pos < input_size) {
-        sample_t* frame2_data = frames_[2].data();
-        for (; frame_pos_ < frame_size_ * 3 && input_pos < input_size;
-             ++frame_pos_, ++input_pos) {
-            frame2_data[frame_pos_ - frame_size_ * 2] = input_data[input_pos];
-        }
+        core::Slice<sample_t>& chunk = chunks_[chunk_pos_ / chunk_size_];
+        const size_t chunk_off = chunk_pos_ % chunk_size_;
+
+        const size_t n_samples =
+            std::min(chunk_size_ - chunk_off, input_size - input_pos);
+
+        memcpy(chunk.data() + chunk_off, input_data + input_pos,
+               n_samples * sizeof(sample_t));
 
-        // All three slices are full, resampling frame_size_ samples.
-        if (frame_pos_ >= frame_size_ * 3) {
-            resampler_.renew_buffers(frames_[0], frames_[1], frames_[2]);
+        chunk_pos_ += n_samples;
+        input_pos += n_samples;
+
+        // All three chunks are full, resampling chunk_size_ samples.
+        if (chunk_pos_ == chunk_size_ * 3) {
+            resampler_->renew_buffers(chunks_[0], chunks_[1], chunks_[2]);
 
             Frame out_frame(output_.data(), output_.size());
-            while (resampler_.resample_buff(out_frame)) {
+            while (resampler_->resample_buff(out_frame)) {
                 writer_.write(out_frame);
             }
 
-            frame_pos_ -= frames_[0].size();
-            core::Slice<sample_t> temp = frames_[0];
-            frames_[0] = frames_[1];
-            frames_[1] = frames_[2];
-            frames_[2] = temp;
+            chunk_pos_ -= chunk_size_;
+
+            core::Slice<sample_t> temp = chunks_[0];
+            chunks_[0] = chunks_[1];
+            chunks_[1] = chunks_[2];
+            chunks_[2] = temp;
         }
     }
 }
 
-bool ResamplerWriter::init_(core::BufferPool<sample_t>& buffer_pool) {
-    for (size_t n = 0; n < ROC_ARRAY_SIZE(frames_); n++) {
-        frames_[n] = new (buffer_pool) core::Buffer<sample_t>(buffer_pool);
+bool ResamplerWriter::init_(size_t chunk_size, float scaling) {
+    // Old resampler and chunks are kept until the new ones are ready, so that
+    // failed set_scaling() doesn't change anything.
+    core::UniquePtr<IResampler> resampler(
+        new_resampler(allocator_, config_, channels_, chunk_size), allocator_);
+    if (!resampler || !resampler->valid()) {
+        return false;
+    }
+
+    if (!resampler->set_scaling(scaling)) {
+        return false;
+    }
+
+    core::Slice<sample_t> chunks[ROC_ARRAY_SIZE(chunks_)];
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(chunks); n++) {
+        chunks[n] = new (buffer_pool_) core::Buffer<sample_t>(buffer_pool_);
 
-        if (!frames_[n]) {
+        if (!chunks[n]) {
             roc_log(LogError, "resampler writer: can't allocate buffer");
             return false;
         }
 
-        frames_[n].resize(frame_size_);
+        if (chunks[n].capacity() < chunk_size) {
+            roc_log(LogError,
+                    "resampler writer: buffer is too small: capacity=%lu chunk_size=%lu",
+                    (unsigned long)chunks[n].capacity(), (unsigned long)chunk_size);
+            return false;
+        }
+
+        chunks[n].resize(chunk_size);
     }
 
-    output_ = new (buffer_pool) core::Buffer<sample_t>(buffer_pool);
+    resampler_.reset(resampler.release(), allocator_);
 
-    if (!output_) {
-        roc_log(LogError, "resampler writer: can't allocate buffer");
-        return false;
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(chunks_); n++) {
+        chunks_[n] = chunks[n];
     }
 
-    output_.resize(frame_size_);
+    chunk_size_ = chunk_size;
 
     return true;
 }
@@ -14,12 +14,14 @@
 
 #include "roc_audio/frame.h"
 #include "roc_audio/iwriter.h"
+#include "roc_audio/iresampler.h"
 #include "roc_audio/resampler.h"
 #include "roc_audio/units.h"
 #include "roc_core/array.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/unique_ptr.h"
 #include "roc_packet/units.h"
 
 namespace roc {
@@ -28,6 +30,9 @@ namespace audio {
 //! Resamples audio stream with non-integer dynamically changing factor.
 //! @remarks
 //!  Typicaly being used with factor close to 1 ( 0.9 < factor < 1.1 ).
+//!  Input is accumulated in small chunks, which size is derived from the
+//!  resampler window, so the latency depends on filter length and not on the
+//!  frame size.
 class ResamplerWriter : public IWriter, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -35,7 +40,7 @@ public:
     //! @b Parameters
     //!  - @p writer specifies output audio stream used in write()
     //!  - @p buffer_pool is used to allocate temporary buffers
-    //!  - @p frame_size is number of samples per resampler frame per audio channel
+    //!  - @p frame_size is number of samples for all channels per output frame
     //!  - @p channels is the bitmask of audio channels
     ResamplerWriter(IWriter& writer,
                     core::BufferPool<sample_t>& buffer_pool,
@@ -56,22 +61,31 @@ public:
     //! @remarks
     //!  Resampling algorithm needs some window of input samples. The length of the window
     //!  (length of sinc impulse response) is a compromise between SNR and speed. It
-    //!  depends on current resampling factor. So we choose length of input buffers to let
-    //!  it handle maximum length of input. If new scaling factor breaks equation this
-    //!  function returns false.
+    //!  depends on current resampling factor. Input chunks are sized to handle given
+    //!  factor with some headroom. If new scaling factor doesn't fit into chunks, they
+    //!  are reallocated if writing was not started yet, and otherwise this function
+    //!  returns false.
     bool set_scaling(float);
 
 private:
-    bool init_(core::BufferPool<sample_t>&);
+    bool init_(size_t chunk_size, float scaling);
 
-    Resampler resampler_;
+    core::BufferPool<sample_t>& buffer_pool_;
+    core::IAllocator& allocator_;
+
+    const ResamplerConfig config_;
+    const packet::channel_mask_t channels_;
+
+    core::UniquePtr<IResampler> resampler_;
     IWriter& writer_;
 
     core::Slice<sample_t> output_;
 
-    core::Slice<sample_t> frames_[3];
-    size_t frame_pos_;
-    const size_t frame_size_;
+    // ring of three chunks: previous, current and next
+    core::Slice<sample_t> chunks_[3];
+    size_t chunk_pos_;
+    size_t chunk_size_;
+    bool started_;
 
     bool valid_;
 };
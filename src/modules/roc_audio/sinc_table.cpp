@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/sinc_table.h"
+#include "roc_audio/resampler_kernel.h"
+#include "roc_audio/sinc_table_cache.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+SincTable::SincTable(core::IAllocator& allocator,
+                     size_t window_size,
+                     size_t window_interp,
+                     SincTableFormat format)
+    : window_size_(window_size)
+    , window_interp_(window_interp)
+    , format_(format)
+    , table_(allocator)
+    , table_q15_(allocator)
+    , valid_(false) {
+    const size_t size = window_size_ * window_interp_ + 2;
+
+    if (format_ == SincTableFormat_Float) {
+        if (!table_.resize(size)) {
+            roc_log(LogError, "sinc table: can't allocate table");
+            return;
+        }
+    } else {
+        if (!table_q15_.resize(size)) {
+            roc_log(LogError, "sinc table: can't allocate table");
+            return;
+        }
+    }
+
+    const double sinc_step = 1.0 / (double)window_interp_;
+    double sinc_t = sinc_step;
+
+    for (size_t i = 0; i < size; ++i) {
+        double value = 1.0;
+        if (i != 0) {
+            const double window = 0.54
+                - 0.46
+                    * std::cos(2 * M_PI * ((double)(i - 1) / 2.0 / (double)size + 0.5));
+            value = std::sin(M_PI * sinc_t) / M_PI / sinc_t * window;
+            sinc_t += sinc_step;
+        }
+        if (i >= size - 2) {
+            value = 0;
+        }
+
+        if (format_ == SincTableFormat_Float) {
+            table_[i] = (float)value;
+        } else {
+            table_q15_[i] =
+                (int16_t)std::floor(value * (double)ResamplerSincQ15One + 0.5);
+        }
+    }
+
+    valid_ = true;
+}
+
+bool SincTable::valid() const {
+    return valid_;
+}
+
+size_t SincTable::window_size() const {
+    return window_size_;
+}
+
+size_t SincTable::window_interp() const {
+    return window_interp_;
+}
+
+SincTableFormat SincTable::format() const {
+    return format_;
+}
+
+const sample_t* SincTable::data() const {
+    roc_panic_if(format_ != SincTableFormat_Float);
+    return &table_[0];
+}
+
+const int16_t* SincTable::data_q15() const {
+    roc_panic_if(format_ != SincTableFormat_Q15);
+    return &table_q15_[0];
+}
+
+size_t SincTable::size() const {
+    return format_ == SincTableFormat_Float ? table_.size() : table_q15_.size();
+}
+
+void SincTable::destroy() {
+    SincTableCache::instance().remove_(*this);
+}
+
+} // namespace audio
+} // namespace roc
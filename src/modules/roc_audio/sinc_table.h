@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/sinc_table.h
+//! @brief Sinc table.
+
+#ifndef ROC_AUDIO_SINC_TABLE_H_
+#define ROC_AUDIO_SINC_TABLE_H_
+
+#include "roc_audio/units.h"
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list_node.h"
+#include "roc_core/refcnt.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+//! Sinc table format.
+enum SincTableFormat {
+    //! Floating point values.
+    SincTableFormat_Float,
+
+    //! 16-bit fixed point values.
+    //! @remarks
+    //!  Table is two times smaller and fits better into CPU cache, at the cost
+    //!  of about -90 dB quantization noise.
+    SincTableFormat_Q15
+};
+
+//! Immutable table of windowed sinc values.
+//! @remarks
+//!  Holds positive half of the window, window_interp values per zero crossing,
+//!  plus two trailing zeros used by interpolation. Tables are shared between
+//!  resamplers via SincTableCache.
+class SincTable : public core::RefCnt<SincTable>, public core::ListNode {
+public:
+    //! Initialize and fill the table.
+    SincTable(core::IAllocator& allocator,
+              size_t window_size,
+              size_t window_interp,
+              SincTableFormat format);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Get number of zero crossings in half of the window.
+    size_t window_size() const;
+
+    //! Get number of values per zero crossing.
+    size_t window_interp() const;
+
+    //! Get table format.
+    SincTableFormat format() const;
+
+    //! Get table values.
+    //! @pre
+    //!  Table format should be SincTableFormat_Float.
+    const sample_t* data() const;
+
+    //! Get table values in fixed point.
+    //! @remarks
+    //!  1.0 is represented as ResamplerSincQ15One.
+    //! @pre
+    //!  Table format should be SincTableFormat_Q15.
+    const int16_t* data_q15() const;
+
+    //! Get number of table values.
+    size_t size() const;
+
+private:
+    friend class core::RefCnt<SincTable>;
+
+    void destroy();
+
+    const size_t window_size_;
+    const size_t window_interp_;
+    const SincTableFormat format_;
+
+    core::Array<sample_t> table_;
+    core::Array<int16_t> table_q15_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_SINC_TABLE_H_
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/sinc_table_cache.h"
+#include "roc_core/log.h"
+#include "roc_core/unique_ptr.h"
+
+namespace roc {
+namespace audio {
+
+SincTableCache::SincTableCache() {
+}
+
+core::SharedPtr<SincTable>
+SincTableCache::get(size_t window_size, size_t window_interp, SincTableFormat format) {
+    core::Mutex::Lock lock(mutex_);
+
+    for (SincTable* table = tables_.front(); table;) {
+        SincTable* next = tables_.nextof(*table);
+
+        if (table->window_size() == window_size
+            && table->window_interp() == window_interp && table->format() == format) {
+            // The counter may drop to zero concurrently, so it's incremented
+            // only if it's non-zero.
+            if (table->try_incref()) {
+                core::SharedPtr<SincTable> ptr(table);
+                table->decref();
+                return ptr;
+            }
+        }
+
+        // The counter became zero and remove_() is waiting for the mutex to
+        // destroy the table, so it's dead and should not be returned.
+        if (table->getref() == 0) {
+            tables_.remove(*table);
+        }
+
+        table = next;
+    }
+
+    core::UniquePtr<SincTable> table(
+        new (allocator_) SincTable(allocator_, window_size, window_interp, format),
+        allocator_);
+
+    if (!table || !table->valid()) {
+        roc_log(LogError,
+                "sinc table cache: can't create table:"
+                " window_size=%lu window_interp=%lu format=%d",
+                (unsigned long)window_size, (unsigned long)window_interp, (int)format);
+        return NULL;
+    }
+
+    roc_log(LogDebug,
+            "sinc table cache: created table:"
+            " window_size=%lu window_interp=%lu format=%d",
+            (unsigned long)window_size, (unsigned long)window_interp, (int)format);
+
+    tables_.push_back(*table);
+
+    return table.release();
+}
+
+size_t SincTableCache::num_tables() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return tables_.size();
+}
+
+void SincTableCache::remove_(SincTable& table) {
+    core::Mutex::Lock lock(mutex_);
+
+    roc_log(LogDebug,
+            "sinc table cache: removing table: window_size=%lu window_interp=%lu",
+            (unsigned long)table.window_size(), (unsigned long)table.window_interp());
+
+    // get() never returns a table after its counter became zero, so this
+    // is the only place where the table is destroyed, but get() could
+    // already remove it from the list.
+    if (table.list_node_data()->list == &tables_) {
+        tables_.remove(table);
+    }
+    allocator_.destroy(table);
+}
+
+} // namespace audio
+} // namespace roc
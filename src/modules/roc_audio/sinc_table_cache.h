@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/sinc_table_cache.h
+//! @brief Sinc table cache.
+
+#ifndef ROC_AUDIO_SINC_TABLE_CACHE_H_
+#define ROC_AUDIO_SINC_TABLE_CACHE_H_
+
+#include "roc_audio/sinc_table.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/list.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/singleton.h"
+
+namespace roc {
+namespace audio {
+
+//! Process-wide cache of sinc tables.
+//! @remarks
+//!  Resamplers with the same window parameters and table format share one
+//!  read-only table.
+//!  A table is freed when the last resampler using it is destroyed.
+//!  Thread-safe.
+class SincTableCache : public core::NonCopyable<> {
+public:
+    //! Get cache instance.
+    static SincTableCache& instance() {
+        return core::Singleton<SincTableCache>::instance();
+    }
+
+    //! Get table with given parameters.
+    //! @remarks
+    //!  Creates and fills a new table if there is no such table yet.
+    //! @returns
+    //!  NULL if the table can't be allocated.
+    core::SharedPtr<SincTable>
+    get(size_t window_size, size_t window_interp, SincTableFormat format);
+
+    //! Get number of tables currently in cache.
+    size_t num_tables() const;
+
+private:
+    friend class core::Singleton<SincTableCache>;
+    friend class SincTable;
+
+    SincTableCache();
+
+    void remove_(SincTable& table);
+
+    core::Mutex mutex_;
+
+    core::HeapAllocator allocator_;
+    core::List<SincTable, core::NoOwnership> tables_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_SINC_TABLE_CACHE_H_
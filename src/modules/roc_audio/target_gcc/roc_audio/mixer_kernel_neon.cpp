@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/mixer_kernel.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace roc {
+namespace audio {
+
+void mixer_add_neon(sample_t* acc, const sample_t* in, size_t n, float gain) {
+    const float32x4_t v_gain = vdupq_n_f32(gain);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(acc + i, vmlaq_f32(vld1q_f32(acc + i), vld1q_f32(in + i), v_gain));
+    }
+
+    mixer_add_scalar(acc + i, in + i, n - i, gain);
+}
+
+void mixer_clamp_neon(sample_t* data, size_t n) {
+    const float32x4_t v_min = vdupq_n_f32(SampleMin);
+    const float32x4_t v_max = vdupq_n_f32(SampleMax);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(data + i, vminq_f32(vmaxq_f32(vld1q_f32(data + i), v_min), v_max));
+    }
+
+    mixer_clamp_scalar(data + i, n - i);
+}
+
+} // namespace audio
+} // namespace roc
+
+#endif // defined(__ARM_NEON) || defined(__ARM_NEON__)
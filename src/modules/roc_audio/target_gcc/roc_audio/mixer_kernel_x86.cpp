@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/mixer_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include "roc_core/attributes.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+ROC_ATTR_TARGET("sse2")
+void mixer_add_sse(sample_t* acc, const sample_t* in, size_t n, float gain) {
+    const __m128 v_gain = _mm_set1_ps(gain);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i),
+                                          _mm_mul_ps(_mm_loadu_ps(in + i), v_gain)));
+    }
+
+    mixer_add_scalar(acc + i, in + i, n - i, gain);
+}
+
+ROC_ATTR_TARGET("sse2")
+void mixer_clamp_sse(sample_t* data, size_t n) {
+    const __m128 v_min = _mm_set1_ps(SampleMin);
+    const __m128 v_max = _mm_set1_ps(SampleMax);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(data + i,
+                      _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), v_min), v_max));
+    }
+
+    mixer_clamp_scalar(data + i, n - i);
+}
+
+ROC_ATTR_TARGET("avx2,fma")
+void mixer_add_avx2(sample_t* acc, const sample_t* in, size_t n, float gain) {
+    const __m256 v_gain = _mm256_set1_ps(gain);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(acc + i, _mm256_fmadd_ps(_mm256_loadu_ps(in + i), v_gain,
+                                                  _mm256_loadu_ps(acc + i)));
+    }
+
+    // Avoid AVX to SSE transition penalty in the non-VEX code we're calling.
+    _mm256_zeroupper();
+
+    mixer_add_scalar(acc + i, in + i, n - i, gain);
+}
+
+ROC_ATTR_TARGET("avx2,fma")
+void mixer_clamp_avx2(sample_t* data, size_t n) {
+    const __m256 v_min = _mm256_set1_ps(SampleMin);
+    const __m256 v_max = _mm256_set1_ps(SampleMax);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(data + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i),
+                                                               v_min),
+                                                 v_max));
+    }
+
+    _mm256_zeroupper();
+
+    mixer_clamp_scalar(data + i, n - i);
+}
+
+} // namespace audio
+} // namespace roc
+
+#endif // defined(__x86_64__) || defined(__i386__)
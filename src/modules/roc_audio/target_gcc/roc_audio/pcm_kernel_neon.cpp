@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/pcm_kernel.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Converts between host and network byte order.
+inline int16x8_t bswap16_neon(int16x8_t v) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return vreinterpretq_s16_u8(vrev16q_u8(vreinterpretq_u8_s16(v)));
+#else
+    return v;
+#endif
+}
+
+// Scales, saturates, and truncates four samples to 32-bit integers.
+inline int32x4_t to_int_neon(float32x4_t v) {
+    v = vmulq_n_f32(v, 32768.0f);
+    v = vminq_f32(v, vdupq_n_f32(+32767.0f));
+    v = vmaxq_f32(v, vdupq_n_f32(-32768.0f));
+    return vcvtq_s32_f32(v);
+}
+
+} // namespace
+
+void pcm_encode_int16_be_neon(int16_t* out, const sample_t* in, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x4_t v_lo = vqmovn_s32(to_int_neon(vld1q_f32(in + i)));
+        const int16x4_t v_hi = vqmovn_s32(to_int_neon(vld1q_f32(in + i + 4)));
+
+        vst1q_s16(out + i, bswap16_neon(vcombine_s16(v_lo, v_hi)));
+    }
+
+    pcm_encode_int16_be_scalar(out + i, in + i, n - i);
+}
+
+void pcm_decode_int16_be_neon(sample_t* out, const int16_t* in, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t v = bswap16_neon(vld1q_s16(in + i));
+
+        vst1q_f32(out + i,
+                  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), 1.0f / 32768.0f));
+        vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))),
+                                           1.0f / 32768.0f));
+    }
+
+    pcm_decode_int16_be_scalar(out + i, in + i, n - i);
+}
+
+} // namespace audio
+} // namespace roc
+
+#endif // defined(__ARM_NEON) || defined(__ARM_NEON__)
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/pcm_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include "roc_core/attributes.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// SSE2 has no byte shuffle, so swap bytes of every 16-bit word with shifts.
+ROC_ATTR_TARGET("sse2")
+inline __m128i bswap16_sse(__m128i v) {
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+// Scales, saturates, and truncates four samples to 32-bit integers.
+// Values are clamped before conversion because out of range floats are
+// converted to INT_MIN.
+ROC_ATTR_TARGET("sse2")
+inline __m128i to_int_sse(__m128 v) {
+    v = _mm_mul_ps(v, _mm_set1_ps(32768.0f));
+    v = _mm_min_ps(v, _mm_set1_ps(+32767.0f));
+    v = _mm_max_ps(v, _mm_set1_ps(-32768.0f));
+    return _mm_cvttps_epi32(v);
+}
+
+ROC_ATTR_TARGET("avx2")
+inline __m256i to_int_avx2(__m256 v) {
+    v = _mm256_mul_ps(v, _mm256_set1_ps(32768.0f));
+    v = _mm256_min_ps(v, _mm256_set1_ps(+32767.0f));
+    v = _mm256_max_ps(v, _mm256_set1_ps(-32768.0f));
+    return _mm256_cvttps_epi32(v);
+}
+
+} // namespace
+
+ROC_ATTR_TARGET("sse2")
+void pcm_encode_int16_be_sse(int16_t* out, const sample_t* in, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v_lo = to_int_sse(_mm_loadu_ps(in + i));
+        const __m128i v_hi = to_int_sse(_mm_loadu_ps(in + i + 4));
+
+        _mm_storeu_si128((__m128i*)(out + i), bswap16_sse(_mm_packs_epi32(v_lo, v_hi)));
+    }
+
+    pcm_encode_int16_be_scalar(out + i, in + i, n - i);
+}
+
+ROC_ATTR_TARGET("sse2")
+void pcm_decode_int16_be_sse(sample_t* out, const int16_t* in, size_t n) {
+    const __m128 v_scale = _mm_set1_ps(1.0f / 32768.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v = bswap16_sse(_mm_loadu_si128((const __m128i*)(in + i)));
+
+        // Put every word to the upper half of a dword and shift it back
+        // arithmetically to get sign extension.
+        const __m128i v_lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i v_hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v_lo), v_scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(v_hi), v_scale));
+    }
+
+    pcm_decode_int16_be_scalar(out + i, in + i, n - i);
+}
+
+ROC_ATTR_TARGET("avx2")
+void pcm_encode_int16_be_avx2(int16_t* out, const sample_t* in, size_t n) {
+    const __m256i v_bswap =
+        _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14, 1, 0, 3,
+                         2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i v_lo = to_int_avx2(_mm256_loadu_ps(in + i));
+        const __m256i v_hi = to_int_avx2(_mm256_loadu_ps(in + i + 8));
+
+        // Packing works within 128-bit lanes, so the result is
+        // [lo0-3 hi0-3 lo4-7 hi4-7]; restore the order of 64-bit quarters.
+        __m256i v = _mm256_packs_epi32(v_lo, v_hi);
+        v = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0));
+
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_shuffle_epi8(v, v_bswap));
+    }
+
+    // Avoid AVX to SSE transition penalty in the non-VEX code we're calling.
+    _mm256_zeroupper();
+
+    pcm_encode_int16_be_scalar(out + i, in + i, n - i);
+}
+
+ROC_ATTR_TARGET("avx2")
+void pcm_decode_int16_be_avx2(sample_t* out, const int16_t* in, size_t n) {
+    const __m128i v_bswap =
+        _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    const __m256 v_scale = _mm256_set1_ps(1.0f / 32768.0f);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v_lo =
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(in + i)), v_bswap);
+        const __m128i v_hi =
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(in + i + 8)), v_bswap);
+
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(
+                                                    _mm256_cvtepi16_epi32(v_lo)),
+                                                v_scale));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(
+                                                        _mm256_cvtepi16_epi32(v_hi)),
+                                                    v_scale));
+    }
+
+    _mm256_zeroupper();
+
+    pcm_decode_int16_be_scalar(out + i, in + i, n - i);
+}
+
+} // namespace audio
+} // namespace roc
+
+#endif // defined(__x86_64__) || defined(__i386__)
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/resampler_kernel.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+// Adds per-channel products to accumulators in memory, four channels at once.
+// Used when there are too many channels to keep accumulators in registers.
+void dot_multichannel_neon(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        const float32x4_t v_coeff = vdupq_n_f32(coeffs[i]);
+
+        size_t ch = 0;
+        for (; ch + 4 <= num_ch; ch += 4) {
+            vst1q_f32(acc + ch, vmlaq_f32(vld1q_f32(acc + ch), vld1q_f32(in + ch), v_coeff));
+        }
+        for (; ch < num_ch; ch++) {
+            acc[ch] += in[ch] * coeffs[i];
+        }
+
+        in += num_ch;
+    }
+}
+
+} // namespace
+
+void resampler_sinc_neon(sample_t* coeffs,
+                         const sample_t* table,
+                         size_t shift,
+                         size_t n,
+                         uint32_t pos,
+                         int32_t step,
+                         float fract) {
+    const uint32_t pos_init[4] = { pos, pos + (uint32_t)step, pos + (uint32_t)step * 2,
+                                   pos + (uint32_t)step * 3 };
+
+    const uint32x4_t v_step = vdupq_n_u32((uint32_t)step * 4);
+    const int32x4_t v_shift = vdupq_n_s32(-(int32_t)shift);
+    const float32x4_t v_fract = vdupq_n_f32(fract);
+
+    uint32x4_t v_pos = vld1q_u32(pos_init);
+
+    size_t i = 0;
+
+    // NEON has no gather, so table values are loaded one by one, while
+    // interpolation is vectorized.
+    for (; i + 4 <= n; i += 4) {
+        uint32_t index[4];
+        vst1q_u32(index, vshlq_u32(v_pos, v_shift));
+
+        const float hl[4] = { table[index[0]], table[index[1]], table[index[2]],
+                              table[index[3]] };
+        const float hh[4] = { table[index[0] + 1], table[index[1] + 1],
+                              table[index[2] + 1], table[index[3] + 1] };
+
+        const float32x4_t v_hl = vld1q_f32(hl);
+        const float32x4_t v_hh = vld1q_f32(hh);
+
+        vst1q_f32(coeffs + i, vmlaq_f32(v_hl, v_fract, vsubq_f32(v_hh, v_hl)));
+
+        v_pos = vaddq_u32(v_pos, v_step);
+    }
+
+    pos += (uint32_t)step * (uint32_t)i;
+
+    resampler_sinc_scalar(coeffs + i, table, shift, n - i, pos, step, fract);
+}
+
+void resampler_sinc_q15_neon(sample_t* coeffs,
+                             const int16_t* table,
+                             size_t shift,
+                             size_t n,
+                             uint32_t pos,
+                             int32_t step,
+                             float fract) {
+    const uint32_t pos_init[4] = { pos, pos + (uint32_t)step, pos + (uint32_t)step * 2,
+                                   pos + (uint32_t)step * 3 };
+
+    const uint32x4_t v_step = vdupq_n_u32((uint32_t)step * 4);
+    const int32x4_t v_shift = vdupq_n_s32(-(int32_t)shift);
+    const float32x4_t v_fract = vdupq_n_f32(fract);
+    const float32x4_t v_scale = vdupq_n_f32(1.0f / ResamplerSincQ15One);
+
+    uint32x4_t v_pos = vld1q_u32(pos_init);
+
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        uint32_t index[4];
+        vst1q_u32(index, vshlq_u32(v_pos, v_shift));
+
+        const int16_t hl[4] = { table[index[0]], table[index[1]], table[index[2]],
+                                table[index[3]] };
+        const int16_t hh[4] = { table[index[0] + 1], table[index[1] + 1],
+                                table[index[2] + 1], table[index[3] + 1] };
+
+        const float32x4_t v_hl = vcvtq_f32_s32(vmovl_s16(vld1_s16(hl)));
+        const float32x4_t v_hh = vcvtq_f32_s32(vmovl_s16(vld1_s16(hh)));
+
+        vst1q_f32(coeffs + i,
+                  vmulq_f32(vmlaq_f32(v_hl, v_fract, vsubq_f32(v_hh, v_hl)), v_scale));
+
+        v_pos = vaddq_u32(v_pos, v_step);
+    }
+
+    pos += (uint32_t)step * (uint32_t)i;
+
+    resampler_sinc_q15_scalar(coeffs + i, table, shift, n - i, pos, step, fract);
+}
+
+void resampler_dot_neon(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n) {
+    size_t i = 0;
+
+    switch (num_ch) {
+    case 1: {
+        float32x4_t v_acc = vdupq_n_f32(0);
+
+        for (; i + 4 <= n; i += 4) {
+            v_acc = vmlaq_f32(v_acc, vld1q_f32(in + i), vld1q_f32(coeffs + i));
+        }
+
+        float32x2_t v_sum = vadd_f32(vget_low_f32(v_acc), vget_high_f32(v_acc));
+        v_sum = vpadd_f32(v_sum, v_sum);
+
+        acc[0] += vget_lane_f32(v_sum, 0);
+    } break;
+
+    case 2: {
+        // Accumulators are [L R L R].
+        float32x4_t v_acc = vdupq_n_f32(0);
+
+        for (; i + 4 <= n; i += 4) {
+            // [c0 c0 c1 c1] and [c2 c2 c3 c3]
+            const float32x4x2_t v_coeff2 = vzipq_f32(vld1q_f32(coeffs + i),
+                                                     vld1q_f32(coeffs + i));
+
+            v_acc = vmlaq_f32(v_acc, vld1q_f32(in + i * 2), v_coeff2.val[0]);
+            v_acc = vmlaq_f32(v_acc, vld1q_f32(in + i * 2 + 4), v_coeff2.val[1]);
+        }
+
+        const float32x2_t v_sum = vadd_f32(vget_low_f32(v_acc), vget_high_f32(v_acc));
+
+        acc[0] += vget_lane_f32(v_sum, 0);
+        acc[1] += vget_lane_f32(v_sum, 1);
+    } break;
+
+    default:
+        dot_multichannel_neon(acc, coeffs, in, num_ch, n);
+        return;
+    }
+
+    resampler_dot_scalar(acc, coeffs + i, in + i * num_ch, num_ch, n - i);
+}
+
+} // namespace audio
+} // namespace roc
+
+#endif // defined(__ARM_NEON) || defined(__ARM_NEON__)
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/resampler_kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#include "roc_core/attributes.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+ROC_ATTR_TARGET("sse2")
+inline float hsum_sse(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+// Adds per-channel products to accumulators in memory, four channels at once.
+// Used when there are too many channels to keep accumulators in registers.
+ROC_ATTR_TARGET("sse2")
+void dot_multichannel_sse(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        const __m128 v_coeff = _mm_set1_ps(coeffs[i]);
+
+        size_t ch = 0;
+        for (; ch + 4 <= num_ch; ch += 4) {
+            _mm_storeu_ps(acc + ch,
+                          _mm_add_ps(_mm_loadu_ps(acc + ch),
+                                     _mm_mul_ps(_mm_loadu_ps(in + ch), v_coeff)));
+        }
+        for (; ch < num_ch; ch++) {
+            acc[ch] += in[ch] * coeffs[i];
+        }
+
+        in += num_ch;
+    }
+}
+
+ROC_ATTR_TARGET("avx2,fma")
+void dot_multichannel_avx2(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        const __m256 v_coeff = _mm256_set1_ps(coeffs[i]);
+
+        size_t ch = 0;
+        for (; ch + 8 <= num_ch; ch += 8) {
+            _mm256_storeu_ps(acc + ch, _mm256_fmadd_ps(_mm256_loadu_ps(in + ch), v_coeff,
+                                                       _mm256_loadu_ps(acc + ch)));
+        }
+        for (; ch < num_ch; ch++) {
+            acc[ch] += in[ch] * coeffs[i];
+        }
+
+        in += num_ch;
+    }
+
+    // Avoid AVX to SSE transition penalty in the non-VEX code we're returning to.
+    _mm256_zeroupper();
+}
+
+// Loads two adjacent table values as a single 32-bit word, the lower one
+// in the low half.
+inline int32_t load_q15_pair(const int16_t* table, size_t index) {
+    int32_t pair;
+    memcpy(&pair, table + index, sizeof(pair));
+    return pair;
+}
+
+} // namespace
+
+ROC_ATTR_TARGET("sse2")
+void resampler_sinc_sse(sample_t* coeffs,
+                        const sample_t* table,
+                        size_t shift,
+                        size_t n,
+                        uint32_t pos,
+                        int32_t step,
+                        float fract) {
+    const __m128 v_fract = _mm_set1_ps(fract);
+
+    size_t i = 0;
+
+    // SSE2 has no gather, so table values are loaded one by one, while
+    // interpolation is vectorized.
+    for (; i + 4 <= n; i += 4) {
+        const size_t i0 = pos >> shift;
+        const size_t i1 = (pos + (uint32_t)step) >> shift;
+        const size_t i2 = (pos + (uint32_t)step * 2) >> shift;
+        const size_t i3 = (pos + (uint32_t)step * 3) >> shift;
+
+        const __m128 v_hl = _mm_setr_ps(table[i0], table[i1], table[i2], table[i3]);
+        const __m128 v_hh =
+            _mm_setr_ps(table[i0 + 1], table[i1 + 1], table[i2 + 1], table[i3 + 1]);
+
+        _mm_storeu_ps(coeffs + i,
+                      _mm_add_ps(v_hl, _mm_mul_ps(v_fract, _mm_sub_ps(v_hh, v_hl))));
+
+        pos += (uint32_t)step * 4;
+    }
+
+    resampler_sinc_scalar(coeffs + i, table, shift, n - i, pos, step, fract);
+}
+
+ROC_ATTR_TARGET("sse2")
+void resampler_sinc_q15_sse(sample_t* coeffs,
+                            const int16_t* table,
+                            size_t shift,
+                            size_t n,
+                            uint32_t pos,
+                            int32_t step,
+                            float fract) {
+    const __m128 v_fract = _mm_set1_ps(fract);
+    const __m128 v_scale = _mm_set1_ps(1.0f / ResamplerSincQ15One);
+
+    size_t i = 0;
+
+    // Every load fetches both values needed for interpolation.
+    for (; i + 4 <= n; i += 4) {
+        const __m128i v_pair = _mm_setr_epi32(
+            load_q15_pair(table, pos >> shift),
+            load_q15_pair(table, (pos + (uint32_t)step) >> shift),
+            load_q15_pair(table, (pos + (uint32_t)step * 2) >> shift),
+            load_q15_pair(table, (pos + (uint32_t)step * 3) >> shift));
+
+        const __m128 v_hl =
+            _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(v_pair, 16), 16));
+        const __m128 v_hh = _mm_cvtepi32_ps(_mm_srai_epi32(v_pair, 16));
+
+        _mm_storeu_ps(
+            coeffs + i,
+            _mm_mul_ps(_mm_add_ps(v_hl, _mm_mul_ps(v_fract, _mm_sub_ps(v_hh, v_hl))),
+                       v_scale));
+
+        pos += (uint32_t)step * 4;
+    }
+
+    resampler_sinc_q15_scalar(coeffs + i, table, shift, n - i, pos, step, fract);
+}
+
+ROC_ATTR_TARGET("sse2")
+void resampler_dot_sse(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n) {
+    size_t i = 0;
+
+    switch (num_ch) {
+    case 1: {
+        __m128 v_acc = _mm_setzero_ps();
+
+        for (; i + 4 <= n; i += 4) {
+            v_acc = _mm_add_ps(v_acc,
+                               _mm_mul_ps(_mm_loadu_ps(in + i), _mm_loadu_ps(coeffs + i)));
+        }
+
+        acc[0] += hsum_sse(v_acc);
+    } break;
+
+    case 2: {
+        // Accumulators are [L R L R].
+        __m128 v_acc = _mm_setzero_ps();
+
+        for (; i + 4 <= n; i += 4) {
+            const __m128 v_coeff = _mm_loadu_ps(coeffs + i);
+
+            // [c0 c0 c1 c1] and [c2 c2 c3 c3]
+            const __m128 v_coeff_lo = _mm_unpacklo_ps(v_coeff, v_coeff);
+            const __m128 v_coeff_hi = _mm_unpackhi_ps(v_coeff, v_coeff);
+
+            v_acc = _mm_add_ps(v_acc, _mm_mul_ps(_mm_loadu_ps(in + i * 2), v_coeff_lo));
+            v_acc = _mm_add_ps(v_acc,
+                               _mm_mul_ps(_mm_loadu_ps(in + i * 2 + 4), v_coeff_hi));
+        }
+
+        v_acc = _mm_add_ps(v_acc, _mm_movehl_ps(v_acc, v_acc));
+
+        float sum[4];
+        _mm_storeu_ps(sum, v_acc);
+
+        acc[0] += sum[0];
+        acc[1] += sum[1];
+    } break;
+
+    default:
+        dot_multichannel_sse(acc, coeffs, in, num_ch, n);
+        return;
+    }
+
+    resampler_dot_scalar(acc, coeffs + i, in + i * num_ch, num_ch, n - i);
+}
+
+ROC_ATTR_TARGET("avx2,fma")
+void resampler_sinc_avx2(sample_t* coeffs,
+                         const sample_t* table,
+                         size_t shift,
+                         size_t n,
+                         uint32_t pos,
+                         int32_t step,
+                         float fract) {
+    const __m256i v_lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    const __m256i v_step = _mm256_set1_epi32(step * 8);
+    const __m128i v_shift = _mm_cvtsi32_si128((int)shift);
+    const __m256 v_fract = _mm256_set1_ps(fract);
+
+    __m256i v_pos = _mm256_add_epi32(_mm256_set1_epi32((int)pos),
+                                     _mm256_mullo_epi32(v_lane, _mm256_set1_epi32(step)));
+
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v_index = _mm256_srl_epi32(v_pos, v_shift);
+
+        const __m256 v_hl = _mm256_i32gather_ps(table, v_index, 4);
+        const __m256 v_hh = _mm256_i32gather_ps(table + 1, v_index, 4);
+
+        _mm256_storeu_ps(coeffs + i,
+                         _mm256_fmadd_ps(v_fract, _mm256_sub_ps(v_hh, v_hl), v_hl));
+
+        v_pos = _mm256_add_epi32(v_pos, v_step);
+    }
+
+    // Avoid AVX to SSE transition penalty in the non-VEX code we're calling.
+    _mm256_zeroupper();
+
+    pos += (uint32_t)step * (uint32_t)i;
+
+    resampler_sinc_scalar(coeffs + i, table, shift, n - i, pos, step, fract);
+}
+
+ROC_ATTR_TARGET("avx2,fma")
+void resampler_sinc_q15_avx2(sample_t* coeffs,
+                             const int16_t* table,
+                             size_t shift,
+                             size_t n,
+                             uint32_t pos,
+                             int32_t step,
+                             float fract) {
+    const __m256i v_lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    const __m256i v_step = _mm256_set1_epi32(step * 8);
+    const __m128i v_shift = _mm_cvtsi32_si128((int)shift);
+    const __m256 v_fract = _mm256_set1_ps(fract);
+    const __m256 v_scale = _mm256_set1_ps(1.0f / ResamplerSincQ15One);
+
+    __m256i v_pos = _mm256_add_epi32(_mm256_set1_epi32((int)pos),
+                                     _mm256_mullo_epi32(v_lane, _mm256_set1_epi32(step)));
+
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v_index = _mm256_srl_epi32(v_pos, v_shift);
+
+        // Gather 32-bit words with 16-bit scale, so that every lane gets both
+        // values needed for interpolation.
+        const __m256i v_pair = _mm256_i32gather_epi32((const int*)table, v_index, 2);
+
+        const __m256 v_hl =
+            _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(v_pair, 16), 16));
+        const __m256 v_hh = _mm256_cvtepi32_ps(_mm256_srai_epi32(v_pair, 16));
+
+        _mm256_storeu_ps(
+            coeffs + i,
+            _mm256_mul_ps(_mm256_fmadd_ps(v_fract, _mm256_sub_ps(v_hh, v_hl), v_hl),
+                          v_scale));
+
+        v_pos = _mm256_add_epi32(v_pos, v_step);
+    }
+
+    // Avoid AVX to SSE transition penalty in the non-VEX code we're calling.
+    _mm256_zeroupper();
+
+    pos += (uint32_t)step * (uint32_t)i;
+
+    resampler_sinc_q15_scalar(coeffs + i, table, shift, n - i, pos, step, fract);
+}
+
+ROC_ATTR_TARGET("avx2,fma")
+void resampler_dot_avx2(
+    sample_t* acc, const sample_t* coeffs, const sample_t* in, size_t num_ch, size_t n) {
+    size_t i = 0;
+
+    switch (num_ch) {
+    case 1: {
+        __m256 v_acc = _mm256_setzero_ps();
+
+        for (; i + 8 <= n; i += 8) {
+            v_acc = _mm256_fmadd_ps(_mm256_loadu_ps(in + i), _mm256_loadu_ps(coeffs + i),
+                                    v_acc);
+        }
+
+        const __m128 v_sum =
+            _mm_add_ps(_mm256_castps256_ps128(v_acc), _mm256_extractf128_ps(v_acc, 1));
+
+        acc[0] += hsum_sse(v_sum);
+    } break;
+
+    case 2: {
+        // Accumulators are [L R L R L R L R].
+        __m256 v_acc = _mm256_setzero_ps();
+
+        for (; i + 4 <= n; i += 4) {
+            const __m128 v_coeff = _mm_loadu_ps(coeffs + i);
+
+            // [c0 c0 c1 c1 c2 c2 c3 c3]
+            const __m256 v_coeff2 = _mm256_insertf128_ps(
+                _mm256_castps128_ps256(_mm_unpacklo_ps(v_coeff, v_coeff)),
+                _mm_unpackhi_ps(v_coeff, v_coeff), 1);
+
+            v_acc = _mm256_fmadd_ps(_mm256_loadu_ps(in + i * 2), v_coeff2, v_acc);
+        }
+
+        __m128 v_sum =
+            _mm_add_ps(_mm256_castps256_ps128(v_acc), _mm256_extractf128_ps(v_acc, 1));
+        v_sum = _mm_add_ps(v_sum, _mm_movehl_ps(v_sum, v_sum));
+
+        float sum[4];
+        _mm_storeu_ps(sum, v_sum);
+
+        acc[0] += sum[0];
+        acc[1] += sum[1];
+    } break;
+
+    default:
+        dot_multichannel_avx2(acc, coeffs, in, num_ch, n);
+        return;
+    }
+
+    // Avoid AVX to SSE transition penalty in the non-VEX code we're calling.
+    _mm256_zeroupper();
+
+    resampler_dot_scalar(acc, coeffs + i, in + i * num_ch, num_ch, n - i);
+}
+
+} // namespace audio
+} // namespace roc
+
+#endif // defined(__x86_64__) || defined(__i386__)
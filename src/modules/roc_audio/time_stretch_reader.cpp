@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/time_stretch_reader.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+const float MinScaling = 0.5f;
+const float MaxScaling = 1.5f;
+
+// Scaling closer to one than this is treated as no stretching.
+const float ScalingEpsilon = 1e-6f;
+
+// Segment position is first searched with this step and every this-th sample
+// used for comparison, then refined around the best match.
+const size_t CoarseStep = 4;
+
+size_t segment_len(const TimeStretchConfig& config, size_t sample_rate) {
+    const size_t len =
+        (size_t)packet::timestamp_from_ns(config.segment_length, sample_rate);
+    return len & ~(size_t)1;
+}
+
+size_t search_len(const TimeStretchConfig& config, size_t sample_rate) {
+    if (config.search_length <= 0) {
+        return 0;
+    }
+    return (size_t)packet::timestamp_from_ns(config.search_length, sample_rate);
+}
+
+} // namespace
+
+TimeStretchReader::TimeStretchReader(IReader& reader,
+                                     core::IAllocator& allocator,
+                                     const TimeStretchConfig& config,
+                                     size_t sample_rate,
+                                     packet::channel_mask_t channels)
+    : reader_(reader)
+    , num_ch_(packet::num_channels(channels))
+    , segment_len_(segment_len(config, sample_rate))
+    , hop_len_(segment_len_ / 2)
+    , search_len_(search_len(config, sample_rate))
+    , window_(allocator)
+    , input_(allocator)
+    , input_size_(0)
+    , tail_(allocator)
+    , output_(allocator)
+    , output_pos_(0)
+    , output_size_(0)
+    , natural_pos_(0)
+    , ideal_pos_(0)
+    , scaling_(1.0f)
+    , stretching_(false)
+    , flags_(0)
+    , valid_(false) {
+    roc_log(LogDebug,
+            "time stretch reader: initializing: segment_len=%lu search_len=%lu"
+            " num_ch=%lu",
+            (unsigned long)segment_len_, (unsigned long)search_len_,
+            (unsigned long)num_ch_);
+
+    if (num_ch_ == 0 || segment_len_ < 4 || search_len_ >= hop_len_) {
+        roc_log(LogError,
+                "time stretch reader: invalid config: segment_len=%lu search_len=%lu"
+                " num_ch=%lu",
+                (unsigned long)segment_len_, (unsigned long)search_len_,
+                (unsigned long)num_ch_);
+        return;
+    }
+
+    // Input holds the segment with its search range, the previous segment
+    // and the drift between them, which is less than a hop plus search range.
+    const size_t input_len = 2 * (segment_len_ + 2 * search_len_) + hop_len_;
+
+    if (!window_.resize(segment_len_) || !input_.resize(input_len * num_ch_)
+        || !tail_.resize(hop_len_ * num_ch_) || !output_.resize(hop_len_ * num_ch_)) {
+        roc_log(LogError, "time stretch reader: can't allocate buffers");
+        return;
+    }
+
+    // Periodic Hann window. Its halves sum to one, so overlapping segments
+    // taken from contiguous input reproduce the input.
+    for (size_t n = 0; n < segment_len_; n++) {
+        window_[n] =
+            (sample_t)(0.5 - 0.5 * std::cos(2 * M_PI * (double)n / (double)segment_len_));
+    }
+
+    valid_ = true;
+}
+
+bool TimeStretchReader::valid() const {
+    return valid_;
+}
+
+float TimeStretchReader::scaling() const {
+    return scaling_;
+}
+
+bool TimeStretchReader::set_scaling(float scaling) {
+    roc_panic_if(!valid_);
+
+    if (scaling < MinScaling || scaling > MaxScaling) {
+        roc_log(LogError,
+                "time stretch reader: scaling out of bounds: scaling=%.5f min=%.5f "
+                "max=%.5f",
+                (double)scaling, (double)MinScaling, (double)MaxScaling);
+        return false;
+    }
+
+    scaling_ = scaling;
+    return true;
+}
+
+void TimeStretchReader::read(Frame& frame) {
+    roc_panic_if(!valid_);
+
+    if (frame.size() % num_ch_ != 0) {
+        roc_panic("time stretch reader: unexpected frame size");
+    }
+
+    sample_t* data = frame.data();
+    size_t remaining = frame.size() / num_ch_;
+
+    flags_ = 0;
+
+    while (remaining != 0) {
+        if (output_pos_ == output_size_) {
+            const bool want_stretching = std::fabs(scaling_ - 1.0f) > ScalingEpsilon;
+
+            if (!stretching_ && !want_stretching && natural_pos_ == input_size_) {
+                Frame part(data, remaining * num_ch_);
+                reader_.read(part);
+
+                if (data == frame.data()) {
+                    frame.set_flags(part.flags());
+                    return;
+                }
+
+                flags_ |= part.flags();
+                break;
+            }
+
+            if (want_stretching && !stretching_) {
+                start_stretching_();
+            } else if (!want_stretching && stretching_) {
+                // remaining part of the last segment is the same as input
+                // starting from natural_pos_, so just continue copying from there
+                stretching_ = false;
+            }
+
+            if (stretching_) {
+                produce_stretch_hop_();
+            } else {
+                produce_copy_hop_();
+            }
+
+            shrink_input_();
+        }
+
+        const size_t n_samples = std::min(remaining, output_size_ - output_pos_);
+
+        memcpy(data, &output_[0] + output_pos_ * num_ch_,
+               n_samples * num_ch_ * sizeof(sample_t));
+
+        data += n_samples * num_ch_;
+        remaining -= n_samples;
+        output_pos_ += n_samples;
+    }
+
+    // buffered samples came from different input frames, so we can't say
+    // that the whole frame is blank
+    frame.set_flags(flags_ & ~(unsigned)Frame::FlagBlank);
+}
+
+void TimeStretchReader::produce_copy_hop_() {
+    const size_t n_samples = std::min(input_size_ - natural_pos_, hop_len_);
+
+    memcpy(&output_[0], &input_[0] + natural_pos_ * num_ch_,
+           n_samples * num_ch_ * sizeof(sample_t));
+
+    natural_pos_ += n_samples;
+
+    output_pos_ = 0;
+    output_size_ = n_samples;
+}
+
+void TimeStretchReader::start_stretching_() {
+    fill_input_(natural_pos_ + hop_len_);
+
+    const sample_t* in = &input_[0] + natural_pos_ * num_ch_;
+
+    for (size_t n = 0; n < hop_len_; n++) {
+        for (size_t ch = 0; ch < num_ch_; ch++) {
+            tail_[n * num_ch_ + ch] = in[n * num_ch_ + ch] * window_[hop_len_ + n];
+        }
+    }
+
+    ideal_pos_ = (float)natural_pos_;
+    stretching_ = true;
+
+    roc_log(LogDebug, "time stretch reader: started stretching: scaling=%.5f",
+            (double)scaling_);
+}
+
+void TimeStretchReader::produce_stretch_hop_() {
+    const size_t ideal_pos = (size_t)(ideal_pos_ + 0.5f);
+
+    fill_input_(std::max(ideal_pos + search_len_ + segment_len_, natural_pos_ + hop_len_));
+
+    const size_t pos = find_segment_();
+
+    const sample_t* head = &input_[0] + pos * num_ch_;
+    const sample_t* tail = head + hop_len_ * num_ch_;
+
+    for (size_t n = 0; n < hop_len_; n++) {
+        for (size_t ch = 0; ch < num_ch_; ch++) {
+            const size_t i = n * num_ch_ + ch;
+
+            output_[i] = tail_[i] + head[i] * window_[n];
+            tail_[i] = tail[i] * window_[hop_len_ + n];
+        }
+    }
+
+    natural_pos_ = pos + hop_len_;
+    ideal_pos_ += (float)hop_len_ * scaling_;
+
+    output_pos_ = 0;
+    output_size_ = hop_len_;
+}
+
+size_t TimeStretchReader::find_segment_() const {
+    const size_t ideal_pos = (size_t)(ideal_pos_ + 0.5f);
+
+    const size_t lo = ideal_pos > search_len_ ? ideal_pos - search_len_ : 0;
+    const size_t hi = ideal_pos + search_len_;
+
+    size_t best_pos = lo;
+    float best_similarity = segment_similarity_(lo, CoarseStep);
+
+    for (size_t pos = lo + CoarseStep; pos <= hi; pos += CoarseStep) {
+        const float similarity = segment_similarity_(pos, CoarseStep);
+        if (similarity > best_similarity) {
+            best_similarity = similarity;
+            best_pos = pos;
+        }
+    }
+
+    const size_t fine_lo = std::max(lo, best_pos > CoarseStep ? best_pos - CoarseStep : 0);
+    const size_t fine_hi = std::min(hi, best_pos + CoarseStep);
+
+    best_similarity = segment_similarity_(best_pos, 1);
+
+    for (size_t pos = fine_lo; pos <= fine_hi; pos++) {
+        if (pos == best_pos) {
+            continue;
+        }
+        const float similarity = segment_similarity_(pos, 1);
+        if (similarity > best_similarity) {
+            best_similarity = similarity;
+            best_pos = pos;
+        }
+    }
+
+    return best_pos;
+}
+
+// Normalized cross-correlation between the samples that would naturally follow
+// the last emitted segment and the head of a candidate segment.
+float TimeStretchReader::segment_similarity_(size_t pos, size_t stride) const {
+    const sample_t* expected = &input_[0] + natural_pos_ * num_ch_;
+    const sample_t* actual = &input_[0] + pos * num_ch_;
+
+    float corr = 0;
+    float energy = 0;
+
+    for (size_t n = 0; n < hop_len_; n += stride) {
+        for (size_t ch = 0; ch < num_ch_; ch++) {
+            const size_t i = n * num_ch_ + ch;
+
+            corr += expected[i] * actual[i];
+            energy += actual[i] * actual[i];
+        }
+    }
+
+    return corr / std::sqrt(energy + 1e-9f);
+}
+
+void TimeStretchReader::fill_input_(size_t end) {
+    if (end <= input_size_) {
+        return;
+    }
+
+    if (end * num_ch_ > input_.size()) {
+        roc_panic("time stretch reader: input buffer overflow: end=%lu size=%lu",
+                  (unsigned long)end, (unsigned long)(input_.size() / num_ch_));
+    }
+
+    Frame frame(&input_[0] + input_size_ * num_ch_, (end - input_size_) * num_ch_);
+    reader_.read(frame);
+
+    flags_ |= frame.flags();
+    input_size_ = end;
+}
+
+void TimeStretchReader::shrink_input_() {
+    size_t start = natural_pos_;
+
+    if (stretching_) {
+        const size_t ideal_pos = (size_t)ideal_pos_;
+        start = std::min(start, ideal_pos > search_len_ ? ideal_pos - search_len_ : 0);
+    }
+
+    if (start == 0) {
+        return;
+    }
+
+    memmove(&input_[0], &input_[0] + start * num_ch_,
+            (input_size_ - start) * num_ch_ * sizeof(sample_t));
+
+    input_size_ -= start;
+    natural_pos_ -= start;
+    ideal_pos_ -= (float)start;
+}
+
+} // namespace audio
+} // namespace roc
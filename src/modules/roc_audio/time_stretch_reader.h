@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/time_stretch_reader.h
+//! @brief Time stretching reader.
+
+#ifndef ROC_AUDIO_TIME_STRETCH_READER_H_
+#define ROC_AUDIO_TIME_STRETCH_READER_H_
+
+#include "roc_audio/frame.h"
+#include "roc_audio/ireader.h"
+#include "roc_audio/units.h"
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace audio {
+
+//! Time stretching parameters.
+struct TimeStretchConfig {
+    //! Length of overlapping segments, nanoseconds.
+    //! Longer segments are better for low frequencies, shorter segments
+    //! produce less audible echo on transients.
+    core::nanoseconds_t segment_length;
+
+    //! Maximum shift of a segment from its ideal position, nanoseconds.
+    //! Segments are shifted to match the waveform of the previous segment.
+    core::nanoseconds_t search_length;
+
+    TimeStretchConfig()
+        : segment_length(20 * core::Millisecond)
+        , search_length(5 * core::Millisecond) {
+    }
+};
+
+//! Changes stream duration without changing its pitch.
+//! @remarks
+//!  Implements WSOLA (waveform similarity overlap-add). Output is assembled
+//!  from Hann-windowed input segments overlapping by half. The position of
+//!  every next segment in the input advances by the scaled hop, and is then
+//!  adjusted within the search range to the point where the segment best
+//!  continues the waveform of the previous one.
+//!
+//!  When scaling is one, the reader drains buffered samples and then reads
+//!  directly into the output frame, so it costs nothing when not stretching.
+class TimeStretchReader : public IReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p reader specifies input audio stream used in read()
+    //!  - @p allocator is used to allocate buffers
+    //!  - @p config defines segment and search lengths
+    //!  - @p sample_rate is the number of samples per second per channel
+    //!  - @p channels is the bitmask of audio channels
+    TimeStretchReader(IReader& reader,
+                      core::IAllocator& allocator,
+                      const TimeStretchConfig& config,
+                      size_t sample_rate,
+                      packet::channel_mask_t channels);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Read audio frame.
+    virtual void read(Frame& frame);
+
+    //! Set stretch factor.
+    //! @remarks
+    //!  Defines how many input samples are consumed per output sample.
+    //!  Values above one shorten the stream, values below one lengthen it.
+    //!  The new factor is applied from the next segment.
+    //! @returns
+    //!  false if the factor is out of the supported range.
+    bool set_scaling(float scaling);
+
+    //! Get stretch factor.
+    float scaling() const;
+
+private:
+    void produce_hop_();
+    void produce_copy_hop_();
+    void produce_stretch_hop_();
+
+    void start_stretching_();
+    size_t find_segment_() const;
+    float segment_similarity_(size_t pos, size_t stride) const;
+
+    void fill_input_(size_t end);
+    void shrink_input_();
+
+    IReader& reader_;
+
+    const size_t num_ch_;
+    const size_t segment_len_;
+    const size_t hop_len_;
+    const size_t search_len_;
+
+    core::Array<sample_t> window_;
+
+    core::Array<sample_t> input_;
+    size_t input_size_;
+
+    core::Array<sample_t> tail_;
+
+    core::Array<sample_t> output_;
+    size_t output_pos_;
+    size_t output_size_;
+
+    // start of the samples following the last emitted segment
+    size_t natural_pos_;
+    // ideal start of the next segment
+    float ideal_pos_;
+
+    float scaling_;
+    bool stretching_;
+
+    unsigned flags_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_TIME_STRETCH_READER_H_
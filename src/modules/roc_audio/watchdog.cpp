@@ -80,6 +80,7 @@ void Watchdog::read(Frame& frame) {
         if (frame.size() != 0) {
             memset(frame.data(), 0, frame.size() * sizeof(sample_t));
         }
+        frame.set_flags(Frame::FlagBlank);
         return;
     }
 
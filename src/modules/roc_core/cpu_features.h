@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/cpu_features.h
+//! @brief CPU features.
+
+#ifndef ROC_CORE_CPU_FEATURES_H_
+#define ROC_CORE_CPU_FEATURES_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! CPU instruction set extension.
+enum CpuFeature {
+    CpuFeature_SSE2, //!< x86 SSE2.
+    CpuFeature_AVX2, //!< x86 AVX2.
+    CpuFeature_FMA,  //!< x86 FMA3.
+    CpuFeature_NEON  //!< ARM NEON.
+};
+
+//! Check if the CPU we're running on supports given instruction set extension.
+//! @remarks
+//!  Returns false for extensions of other architectures.
+bool cpu_supports(CpuFeature feature);
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_CPU_FEATURES_H_
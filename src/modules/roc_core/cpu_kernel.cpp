@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/cpu_kernel.h"
+#include "roc_core/cpu_features.h"
+
+namespace roc {
+namespace core {
+
+bool cpu_kernel_supported(CpuKernel kernel) {
+    switch (kernel) {
+    case CpuKernel_Scalar:
+        return true;
+
+    case CpuKernel_SSE:
+        return cpu_supports(CpuFeature_SSE2);
+
+    case CpuKernel_AVX2:
+        return cpu_supports(CpuFeature_AVX2) && cpu_supports(CpuFeature_FMA);
+
+    case CpuKernel_NEON:
+        return cpu_supports(CpuFeature_NEON);
+
+    default:
+        break;
+    }
+
+    return false;
+}
+
+const char* cpu_kernel_to_str(CpuKernel kernel) {
+    switch (kernel) {
+    case CpuKernel_Auto:
+        return "auto";
+    case CpuKernel_Scalar:
+        return "scalar";
+    case CpuKernel_SSE:
+        return "sse";
+    case CpuKernel_AVX2:
+        return "avx2";
+    case CpuKernel_NEON:
+        return "neon";
+    default:
+        break;
+    }
+    return "<invalid>";
+}
+
+} // namespace core
+} // namespace roc
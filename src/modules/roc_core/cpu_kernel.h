@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/cpu_kernel.h
+//! @brief CPU kernel dispatch.
+
+#ifndef ROC_CORE_CPU_KERNEL_H_
+#define ROC_CORE_CPU_KERNEL_H_
+
+#include "roc_core/helpers.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Kernel implementation.
+enum CpuKernel {
+    //! Select the fastest kernel supported by the CPU.
+    CpuKernel_Auto,
+
+    //! Portable scalar implementation.
+    CpuKernel_Scalar,
+
+    //! x86 SSE2 implementation.
+    CpuKernel_SSE,
+
+    //! x86 AVX2 and FMA implementation.
+    CpuKernel_AVX2,
+
+    //! ARM NEON implementation.
+    CpuKernel_NEON,
+
+    //! Number of kernels.
+    CpuKernel_Count
+};
+
+//! Check if the CPU we're running on can run given kernel.
+bool cpu_kernel_supported(CpuKernel kernel);
+
+//! Get kernel name.
+const char* cpu_kernel_to_str(CpuKernel kernel);
+
+//! Get the fastest kernel from @p table supported by the CPU.
+//! @remarks
+//!  @p table holds kernel functions indexed by CpuKernel. Kernels not
+//!  built for the current target are NULL.
+template <class Funcs>
+CpuKernel cpu_kernel_best(const Funcs* const (&table)[CpuKernel_Count]) {
+    const CpuKernel order[] = { CpuKernel_AVX2, CpuKernel_NEON, CpuKernel_SSE };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(order); n++) {
+        if (table[order[n]] && cpu_kernel_supported(order[n])) {
+            return order[n];
+        }
+    }
+
+    return CpuKernel_Scalar;
+}
+
+//! Get kernel functions from @p table.
+//! @returns
+//!  NULL if the kernel is not supported by the build or the CPU.
+template <class Funcs>
+const Funcs* cpu_kernel_funcs(const Funcs* const (&table)[CpuKernel_Count],
+                              CpuKernel kernel) {
+    if (kernel == CpuKernel_Auto) {
+        kernel = cpu_kernel_best(table);
+    }
+
+    if ((size_t)kernel >= CpuKernel_Count || !table[kernel]
+        || !cpu_kernel_supported(kernel)) {
+        return NULL;
+    }
+
+    return table[kernel];
+}
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_CPU_KERNEL_H_
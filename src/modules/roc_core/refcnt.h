@@ -48,6 +48,21 @@ public:
         ++counter_;
     }
 
+    //! Increment reference counter if it's non-zero.
+    //! @returns
+    //!  false if the counter is zero, i.e. the object is being destroyed.
+    bool try_incref() const {
+        for (;;) {
+            const long counter = counter_;
+            if (counter <= 0) {
+                return false;
+            }
+            if (counter_.compare_exchange(counter, counter + 1)) {
+                return true;
+            }
+        }
+    }
+
     //! Decrement reference counter.
     //! @remarks
     //!  Calls free() if reference counter becomes zero.
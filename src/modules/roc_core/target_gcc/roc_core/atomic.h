@@ -53,6 +53,13 @@ public:
         return __sync_sub_and_fetch(&value_, 1);
     }
 
+    //! Atomic compare-and-swap.
+    //! @returns
+    //!  true if the value was equal to @p expected and was set to @p desired.
+    bool compare_exchange(long expected, long desired) {
+        return __sync_bool_compare_and_swap(&value_, expected, desired);
+    }
+
 private:
     mutable long value_;
 };
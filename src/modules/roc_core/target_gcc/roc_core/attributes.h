@@ -24,6 +24,9 @@
 //! Structure's fields are packed.
 #define ROC_ATTR_PACKED __attribute__((packed))
 
+//! Function is compiled for given instruction set, e.g. "avx2".
+#define ROC_ATTR_TARGET(isa) __attribute__((target(isa)))
+
 //! Function gets printf-like arguments.
 #define ROC_ATTR_PRINTF(n_fmt_arg, n_var_arg)                                            \
     __attribute__((format(printf, n_fmt_arg, n_var_arg)))
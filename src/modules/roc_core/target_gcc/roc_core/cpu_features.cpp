@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/cpu_features.h"
+
+namespace roc {
+namespace core {
+
+bool cpu_supports(CpuFeature feature) {
+#if defined(__x86_64__) || defined(__i386__)
+    // May be called before static constructors, when the compiler runtime
+    // didn't initialize the CPU model yet.
+    __builtin_cpu_init();
+#endif
+
+    switch (feature) {
+#if defined(__x86_64__) || defined(__i386__)
+    case CpuFeature_SSE2:
+        return __builtin_cpu_supports("sse2");
+
+    case CpuFeature_AVX2:
+        return __builtin_cpu_supports("avx2");
+
+    case CpuFeature_FMA:
+        return __builtin_cpu_supports("fma");
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    case CpuFeature_NEON:
+        return true;
+#endif
+
+    default:
+        break;
+    }
+
+    return false;
+}
+
+} // namespace core
+} // namespace roc
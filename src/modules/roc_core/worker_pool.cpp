@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2020 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/worker_pool.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+WorkerPool::WorkerPool(size_t num_threads, IAllocator& allocator)
+    : task_cond_(mutex_)
+    , done_cond_(mutex_)
+    , workers_(allocator)
+    , allocator_(allocator)
+    , stop_(false)
+    , valid_(false) {
+    if (num_threads == 0) {
+        roc_log(LogError, "worker pool: number of threads can't be zero");
+        return;
+    }
+
+    if (!workers_.grow(num_threads)) {
+        roc_log(LogError, "worker pool: can't allocate workers array");
+        return;
+    }
+
+    for (size_t n = 0; n < num_threads; n++) {
+        Worker* worker = new (allocator_) Worker(*this);
+        if (!worker) {
+            roc_log(LogError, "worker pool: can't allocate worker");
+            return;
+        }
+
+        workers_.push_back(worker);
+
+        if (!worker->start()) {
+            roc_log(LogError, "worker pool: can't start worker thread");
+            return;
+        }
+    }
+
+    roc_log(LogDebug, "worker pool: started %lu thread(s)",
+            (unsigned long)workers_.size());
+
+    valid_ = true;
+}
+
+WorkerPool::~WorkerPool() {
+    stop_workers_();
+
+    if (tasks_.size() != 0) {
+        roc_panic("worker pool: destroying pool with scheduled tasks: n_tasks=%lu",
+                  (unsigned long)tasks_.size());
+    }
+}
+
+bool WorkerPool::valid() const {
+    return valid_;
+}
+
+size_t WorkerPool::num_threads() const {
+    return workers_.size();
+}
+
+void WorkerPool::schedule(WorkerTask& task, nanoseconds_t deadline) {
+    Mutex::Lock lock(mutex_);
+
+    if (task.state_ == WorkerTask::Pending || task.state_ == WorkerTask::Running) {
+        roc_panic("worker pool: attempting to schedule task which is already scheduled");
+    }
+
+    task.deadline_ = deadline;
+    task.state_ = WorkerTask::Pending;
+
+    WorkerTask* pos = tasks_.front();
+    while (pos && pos->deadline_ <= deadline) {
+        pos = tasks_.nextof(*pos);
+    }
+
+    if (pos) {
+        tasks_.insert_before(task, *pos);
+    } else {
+        tasks_.push_back(task);
+    }
+
+    task_cond_.broadcast();
+}
+
+bool WorkerPool::pending(const WorkerTask& task) const {
+    Mutex::Lock lock(mutex_);
+
+    return task.state_ == WorkerTask::Pending || task.state_ == WorkerTask::Running;
+}
+
+void WorkerPool::wait(WorkerTask& task) {
+    Mutex::Lock lock(mutex_);
+
+    if (task.state_ == WorkerTask::Pending) {
+        tasks_.remove(task);
+        execute_(task);
+        return;
+    }
+
+    while (task.state_ == WorkerTask::Running) {
+        done_cond_.wait();
+    }
+}
+
+void WorkerPool::cancel(WorkerTask& task) {
+    Mutex::Lock lock(mutex_);
+
+    if (task.state_ == WorkerTask::Pending) {
+        tasks_.remove(task);
+        task.state_ = WorkerTask::Idle;
+        return;
+    }
+
+    while (task.state_ == WorkerTask::Running) {
+        done_cond_.wait();
+    }
+}
+
+void WorkerPool::run_worker_() {
+    Mutex::Lock lock(mutex_);
+
+    for (;;) {
+        while (!stop_ && tasks_.size() == 0) {
+            task_cond_.wait();
+        }
+
+        if (stop_) {
+            break;
+        }
+
+        WorkerTask* task = tasks_.front();
+        tasks_.remove(*task);
+
+        execute_(*task);
+    }
+}
+
+void WorkerPool::execute_(WorkerTask& task) {
+    task.state_ = WorkerTask::Running;
+
+    mutex_.unlock();
+    task.execute();
+    mutex_.lock();
+
+    task.state_ = WorkerTask::Finished;
+    done_cond_.broadcast();
+}
+
+void WorkerPool::stop_workers_() {
+    {
+        Mutex::Lock lock(mutex_);
+
+        stop_ = true;
+        task_cond_.broadcast();
+    }
+
+    for (size_t n = 0; n < workers_.size(); n++) {
+        workers_[n]->join();
+        allocator_.destroy(*workers_[n]);
+    }
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/worker_pool.h
+//! @brief Worker thread pool.
+
+#ifndef ROC_CORE_WORKER_POOL_H_
+#define ROC_CORE_WORKER_POOL_H_
+
+#include "roc_core/array.h"
+#include "roc_core/cond.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/list.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
+#include "roc_core/worker_task.h"
+
+namespace roc {
+namespace core {
+
+//! Worker thread pool.
+//!
+//! Executes tasks in background threads. Pending tasks are ordered by their
+//! deadline, so that the task which is needed first is executed first.
+class WorkerPool : public NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @remarks
+    //!  Starts @p num_threads background threads.
+    WorkerPool(size_t num_threads, IAllocator& allocator);
+
+    //! Destroy.
+    //!
+    //! @remarks
+    //!  Waits until background threads finish. There should be no scheduled
+    //!  tasks at this point.
+    ~WorkerPool();
+
+    //! Check if the pool was successfully constructed.
+    bool valid() const;
+
+    //! Get number of background threads.
+    size_t num_threads() const;
+
+    //! Schedule task for asynchronous execution.
+    //!
+    //! @remarks
+    //!  @p deadline is an absolute timestamp in nanoseconds; tasks with earlier
+    //!  deadlines are executed first.
+    //!
+    //! @pre
+    //!  @p task should not be already scheduled.
+    void schedule(WorkerTask& task, nanoseconds_t deadline);
+
+    //! Check if task is scheduled and not yet finished.
+    bool pending(const WorkerTask& task) const;
+
+    //! Wait until task is finished.
+    //!
+    //! @remarks
+    //!  If the task was not picked by a background thread yet, it is executed
+    //!  in the calling thread, so that the caller never waits for other tasks.
+    //!  After this call the task may be scheduled again.
+    void wait(WorkerTask& task);
+
+    //! Cancel task.
+    //!
+    //! @remarks
+    //!  If the task was not picked by a background thread yet, it is removed from
+    //!  the queue without being executed. Otherwise, waits until it is finished.
+    //!  After this call the task may be scheduled again.
+    void cancel(WorkerTask& task);
+
+private:
+    class Worker : public Thread {
+    public:
+        Worker(WorkerPool& pool)
+            : pool_(pool) {
+        }
+
+    private:
+        virtual void run() {
+            pool_.run_worker_();
+        }
+
+        WorkerPool& pool_;
+    };
+
+    void run_worker_();
+    void execute_(WorkerTask& task);
+
+    void stop_workers_();
+
+    Mutex mutex_;
+    Cond task_cond_;
+    Cond done_cond_;
+
+    List<WorkerTask, NoOwnership> tasks_;
+    Array<Worker*> workers_;
+
+    IAllocator& allocator_;
+
+    bool stop_;
+    bool valid_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_WORKER_POOL_H_
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2020 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/worker_task.h
+//! @brief Worker pool task.
+
+#ifndef ROC_CORE_WORKER_TASK_H_
+#define ROC_CORE_WORKER_TASK_H_
+
+#include "roc_core/list_node.h"
+#include "roc_core/time.h"
+
+namespace roc {
+namespace core {
+
+class WorkerPool;
+
+//! Base class for tasks executed by WorkerPool.
+//!
+//! @remarks
+//!  The task object is owned by the caller. It should not be destroyed while
+//!  it is scheduled; use WorkerPool::wait() or WorkerPool::cancel() first.
+class WorkerTask : public ListNode {
+public:
+    WorkerTask()
+        : deadline_(0)
+        , state_(Idle) {
+    }
+
+    virtual ~WorkerTask() {
+    }
+
+    //! Execute task.
+    //! @remarks
+    //!  Invoked either from a worker thread or from the thread that waits
+    //!  for the task, but never concurrently.
+    virtual void execute() = 0;
+
+private:
+    friend class WorkerPool;
+
+    enum State { Idle, Pending, Running, Finished };
+
+    nanoseconds_t deadline_;
+    State state_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_WORKER_TASK_H_
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/block_adapter.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+// Repair packets are reserved for twice the reported loss rate, so that
+// the block survives moderate variations of the loss rate between reports.
+const float LossMargin = 2.0f;
+
+} // namespace
+
+BlockAdapter::BlockAdapter(const BlockAdapterConfig& config,
+                           const WriterConfig& writer_config,
+                           Writer& writer)
+    : writer_(writer)
+    , min_repair_packets_(config.min_repair_packets)
+    , max_repair_packets_(config.max_repair_packets)
+    , n_source_packets_(writer_config.n_source_packets)
+    , n_repair_packets_(writer_config.n_repair_packets) {
+    if (enabled() && min_repair_packets_ > max_repair_packets_) {
+        roc_panic("fec block adapter: min_repair_packets > max_repair_packets:"
+                  " min=%lu max=%lu",
+                  (unsigned long)min_repair_packets_,
+                  (unsigned long)max_repair_packets_);
+    }
+}
+
+bool BlockAdapter::enabled() const {
+    return max_repair_packets_ != 0;
+}
+
+size_t BlockAdapter::n_repair_packets() const {
+    return n_repair_packets_;
+}
+
+void BlockAdapter::update(const Feedback& feedback) {
+    if (!enabled()) {
+        return;
+    }
+
+    const size_t required = required_repair_packets_(feedback);
+
+    size_t rblen = n_repair_packets_;
+    if (required > rblen) {
+        rblen = required;
+    } else if (required < rblen) {
+        rblen--;
+    }
+
+    if (rblen == n_repair_packets_) {
+        return;
+    }
+
+    roc_log(LogDebug,
+            "fec block adapter: updating repair block length:"
+            " loss_rate=%.4f max_burst=%lu cur_rbl=%lu new_rbl=%lu",
+            (double)feedback.loss_rate, (unsigned long)feedback.max_burst,
+            (unsigned long)n_repair_packets_, (unsigned long)rblen);
+
+    if (!writer_.resize(n_source_packets_, rblen)) {
+        return;
+    }
+
+    n_repair_packets_ = rblen;
+}
+
+size_t BlockAdapter::required_repair_packets_(const Feedback& feedback) const {
+    const float expected_losses =
+        feedback.loss_rate * LossMargin * (float)n_source_packets_;
+
+    size_t required = (size_t)(expected_losses + 0.5f);
+
+    if (required < feedback.max_burst) {
+        required = feedback.max_burst;
+    }
+
+    if (required < min_repair_packets_) {
+        required = min_repair_packets_;
+    }
+    if (required > max_repair_packets_) {
+        required = max_repair_packets_;
+    }
+
+    return required;
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/block_adapter.h
+//! @brief FEC block length adapter.
+
+#ifndef ROC_FEC_BLOCK_ADAPTER_H_
+#define ROC_FEC_BLOCK_ADAPTER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_fec/feedback.h"
+#include "roc_fec/writer.h"
+
+namespace roc {
+namespace fec {
+
+//! FEC block length adapter parameters.
+struct BlockAdapterConfig {
+    //! Minimum number of repair packets per block.
+    size_t min_repair_packets;
+
+    //! Maximum number of repair packets per block.
+    //! If zero, block length is not adapted.
+    size_t max_repair_packets;
+
+    BlockAdapterConfig()
+        : min_repair_packets(1)
+        , max_repair_packets(0) {
+    }
+};
+
+//! FEC block length adapter.
+//!
+//! Adjusts the number of repair packets per block produced by fec::Writer
+//! according to loss reports from receiver. The number of source packets
+//! per block is kept unchanged since it determines the latency.
+//!
+//! The number of repair packets grows immediately when losses increase
+//! and shrinks by one packet per report when they decrease.
+class BlockAdapter : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config defines repair block length bounds
+    //!  - @p writer_config defines initial block length
+    //!  - @p writer is resized when reports arrive
+    BlockAdapter(const BlockAdapterConfig& config,
+                 const WriterConfig& writer_config,
+                 Writer& writer);
+
+    //! Check if adaptation is enabled.
+    bool enabled() const;
+
+    //! Get current number of repair packets per block.
+    size_t n_repair_packets() const;
+
+    //! Handle loss report.
+    void update(const Feedback& feedback);
+
+private:
+    size_t required_repair_packets_(const Feedback& feedback) const;
+
+    Writer& writer_;
+
+    const size_t min_repair_packets_;
+    const size_t max_repair_packets_;
+
+    const size_t n_source_packets_;
+    size_t n_repair_packets_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_BLOCK_ADAPTER_H_
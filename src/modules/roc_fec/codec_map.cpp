@@ -11,6 +11,8 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/unique_ptr.h"
+#include "roc_fec/xor_decoder.h"
+#include "roc_fec/xor_encoder.h"
 #include "roc_packet/fec_scheme_to_str.h"
 
 #ifdef ROC_TARGET_OPENFEC
@@ -38,6 +40,14 @@ ROC_ATTR_UNUSED I* ctor_func(const CodecConfig& config,
 
 CodecMap::CodecMap()
     : n_codecs_(0) {
+    {
+        Codec codec;
+        codec.encoder_ctor = ctor_func<IBlockEncoder, XorEncoder>;
+        codec.decoder_ctor = ctor_func<IBlockDecoder, XorDecoder>;
+
+        codec.scheme = packet::FEC_XOR_Parity;
+        add_codec_(codec);
+    }
 #ifdef ROC_TARGET_OPENFEC
     {
         Codec codec;
@@ -51,7 +51,7 @@ public:
                                core::IAllocator& allocator) const;
 
 private:
-    enum { MaxCodecs = 2 };
+    enum { MaxCodecs = 3 };
 
     struct Codec {
         packet::FECScheme scheme;
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/feedback.h
+//! @brief FEC loss feedback.
+
+#ifndef ROC_FEC_FEEDBACK_H_
+#define ROC_FEC_FEEDBACK_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/endian.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! Loss report sent by receiver to sender.
+struct Feedback {
+    //! Fraction of lost source packets, in range [0; 1].
+    float loss_rate;
+
+    //! Maximum number of consecutive lost source packets.
+    size_t max_burst;
+
+    Feedback()
+        : loss_rate(0)
+        , max_burst(0) {
+    }
+};
+
+//! Loss report header.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |             Magic             |    Version    |   Reserved    |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |           Loss Rate           |           Max Burst           |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+//!
+//! Loss rate is a fixed-point fraction, where 0xffff corresponds to 1.
+class ROC_ATTR_PACKED FeedbackHeader {
+private:
+    enum {
+        //! Magic value.
+        Magic = 0x5246,
+
+        //! Header version.
+        Version = 1,
+
+        //! Loss rate fixed-point scale.
+        LossScale = 0xffff
+    };
+
+    uint16_t magic_;
+    uint8_t version_;
+    uint8_t reserved_;
+    uint16_t loss_rate_;
+    uint16_t max_burst_;
+
+public:
+    //! Clear header and set magic and version.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+        magic_ = core::hton16(Magic);
+        version_ = Version;
+    }
+
+    //! Check magic and version.
+    bool valid() const {
+        return core::ntoh16(magic_) == Magic && version_ == Version;
+    }
+
+    //! Get report.
+    Feedback feedback() const {
+        Feedback fb;
+        fb.loss_rate = float(core::ntoh16(loss_rate_)) / LossScale;
+        fb.max_burst = core::ntoh16(max_burst_);
+        return fb;
+    }
+
+    //! Set report.
+    void set_feedback(const Feedback& fb) {
+        float loss_rate = fb.loss_rate;
+        if (loss_rate < 0) {
+            loss_rate = 0;
+        }
+        if (loss_rate > 1) {
+            loss_rate = 1;
+        }
+        loss_rate_ = core::hton16(uint16_t(loss_rate * LossScale + 0.5f));
+
+        size_t max_burst = fb.max_burst;
+        if (max_burst > 0xffff) {
+            max_burst = 0xffff;
+        }
+        max_burst_ = core::hton16(uint16_t(max_burst));
+    }
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_FEEDBACK_H_
@@ -183,6 +183,162 @@ public:
     }
 };
 
+//! XOR Source FEC Payload ID.
+//!
+//! @remarks
+//!  Has the same layout as LDPC_Source_PayloadID.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |   Source Block Number (SBN)   |   Encoding Symbol ID (ESI)    |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |    Source Block Length (k)    |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED XOR_Source_PayloadID {
+private:
+    //! Source block number.
+    uint16_t sbn_;
+
+    //! Encoding symbol ID.
+    uint16_t esi_;
+
+    //! Source block length.
+    uint16_t k_;
+
+public:
+    //! Get FEC scheme to which these packets belong to.
+    static packet::FECScheme fec_scheme() {
+        return packet::FEC_XOR_Parity;
+    }
+
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get source block number.
+    uint16_t sbn() const {
+        return core::ntoh16(sbn_);
+    }
+
+    //! Set source block number.
+    void set_sbn(uint16_t val) {
+        sbn_ = core::hton16(val);
+    }
+
+    //! Get encoding symbol ID.
+    uint16_t esi() const {
+        return core::ntoh16(esi_);
+    }
+
+    //! Set encoding symbol ID.
+    void set_esi(uint16_t val) {
+        esi_ = core::hton16(val);
+    }
+
+    //! Get source block length.
+    uint16_t k() const {
+        return core::ntoh16(k_);
+    }
+
+    //! Set source block length.
+    void set_k(uint16_t val) {
+        k_ = core::hton16(val);
+    }
+
+    //! Get number encoding symbols.
+    uint16_t n() const {
+        return 0;
+    }
+
+    //! Set number encoding symbols.
+    void set_n(uint16_t) {
+    }
+};
+
+//! XOR Repair FEC Payload ID.
+//!
+//! @remarks
+//!  Has the same layout as LDPC_Repair_PayloadID.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |   Source Block Number (SBN)   |   Encoding Symbol ID (ESI)    |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |    Source Block Length (k)    |  Number Encoding Symbols (n)  |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED XOR_Repair_PayloadID {
+private:
+    //! Source block number.
+    uint16_t sbn_;
+
+    //! Encoding symbol ID.
+    uint16_t esi_;
+
+    //! Source block length.
+    uint16_t k_;
+
+    //! Number encoding symbols.
+    uint16_t n_;
+
+public:
+    //! Get FEC scheme to which these packets belong to.
+    static packet::FECScheme fec_scheme() {
+        return packet::FEC_XOR_Parity;
+    }
+
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get source block number.
+    uint16_t sbn() const {
+        return core::ntoh16(sbn_);
+    }
+
+    //! Set source block number.
+    void set_sbn(uint16_t val) {
+        sbn_ = core::hton16(val);
+    }
+
+    //! Get encoding symbol ID.
+    uint16_t esi() const {
+        return core::ntoh16(esi_);
+    }
+
+    //! Set encoding symbol ID.
+    void set_esi(uint16_t val) {
+        esi_ = core::hton16(val);
+    }
+
+    //! Get source block length.
+    uint16_t k() const {
+        return core::ntoh16(k_);
+    }
+
+    //! Set source block length.
+    void set_k(uint16_t val) {
+        k_ = core::hton16(val);
+    }
+
+    //! Get number encoding symbols.
+    uint16_t n() const {
+        return core::ntoh16(n_);
+    }
+
+    //! Set number encoding symbols.
+    void set_n(uint16_t val) {
+        n_ = core::hton16(val);
+    }
+};
+
 //! Reed-Solomon Source or Repair Payload ID (for m=8).
 //!
 //! @code
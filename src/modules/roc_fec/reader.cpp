@@ -9,6 +9,7 @@
 #include "roc_fec/reader.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/time.h"
 #include "roc_packet/fec_scheme_to_str.h"
 
 namespace roc {
@@ -31,6 +32,15 @@ Reader::Reader(const ReaderConfig& config,
     , repair_queue_(0)
     , source_block_(allocator)
     , repair_block_(allocator)
+    , worker_pool_(NULL)
+    , decode_task_(*this)
+    , decode_scheduled_(false)
+    , decode_failed_(false)
+    , last_block_time_(0)
+    , packet_interval_(0)
+    , pending_block_(allocator)
+    , pending_sblen_(0)
+    , pending_payload_size_(0)
     , valid_(false)
     , alive_(true)
     , started_(false)
@@ -47,6 +57,12 @@ Reader::Reader(const ReaderConfig& config,
     valid_ = true;
 }
 
+Reader::~Reader() {
+    if (decode_scheduled_) {
+        worker_pool_->cancel(decode_task_);
+    }
+}
+
 bool Reader::valid() const {
     return valid_;
 }
@@ -59,6 +75,24 @@ bool Reader::alive() const {
     return alive_;
 }
 
+void Reader::set_worker_pool(core::WorkerPool& pool) {
+    roc_panic_if_not(valid());
+
+    if (n_packets_ != 0) {
+        roc_panic("fec reader: worker pool should be set before first packet");
+    }
+
+    worker_pool_ = &pool;
+}
+
+const LossStats& Reader::loss_stats() const {
+    return loss_stats_;
+}
+
+void Reader::reset_loss_stats() {
+    loss_stats_ = LossStats();
+}
+
 packet::PacketPtr Reader::read() {
     roc_panic_if_not(valid());
     if (!alive_) {
@@ -119,6 +153,10 @@ packet::PacketPtr Reader::get_first_packet_() {
 packet::PacketPtr Reader::get_next_packet_() {
     fill_block_();
 
+    if (worker_pool_) {
+        schedule_repair_();
+    }
+
     packet::PacketPtr pp = source_block_[next_packet_];
 
     do {
@@ -160,6 +198,8 @@ packet::PacketPtr Reader::get_next_packet_() {
 void Reader::next_block_() {
     roc_log(LogTrace, "fec reader: next block: sbn=%lu", (unsigned long)cur_sbn_);
 
+    update_loss_stats_();
+
     for (size_t n = 0; n < source_block_.size(); n++) {
         source_block_[n] = NULL;
     }
@@ -168,6 +208,20 @@ void Reader::next_block_() {
         repair_block_[n] = NULL;
     }
 
+    if (decode_scheduled_) {
+        drop_pending_repair_();
+    }
+
+    if (worker_pool_) {
+        const core::nanoseconds_t now = core::timestamp();
+
+        if (last_block_time_ != 0 && source_block_.size() != 0) {
+            packet_interval_ =
+                (now - last_block_time_) / (core::nanoseconds_t)source_block_.size();
+        }
+        last_block_time_ = now;
+    }
+
     cur_sbn_++;
     next_packet_ = 0;
 
@@ -180,7 +234,35 @@ void Reader::next_block_() {
     fill_block_();
 }
 
+void Reader::update_loss_stats_() {
+    size_t burst = 0;
+
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        const bool lost = !source_block_[n]
+            || (source_block_[n]->flags() & packet::Packet::FlagRestored);
+
+        if (lost) {
+            loss_stats_.n_lost_packets++;
+            burst++;
+            if (loss_stats_.max_burst < burst) {
+                loss_stats_.max_burst = burst;
+            }
+        } else {
+            burst = 0;
+        }
+    }
+
+    loss_stats_.n_source_packets += source_block_.size();
+}
+
 void Reader::try_repair_() {
+    if (decode_scheduled_) {
+        // either waits for the worker or decodes the block right here
+        // if the worker didn't start it yet
+        worker_pool_->wait(decode_task_);
+        finish_pending_repair_();
+    }
+
     if (!can_repair_) {
         return;
     }
@@ -235,6 +317,141 @@ void Reader::try_repair_() {
     can_repair_ = false;
 }
 
+void Reader::schedule_repair_() {
+    if (decode_scheduled_ || !can_repair_) {
+        return;
+    }
+
+    if (!source_block_resized_ || !repair_block_resized_ || !payload_resized_) {
+        return;
+    }
+
+    const size_t sblen = source_block_.size();
+    const size_t rblen = repair_block_.size();
+
+    size_t n_lost = 0, n_received = 0, first_lost = 0;
+
+    for (size_t n = 0; n < sblen; n++) {
+        if (source_block_[n]) {
+            n_received++;
+        } else if (n >= next_packet_) {
+            if (n_lost == 0) {
+                first_lost = n;
+            }
+            n_lost++;
+        }
+    }
+
+    for (size_t n = 0; n < rblen; n++) {
+        if (repair_block_[n]) {
+            n_received++;
+        }
+    }
+
+    // nothing to repair or not enough packets to repair anything yet
+    if (n_lost == 0 || n_received < sblen) {
+        return;
+    }
+
+    if (!pending_block_.resize(sblen + rblen)) {
+        roc_log(LogError,
+                "fec reader: can't allocate pending block memory, shutting down:"
+                " sblen=%lu rblen=%lu",
+                (unsigned long)sblen, (unsigned long)rblen);
+        alive_ = false;
+        return;
+    }
+
+    for (size_t n = 0; n < sblen; n++) {
+        if (source_block_[n]) {
+            pending_block_[n] = source_block_[n]->fec()->payload;
+        }
+    }
+
+    for (size_t n = 0; n < rblen; n++) {
+        if (repair_block_[n]) {
+            pending_block_[sblen + n] = repair_block_[n]->fec()->payload;
+        }
+    }
+
+    pending_sblen_ = sblen;
+    pending_payload_size_ = payload_size_;
+
+    decode_failed_ = false;
+    decode_scheduled_ = true;
+
+    // new packets will make repair possible again
+    can_repair_ = false;
+
+    // restored packets should be ready when the first lost packet is read
+    const core::nanoseconds_t deadline = core::timestamp()
+        + packet_interval_ * (core::nanoseconds_t)(first_lost - next_packet_);
+
+    worker_pool_->schedule(decode_task_, deadline);
+}
+
+void Reader::decode_pending_block_() {
+    const size_t sblen = pending_sblen_;
+    const size_t rblen = pending_block_.size() - sblen;
+
+    if (!decoder_.begin(sblen, rblen, pending_payload_size_)) {
+        decode_failed_ = true;
+        return;
+    }
+
+    for (size_t n = 0; n < sblen + rblen; n++) {
+        if (pending_block_[n]) {
+            decoder_.set(n, pending_block_[n]);
+        }
+    }
+
+    for (size_t n = 0; n < sblen; n++) {
+        if (!pending_block_[n]) {
+            pending_block_[n] = decoder_.repair(n);
+        }
+    }
+
+    decoder_.end();
+}
+
+void Reader::finish_pending_repair_() {
+    if (decode_failed_) {
+        roc_log(LogDebug,
+                "fec reader: can't begin decoder block, shutting down:"
+                " sbl=%lu rbl=%lu payload_size=%lu",
+                (unsigned long)pending_sblen_,
+                (unsigned long)(pending_block_.size() - pending_sblen_),
+                (unsigned long)pending_payload_size_);
+        alive_ = false;
+    } else {
+        for (size_t n = 0; n < pending_sblen_; n++) {
+            if (n < next_packet_ || source_block_[n] || !pending_block_[n]) {
+                continue;
+            }
+
+            packet::PacketPtr pp = parse_repaired_packet_(pending_block_[n]);
+            if (!pp) {
+                continue;
+            }
+
+            source_block_[n] = pp;
+        }
+    }
+
+    drop_pending_repair_();
+}
+
+void Reader::drop_pending_repair_() {
+    if (decode_scheduled_) {
+        worker_pool_->cancel(decode_task_);
+        decode_scheduled_ = false;
+    }
+
+    for (size_t n = 0; n < pending_block_.size(); n++) {
+        pending_block_[n] = core::Slice<uint8_t>();
+    }
+}
+
 packet::PacketPtr Reader::parse_repaired_packet_(const core::Slice<uint8_t>& buffer) {
     packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
     if (!pp) {
@@ -16,6 +16,7 @@
 #include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/slice.h"
+#include "roc_core/worker_pool.h"
 #include "roc_fec/iblock_decoder.h"
 #include "roc_packet/iparser.h"
 #include "roc_packet/ireader.h"
@@ -36,6 +37,26 @@ struct ReaderConfig {
     }
 };
 
+//! FEC reader loss statistics.
+struct LossStats {
+    //! Number of source packets in finished blocks.
+    size_t n_source_packets;
+
+    //! Number of source packets that didn't arrive.
+    //! @remarks
+    //!  Includes packets that were restored from repair packets.
+    size_t n_lost_packets;
+
+    //! Maximum number of consecutive source packets that didn't arrive.
+    size_t max_burst;
+
+    LossStats()
+        : n_source_packets(0)
+        , n_lost_packets(0)
+        , max_burst(0) {
+    }
+};
+
 //! FEC reader.
 class Reader : public packet::IReader, public core::NonCopyable<> {
 public:
@@ -57,6 +78,11 @@ public:
            packet::PacketPool& packet_pool,
            core::IAllocator& allocator);
 
+    //! Destroy.
+    //! @remarks
+    //!  Waits until the block being decoded in background is finished.
+    virtual ~Reader();
+
     //! Check if object is successfully constructed.
     bool valid() const;
 
@@ -66,20 +92,62 @@ public:
     //! Is decoder alive?
     bool alive() const;
 
+    //! Offload block decoding to a worker pool.
+    //!
+    //! @remarks
+    //!  When enabled, the block is decoded in background as soon as it has
+    //!  losses and enough packets are received, so that restored packets are
+    //!  usually ready when the reader reaches the lost packet. The task deadline
+    //!  is the time when the first lost packet is expected to be read, estimated
+    //!  from the duration of the previous block. If restored packets are not
+    //!  ready in time, read() waits for the decoding to finish.
+    //!
+    //! @pre
+    //!  Should be called before the first read().
+    void set_worker_pool(core::WorkerPool& pool);
+
+    //! Get loss statistics.
+    //! @remarks
+    //!  Accumulated over finished blocks since the last reset_loss_stats().
+    const LossStats& loss_stats() const;
+
+    //! Reset loss statistics.
+    void reset_loss_stats();
+
     //! Read packet.
     //! @remarks
     //!  When a packet loss is detected, try to restore it from repair packets.
     virtual packet::PacketPtr read();
 
 private:
+    class DecodeTask : public core::WorkerTask {
+    public:
+        DecodeTask(Reader& reader)
+            : reader_(reader) {
+        }
+
+    private:
+        virtual void execute() {
+            reader_.decode_pending_block_();
+        }
+
+        Reader& reader_;
+    };
+
     packet::PacketPtr read_();
 
     packet::PacketPtr get_first_packet_();
     packet::PacketPtr get_next_packet_();
 
     void next_block_();
+    void update_loss_stats_();
     void try_repair_();
 
+    void schedule_repair_();
+    void decode_pending_block_();
+    void finish_pending_repair_();
+    void drop_pending_repair_();
+
     packet::PacketPtr parse_repaired_packet_(const core::Slice<uint8_t>& buffer);
 
     void fetch_packets_();
@@ -120,6 +188,18 @@ private:
     core::Array<packet::PacketPtr> source_block_;
     core::Array<packet::PacketPtr> repair_block_;
 
+    core::WorkerPool* worker_pool_;
+    DecodeTask decode_task_;
+    bool decode_scheduled_;
+    bool decode_failed_;
+
+    core::nanoseconds_t last_block_time_;
+    core::nanoseconds_t packet_interval_;
+
+    core::Array<core::Slice<uint8_t> > pending_block_;
+    size_t pending_sblen_;
+    size_t pending_payload_size_;
+
     bool valid_;
 
     bool alive_;
@@ -137,6 +217,8 @@ private:
 
     unsigned n_packets_;
 
+    LossStats loss_stats_;
+
     const size_t max_sbn_jump_;
     const packet::FECScheme fec_scheme_;
 };
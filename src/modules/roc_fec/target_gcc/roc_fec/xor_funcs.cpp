@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+
+#include "roc_fec/xor_funcs.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+// GCC and Clang lower this type to SSE2 or NEON registers when available
+// and to plain integer operations otherwise
+typedef uint8_t vec_t __attribute__((vector_size(16)));
+
+enum { VecSize = sizeof(vec_t), Unroll = 4 };
+
+// memcpy() is compiled to a single unaligned load or store
+inline vec_t load(const uint8_t* ptr) {
+    vec_t v;
+    memcpy(&v, ptr, VecSize);
+    return v;
+}
+
+inline void store(uint8_t* ptr, vec_t v) {
+    memcpy(ptr, &v, VecSize);
+}
+
+} // namespace
+
+void xor_buffers(uint8_t* dst, const uint8_t* src, size_t size) {
+    size_t n = 0;
+
+    for (; n + VecSize * Unroll <= size; n += VecSize * Unroll) {
+        const vec_t d0 = load(dst + n) ^ load(src + n);
+        const vec_t d1 = load(dst + n + VecSize) ^ load(src + n + VecSize);
+        const vec_t d2 = load(dst + n + VecSize * 2) ^ load(src + n + VecSize * 2);
+        const vec_t d3 = load(dst + n + VecSize * 3) ^ load(src + n + VecSize * 3);
+
+        store(dst + n, d0);
+        store(dst + n + VecSize, d1);
+        store(dst + n + VecSize * 2, d2);
+        store(dst + n + VecSize * 3, d3);
+    }
+
+    for (; n + VecSize <= size; n += VecSize) {
+        store(dst + n, load(dst + n) ^ load(src + n));
+    }
+
+    for (; n < size; n++) {
+        dst[n] ^= src[n];
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -10,6 +10,7 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/random.h"
+#include "roc_core/time.h"
 #include "roc_packet/fec_scheme_to_str.h"
 
 namespace roc {
@@ -36,6 +37,17 @@ Writer::Writer(const WriterConfig& config,
     , packet_pool_(packet_pool)
     , buffer_pool_(buffer_pool)
     , repair_block_(allocator)
+    , worker_pool_(NULL)
+    , encode_task_(*this)
+    , encode_scheduled_(false)
+    , encode_failed_(false)
+    , encode_deadline_(0)
+    , last_block_time_(0)
+    , packet_interval_(0)
+    , source_block_(allocator)
+    , pending_source_block_(allocator)
+    , pending_repair_block_(allocator)
+    , pending_payload_size_(0)
     , first_packet_(true)
     , cur_sbn_((packet::blknum_t)core::random(packet::blknum_t(-1)))
     , cur_block_repair_sn_((packet::seqnum_t)core::random(packet::seqnum_t(-1)))
@@ -49,6 +61,16 @@ Writer::Writer(const WriterConfig& config,
     valid_ = true;
 }
 
+Writer::~Writer() {
+    if (encode_scheduled_) {
+        // repair packets of the last block are written instead of being dropped
+        worker_pool_->wait(encode_task_);
+        if (alive_) {
+            finish_pending_block_();
+        }
+    }
+}
+
 bool Writer::valid() const {
     return valid_;
 }
@@ -91,6 +113,16 @@ bool Writer::resize(size_t sblen, size_t rblen) {
     return true;
 }
 
+void Writer::set_worker_pool(core::WorkerPool& pool) {
+    roc_panic_if_not(valid());
+
+    if (!first_packet_) {
+        roc_panic("fec writer: worker pool should be set before first packet");
+    }
+
+    worker_pool_ = &pool;
+}
+
 void Writer::write(const packet::PacketPtr& pp) {
     roc_panic_if_not(valid());
     roc_panic_if_not(pp);
@@ -99,6 +131,18 @@ void Writer::write(const packet::PacketPtr& pp) {
         return;
     }
 
+    if (encode_scheduled_
+        && (!worker_pool_->pending(encode_task_)
+            || core::timestamp() >= encode_deadline_)) {
+        // if the deadline is reached, this either waits for the worker or
+        // encodes the block right here if it's not started
+        worker_pool_->wait(encode_task_);
+        finish_pending_block_();
+        if (!alive_) {
+            return;
+        }
+    }
+
     validate_fec_packet_(pp);
 
     if (first_packet_) {
@@ -135,6 +179,11 @@ bool Writer::begin_block_(const packet::PacketPtr& pp) {
             (unsigned long)cur_sbn_, (unsigned long)cur_sblen_, (unsigned long)cur_rblen_,
             (unsigned long)cur_payload_size_);
 
+    if (worker_pool_) {
+        // encoder is used only by the background task
+        return true;
+    }
+
     if (!encoder_.begin(cur_sblen_, cur_rblen_, cur_payload_size_)) {
         roc_log(LogError,
                 "fec writer: can't begin encoder block, shutting down:"
@@ -147,10 +196,15 @@ bool Writer::begin_block_(const packet::PacketPtr& pp) {
 }
 
 void Writer::end_block_() {
+    if (worker_pool_) {
+        schedule_block_();
+        return;
+    }
+
     make_repair_packets_();
     encode_repair_packets_();
-    compose_repair_packets_();
-    write_repair_packets_();
+    compose_repair_packets_(repair_block_);
+    write_repair_packets_(repair_block_);
 
     encoder_.end();
 }
@@ -161,6 +215,104 @@ void Writer::next_block_() {
     cur_packet_ = 0;
 }
 
+void Writer::schedule_block_() {
+    if (encode_scheduled_) {
+        // previous block is still being encoded; this either waits for
+        // the worker or encodes the block right here if it's not started
+        worker_pool_->wait(encode_task_);
+        finish_pending_block_();
+        if (!alive_) {
+            return;
+        }
+    }
+
+    make_repair_packets_();
+
+    if (!pending_source_block_.resize(cur_sblen_)
+        || !pending_repair_block_.resize(cur_rblen_)) {
+        roc_log(LogError,
+                "fec writer: can't allocate pending block memory, shutting down:"
+                " sblen=%lu rblen=%lu",
+                (unsigned long)cur_sblen_, (unsigned long)cur_rblen_);
+        alive_ = false;
+        return;
+    }
+
+    for (size_t i = 0; i < cur_sblen_; i++) {
+        pending_source_block_[i] = source_block_[i];
+        source_block_[i] = core::Slice<uint8_t>();
+    }
+
+    for (size_t i = 0; i < cur_rblen_; i++) {
+        pending_repair_block_[i] = repair_block_[i];
+        repair_block_[i] = NULL;
+    }
+
+    pending_payload_size_ = cur_payload_size_;
+
+    const core::nanoseconds_t now = core::timestamp();
+
+    if (last_block_time_ != 0) {
+        packet_interval_ = (now - last_block_time_) / (core::nanoseconds_t)cur_sblen_;
+    }
+    last_block_time_ = now;
+
+    // repair packets should be sent before the next source packet
+    encode_deadline_ = now + packet_interval_;
+
+    encode_failed_ = false;
+    encode_scheduled_ = true;
+
+    worker_pool_->schedule(encode_task_, encode_deadline_);
+}
+
+void Writer::encode_pending_block_() {
+    const size_t sblen = pending_source_block_.size();
+    const size_t rblen = pending_repair_block_.size();
+
+    if (!encoder_.begin(sblen, rblen, pending_payload_size_)) {
+        encode_failed_ = true;
+        return;
+    }
+
+    for (size_t i = 0; i < sblen; i++) {
+        encoder_.set(i, pending_source_block_[i]);
+    }
+
+    for (size_t i = 0; i < rblen; i++) {
+        if (pending_repair_block_[i]) {
+            encoder_.set(sblen + i, pending_repair_block_[i]->fec()->payload);
+        }
+    }
+
+    encoder_.fill();
+    encoder_.end();
+}
+
+void Writer::finish_pending_block_() {
+    encode_scheduled_ = false;
+
+    if (encode_failed_) {
+        roc_log(LogError,
+                "fec writer: can't begin encoder block, shutting down:"
+                " sblen=%lu rblen=%lu",
+                (unsigned long)pending_source_block_.size(),
+                (unsigned long)pending_repair_block_.size());
+        alive_ = false;
+    } else {
+        compose_repair_packets_(pending_repair_block_);
+        write_repair_packets_(pending_repair_block_);
+    }
+
+    for (size_t i = 0; i < pending_source_block_.size(); i++) {
+        pending_source_block_[i] = core::Slice<uint8_t>();
+    }
+
+    for (size_t i = 0; i < pending_repair_block_.size(); i++) {
+        pending_repair_block_[i] = NULL;
+    }
+}
+
 bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
     if (payload_size == 0) {
         roc_log(LogError, "fec writer: payload size can't be zero");
@@ -177,6 +329,16 @@ bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
         }
     }
 
+    if (worker_pool_ && source_block_.size() != sblen) {
+        if (!source_block_.resize(sblen)) {
+            roc_log(LogError,
+                    "fec writer: can't allocate source block memory, shutting down:"
+                    " cur_sbl=%lu new_sbl=%lu",
+                    (unsigned long)source_block_.size(), (unsigned long)sblen);
+            return (alive_ = false);
+        }
+    }
+
     cur_sblen_ = sblen;
     cur_rblen_ = rblen;
     cur_payload_size_ = payload_size;
@@ -185,7 +347,11 @@ bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
 }
 
 void Writer::write_source_packet_(const packet::PacketPtr& pp) {
-    encoder_.set(cur_packet_, pp->fec()->payload);
+    if (worker_pool_) {
+        source_block_[cur_packet_] = pp->fec()->payload;
+    } else {
+        encoder_.set(cur_packet_, pp->fec()->payload);
+    }
 
     pp->add_flags(packet::Packet::FlagComposed);
     fill_packet_fec_fields_(pp, (packet::seqnum_t)cur_packet_);
@@ -253,9 +419,9 @@ void Writer::encode_repair_packets_() {
     encoder_.fill();
 }
 
-void Writer::compose_repair_packets_() {
-    for (size_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = repair_block_[i];
+void Writer::compose_repair_packets_(core::Array<packet::PacketPtr>& block) {
+    for (size_t i = 0; i < block.size(); i++) {
+        packet::PacketPtr rp = block[i];
         if (!rp) {
             continue;
         }
@@ -268,12 +434,12 @@ void Writer::compose_repair_packets_() {
     }
 }
 
-void Writer::write_repair_packets_() {
-    for (packet::seqnum_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = repair_block_[i];
+void Writer::write_repair_packets_(core::Array<packet::PacketPtr>& block) {
+    for (size_t i = 0; i < block.size(); i++) {
+        packet::PacketPtr rp = block[i];
         if (rp) {
-            writer_.write(repair_block_[i]);
-            repair_block_[i] = NULL;
+            writer_.write(rp);
+            block[i] = NULL;
         }
     }
 }
@@ -17,6 +17,7 @@
 #include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/slice.h"
+#include "roc_core/worker_pool.h"
 #include "roc_fec/iblock_encoder.h"
 #include "roc_packet/icomposer.h"
 #include "roc_packet/iwriter.h"
@@ -64,6 +65,11 @@ public:
            core::BufferPool<uint8_t>& buffer_pool,
            core::IAllocator& allocator);
 
+    //! Destroy.
+    //! @remarks
+    //!  Waits until the block being encoded in background is finished.
+    virtual ~Writer();
+
     //! Check if object is successfully constructed.
     bool valid() const;
 
@@ -73,6 +79,21 @@ public:
     //! Set number of source packets per block.
     bool resize(size_t sblen, size_t rblen);
 
+    //! Offload block encoding to a worker pool.
+    //!
+    //! @remarks
+    //!  When enabled, the block is encoded in background after its last source
+    //!  packet is written. The task deadline is the time when the next source
+    //!  packet is expected, estimated from the duration of the previous block.
+    //!  Repair packets are written on the first write() call when encoding is
+    //!  finished or the deadline is reached, whichever comes first. Repair
+    //!  packets of the last block are written when the writer is destroyed,
+    //!  so the output writer should outlive it.
+    //!
+    //! @pre
+    //!  Should be called before the first write().
+    void set_worker_pool(core::WorkerPool& pool);
+
     //! Write packet.
     //! @remarks
     //!  - writes the given source packet to the output writer
@@ -80,18 +101,36 @@ public:
     virtual void write(const packet::PacketPtr&);
 
 private:
+    class EncodeTask : public core::WorkerTask {
+    public:
+        EncodeTask(Writer& writer)
+            : writer_(writer) {
+        }
+
+    private:
+        virtual void execute() {
+            writer_.encode_pending_block_();
+        }
+
+        Writer& writer_;
+    };
+
     bool begin_block_(const packet::PacketPtr& pp);
     void end_block_();
     void next_block_();
 
+    void schedule_block_();
+    void encode_pending_block_();
+    void finish_pending_block_();
+
     bool apply_sizes_(size_t sblen, size_t rblen, size_t payload_size);
 
     void write_source_packet_(const packet::PacketPtr&);
     void make_repair_packets_();
     packet::PacketPtr make_repair_packet_(packet::seqnum_t n);
     void encode_repair_packets_();
-    void compose_repair_packets_();
-    void write_repair_packets_();
+    void compose_repair_packets_(core::Array<packet::PacketPtr>& block);
+    void write_repair_packets_(core::Array<packet::PacketPtr>& block);
     void fill_packet_fec_fields_(const packet::PacketPtr& packet, packet::seqnum_t n);
 
     void validate_fec_packet_(const packet::PacketPtr&);
@@ -116,6 +155,20 @@ private:
 
     core::Array<packet::PacketPtr> repair_block_;
 
+    core::WorkerPool* worker_pool_;
+    EncodeTask encode_task_;
+    bool encode_scheduled_;
+    bool encode_failed_;
+    core::nanoseconds_t encode_deadline_;
+
+    core::nanoseconds_t last_block_time_;
+    core::nanoseconds_t packet_interval_;
+
+    core::Array<core::Slice<uint8_t> > source_block_;
+    core::Array<core::Slice<uint8_t> > pending_source_block_;
+    core::Array<packet::PacketPtr> pending_repair_block_;
+    size_t pending_payload_size_;
+
     bool first_packet_;
 
     packet::blknum_t cur_sbn_;
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/xor_decoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/xor_funcs.h"
+
+namespace roc {
+namespace fec {
+
+XorDecoder::XorDecoder(const CodecConfig& config,
+                       core::BufferPool<uint8_t>& buffer_pool,
+                       core::IAllocator& allocator)
+    : sblen_(0)
+    , rblen_(0)
+    , payload_size_(0)
+    , buffer_pool_(buffer_pool)
+    , buff_tab_(allocator)
+    , valid_(false) {
+    if (config.scheme != packet::FEC_XOR_Parity) {
+        roc_panic("xor decoder: unexpected fec scheme");
+    }
+
+    roc_log(LogDebug, "xor decoder: initializing");
+
+    valid_ = true;
+}
+
+bool XorDecoder::valid() const {
+    return valid_;
+}
+
+size_t XorDecoder::max_block_length() const {
+    roc_panic_if_not(valid());
+
+    return 0xffff;
+}
+
+bool XorDecoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if_not(valid());
+
+    if (!buff_tab_.resize(sblen + rblen)) {
+        return false;
+    }
+
+    sblen_ = sblen;
+    rblen_ = rblen;
+    payload_size_ = payload_size;
+
+    return true;
+}
+
+void XorDecoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if_not(valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("xor decoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (!buffer) {
+        roc_panic("xor decoder: null buffer");
+    }
+
+    if (buffer.size() == 0 || buffer.size() != payload_size_) {
+        roc_panic("xor decoder: invalid payload size: cur=%lu new=%lu",
+                  (unsigned long)payload_size_, (unsigned long)buffer.size());
+    }
+
+    if (buff_tab_[index]) {
+        roc_panic("xor decoder: can't overwrite buffer: index=%lu",
+                  (unsigned long)index);
+    }
+
+    buff_tab_[index] = buffer;
+}
+
+core::Slice<uint8_t> XorDecoder::repair(size_t index) {
+    roc_panic_if_not(valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("xor decoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (buff_tab_[index] || index >= sblen_ || !can_repair_(index)) {
+        return buff_tab_[index];
+    }
+
+    core::Slice<uint8_t> buffer = make_buffer_();
+    if (!buffer) {
+        return buffer;
+    }
+
+    const size_t column = index % rblen_;
+
+    memcpy(buffer.data(), buff_tab_[sblen_ + column].data(), payload_size_);
+
+    for (size_t s = column; s < sblen_; s += rblen_) {
+        if (s != index) {
+            xor_buffers(buffer.data(), buff_tab_[s].data(), payload_size_);
+        }
+    }
+
+    roc_log(LogTrace, "xor decoder: repaired packet: index=%lu", (unsigned long)index);
+
+    buff_tab_[index] = buffer;
+
+    return buffer;
+}
+
+void XorDecoder::end() {
+    roc_panic_if_not(valid());
+
+    for (size_t i = 0; i < buff_tab_.size(); ++i) {
+        buff_tab_[i] = core::Slice<uint8_t>();
+    }
+}
+
+bool XorDecoder::can_repair_(size_t index) const {
+    if (rblen_ == 0) {
+        return false;
+    }
+
+    const size_t column = index % rblen_;
+
+    if (!buff_tab_[sblen_ + column]) {
+        return false;
+    }
+
+    for (size_t s = column; s < sblen_; s += rblen_) {
+        if (s != index && !buff_tab_[s]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+core::Slice<uint8_t> XorDecoder::make_buffer_() {
+    core::Slice<uint8_t> buffer = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+
+    if (!buffer) {
+        roc_log(LogError, "xor decoder: can't allocate buffer");
+        return core::Slice<uint8_t>();
+    }
+
+    if (buffer.capacity() < payload_size_) {
+        roc_log(LogError, "xor decoder: packet size too large: size=%lu max=%lu",
+                (unsigned long)payload_size_, (unsigned long)buffer.capacity());
+        return core::Slice<uint8_t>();
+    }
+
+    buffer.resize(payload_size_);
+
+    return buffer;
+}
+
+} // namespace fec
+} // namespace roc
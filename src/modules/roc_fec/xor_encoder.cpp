@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/xor_encoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/xor_funcs.h"
+
+namespace roc {
+namespace fec {
+
+XorEncoder::XorEncoder(const CodecConfig& config,
+                       core::BufferPool<uint8_t>&,
+                       core::IAllocator& allocator)
+    : sblen_(0)
+    , rblen_(0)
+    , payload_size_(0)
+    , buff_tab_(allocator)
+    , valid_(false) {
+    if (config.scheme != packet::FEC_XOR_Parity) {
+        roc_panic("xor encoder: unexpected fec scheme");
+    }
+
+    roc_log(LogDebug, "xor encoder: initializing");
+
+    valid_ = true;
+}
+
+bool XorEncoder::valid() const {
+    return valid_;
+}
+
+size_t XorEncoder::alignment() const {
+    return Alignment;
+}
+
+size_t XorEncoder::max_block_length() const {
+    roc_panic_if_not(valid());
+
+    return 0xffff;
+}
+
+bool XorEncoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if_not(valid());
+
+    if (!buff_tab_.resize(sblen + rblen)) {
+        return false;
+    }
+
+    sblen_ = sblen;
+    rblen_ = rblen;
+    payload_size_ = payload_size;
+
+    return true;
+}
+
+void XorEncoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if_not(valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("xor encoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (!buffer) {
+        roc_panic("xor encoder: null buffer");
+    }
+
+    if (buffer.size() == 0 || buffer.size() != payload_size_) {
+        roc_panic("xor encoder: invalid payload size: cur=%lu new=%lu",
+                  (unsigned long)payload_size_, (unsigned long)buffer.size());
+    }
+
+    buff_tab_[index] = buffer;
+}
+
+void XorEncoder::fill() {
+    roc_panic_if_not(valid());
+
+    for (size_t r = 0; r < rblen_; r++) {
+        core::Slice<uint8_t>& repair = buff_tab_[sblen_ + r];
+        if (!repair) {
+            roc_panic("xor encoder: repair buffer not set: index=%lu",
+                      (unsigned long)(sblen_ + r));
+        }
+
+        bool first = true;
+
+        for (size_t s = r; s < sblen_; s += rblen_) {
+            if (!buff_tab_[s]) {
+                roc_panic("xor encoder: source buffer not set: index=%lu",
+                          (unsigned long)s);
+            }
+
+            if (first) {
+                memcpy(repair.data(), buff_tab_[s].data(), payload_size_);
+                first = false;
+            } else {
+                xor_buffers(repair.data(), buff_tab_[s].data(), payload_size_);
+            }
+        }
+
+        if (first) {
+            memset(repair.data(), 0, payload_size_);
+        }
+    }
+}
+
+void XorEncoder::end() {
+    roc_panic_if_not(valid());
+
+    for (size_t i = 0; i < buff_tab_.size(); ++i) {
+        buff_tab_[i] = core::Slice<uint8_t>();
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/xor_funcs.h
+//! @brief XOR functions.
+
+#ifndef ROC_FEC_XOR_FUNCS_H_
+#define ROC_FEC_XOR_FUNCS_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! XOR @p size bytes from @p src into @p dst.
+//!
+//! @remarks
+//!  Buffers may have any alignment but should not overlap.
+void xor_buffers(uint8_t* dst, const uint8_t* src, size_t size);
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_XOR_FUNCS_H_
@@ -138,6 +138,29 @@ packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address) {
     return task.writer;
 }
 
+packet::IWriter* Transceiver::add_udp_sender(packet::Address& bind_address,
+                                             packet::IWriter& inbound_writer) {
+    if (!valid()) {
+        roc_panic("transceiver: can't use invalid transceiver");
+    }
+
+    Task task;
+    task.fn = &Transceiver::add_udp_sender_;
+    task.address = &bind_address;
+    task.writer = NULL;
+    task.inbound_writer = &inbound_writer;
+
+    run_task_(task);
+
+    if (!task.result) {
+        if (task.port) {
+            wait_port_closed_(*task.port);
+        }
+    }
+
+    return task.writer;
+}
+
 void Transceiver::remove_port(packet::Address bind_address) {
     if (!valid()) {
         roc_panic("transceiver: can't use invalid transceiver");
@@ -288,7 +311,8 @@ bool Transceiver::add_udp_receiver_(Task& task) {
 
 bool Transceiver::add_udp_sender_(Task& task) {
     core::SharedPtr<UDPSenderPort> sp =
-        new (allocator_) UDPSenderPort(*this, *task.address, loop_, allocator_);
+        new (allocator_) UDPSenderPort(*this, *task.address, loop_, task.inbound_writer,
+                                       packet_pool_, buffer_pool_, allocator_);
     if (!sp) {
         roc_log(LogError, "transceiver: can't add port %s: can't allocate sender",
                 packet::address_to_str(*task.address).c_str());
@@ -83,6 +83,17 @@ public:
     //!  a new packet writer on success or null if error occurred
     packet::IWriter* add_udp_sender(packet::Address& bind_address);
 
+    //! Add UDP datagram sender port that also receives packets.
+    //!
+    //! Same as above, but packets received on the sender port, e.g. feedback
+    //! from the remote receiver, are passed to @p inbound_writer. Writer will
+    //! be called from the network thread. It should not block.
+    //!
+    //! @returns
+    //!  a new packet writer on success or null if error occurred
+    packet::IWriter* add_udp_sender(packet::Address& bind_address,
+                                    packet::IWriter& inbound_writer);
+
     //! Remove sender or receiver port. Wait until port will be removed.
     void remove_port(packet::Address bind_address);
 
@@ -92,6 +103,7 @@ private:
 
         packet::Address* address;
         packet::IWriter* writer;
+        packet::IWriter* inbound_writer;
         BasicPort* port;
 
         bool result;
@@ -101,6 +113,7 @@ private:
             : fn(NULL)
             , address(NULL)
             , writer(NULL)
+            , inbound_writer(NULL)
             , port(NULL)
             , result(false)
             , done(false) {
@@ -10,6 +10,8 @@
 #include "roc_core/helpers.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/time.h"
 #include "roc_packet/address_to_str.h"
 
 namespace roc {
@@ -18,13 +20,20 @@ namespace netio {
 UDPSenderPort::UDPSenderPort(ICloseHandler& close_handler,
                              const packet::Address& address,
                              uv_loop_t& event_loop,
+                             packet::IWriter* inbound_writer,
+                             packet::PacketPool& packet_pool,
+                             core::BufferPool<uint8_t>& buffer_pool,
                              core::IAllocator& allocator)
     : BasicPort(allocator)
     , close_handler_(close_handler)
     , loop_(event_loop)
     , write_sem_initialized_(false)
     , handle_initialized_(false)
+    , recv_started_(false)
     , address_(address)
+    , inbound_writer_(inbound_writer)
+    , packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
     , pending_(0)
     , stopped_(true)
     , closed_(false)
@@ -92,6 +101,16 @@ bool UDPSenderPort::open() {
         return false;
     }
 
+    if (inbound_writer_) {
+        if (int err = uv_udp_recv_start(&handle_, alloc_cb_, recv_cb_)) {
+            roc_log(LogError, "udp sender: uv_udp_recv_start(): [%s] %s",
+                    uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+
+        recv_started_ = true;
+    }
+
     roc_log(LogInfo, "udp sender: opened port %s",
             packet::address_to_str(address_).c_str());
 
@@ -227,6 +246,89 @@ void UDPSenderPort::send_cb_(uv_udp_send_t* req, int status) {
     }
 }
 
+void UDPSenderPort::alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf) {
+    roc_panic_if_not(handle);
+    roc_panic_if_not(buf);
+
+    UDPSenderPort& self = *(UDPSenderPort*)handle->data;
+
+    core::SharedPtr<core::Buffer<uint8_t> > bp =
+        new (self.buffer_pool_) core::Buffer<uint8_t>(self.buffer_pool_);
+
+    if (!bp) {
+        roc_log(LogError, "udp sender: can't allocate buffer");
+
+        buf->base = NULL;
+        buf->len = 0;
+
+        return;
+    }
+
+    if (size > bp->size()) {
+        size = bp->size();
+    }
+
+    bp->incref(); // will be decremented in recv_cb_()
+
+    buf->base = (char*)bp->data();
+    buf->len = size;
+}
+
+void UDPSenderPort::recv_cb_(uv_udp_t* handle,
+                             ssize_t nread,
+                             const uv_buf_t* buf,
+                             const sockaddr* sockaddr,
+                             unsigned flags) {
+    roc_panic_if_not(handle);
+    roc_panic_if_not(buf);
+
+    UDPSenderPort& self = *(UDPSenderPort*)handle->data;
+
+    if (!buf->base) {
+        return;
+    }
+
+    core::SharedPtr<core::Buffer<uint8_t> > bp =
+        core::Buffer<uint8_t>::container_of(buf->base);
+
+    // one reference for incref() called from alloc_cb_()
+    // one reference for the shared pointer above
+    roc_panic_if(bp->getref() != 2);
+
+    // decrement reference counter incremented in alloc_cb_()
+    bp->decref();
+
+    if (nread <= 0 || !sockaddr || (flags & UV_UDP_PARTIAL)) {
+        return;
+    }
+
+    packet::Address src_addr;
+    if (!src_addr.set_saddr(sockaddr)) {
+        roc_log(LogError, "udp sender: can't determine source address of inbound packet");
+        return;
+    }
+
+    roc_log(LogTrace, "udp sender: received packet: src=%s dst=%s nread=%ld",
+            packet::address_to_str(src_addr).c_str(),
+            packet::address_to_str(self.address_).c_str(), (long)nread);
+
+    packet::PacketPtr pp = new (self.packet_pool_) packet::Packet(self.packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "udp sender: can't allocate packet");
+        return;
+    }
+
+    pp->add_flags(packet::Packet::FlagUDP);
+
+    pp->udp()->src_addr = src_addr;
+    pp->udp()->dst_addr = self.address_;
+    pp->udp()->receive_timestamp = core::timestamp();
+
+    pp->set_data(core::Slice<uint8_t>(*bp, 0, (size_t)nread));
+
+    self.inbound_writer_->write(pp);
+}
+
 packet::PacketPtr UDPSenderPort::read_() {
     core::Mutex::Lock lock(mutex_);
 
@@ -250,6 +352,15 @@ void UDPSenderPort::close_() {
         return;
     }
 
+    if (recv_started_) {
+        if (int err = uv_udp_recv_stop(&handle_)) {
+            roc_log(LogError, "udp sender: uv_udp_recv_stop(): [%s] %s",
+                    uv_err_name(err), uv_strerror(err));
+        }
+
+        recv_started_ = false;
+    }
+
     if (handle_initialized_ && !uv_is_closing((uv_handle_t*)&handle_)) {
         roc_log(LogInfo, "udp sender: closing port %s",
                 packet::address_to_str(address_).c_str());
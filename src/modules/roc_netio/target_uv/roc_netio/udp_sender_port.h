@@ -14,6 +14,7 @@
 
 #include <uv.h>
 
+#include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/mutex.h"
 #include "roc_core/refcnt.h"
@@ -21,6 +22,7 @@
 #include "roc_netio/iclose_handler.h"
 #include "roc_packet/address.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
 
 namespace roc {
 namespace netio {
@@ -29,9 +31,16 @@ namespace netio {
 class UDPSenderPort : public BasicPort, public packet::IWriter {
 public:
     //! Initialize.
+    //!
+    //! @remarks
+    //!  If @p inbound_writer is not NULL, packets received on the port are
+    //!  passed to it.
     UDPSenderPort(ICloseHandler& close_handler,
                   const packet::Address&,
                   uv_loop_t& event_loop,
+                  packet::IWriter* inbound_writer,
+                  packet::PacketPool& packet_pool,
+                  core::BufferPool<uint8_t>& buffer_pool,
                   core::IAllocator& allocator);
 
     //! Destroy.
@@ -55,6 +64,12 @@ private:
     static void close_cb_(uv_handle_t* handle);
     static void write_sem_cb_(uv_async_t* handle);
     static void send_cb_(uv_udp_send_t* req, int status);
+    static void alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf);
+    static void recv_cb_(uv_udp_t* handle,
+                         ssize_t nread,
+                         const uv_buf_t* buf,
+                         const sockaddr* addr,
+                         unsigned flags);
 
     packet::PacketPtr read_();
     void close_();
@@ -69,8 +84,14 @@ private:
     uv_udp_t handle_;
     bool handle_initialized_;
 
+    bool recv_started_;
+
     packet::Address address_;
 
+    packet::IWriter* inbound_writer_;
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+
     core::List<packet::Packet> list_;
     core::Mutex mutex_;
 
@@ -13,7 +13,15 @@ namespace roc {
 namespace packet {
 
 ConcurrentQueue::ConcurrentQueue()
-    : cond_(mutex_) {
+    : cond_(mutex_)
+    , max_size_(0)
+    , blocking_(true) {
+}
+
+ConcurrentQueue::ConcurrentQueue(size_t max_size, bool blocking)
+    : cond_(mutex_)
+    , max_size_(max_size)
+    , blocking_(blocking) {
 }
 
 PacketPtr ConcurrentQueue::read() {
@@ -21,6 +29,9 @@ PacketPtr ConcurrentQueue::read() {
 
     PacketPtr packet;
     while (!(packet = list_.front())) {
+        if (!blocking_) {
+            return NULL;
+        }
         cond_.wait();
     }
 
@@ -36,6 +47,10 @@ void ConcurrentQueue::write(const PacketPtr& packet) {
 
     core::Mutex::Lock lock(mutex_);
 
+    if (max_size_ != 0 && list_.size() >= max_size_) {
+        return;
+    }
+
     list_.push_back(*packet);
     cond_.broadcast();
 }
@@ -7,7 +7,7 @@
  */
 
 //! @file roc_packet/concurrent_queue.h
-//! @brief Concurrent blocking packet queue.
+//! @brief Concurrent packet queue.
 
 #ifndef ROC_PACKET_CONCURRENT_QUEUE_H_
 #define ROC_PACKET_CONCURRENT_QUEUE_H_
@@ -23,26 +23,41 @@
 namespace roc {
 namespace packet {
 
-//! Concurrent blocking packet queue.
+//! Concurrent packet queue.
 class ConcurrentQueue : public IReader, public IWriter, public core::NonCopyable<> {
 public:
+    //! Initialize unbounded blocking queue.
     ConcurrentQueue();
 
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p max_size defines maximum number of packets in the queue,
+    //!    or zero if the queue is unbounded
+    //!  - @p blocking defines whether read() waits for a packet when
+    //!    the queue is empty
+    ConcurrentQueue(size_t max_size, bool blocking);
+
     //! Read next packet.
     //! @remarks
-    //!  Blocks until the queue becomes non-empty and returns the first
-    //!  packet from the queue.
+    //!  If the queue is blocking, blocks until the queue becomes non-empty
+    //!  and returns the first packet from the queue. Otherwise, returns
+    //!  NULL if the queue is empty.
     virtual PacketPtr read();
 
     //! Add packet to the queue.
     //! @remarks
-    //!  Adds packet to the end of the queue.
+    //!  Adds packet to the end of the queue. If the queue is full, the
+    //!  packet is dropped.
     virtual void write(const PacketPtr& packet);
 
 private:
     core::Mutex mutex_;
     core::Cond cond_;
     core::List<Packet> list_;
+
+    const size_t max_size_;
+    const bool blocking_;
 };
 
 } // namespace packet
@@ -28,7 +28,10 @@ enum FECScheme {
     FEC_ReedSolomon_M8,
 
     //! LDPC-Staircase.
-    FEC_LDPC_Staircase
+    FEC_LDPC_Staircase,
+
+    //! XOR parity.
+    FEC_XOR_Parity
 };
 
 //! FECFRAME packet.
@@ -124,6 +124,25 @@ bool Address::get_ip(char* buf, size_t bufsz) const {
     return true;
 }
 
+bool Address::same_ip(const Address& other) const {
+    if (family_() != other.family_()) {
+        return false;
+    }
+
+    switch (family_()) {
+    case AF_INET:
+        return sa_.addr4.sin_addr.s_addr == other.sa_.addr4.sin_addr.s_addr;
+
+    case AF_INET6:
+        return memcmp(sa_.addr6.sin6_addr.s6_addr, other.sa_.addr6.sin6_addr.s6_addr,
+                      sizeof(sa_.addr6.sin6_addr.s6_addr))
+            == 0;
+
+    default:
+        return false;
+    }
+}
+
 bool Address::operator==(const Address& other) const {
     if (family_() != other.family_()) {
         return false;
@@ -59,6 +59,9 @@ public:
     //! Get IP address.
     bool get_ip(char* buf, size_t bufsz) const;
 
+    //! Check whether both addresses have the same IP, ignoring port.
+    bool same_ip(const Address& other) const;
+
     //! Compare addresses.
     bool operator==(const Address& other) const;
 
@@ -19,6 +19,8 @@ const char* fec_scheme_to_str(FECScheme scheme) {
         return "rs8m";
     case FEC_LDPC_Staircase:
         return "ldpc";
+    case FEC_XOR_Parity:
+        return "xor";
     }
     return "?";
 }
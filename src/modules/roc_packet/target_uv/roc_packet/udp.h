@@ -16,6 +16,7 @@
 
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_packet/address.h"
 
 namespace roc {
@@ -29,8 +30,16 @@ struct UDP {
     //! Destination address.
     Address dst_addr;
 
+    //! Time when the packet was received, nanoseconds.
+    //! @remarks
+    //!  Zero if the packet was not received from network.
+    core::nanoseconds_t receive_timestamp;
+
     //! Sender request state.
     uv_udp_send_t request;
+
+    //! Construct zero UDP packet.
+    UDP();
 };
 
 } // namespace packet
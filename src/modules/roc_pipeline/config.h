@@ -14,15 +14,18 @@
 
 #include "roc_audio/latency_monitor.h"
 #include "roc_audio/resampler.h"
+#include "roc_audio/time_stretch_reader.h"
 #include "roc_audio/watchdog.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/time.h"
+#include "roc_fec/block_adapter.h"
 #include "roc_fec/codec_config.h"
 #include "roc_fec/reader.h"
 #include "roc_fec/writer.h"
 #include "roc_packet/units.h"
 #include "roc_pipeline/port.h"
 #include "roc_rtp/headers.h"
+#include "roc_rtp/nack_generator.h"
 #include "roc_rtp/validator.h"
 
 namespace roc {
@@ -49,6 +52,24 @@ const int DefaultMinLatencyFactor = -1;
 //! Default maximum latency relative to target latency.
 const int DefaultMaxLatencyFactor = 2;
 
+//! Default minimum adaptive target latency.
+const core::nanoseconds_t DefaultMinTargetLatency = 20 * core::Millisecond;
+
+//! Default time during which packets from rejected or shed senders are ignored.
+const core::nanoseconds_t DefaultRejectTimeout = core::Second;
+
+//! Default number of frames in asynchronous sender queue.
+const size_t DefaultAsyncQueueSize = 32;
+
+//! Asynchronous sender queue overflow policy.
+enum AsyncOverflowPolicy {
+    //! Block writer until sender thread frees space in queue.
+    AsyncOverflow_Block,
+
+    //! Drop samples that don't fit into queue.
+    AsyncOverflow_Drop
+};
+
 //! Port parameters.
 //! @remarks
 //!  On receiver, defines a listened port parameters. On sender,
@@ -76,6 +97,14 @@ struct SenderConfig {
     //! FEC encoder parameters.
     fec::CodecConfig fec_encoder;
 
+    //! FEC block length adapter parameters.
+    fec::BlockAdapterConfig fec_adapter;
+
+    //! How long sent packets are kept for retransmission, nanoseconds.
+    //! @remarks
+    //!  Used only if retransmission port is provided.
+    core::nanoseconds_t retransmission_buffer_length;
+
     //! Number of samples per second per channel.
     size_t input_sample_rate;
 
@@ -103,8 +132,23 @@ struct SenderConfig {
     //! Fill unitialized data with large values to make them more noticable.
     bool poisoning;
 
+    //! Encode and send packets in a separate thread.
+    //! @remarks
+    //!  If set, write() only copies samples to a queue, and a sender thread
+    //!  performs resampling, encoding, FEC, and writes packets to ports.
+    bool async;
+
+    //! Maximum number of frames in asynchronous sender queue.
+    //! @remarks
+    //!  Every frame holds up to internal_frame_size samples.
+    size_t async_queue_size;
+
+    //! What to do when asynchronous sender queue is full.
+    AsyncOverflowPolicy async_overflow;
+
     SenderConfig()
-        : input_sample_rate(DefaultSampleRate)
+        : retransmission_buffer_length(DefaultLatency)
+        , input_sample_rate(DefaultSampleRate)
         , input_channels(DefaultChannelMask)
         , internal_frame_size(DefaultInternalFrameSize)
         , packet_length(DefaultPacketLength)
@@ -112,7 +156,10 @@ struct SenderConfig {
         , resampling(false)
         , interleaving(false)
         , timing(false)
-        , poisoning(false) {
+        , poisoning(false)
+        , async(false)
+        , async_queue_size(DefaultAsyncQueueSize)
+        , async_overflow(AsyncOverflow_Block) {
     }
 };
 
@@ -123,6 +170,13 @@ struct ReceiverSessionConfig {
     //! Target latency, nanoseconds.
     core::nanoseconds_t target_latency;
 
+    //! Fast start latency, nanoseconds.
+    //! If non-zero, playback starts as soon as this amount of samples is
+    //! buffered, and the latency is then slowly grown to target latency by
+    //! slowing down playback. Requires resampling.
+    //! If zero, playback starts when target latency is buffered.
+    core::nanoseconds_t start_latency;
+
     //! Channel mask.
     packet::channel_mask_t channels;
 
@@ -135,6 +189,18 @@ struct ReceiverSessionConfig {
     //! FEC decoder parameters.
     fec::CodecConfig fec_decoder;
 
+    //! Interval between FEC loss reports sent to sender, nanoseconds.
+    //! If zero, loss reports are not sent.
+    core::nanoseconds_t fec_feedback_interval;
+
+    //! Request retransmission of lost packets.
+    //! @remarks
+    //!  Enabled automatically if receiver has a retransmission port.
+    bool retransmission;
+
+    //! NACK generator parameters.
+    rtp::NackConfig nack;
+
     //! RTP validator parameters.
     rtp::ValidatorConfig rtp_validator;
 
@@ -147,12 +213,29 @@ struct ReceiverSessionConfig {
     //! Resampler parameters.
     audio::ResamplerConfig resampler;
 
+    //! Quickly correct large latency deviations by time stretching.
+    //! @remarks
+    //!  The stream is compressed or expanded without changing pitch when the
+    //!  latency is far from the target, see LatencyMonitorConfig::stretch_threshold.
+    bool time_stretching;
+
+    //! Time stretcher parameters.
+    audio::TimeStretchConfig time_stretch;
+
     ReceiverSessionConfig()
         : target_latency(DefaultLatency)
+        , start_latency(0)
         , channels(DefaultChannelMask)
-        , payload_type(0) {
+        , payload_type(0)
+        , fec_feedback_interval(0)
+        , retransmission(false)
+        , time_stretching(false) {
         latency_monitor.min_latency = target_latency * DefaultMinLatencyFactor;
         latency_monitor.max_latency = target_latency * DefaultMaxLatencyFactor;
+        latency_monitor.min_target_latency = DefaultMinTargetLatency;
+        // leave room for jitter above the largest target
+        latency_monitor.max_target_latency =
+            target_latency + (latency_monitor.max_latency - target_latency) / 2;
     }
 };
 
@@ -181,6 +264,61 @@ struct ReceiverCommonConfig {
     //! Insert weird beeps instead of silence on packet loss.
     bool beeping;
 
+    //! Read sessions in parallel using the worker pool, if any.
+    bool parallel_sessions;
+
+    //! Mix all sessions into a single output stream.
+    //! @remarks
+    //!  If false, sessions are not mixed and should be read one by one
+    //!  using Receiver::read_session(). Sessions that are not read during
+    //!  the no playback timeout are removed.
+    bool mixing;
+
+    //! Number of idle sessions to keep constructed in advance.
+    //! @remarks
+    //!  Idle sessions are constructed for the parameters of the last created
+    //!  session, and are bound to new senders instead of constructing a session
+    //!  when the first packet from the sender is routed. Idle sessions are
+    //!  constructed in background, on the worker pool if it is available, and
+    //!  on a thread owned by the receiver otherwise. If zero, sessions are
+    //!  always constructed on demand.
+    size_t session_pool_size;
+
+    //! Parse and route packets on the thread writing packets to the receiver.
+    //! @remarks
+    //!  If true, Receiver::write() parses packets and puts them to per-session
+    //!  queues, and the thread reading frames only passes queued packets to
+    //!  sessions. Packets from new senders are still routed on the thread
+    //!  reading frames, since it is the thread that creates sessions.
+    bool route_on_write;
+
+    //! Maximum number of sessions.
+    //! @remarks
+    //!  Packets from new senders are rejected when this number of sessions
+    //!  is reached. If zero, the number of sessions is not limited.
+    size_t max_sessions;
+
+    //! Maximum number of packets per second accepted from a single sender.
+    //! @remarks
+    //!  Packets exceeding this rate are dropped. If zero, the rate is not limited.
+    size_t max_packet_rate;
+
+    //! Maximum time spent in a single Receiver::read(), in nanoseconds.
+    //! @remarks
+    //!  If a read takes longer, the most recently created session is removed.
+    //!  The last remaining session is never removed. If zero, the time is not
+    //!  limited. Not used when mixing is disabled.
+    core::nanoseconds_t read_budget;
+
+    //! Time during which packets from rejected or shed senders are ignored.
+    //! @remarks
+    //!  Applied to senders rejected because of max_sessions and to senders
+    //!  which session was removed because of read_budget. Prevents the same
+    //!  sender from trying to create a session on every packet. If a sender
+    //!  is removed because of read_budget again soon after it was re-admitted,
+    //!  the time is doubled for it, up to a limit.
+    core::nanoseconds_t reject_timeout;
+
     ReceiverCommonConfig()
         : output_sample_rate(DefaultSampleRate)
         , output_channels(DefaultChannelMask)
@@ -188,7 +326,15 @@ struct ReceiverCommonConfig {
         , resampling(false)
         , timing(false)
         , poisoning(false)
-        , beeping(false) {
+        , beeping(false)
+        , parallel_sessions(false)
+        , mixing(true)
+        , session_pool_size(0)
+        , route_on_write(false)
+        , max_sessions(0)
+        , max_packet_rate(0)
+        , read_budget(0)
+        , reject_timeout(DefaultRejectTimeout) {
     }
 };
 
@@ -21,7 +21,10 @@ enum PortType {
     Port_AudioSource,
 
     //! Audio repair packets.
-    Port_AudioRepair
+    Port_AudioRepair,
+
+    //! Retransmitted audio source packets.
+    Port_AudioRetransmission
 };
 
 //! Port protocol.
@@ -42,7 +45,16 @@ enum PortProtocol {
     Proto_RTP_LDPC_Source,
 
     //! FEC repair packet + FECFRAME LDPC header.
-    Proto_LDPC_Repair
+    Proto_LDPC_Repair,
+
+    //! RTP source packet + FECFRAME XOR parity footer.
+    Proto_RTP_XOR_Source,
+
+    //! FEC repair packet + FECFRAME XOR parity header.
+    Proto_XOR_Repair,
+
+    //! RTP retransmission packet (RFC 4588) of a source packet.
+    Proto_RTP_RTX
 };
 
 } // namespace pipeline
@@ -33,14 +33,52 @@ packet::FECScheme port_fec_scheme(PortProtocol proto) {
 
     case Proto_LDPC_Repair:
         return packet::FEC_LDPC_Staircase;
+
+    case Proto_RTP_XOR_Source:
+        return packet::FEC_XOR_Parity;
+
+    case Proto_XOR_Repair:
+        return packet::FEC_XOR_Parity;
+
+    case Proto_RTP_RTX:
+        return packet::FEC_None;
     }
 
     return packet::FEC_None;
 }
 
+PortProtocol port_source_protocol(packet::FECScheme fec_scheme) {
+    switch (fec_scheme) {
+    case packet::FEC_None:
+        return Proto_RTP;
+
+    case packet::FEC_ReedSolomon_M8:
+        return Proto_RTP_RSm8_Source;
+
+    case packet::FEC_LDPC_Staircase:
+        return Proto_RTP_LDPC_Source;
+
+    case packet::FEC_XOR_Parity:
+        return Proto_RTP_XOR_Source;
+    }
+
+    return Proto_None;
+}
+
 bool validate_port(packet::FECScheme fec_scheme,
                    PortProtocol port_protocol,
                    PortType port_type) {
+    if (port_type == Port_AudioRetransmission || port_protocol == Proto_RTP_RTX) {
+        if (port_type != Port_AudioRetransmission || port_protocol != Proto_RTP_RTX) {
+            roc_log(LogError,
+                    "bad ports configuration:"
+                    " %s port can't use protocol '%s'",
+                    port_type_to_str(port_type), port_proto_to_str(port_protocol));
+            return false;
+        }
+        return true;
+    }
+
     const packet::FECScheme port_scheme = port_fec_scheme(port_protocol);
 
     if (port_scheme != fec_scheme) {
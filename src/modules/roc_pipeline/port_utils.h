@@ -21,6 +21,9 @@ namespace pipeline {
 //! Get FEC scheme for given protocol.
 packet::FECScheme port_fec_scheme(PortProtocol proto);
 
+//! Get source port protocol for given FEC scheme.
+PortProtocol port_source_protocol(packet::FECScheme fec_scheme);
+
 //! Validate consistency of a single port and FEC scheme.
 bool validate_port(packet::FECScheme fec_scheme,
                    PortProtocol port_protocol,
@@ -10,37 +10,81 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_packet/address_to_str.h"
 #include "roc_pipeline/port_to_str.h"
 
 namespace roc {
 namespace pipeline {
 
+namespace {
+
+enum { MaxRejectedSenders = 64, MaxRejectBackoff = 32 };
+
+const core::nanoseconds_t LogInterval = 20 * core::Second;
+
+bool same_session_params(const ReceiverSessionConfig& a, const ReceiverSessionConfig& b) {
+    return a.payload_type == b.payload_type
+        && a.fec_decoder.scheme == b.fec_decoder.scheme
+        && a.retransmission == b.retransmission;
+}
+
+} // namespace
+
 Receiver::Receiver(const ReceiverConfig& config,
                    const fec::CodecMap& codec_map,
                    const rtp::FormatMap& format_map,
+                   core::WorkerPool* worker_pool,
                    packet::PacketPool& packet_pool,
                    core::BufferPool<uint8_t>& byte_buffer_pool,
                    core::BufferPool<audio::sample_t>& sample_buffer_pool,
                    core::IAllocator& allocator)
     : codec_map_(codec_map)
     , format_map_(format_map)
+    , worker_pool_(worker_pool)
+    , feedback_writer_(NULL)
     , packet_pool_(packet_pool)
     , byte_buffer_pool_(byte_buffer_pool)
     , sample_buffer_pool_(sample_buffer_pool)
     , allocator_(allocator)
+    , has_idle_session_config_(false)
+    , refilling_idle_sessions_(false)
+    , refill_pool_(worker_pool)
+    , refill_task_(*this)
+    , next_session_id_(1)
+    , rejected_senders_(allocator)
+    , num_rejected_sessions_(0)
+    , num_rejected_packets_(0)
+    , num_shed_sessions_(0)
+    , reject_rate_limiter_(LogInterval)
     , ticker_(config.common.output_sample_rate)
     , audio_reader_(NULL)
     , config_(config)
     , timestamp_(0)
     , num_channels_(packet::num_channels(config.common.output_channels))
     , active_cond_(control_mutex_) {
-    mixer_.reset(new (allocator_)
-                     audio::Mixer(sample_buffer_pool, config.common.internal_frame_size),
+    if (config.common.session_pool_size != 0 && !refill_pool_) {
+        // idle sessions should be constructed neither on the thread writing
+        // packets nor on the thread reading frames
+        own_worker_pool_.reset(new (allocator_) core::WorkerPool(1, allocator_),
+                               allocator_);
+        if (!own_worker_pool_ || !own_worker_pool_->valid()) {
+            roc_log(LogError, "receiver: can't create worker pool for idle sessions");
+            return;
+        }
+        refill_pool_ = own_worker_pool_.get();
+    }
+
+    mixer_.reset(new (allocator_) audio::Mixer(sample_buffer_pool, allocator_,
+                                               config.common.internal_frame_size),
                  allocator_);
     if (!mixer_ || !mixer_->valid()) {
         return;
     }
+    if (worker_pool_ && config.common.parallel_sessions) {
+        mixer_->set_worker_pool(*worker_pool_);
+    }
     audio::IReader* areader = mixer_.get();
 
     if (config.common.poisoning) {
@@ -54,10 +98,22 @@ Receiver::Receiver(const ReceiverConfig& config,
     audio_reader_ = areader;
 }
 
+Receiver::~Receiver() {
+    if (refill_pool_) {
+        refill_pool_->cancel(refill_task_);
+    }
+}
+
 bool Receiver::valid() {
     return audio_reader_;
 }
 
+void Receiver::set_feedback_writer(packet::IWriter& writer) {
+    roc_panic_if(!valid());
+
+    feedback_writer_ = &writer;
+}
+
 bool Receiver::add_port(const PortConfig& config) {
     roc_log(LogInfo, "receiver: adding port %s", port_to_str(config).c_str());
 
@@ -91,6 +147,69 @@ size_t Receiver::num_sessions() const {
     return sessions_.size();
 }
 
+size_t Receiver::num_idle_sessions() const {
+    core::Mutex::Lock lock(control_mutex_);
+
+    return idle_sessions_.size();
+}
+
+size_t Receiver::num_rejected_sessions() const {
+    core::Mutex::Lock lock(control_mutex_);
+
+    return num_rejected_sessions_;
+}
+
+size_t Receiver::num_shed_sessions() const {
+    core::Mutex::Lock lock(control_mutex_);
+
+    return num_shed_sessions_;
+}
+
+void Receiver::iterate_sessions(void (*fn)(void*, session_id_t, const packet::Address&),
+                                void* arg) const {
+    core::Mutex::Lock lock(control_mutex_);
+
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        fn(arg, sess->id(), sess->src_address());
+    }
+}
+
+bool Receiver::read_session(session_id_t id, audio::Frame& frame) {
+    roc_panic_if(!valid());
+
+    if (config_.common.mixing) {
+        roc_log(LogError, "receiver: can't read session, mixing is enabled");
+        return false;
+    }
+
+    core::Mutex::Lock pipeline_lock(pipeline_mutex_);
+
+    prepare_();
+
+    core::SharedPtr<ReceiverSession> sess;
+
+    {
+        core::Mutex::Lock lock(control_mutex_);
+
+        sess = find_session_(id);
+        if (!sess) {
+            return false;
+        }
+    }
+
+    sess->read(frame);
+
+    core::Mutex::Lock lock(control_mutex_);
+
+    if (!sess->update(sess->timestamp())) {
+        remove_session_(*sess);
+    }
+
+    return true;
+}
+
 size_t Receiver::sample_rate() const {
     return config_.common.output_sample_rate;
 }
@@ -114,14 +233,24 @@ void Receiver::wait_active() const {
 }
 
 void Receiver::write(const packet::PacketPtr& packet) {
-    core::Mutex::Lock lock(control_mutex_);
+    {
+        core::Mutex::Lock lock(control_mutex_);
 
-    const State old_state = state_();
+        const State old_state = state_();
 
-    packets_.push_back(*packet);
+        if (config_.common.route_on_write) {
+            enqueue_packet_(packet);
+        } else {
+            packets_.push_back(*packet);
+        }
 
-    if (old_state != Active) {
-        active_cond_.broadcast();
+        if (old_state != Active) {
+            active_cond_.broadcast();
+        }
+
+        if (config_.common.session_pool_size != 0) {
+            schedule_refill_();
+        }
     }
 }
 
@@ -132,11 +261,18 @@ bool Receiver::read(audio::Frame& frame) {
         ticker_.wait(timestamp_);
     }
 
+    const core::nanoseconds_t start_time =
+        config_.common.read_budget != 0 ? core::timestamp() : 0;
+
     prepare_();
 
     audio_reader_->read(frame);
     timestamp_ += frame.size() / num_channels_;
 
+    if (config_.common.read_budget != 0 && config_.common.mixing) {
+        shed_sessions_(core::timestamp() - start_time);
+    }
+
     return true;
 }
 
@@ -146,7 +282,18 @@ void Receiver::prepare_() {
     const State old_state = state_();
 
     fetch_packets_();
-    update_sessions_();
+
+    if (config_.common.route_on_write) {
+        flush_sessions_();
+    }
+
+    // if mixing is disabled, sessions are updated when they are read,
+    // and sessions that nobody reads are removed here
+    if (config_.common.mixing) {
+        update_sessions_();
+    } else {
+        remove_unread_sessions_();
+    }
 
     if (old_state != Active && state_() == Active) {
         active_cond_.broadcast();
@@ -165,6 +312,28 @@ sndio::ISource::State Receiver::state_() const {
     return Inactive;
 }
 
+void Receiver::enqueue_packet_(const packet::PacketPtr& packet) {
+    if (!parse_packet_(packet)) {
+        return;
+    }
+
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        if (sess->enqueue(packet)) {
+            return;
+        }
+    }
+
+    // drop packets from rejected senders before they reach the reading thread
+    if (!can_create_session_(packet)) {
+        return;
+    }
+
+    // packet is already parsed; fetch_packets_() will create a session for it
+    packets_.push_back(*packet);
+}
+
 void Receiver::fetch_packets_() {
     for (;;) {
         packet::PacketPtr packet = packets_.front();
@@ -174,7 +343,7 @@ void Receiver::fetch_packets_() {
 
         packets_.remove(*packet);
 
-        if (!parse_packet_(packet)) {
+        if (!config_.common.route_on_write && !parse_packet_(packet)) {
             continue;
         }
 
@@ -184,6 +353,14 @@ void Receiver::fetch_packets_() {
     }
 }
 
+void Receiver::flush_sessions_() {
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        sess->flush();
+    }
+}
+
 bool Receiver::parse_packet_(const packet::PacketPtr& packet) {
     core::SharedPtr<ReceiverPort> port;
 
@@ -220,9 +397,152 @@ bool Receiver::can_create_session_(const packet::PacketPtr& packet) {
         return false;
     }
 
+    if (packet->flags() & packet::Packet::FlagRetransmitted) {
+        roc_log(LogDebug, "receiver: ignoring retransmitted packet for unknown session");
+        return false;
+    }
+
+    if (!packet->udp()) {
+        return true;
+    }
+
+    const packet::Address& src_address = packet->udp()->src_addr;
+
+    if (is_rejected_(src_address)) {
+        num_rejected_packets_++;
+        return false;
+    }
+
+    if (config_.common.max_sessions != 0
+        && sessions_.size() >= config_.common.max_sessions) {
+        num_rejected_packets_++;
+
+        // if there are too many rejected senders, packets from the rest of them
+        // are dropped without remembering the sender
+        if (!reject_sender_(src_address, false)) {
+            return false;
+        }
+
+        num_rejected_sessions_++;
+
+        if (reject_rate_limiter_.allow()) {
+            roc_log(LogInfo,
+                    "receiver: rejecting sessions, too many sessions: src_addr=%s"
+                    " max_sessions=%lu rejected_sessions=%lu rejected_packets=%lu",
+                    packet::address_to_str(src_address).c_str(),
+                    (unsigned long)config_.common.max_sessions,
+                    (unsigned long)num_rejected_sessions_,
+                    (unsigned long)num_rejected_packets_);
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+bool Receiver::is_rejected_(const packet::Address& address) const {
+    for (size_t n = 0; n < rejected_senders_.size(); n++) {
+        if (rejected_senders_[n].address == address) {
+            return core::timestamp() < rejected_senders_[n].deadline;
+        }
+    }
+
+    return false;
+}
+
+bool Receiver::reject_sender_(const packet::Address& address, bool shed) {
+    const core::nanoseconds_t now = core::timestamp();
+
+    const size_t size = rejected_senders_.size();
+
+    size_t pos = size;
+    size_t free_pos = size;
+    size_t oldest = size;
+    core::nanoseconds_t oldest_time = 0;
+
+    // after the deadline, the sender is re-admitted, but is remembered
+    // for one more timeout, to detect if it is shed again
+    for (size_t n = 0; n < size; n++) {
+        const RejectedSender& sender = rejected_senders_[n];
+        if (sender.address == address) {
+            pos = n;
+            break;
+        }
+        const core::nanoseconds_t forget_time = sender.deadline + sender.timeout;
+        if (free_pos == size && forget_time <= now) {
+            free_pos = n;
+        }
+        if (oldest == size || forget_time < oldest_time) {
+            oldest = n;
+            oldest_time = forget_time;
+        }
+    }
+
+    core::nanoseconds_t timeout = config_.common.reject_timeout;
+
+    if (pos != size) {
+        const RejectedSender& sender = rejected_senders_[pos];
+
+        if (shed && now < sender.deadline + sender.timeout) {
+            // shed again soon after re-admission, so the overload is not over;
+            // wait longer before the next attempt
+            timeout = std::min(sender.timeout * 2,
+                               config_.common.reject_timeout * MaxRejectBackoff);
+        } else if (!shed) {
+            // keep the backoff of a shed sender
+            timeout = std::max(sender.timeout, timeout);
+        }
+    } else if (free_pos != size) {
+        pos = free_pos;
+    } else if (size < MaxRejectedSenders && rejected_senders_.resize(size + 1)) {
+        pos = size;
+    } else if (shed && oldest != size) {
+        // shed senders are always remembered, otherwise they would be
+        // re-admitted on the next packet and overload the receiver again
+        pos = oldest;
+    }
+
+    if (pos == rejected_senders_.size()) {
+        return false;
+    }
+
+    rejected_senders_[pos].address = address;
+    rejected_senders_[pos].timeout = timeout;
+    rejected_senders_[pos].deadline =
+        now + (shed ? timeout : config_.common.reject_timeout);
+
     return true;
 }
 
+void Receiver::shed_sessions_(core::nanoseconds_t elapsed) {
+    if (elapsed <= config_.common.read_budget) {
+        return;
+    }
+
+    core::Mutex::Lock lock(control_mutex_);
+
+    if (sessions_.size() <= 1) {
+        return;
+    }
+
+    // newest sessions are shed first, so that established senders keep playing
+    core::SharedPtr<ReceiverSession> sess = sessions_.back();
+
+    roc_log(LogInfo,
+            "receiver: read budget exceeded, shedding session: id=%lu"
+            " elapsed=%ldus budget=%ldus",
+            (unsigned long)sess->id(), (long)(elapsed / core::Microsecond),
+            (long)(config_.common.read_budget / core::Microsecond));
+
+    if (!reject_sender_(sess->src_address(), true)) {
+        roc_log(LogError, "receiver: can't allocate rejected sender");
+    }
+    remove_session_(*sess);
+
+    num_shed_sessions_++;
+}
+
 bool Receiver::create_session_(const packet::PacketPtr& packet) {
     if (!packet->udp()) {
         roc_log(LogError, "receiver: can't create session, unexpected non-udp packet");
@@ -243,13 +563,29 @@ bool Receiver::create_session_(const packet::PacketPtr& packet) {
             packet::address_to_str(src_address).c_str(),
             packet::address_to_str(dst_address).c_str());
 
-    core::SharedPtr<ReceiverSession> sess = new (allocator_)
-        ReceiverSession(sess_config, config_.common, src_address, codec_map_, format_map_,
-                        packet_pool_, byte_buffer_pool_, sample_buffer_pool_, allocator_);
+    core::SharedPtr<ReceiverSession> sess = take_idle_session_(sess_config);
 
-    if (!sess || !sess->valid()) {
-        roc_log(LogError, "receiver: can't create session, initialization failed");
-        return false;
+    if (sess) {
+        sess->bind(src_address);
+    } else {
+        sess = new_session_(sess_config, src_address);
+        if (!sess) {
+            return false;
+        }
+    }
+
+    if (config_.common.session_pool_size != 0) {
+        if (has_idle_session_config_
+            && !same_session_params(sess_config, idle_session_config_)) {
+            // idle sessions were constructed for other parameters; they will
+            // be destroyed by refill_idle_sessions_() outside of the lock
+            while (core::SharedPtr<ReceiverSession> idle = idle_sessions_.front()) {
+                idle_sessions_.remove(*idle);
+                stale_sessions_.push_back(*idle);
+            }
+        }
+        idle_session_config_ = sess_config;
+        has_idle_session_config_ = true;
     }
 
     if (!sess->handle(packet)) {
@@ -257,19 +593,141 @@ bool Receiver::create_session_(const packet::PacketPtr& packet) {
         return false;
     }
 
-    mixer_->add(sess->reader());
+    if (config_.common.mixing && !mixer_->add(sess->reader())) {
+        roc_log(LogError, "receiver: can't create session, can't add session to mixer");
+        return false;
+    }
+
+    sess->set_id(next_session_id_++);
     sessions_.push_back(*sess);
 
     return true;
 }
 
 void Receiver::remove_session_(ReceiverSession& sess) {
-    roc_log(LogInfo, "receiver: removing session");
+    roc_log(LogInfo, "receiver: removing session: id=%lu", (unsigned long)sess.id());
 
-    mixer_->remove(sess.reader());
+    if (config_.common.mixing) {
+        mixer_->remove(sess.reader());
+    }
     sessions_.remove(sess);
 }
 
+core::SharedPtr<ReceiverSession> Receiver::find_session_(session_id_t id) const {
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        if (sess->id() == id) {
+            break;
+        }
+    }
+
+    return sess;
+}
+
+core::SharedPtr<ReceiverSession>
+Receiver::new_session_(const ReceiverSessionConfig& sess_config,
+                       const packet::Address& src_address) {
+    core::SharedPtr<ReceiverSession> sess = new (allocator_)
+        ReceiverSession(sess_config, config_.common, src_address, codec_map_, format_map_,
+                        worker_pool_, feedback_writer_, packet_pool_, byte_buffer_pool_,
+                        sample_buffer_pool_, allocator_);
+
+    if (!sess || !sess->valid()) {
+        roc_log(LogError, "receiver: can't create session, initialization failed");
+        return NULL;
+    }
+
+    return sess;
+}
+
+core::SharedPtr<ReceiverSession>
+Receiver::take_idle_session_(const ReceiverSessionConfig& sess_config) {
+    if (!has_idle_session_config_
+        || !same_session_params(sess_config, idle_session_config_)) {
+        return NULL;
+    }
+
+    core::SharedPtr<ReceiverSession> sess = idle_sessions_.front();
+    if (!sess) {
+        roc_log(LogDebug, "receiver: no idle sessions, constructing new one");
+        return NULL;
+    }
+
+    idle_sessions_.remove(*sess);
+
+    return sess;
+}
+
+void Receiver::schedule_refill_() {
+    if (stale_sessions_.size() == 0
+        && idle_sessions_.size() >= config_.common.session_pool_size) {
+        return;
+    }
+
+    if (refill_pool_->pending(refill_task_)) {
+        return;
+    }
+
+    // sessions are needed only when a new sender connects, so refilling
+    // should not delay tasks needed for the current playback
+    refill_pool_->schedule(refill_task_,
+                           core::timestamp() + config_.default_session.target_latency);
+}
+
+void Receiver::refill_idle_sessions_() {
+    for (;;) {
+        core::SharedPtr<ReceiverSession> sess;
+        ReceiverSessionConfig sess_config;
+
+        {
+            core::Mutex::Lock lock(control_mutex_);
+
+            if (refilling_idle_sessions_) {
+                return;
+            }
+
+            // released after unlocking the mutex
+            sess = stale_sessions_.front();
+            if (sess) {
+                stale_sessions_.remove(*sess);
+                continue;
+            }
+
+            if (!has_idle_session_config_) {
+                if (!format_map_.format(config_.default_session.payload_type)) {
+                    return;
+                }
+                idle_session_config_ = make_session_config_(NULL);
+                has_idle_session_config_ = true;
+            }
+
+            if (idle_sessions_.size() >= config_.common.session_pool_size) {
+                return;
+            }
+
+            sess_config = idle_session_config_;
+            refilling_idle_sessions_ = true;
+        }
+
+        sess = new_session_(sess_config, packet::Address());
+
+        core::Mutex::Lock lock(control_mutex_);
+
+        refilling_idle_sessions_ = false;
+
+        if (!sess) {
+            return;
+        }
+
+        if (!same_session_params(sess_config, idle_session_config_)) {
+            continue;
+        }
+
+        idle_sessions_.push_back(*sess);
+    }
+}
+
 void Receiver::update_sessions_() {
     core::SharedPtr<ReceiverSession> curr, next;
 
@@ -282,20 +740,44 @@ void Receiver::update_sessions_() {
     }
 }
 
+void Receiver::remove_unread_sessions_() {
+    const core::nanoseconds_t now = core::timestamp();
+
+    core::SharedPtr<ReceiverSession> curr, next;
+
+    for (curr = sessions_.front(); curr; curr = next) {
+        next = sessions_.nextof(*curr);
+
+        if (curr->read_timeout_expired(now)) {
+            roc_log(LogInfo, "receiver: removing session that is not read: id=%lu",
+                    (unsigned long)curr->id());
+            remove_session_(*curr);
+        }
+    }
+}
+
 ReceiverSessionConfig
 Receiver::make_session_config_(const packet::PacketPtr& packet) const {
     ReceiverSessionConfig sess_config = config_.default_session;
 
-    packet::RTP* rtp = packet->rtp();
+    packet::RTP* rtp = packet ? packet->rtp() : NULL;
     if (rtp) {
         sess_config.payload_type = rtp->payload_type;
     }
 
-    packet::FEC* fec = packet->fec();
+    packet::FEC* fec = packet ? packet->fec() : NULL;
     if (fec) {
         sess_config.fec_decoder.scheme = fec->fec_scheme;
     }
 
+    core::SharedPtr<ReceiverPort> port;
+
+    for (port = ports_.front(); port; port = ports_.nextof(*port)) {
+        if (port->config().protocol == Proto_RTP_RTX) {
+            sess_config.retransmission = true;
+        }
+    }
+
     return sess_config;
 }
 
@@ -15,13 +15,17 @@
 #include "roc_audio/ireader.h"
 #include "roc_audio/mixer.h"
 #include "roc_audio/poison_reader.h"
+#include "roc_core/array.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/cond.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/rate_limiter.h"
+#include "roc_core/shared_ptr.h"
 #include "roc_core/unique_ptr.h"
+#include "roc_core/worker_pool.h"
 #include "roc_fec/codec_map.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
@@ -41,17 +45,34 @@ class Receiver : public sndio::ISource,
                  public core::NonCopyable<> {
 public:
     //! Initialize.
+    //!
+    //! @remarks
+    //!  If @p worker_pool is not NULL, FEC blocks are decoded and idle sessions
+    //!  are constructed in background. If, in addition,
+    //!  ReceiverCommonConfig::parallel_sessions is set, sessions are read in
+    //!  parallel. If @p worker_pool is NULL and
+    //!  ReceiverCommonConfig::session_pool_size is non-zero, the receiver
+    //!  starts its own background thread to construct idle sessions.
     Receiver(const ReceiverConfig& config,
              const fec::CodecMap& codec_map,
              const rtp::FormatMap& format_map,
+             core::WorkerPool* worker_pool,
              packet::PacketPool& packet_pool,
              core::BufferPool<uint8_t>& byte_buffer_pool,
              core::BufferPool<audio::sample_t>& sample_buffer_pool,
              core::IAllocator& allocator);
 
+    ~Receiver();
+
     //! Check if the pipeline was successfully constructed.
     bool valid();
 
+    //! Set writer for loss reports to senders.
+    //! @remarks
+    //!  Should be called before the first session is created. Reports are
+    //!  sent only if ReceiverSessionConfig::fec_feedback_interval is non-zero.
+    void set_feedback_writer(packet::IWriter& writer);
+
     //! Add receiving port.
     bool add_port(const PortConfig& config);
 
@@ -61,6 +82,30 @@ public:
     //! Get number of alive sessions.
     size_t num_sessions() const;
 
+    //! Get number of idle sessions constructed in advance.
+    size_t num_idle_sessions() const;
+
+    //! Get number of senders rejected because of ReceiverCommonConfig::max_sessions.
+    size_t num_rejected_sessions() const;
+
+    //! Get number of sessions removed because of ReceiverCommonConfig::read_budget.
+    size_t num_shed_sessions() const;
+
+    //! Iterate alive sessions.
+    void iterate_sessions(void (*fn)(void*, session_id_t, const packet::Address&),
+                          void* arg) const;
+
+    //! Read frame from a single session.
+    //!
+    //! @remarks
+    //!  Should be used when ReceiverCommonConfig::mixing is disabled. Routes
+    //!  received packets to sessions like read(), but reads only the given
+    //!  session, without mixing and without waiting for the timer.
+    //!
+    //! @returns
+    //!  false if there is no such session, e.g. if it was terminated
+    bool read_session(session_id_t id, audio::Frame& frame);
+
     //! Get current receiver state.
     virtual State state() const;
 
@@ -74,33 +119,84 @@ public:
     virtual bool has_clock() const;
 
     //! Write packet.
+    //! @remarks
+    //!  If ReceiverCommonConfig::route_on_write is set, parses the packet and
+    //!  routes it to the session queue. If ReceiverCommonConfig::session_pool_size
+    //!  is non-zero, also schedules refilling the pool of idle sessions in
+    //!  background.
     virtual void write(const packet::PacketPtr&);
 
     //! Read frame.
+    //! @remarks
+    //!  If ReceiverCommonConfig::mixing is disabled, produces silence.
+    //!  If ReceiverCommonConfig::read_budget is exceeded, removes the most
+    //!  recently created session.
     virtual bool read(audio::Frame&);
 
 private:
+    class RefillTask : public core::WorkerTask {
+    public:
+        RefillTask(Receiver& receiver)
+            : receiver_(receiver) {
+        }
+
+    private:
+        virtual void execute() {
+            receiver_.refill_idle_sessions_();
+        }
+
+        Receiver& receiver_;
+    };
+
+    struct RejectedSender {
+        packet::Address address;
+        core::nanoseconds_t deadline;
+        core::nanoseconds_t timeout;
+    };
+
     State state_() const;
 
     void prepare_();
 
+    void enqueue_packet_(const packet::PacketPtr& packet);
     void fetch_packets_();
+    void flush_sessions_();
 
     bool parse_packet_(const packet::PacketPtr& packet);
     bool route_packet_(const packet::PacketPtr& packet);
 
     bool can_create_session_(const packet::PacketPtr& packet);
 
+    bool is_rejected_(const packet::Address& address) const;
+    bool reject_sender_(const packet::Address& address, bool shed);
+
+    void shed_sessions_(core::nanoseconds_t elapsed);
+
     bool create_session_(const packet::PacketPtr& packet);
     void remove_session_(ReceiverSession& sess);
 
+    core::SharedPtr<ReceiverSession> find_session_(session_id_t id) const;
+
+    core::SharedPtr<ReceiverSession> new_session_(const ReceiverSessionConfig& sess_config,
+                                                  const packet::Address& src_address);
+
+    core::SharedPtr<ReceiverSession>
+    take_idle_session_(const ReceiverSessionConfig& sess_config);
+
+    void schedule_refill_();
+    void refill_idle_sessions_();
+
     void update_sessions_();
+    void remove_unread_sessions_();
 
     ReceiverSessionConfig make_session_config_(const packet::PacketPtr& packet) const;
 
     const fec::CodecMap& codec_map_;
     const rtp::FormatMap& format_map_;
 
+    core::WorkerPool* worker_pool_;
+    packet::IWriter* feedback_writer_;
+
     packet::PacketPool& packet_pool_;
     core::BufferPool<uint8_t>& byte_buffer_pool_;
     core::BufferPool<audio::sample_t>& sample_buffer_pool_;
@@ -108,6 +204,25 @@ private:
 
     core::List<ReceiverPort> ports_;
     core::List<ReceiverSession> sessions_;
+    core::List<ReceiverSession> idle_sessions_;
+    core::List<ReceiverSession> stale_sessions_;
+
+    ReceiverSessionConfig idle_session_config_;
+    bool has_idle_session_config_;
+    bool refilling_idle_sessions_;
+
+    core::UniquePtr<core::WorkerPool> own_worker_pool_;
+    core::WorkerPool* refill_pool_;
+    RefillTask refill_task_;
+
+    session_id_t next_session_id_;
+
+    core::Array<RejectedSender> rejected_senders_;
+    size_t num_rejected_sessions_;
+    size_t num_rejected_packets_;
+    size_t num_shed_sessions_;
+
+    core::RateLimiter reject_rate_limiter_;
 
     core::List<packet::Packet> packets_;
 
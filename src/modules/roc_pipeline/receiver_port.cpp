@@ -28,6 +28,7 @@ ReceiverPort::ReceiverPort(const PortConfig& config,
     case Proto_RTP:
     case Proto_RTP_LDPC_Source:
     case Proto_RTP_RSm8_Source:
+    case Proto_RTP_XOR_Source:
         rtp_parser_.reset(new (allocator) rtp::Parser(format_map, NULL), allocator);
         if (!rtp_parser_) {
             return;
@@ -77,6 +78,37 @@ ReceiverPort::ReceiverPort(const PortConfig& config,
         }
         parser = fec_parser_.get();
         break;
+    case Proto_RTP_XOR_Source:
+        fec_parser_.reset(
+            new (allocator)
+                fec::Parser<fec::XOR_Source_PayloadID, fec::Source, fec::Footer>(parser),
+            allocator);
+        if (!fec_parser_) {
+            return;
+        }
+        parser = fec_parser_.get();
+        break;
+    case Proto_XOR_Repair:
+        fec_parser_.reset(
+            new (allocator)
+                fec::Parser<fec::XOR_Repair_PayloadID, fec::Repair, fec::Header>(parser),
+            allocator);
+        if (!fec_parser_) {
+            return;
+        }
+        parser = fec_parser_.get();
+        break;
+    }
+
+    switch ((unsigned)config.protocol) {
+    case Proto_RTP_RTX:
+        // restored packet is parsed by session, which knows its fec scheme
+        rtx_parser_.reset(new (allocator) rtp::RtxParser(NULL), allocator);
+        if (!rtx_parser_) {
+            return;
+        }
+        parser = rtx_parser_.get();
+        break;
     }
 
     parser_ = parser;
@@ -106,7 +138,13 @@ bool ReceiverPort::handle(packet::Packet& packet) {
         return false;
     }
 
-    if (!parser_->parse(packet, packet.data())) {
+    return parse(packet, packet.data());
+}
+
+bool ReceiverPort::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if(!valid());
+
+    if (!parser_->parse(packet, buffer)) {
         roc_log(LogDebug, "receiver port: failed to parse packet");
         return false;
     }
@@ -20,6 +20,7 @@
 #include "roc_pipeline/config.h"
 #include "roc_rtp/format_map.h"
 #include "roc_rtp/parser.h"
+#include "roc_rtp/rtx_parser.h"
 
 namespace roc {
 namespace pipeline {
@@ -45,6 +46,11 @@ public:
     //!  true if the packet is dedicated for this port
     bool handle(packet::Packet& packet);
 
+    //! Parse packet contained in given buffer.
+    //! @remarks
+    //!  Unlike handle(), doesn't check packet destination address.
+    bool parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer);
+
 private:
     friend class core::RefCnt<ReceiverPort>;
 
@@ -58,6 +64,7 @@ private:
 
     core::UniquePtr<rtp::Parser> rtp_parser_;
     core::UniquePtr<packet::IParser> fec_parser_;
+    core::UniquePtr<rtp::RtxParser> rtx_parser_;
 };
 
 } // namespace pipeline
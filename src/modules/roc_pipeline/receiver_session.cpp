@@ -9,6 +9,11 @@
 #include "roc_pipeline/receiver_session.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_fec/feedback.h"
+#include "roc_pipeline/port_utils.h"
+#include "roc_rtp/rtx.h"
 
 namespace roc {
 namespace pipeline {
@@ -18,12 +23,28 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
                                  const packet::Address& src_address,
                                  const fec::CodecMap& codec_map,
                                  const rtp::FormatMap& format_map,
+                                 core::WorkerPool* worker_pool,
+                                 packet::IWriter* feedback_writer,
                                  packet::PacketPool& packet_pool,
                                  core::BufferPool<uint8_t>& byte_buffer_pool,
                                  core::BufferPool<audio::sample_t>& sample_buffer_pool,
                                  core::IAllocator& allocator)
     : src_address_(src_address)
+    , feedback_writer_(NULL)
+    , packet_pool_(packet_pool)
+    , byte_buffer_pool_(byte_buffer_pool)
     , allocator_(allocator)
+    , id_(0)
+    , num_channels_(packet::num_channels(session_config.channels))
+    , timestamp_(0)
+    , read_timeout_(session_config.watchdog.no_playback_timeout)
+    , last_read_time_(core::timestamp())
+    , feedback_interval_(0)
+    , next_feedback_(0)
+    , feedback_started_(false)
+    , max_packet_rate_(common_config.max_packet_rate)
+    , rate_window_(0)
+    , rate_packets_(0)
     , audio_reader_(NULL) {
     const rtp::Format* format = format_map.format(session_config.payload_type);
     if (!format) {
@@ -42,16 +63,45 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
 
     packet::IWriter* pwriter = source_queue_.get();
 
+    if (session_config.retransmission) {
+        PortConfig port_config;
+        port_config.protocol = port_source_protocol(session_config.fec_decoder.scheme);
+
+        rtx_source_port_ =
+            new (allocator_) ReceiverPort(port_config, format_map, allocator_);
+        if (!rtx_source_port_ || !rtx_source_port_->valid()) {
+            return;
+        }
+    }
+
+    if (session_config.retransmission && feedback_writer) {
+        nack_generator_.reset(new (allocator_) rtp::NackGenerator(
+                                  *pwriter, *feedback_writer, src_address_,
+                                  session_config.nack, session_config.target_latency,
+                                  common_config.output_sample_rate, packet_pool,
+                                  byte_buffer_pool, allocator_),
+                              allocator_);
+        if (!nack_generator_ || !nack_generator_->valid()) {
+            return;
+        }
+        pwriter = nack_generator_.get();
+    }
+
     if (!queue_router_->add_route(*pwriter, packet::Packet::FlagAudio)) {
         return;
     }
 
     packet::IReader* preader = source_queue_.get();
 
-    delayed_reader_.reset(
-        new (allocator_) packet::DelayedReader(*preader, session_config.target_latency,
-                                               format->sample_rate),
-        allocator_);
+    // with fast start, playback begins at start latency, and latency monitor
+    // then grows the latency to the target by slowing down playback
+    const core::nanoseconds_t start_latency = session_config.start_latency > 0
+        ? std::min(session_config.start_latency, session_config.target_latency)
+        : session_config.target_latency;
+
+    delayed_reader_.reset(new (allocator_) packet::DelayedReader(
+                              *preader, start_latency, format->sample_rate),
+                          allocator_);
     if (!delayed_reader_) {
         return;
     }
@@ -94,8 +144,20 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
         if (!fec_reader_ || !fec_reader_->valid()) {
             return;
         }
+        if (worker_pool) {
+            fec_reader_->set_worker_pool(*worker_pool);
+        }
         preader = fec_reader_.get();
 
+        if (feedback_writer && session_config.fec_feedback_interval > 0) {
+            feedback_writer_ = feedback_writer;
+            feedback_interval_ = (packet::timestamp_t)packet::timestamp_from_ns(
+                session_config.fec_feedback_interval, common_config.output_sample_rate);
+            if (feedback_interval_ == 0) {
+                feedback_interval_ = 1;
+            }
+        }
+
         fec_validator_.reset(new (allocator_)
                                  rtp::Validator(*preader, session_config.rtp_validator,
                                                 format->sample_rate),
@@ -135,6 +197,17 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
         areader = watchdog_.get();
     }
 
+    if (session_config.time_stretching) {
+        time_stretcher_.reset(new (allocator_) audio::TimeStretchReader(
+                                  *areader, allocator_, session_config.time_stretch,
+                                  format->sample_rate, session_config.channels),
+                              allocator_);
+        if (!time_stretcher_ || !time_stretcher_->valid()) {
+            return;
+        }
+        areader = time_stretcher_.get();
+    }
+
     if (common_config.resampling) {
         if (common_config.poisoning) {
             resampler_poisoner_.reset(new (allocator_) audio::PoisonReader(*areader),
@@ -146,8 +219,7 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
         }
         resampler_.reset(new (allocator_) audio::ResamplerReader(
                              *areader, sample_buffer_pool, allocator,
-                             session_config.resampler, session_config.channels,
-                             common_config.internal_frame_size),
+                             session_config.resampler, session_config.channels),
                          allocator_);
         if (!resampler_ || !resampler_->valid()) {
             return;
@@ -166,9 +238,11 @@ ReceiverSession::ReceiverSession(const ReceiverSessionConfig& session_config,
 
     latency_monitor_.reset(new (allocator_) audio::LatencyMonitor(
                                *source_queue_, *depacketizer_, resampler_.get(),
+                               time_stretcher_.get(),
                                session_config.latency_monitor,
-                               session_config.target_latency, format->sample_rate,
-                               common_config.output_sample_rate),
+                               session_config.target_latency,
+                               session_config.start_latency, format->sample_rate,
+                               common_config.output_sample_rate, allocator_),
                            allocator_);
     if (!latency_monitor_ || !latency_monitor_->valid()) {
         return;
@@ -185,9 +259,69 @@ bool ReceiverSession::valid() const {
     return audio_reader_;
 }
 
+session_id_t ReceiverSession::id() const {
+    return id_;
+}
+
+void ReceiverSession::set_id(session_id_t id) {
+    id_ = id;
+}
+
+const packet::Address& ReceiverSession::src_address() const {
+    return src_address_;
+}
+
+void ReceiverSession::bind(const packet::Address& src_address) {
+    roc_panic_if(!valid());
+
+    src_address_ = src_address;
+    last_read_time_ = core::timestamp();
+
+    if (nack_generator_) {
+        nack_generator_->set_dst_address(src_address);
+    }
+}
+
 bool ReceiverSession::handle(const packet::PacketPtr& packet) {
     roc_panic_if(!valid());
 
+    bool parsed = false;
+    if (!accept_(packet, parsed)) {
+        return false;
+    }
+
+    if (parsed) {
+        queue_router_->write(packet);
+    }
+
+    return true;
+}
+
+bool ReceiverSession::enqueue(const packet::PacketPtr& packet) {
+    roc_panic_if(!valid());
+
+    bool parsed = false;
+    if (!accept_(packet, parsed)) {
+        return false;
+    }
+
+    if (parsed) {
+        pending_packets_.push_back(*packet);
+    }
+
+    return true;
+}
+
+void ReceiverSession::flush() {
+    roc_panic_if(!valid());
+
+    while (packet::PacketPtr packet = pending_packets_.front()) {
+        pending_packets_.remove(*packet);
+        queue_router_->write(packet);
+    }
+}
+
+bool ReceiverSession::accept_(const packet::PacketPtr& packet, bool& parsed) {
     packet::UDP* udp = packet->udp();
     if (!udp) {
         return false;
@@ -197,7 +331,52 @@ bool ReceiverSession::handle(const packet::PacketPtr& packet) {
         return false;
     }
 
-    queue_router_->write(packet);
+    if (max_packet_rate_ != 0 && !check_rate_()) {
+        parsed = false;
+        return true;
+    }
+
+    if (packet->flags() & packet::Packet::FlagRetransmitted) {
+        parsed = parse_retransmitted_(*packet);
+    } else {
+        parsed = true;
+    }
+
+    return true;
+}
+
+bool ReceiverSession::check_rate_() {
+    const core::nanoseconds_t now = core::timestamp();
+
+    if (rate_window_ == 0 || now - rate_window_ >= core::Second) {
+        rate_window_ = now;
+        rate_packets_ = 0;
+    }
+
+    if (rate_packets_ >= max_packet_rate_) {
+        roc_log(LogDebug, "receiver session: packet rate exceeded, dropping packet");
+        return false;
+    }
+
+    rate_packets_++;
+    return true;
+}
+
+bool ReceiverSession::parse_retransmitted_(packet::Packet& packet) {
+    if (!rtx_source_port_) {
+        roc_log(LogDebug, "receiver session: unexpected retransmitted packet");
+        return false;
+    }
+
+    // retransmission port restored the original packet in-place, but
+    // only the session knows how to parse it
+    const core::Slice<uint8_t>& data = packet.data();
+
+    if (!rtx_source_port_->parse(packet, data.range(rtp::RtxHeaderSize, data.size()))) {
+        roc_log(LogDebug, "receiver session: can't parse retransmitted packet");
+        return false;
+    }
+
     return true;
 }
 
@@ -216,14 +395,89 @@ bool ReceiverSession::update(packet::timestamp_t time) {
         }
     }
 
+    if (nack_generator_) {
+        nack_generator_->update(time);
+    }
+
+    if (feedback_writer_) {
+        if (!feedback_started_) {
+            next_feedback_ = time + feedback_interval_;
+            feedback_started_ = true;
+        } else if (packet::timestamp_le(next_feedback_, time)) {
+            send_feedback_();
+            next_feedback_ = time + feedback_interval_;
+        }
+    }
+
     return true;
 }
 
+void ReceiverSession::send_feedback_() {
+    const fec::LossStats& stats = fec_reader_->loss_stats();
+    if (stats.n_source_packets == 0) {
+        return;
+    }
+
+    fec::Feedback feedback;
+    feedback.loss_rate = float(stats.n_lost_packets) / stats.n_source_packets;
+    feedback.max_burst = stats.max_burst;
+
+    fec_reader_->reset_loss_stats();
+
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "receiver session: can't allocate feedback packet");
+        return;
+    }
+
+    core::Slice<uint8_t> data =
+        new (byte_buffer_pool_) core::Buffer<uint8_t>(byte_buffer_pool_);
+    if (!data) {
+        roc_log(LogError, "receiver session: can't allocate feedback buffer");
+        return;
+    }
+
+    data.resize(sizeof(fec::FeedbackHeader));
+
+    fec::FeedbackHeader& header = *(fec::FeedbackHeader*)data.data();
+    header.clear();
+    header.set_feedback(feedback);
+
+    pp->add_flags(packet::Packet::FlagUDP);
+    pp->udp()->dst_addr = src_address_;
+    pp->set_data(data);
+
+    roc_log(LogDebug,
+            "receiver session: sending fec feedback: loss_rate=%.4f max_burst=%lu",
+            (double)feedback.loss_rate, (unsigned long)feedback.max_burst);
+
+    feedback_writer_->write(pp);
+}
+
 audio::IReader& ReceiverSession::reader() {
     roc_panic_if(!valid());
 
     return *audio_reader_;
 }
 
+void ReceiverSession::read(audio::Frame& frame) {
+    roc_panic_if(!valid());
+
+    audio_reader_->read(frame);
+    timestamp_ += frame.size() / num_channels_;
+    last_read_time_ = core::timestamp();
+}
+
+packet::timestamp_t ReceiverSession::timestamp() const {
+    return timestamp_;
+}
+
+bool ReceiverSession::read_timeout_expired(core::nanoseconds_t now) const {
+    if (read_timeout_ <= 0) {
+        return false;
+    }
+    return now - last_read_time_ > read_timeout_;
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -18,42 +18,60 @@
 #include "roc_audio/latency_monitor.h"
 #include "roc_audio/poison_reader.h"
 #include "roc_audio/resampler_reader.h"
+#include "roc_audio/time_stretch_reader.h"
 #include "roc_audio/watchdog.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/iallocator.h"
+#include "roc_core/list.h"
 #include "roc_core/list_node.h"
 #include "roc_core/refcnt.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_core/unique_ptr.h"
+#include "roc_core/worker_pool.h"
 #include "roc_fec/codec_map.h"
 #include "roc_fec/iblock_decoder.h"
 #include "roc_fec/reader.h"
 #include "roc_packet/address.h"
 #include "roc_packet/delayed_reader.h"
 #include "roc_packet/iparser.h"
+#include "roc_packet/iwriter.h"
 #include "roc_packet/ireader.h"
 #include "roc_packet/packet.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/router.h"
 #include "roc_packet/sorted_queue.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/receiver_port.h"
 #include "roc_rtp/format_map.h"
+#include "roc_rtp/nack_generator.h"
 #include "roc_rtp/parser.h"
 #include "roc_rtp/validator.h"
 
 namespace roc {
 namespace pipeline {
 
+//! Receiver session identifier.
+typedef uint32_t session_id_t;
+
 //! Receiver session pipeline.
 //! @remarks
 //!  Created at the receiver side for every connected sender.
 class ReceiverSession : public core::RefCnt<ReceiverSession>, public core::ListNode {
 public:
     //! Initialize.
+    //!
+    //! @remarks
+    //!  If @p feedback_writer is not NULL, FEC loss reports and retransmission
+    //!  requests are written to it, addressed to @p src_address.
     ReceiverSession(const ReceiverSessionConfig& session_config,
                     const ReceiverCommonConfig& common_config,
                     const packet::Address& src_address,
                     const fec::CodecMap& codec_map,
                     const rtp::FormatMap& format_map,
+                    core::WorkerPool* worker_pool,
+                    packet::IWriter* feedback_writer,
                     packet::PacketPool& packet_pool,
                     core::BufferPool<uint8_t>& byte_buffer_pool,
                     core::BufferPool<audio::sample_t>& sample_buffer_pool,
@@ -62,11 +80,41 @@ public:
     //! Check if the session pipeline was succefully constructed.
     bool valid() const;
 
+    //! Get session identifier.
+    session_id_t id() const;
+
+    //! Set session identifier.
+    void set_id(session_id_t id);
+
+    //! Get sender address.
+    const packet::Address& src_address() const;
+
+    //! Bind session to another sender address.
+    //! @remarks
+    //!  Allows to construct session in advance, before the first packet
+    //!  from the sender arrives. Should be called before the session
+    //!  handles any packets.
+    void bind(const packet::Address& src_address);
+
     //! Try to route a packet to this session.
     //! @returns
     //!  true if the packet is dedicated for this session
     bool handle(const packet::PacketPtr& packet);
 
+    //! Try to enqueue a packet to this session without routing it.
+    //! @remarks
+    //!  Unlike handle(), may be called concurrently with reading the session.
+    //!  Enqueued packets are routed by flush(). Calls to enqueue() and flush()
+    //!  should be serialized by the caller.
+    //! @returns
+    //!  true if the packet is dedicated for this session
+    bool enqueue(const packet::PacketPtr& packet);
+
+    //! Route enqueued packets.
+    //! @remarks
+    //!  Should not be called concurrently with reading the session.
+    void flush();
+
     //! Update session.
     //! @returns
     //!  false if the session is terminated
@@ -75,19 +123,63 @@ public:
     //! Get audio reader.
     audio::IReader& reader();
 
+    //! Read frame from audio reader and advance session timestamp.
+    //! @remarks
+    //!  Used when the session is read separately instead of being mixed.
+    void read(audio::Frame& frame);
+
+    //! Get number of samples per channel read using read().
+    packet::timestamp_t timestamp() const;
+
+    //! Check if the session was not read using read() for too long.
+    //! @remarks
+    //!  Returns true if no frame was read during the no playback timeout
+    //!  since the session was created, bound, or read last time.
+    bool read_timeout_expired(core::nanoseconds_t now) const;
+
 private:
     friend class core::RefCnt<ReceiverSession>;
 
     void destroy();
 
-    const packet::Address src_address_;
+    void send_feedback_();
+    bool parse_retransmitted_(packet::Packet& packet);
+    bool accept_(const packet::PacketPtr& packet, bool& parsed);
+    bool check_rate_();
+
+    packet::Address src_address_;
+
+    packet::IWriter* feedback_writer_;
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& byte_buffer_pool_;
 
     core::IAllocator& allocator_;
 
+    session_id_t id_;
+
+    const size_t num_channels_;
+    packet::timestamp_t timestamp_;
+
+    const core::nanoseconds_t read_timeout_;
+    core::nanoseconds_t last_read_time_;
+
+    packet::timestamp_t feedback_interval_;
+    packet::timestamp_t next_feedback_;
+    bool feedback_started_;
+
+    const size_t max_packet_rate_;
+    core::nanoseconds_t rate_window_;
+    size_t rate_packets_;
+
     audio::IReader* audio_reader_;
 
+    core::List<packet::Packet> pending_packets_;
+
     core::UniquePtr<packet::Router> queue_router_;
 
+    core::SharedPtr<ReceiverPort> rtx_source_port_;
+
+    core::UniquePtr<rtp::NackGenerator> nack_generator_;
     core::UniquePtr<packet::SortedQueue> source_queue_;
     core::UniquePtr<packet::SortedQueue> repair_queue_;
 
@@ -103,6 +195,8 @@ private:
     core::UniquePtr<audio::IFrameDecoder> payload_decoder_;
     core::UniquePtr<audio::Depacketizer> depacketizer_;
 
+    core::UniquePtr<audio::TimeStretchReader> time_stretcher_;
+
     core::UniquePtr<audio::PoisonReader> resampler_poisoner_;
     core::UniquePtr<audio::ResamplerReader> resampler_;
 
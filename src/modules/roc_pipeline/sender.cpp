@@ -9,6 +9,10 @@
 #include "roc_pipeline/sender.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_fec/feedback.h"
+#include "roc_packet/address_to_str.h"
+#include "roc_rtp/nack.h"
+#include "roc_rtp/rtx.h"
 #include "roc_pipeline/port_to_str.h"
 #include "roc_pipeline/port_utils.h"
 
@@ -20,13 +24,19 @@ Sender::Sender(const SenderConfig& config,
                packet::IWriter& source_writer,
                const PortConfig& repair_port_config,
                packet::IWriter& repair_writer,
+               const PortConfig& rtx_port_config,
+               packet::IWriter& rtx_writer,
                const fec::CodecMap& codec_map,
                const rtp::FormatMap& format_map,
+               core::WorkerPool* worker_pool,
                packet::PacketPool& packet_pool,
                core::BufferPool<uint8_t>& byte_buffer_pool,
                core::BufferPool<audio::sample_t>& sample_buffer_pool,
                core::IAllocator& allocator)
-    : audio_writer_(NULL)
+    : feedback_reader_(NULL)
+    , audio_writer_(NULL)
+    , async_cond_(async_mutex_)
+    , num_dropped_(0)
     , config_(config)
     , timestamp_(0)
     , num_channels_(packet::num_channels(config.input_channels)) {
@@ -35,11 +45,22 @@ Sender::Sender(const SenderConfig& config,
     roc_log(LogInfo, "sender: using remote repair port %s",
             port_to_str(repair_port_config).c_str());
 
+    if (rtx_port_config.protocol != Proto_None) {
+        roc_log(LogInfo, "sender: using remote retransmission port %s",
+                port_to_str(rtx_port_config).c_str());
+    }
+
     if (!validate_ports(config.fec_encoder.scheme, source_port_config.protocol,
                         repair_port_config.protocol)) {
         return;
     }
 
+    if (rtx_port_config.protocol != Proto_None
+        && !validate_port(config.fec_encoder.scheme, rtx_port_config.protocol,
+                          Port_AudioRetransmission)) {
+        return;
+    }
+
     const rtp::Format* format = format_map.format(config.payload_type);
     if (!format) {
         return;
@@ -53,7 +74,7 @@ Sender::Sender(const SenderConfig& config,
     }
 
     source_port_.reset(new (allocator)
-                           SenderPort(source_port_config, source_writer, allocator),
+                           SenderPort(source_port_config, source_writer, packet_pool, allocator),
                        allocator);
     if (!source_port_ || !source_port_->valid()) {
         return;
@@ -65,13 +86,43 @@ Sender::Sender(const SenderConfig& config,
     }
     packet::IWriter* pwriter = router_.get();
 
-    if (!router_->add_route(*source_port_, packet::Packet::FlagAudio)) {
+    packet::IWriter* swriter = source_port_.get();
+
+    if (rtx_port_config.protocol != Proto_None) {
+        if (!rtp::rtx_supported_payload_type(config.payload_type)) {
+            roc_log(LogError,
+                    "sender: payload type %u can't be used with retransmission",
+                    (unsigned)config.payload_type);
+            return;
+        }
+
+        rtx_port_.reset(new (allocator)
+                            SenderPort(rtx_port_config, rtx_writer, packet_pool, allocator),
+                        allocator);
+        if (!rtx_port_ || !rtx_port_->valid()) {
+            return;
+        }
+
+        const size_t n_packets =
+            size_t(config.retransmission_buffer_length / config.packet_length) + 1;
+
+        retransmitter_.reset(new (allocator) rtp::Retransmitter(
+                                 *source_port_, *rtx_port_, n_packets, packet_pool,
+                                 byte_buffer_pool, allocator),
+                             allocator);
+        if (!retransmitter_ || !retransmitter_->valid()) {
+            return;
+        }
+        swriter = retransmitter_.get();
+    }
+
+    if (!router_->add_route(*swriter, packet::Packet::FlagAudio)) {
         return;
     }
 
     if (config.fec_encoder.scheme != packet::FEC_None) {
-        repair_port_.reset(new (allocator)
-                               SenderPort(repair_port_config, repair_writer, allocator),
+        repair_port_.reset(new (allocator) SenderPort(repair_port_config, repair_writer,
+                                                      packet_pool, allocator),
                            allocator);
         if (!repair_port_ || !repair_port_->valid()) {
             return;
@@ -109,7 +160,19 @@ Sender::Sender(const SenderConfig& config,
         if (!fec_writer_ || !fec_writer_->valid()) {
             return;
         }
+        if (worker_pool) {
+            fec_writer_->set_worker_pool(*worker_pool);
+        }
         pwriter = fec_writer_.get();
+
+        if (config.fec_adapter.max_repair_packets != 0) {
+            fec_adapter_.reset(new (allocator) fec::BlockAdapter(
+                                   config.fec_adapter, config.fec_writer, *fec_writer_),
+                               allocator);
+            if (!fec_adapter_) {
+                return;
+            }
+        }
     }
 
     payload_encoder_.reset(format->new_encoder(allocator), allocator);
@@ -160,17 +223,78 @@ Sender::Sender(const SenderConfig& config,
         awriter = pipeline_poisoner_.get();
     }
 
+    if (config.async) {
+        // sender thread is started on first write
+        ring_.reset(new (allocator) audio::FrameRing(
+                        allocator, config.async_queue_size,
+                        config.internal_frame_size / num_channels_ * num_channels_),
+                    allocator);
+        if (!ring_ || !ring_->valid()) {
+            return;
+        }
+    }
+
     audio_writer_ = awriter;
 }
 
+Sender::~Sender() {
+    if (joinable()) {
+        stopping_ = true;
+
+        {
+            core::Mutex::Lock lock(async_mutex_);
+            async_cond_.broadcast();
+        }
+
+        join();
+    }
+}
+
 bool Sender::valid() {
     return audio_writer_;
 }
 
+bool Sender::add_destination(const packet::Address& source_address,
+                             const packet::Address& repair_address) {
+    roc_panic_if(!valid());
+
+    if (retransmitter_) {
+        roc_log(LogError,
+                "sender: can't add destination, not supported with retransmission");
+        return false;
+    }
+
+    if (!source_port_->add_address(source_address)) {
+        roc_log(LogError, "sender: can't add destination source address");
+        return false;
+    }
+
+    if (repair_port_ && !repair_port_->add_address(repair_address)) {
+        roc_log(LogError, "sender: can't add destination repair address");
+        return false;
+    }
+
+    roc_log(LogInfo, "sender: added destination: source_addr=%s repair_addr=%s",
+            packet::address_to_str(source_address).c_str(),
+            repair_port_ ? packet::address_to_str(repair_address).c_str() : "none");
+
+    return true;
+}
+
+size_t Sender::num_destinations() const {
+    return source_port_->num_addresses();
+}
+
 size_t Sender::sample_rate() const {
     return config_.input_sample_rate;
 }
 
+void Sender::set_feedback_reader(packet::IReader& reader) {
+    roc_panic_if(!valid());
+
+    feedback_reader_ = &reader;
+}
+
 bool Sender::has_clock() const {
     return config_.timing;
 }
@@ -182,9 +306,189 @@ void Sender::write(audio::Frame& frame) {
         ticker_->wait(timestamp_);
     }
 
-    audio_writer_->write(frame);
+    if (ring_) {
+        enqueue_(frame);
+    } else {
+        process_(frame);
+    }
+
     timestamp_ += frame.size() / num_channels_;
 }
 
+size_t Sender::num_dropped_samples() const {
+    return num_dropped_;
+}
+
+void Sender::run() {
+    roc_log(LogDebug, "sender: starting sender thread");
+
+    for (;;) {
+        size_t n_samples = 0;
+        audio::sample_t* samples = ring_->front(n_samples);
+
+        if (!samples) {
+            core::Mutex::Lock lock(async_mutex_);
+
+            reader_waiting_ = true;
+            if (ring_->empty() && !stopping_) {
+                async_cond_.wait();
+            }
+            reader_waiting_ = false;
+
+            if (ring_->empty() && stopping_) {
+                break;
+            }
+            continue;
+        }
+
+        audio::Frame frame(samples, n_samples);
+        process_(frame);
+
+        ring_->pop();
+
+        if (writer_waiting_) {
+            core::Mutex::Lock lock(async_mutex_);
+            async_cond_.broadcast();
+        }
+    }
+
+    roc_log(LogDebug, "sender: finishing sender thread");
+}
+
+void Sender::enqueue_(const audio::Frame& frame) {
+    if (!joinable()) {
+        if (!start()) {
+            roc_panic("sender: can't start sender thread");
+        }
+    }
+
+    const audio::sample_t* samples = frame.data();
+    size_t n_samples = frame.size();
+
+    while (n_samples != 0) {
+        const size_t n = std::min(n_samples, ring_->frame_size());
+
+        while (!ring_->push(samples, n)) {
+            if (config_.async_overflow == AsyncOverflow_Drop) {
+                roc_log(LogDebug, "sender: queue is full, dropping samples: n=%lu",
+                        (unsigned long)n_samples);
+                num_dropped_ += n_samples;
+                return;
+            }
+
+            core::Mutex::Lock lock(async_mutex_);
+
+            writer_waiting_ = true;
+            if (ring_->full()) {
+                async_cond_.wait();
+            }
+            writer_waiting_ = false;
+        }
+
+        if (reader_waiting_) {
+            core::Mutex::Lock lock(async_mutex_);
+            async_cond_.broadcast();
+        }
+
+        samples += n;
+        n_samples -= n;
+    }
+}
+
+void Sender::process_(audio::Frame& frame) {
+    if (feedback_reader_) {
+        read_feedback_();
+    }
+
+    audio_writer_->write(frame);
+}
+
+void Sender::read_feedback_() {
+    while (packet::PacketPtr pp = feedback_reader_->read()) {
+        if (!is_destination_(pp)) {
+            roc_log(LogDebug, "sender: dropping feedback packet from unknown address");
+            continue;
+        }
+
+        const core::Slice<uint8_t>& data = pp->data();
+
+        if (data && data.size() >= sizeof(fec::FeedbackHeader)
+            && ((const fec::FeedbackHeader*)data.data())->valid()) {
+            handle_fec_feedback_(data);
+        } else if (data && data.size() >= sizeof(rtp::NackHeader)
+                   && ((const rtp::NackHeader*)data.data())->valid()) {
+            handle_nack_(data);
+        } else {
+            roc_log(LogDebug, "sender: dropping unexpected feedback packet: size=%lu",
+                    (unsigned long)(data ? data.size() : 0));
+        }
+    }
+}
+
+bool Sender::is_destination_(const packet::PacketPtr& packet) const {
+    if (!packet->udp() || !packet->udp()->src_addr.valid()) {
+        return false;
+    }
+
+    // receivers send feedback from their own port, so only IP is checked
+    const packet::Address& src_address = packet->udp()->src_addr;
+
+    if (source_port_->has_host(src_address)) {
+        return true;
+    }
+
+    if (repair_port_ && repair_port_->has_host(src_address)) {
+        return true;
+    }
+
+    if (rtx_port_ && rtx_port_->has_host(src_address)) {
+        return true;
+    }
+
+    return false;
+}
+
+void Sender::handle_fec_feedback_(const core::Slice<uint8_t>& data) {
+    if (!fec_adapter_) {
+        return;
+    }
+
+    const fec::FeedbackHeader& header = *(const fec::FeedbackHeader*)data.data();
+
+    fec_adapter_->update(header.feedback());
+}
+
+void Sender::handle_nack_(const core::Slice<uint8_t>& data) {
+    if (!retransmitter_) {
+        return;
+    }
+
+    const rtp::NackHeader& header = *(const rtp::NackHeader*)data.data();
+
+    const size_t n_entries = header.num_entries();
+
+    if (data.size() < sizeof(rtp::NackHeader) + n_entries * sizeof(rtp::NackEntry)) {
+        roc_log(LogDebug, "sender: dropping truncated nack packet: size=%lu entries=%lu",
+                (unsigned long)data.size(), (unsigned long)n_entries);
+        return;
+    }
+
+    const rtp::NackEntry* entries =
+        (const rtp::NackEntry*)(data.data() + sizeof(rtp::NackHeader));
+
+    for (size_t n = 0; n < n_entries; n++) {
+        const packet::seqnum_t pid = entries[n].pid();
+        const uint16_t blp = entries[n].blp();
+
+        retransmitter_->retransmit(pid);
+
+        for (size_t i = 0; i < rtp::NackEntry::MaxBLP; i++) {
+            if (blp & (1 << i)) {
+                retransmitter_->retransmit(packet::seqnum_t(pid + i + 1));
+            }
+        }
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -12,48 +12,89 @@
 #ifndef ROC_PIPELINE_SENDER_H_
 #define ROC_PIPELINE_SENDER_H_
 
+#include "roc_audio/frame_ring.h"
 #include "roc_audio/iframe_encoder.h"
 #include "roc_audio/packetizer.h"
 #include "roc_audio/poison_writer.h"
 #include "roc_audio/resampler_writer.h"
+#include "roc_core/atomic.h"
 #include "roc_core/buffer_pool.h"
+#include "roc_core/cond.h"
 #include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/thread.h"
 #include "roc_core/ticker.h"
 #include "roc_core/unique_ptr.h"
+#include "roc_core/worker_pool.h"
+#include "roc_fec/block_adapter.h"
 #include "roc_fec/codec_map.h"
 #include "roc_fec/iblock_encoder.h"
 #include "roc_fec/writer.h"
 #include "roc_packet/interleaver.h"
+#include "roc_packet/ireader.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/router.h"
 #include "roc_pipeline/config.h"
 #include "roc_pipeline/sender_port.h"
 #include "roc_rtp/format_map.h"
+#include "roc_rtp/retransmitter.h"
 #include "roc_sndio/isink.h"
 
 namespace roc {
 namespace pipeline {
 
 //! Sender pipeline.
-class Sender : public sndio::ISink, public core::NonCopyable<> {
+class Sender : public sndio::ISink, private core::Thread, public core::NonCopyable<> {
 public:
     //! Initialize.
+    //!
+    //! @remarks
+    //!  If @p worker_pool is not NULL, FEC blocks are encoded in background.
+    //!  If @p rtx_port protocol is not Proto_None, source packets are kept
+    //!  and retransmitted on request.
+    //!  If SenderConfig::async is set, starts sender thread.
     Sender(const SenderConfig& config,
            const PortConfig& source_port,
            packet::IWriter& source_writer,
            const PortConfig& repair_port,
            packet::IWriter& repair_writer,
+           const PortConfig& rtx_port,
+           packet::IWriter& rtx_writer,
            const fec::CodecMap& codec_map,
            const rtp::FormatMap& format_map,
+           core::WorkerPool* worker_pool,
            packet::PacketPool& packet_pool,
            core::BufferPool<uint8_t>& byte_buffer_pool,
            core::BufferPool<audio::sample_t>& sample_buffer_pool,
            core::IAllocator& allocator);
 
+    //! Stop sender thread, if any, after sending queued samples.
+    virtual ~Sender();
+
     //! Check if the pipeline was successfully constructed.
     bool valid();
 
+    //! Set reader for loss reports from receivers.
+    //! @remarks
+    //!  Reports are fetched on every write() and used to adjust the number
+    //!  of repair packets per FEC block and to retransmit lost packets.
+    //!  The reader should be non-blocking. Packets which source IP does not
+    //!  match any of destination addresses are dropped.
+    void set_feedback_reader(packet::IReader& reader);
+
+    //! Add another destination.
+    //! @remarks
+    //!  Packets are composed and FEC-encoded once and then sent to every
+    //!  destination, using the same protocols as the ports passed to the
+    //!  constructor. @p repair_address is used only if FEC is enabled.
+    //!  Not supported with retransmission. Should be called before write().
+    bool add_destination(const packet::Address& source_address,
+                         const packet::Address& repair_address);
+
+    //! Get number of destinations.
+    size_t num_destinations() const;
+
     //! Get sink sample rate.
     virtual size_t sample_rate() const;
 
@@ -61,11 +102,31 @@ public:
     virtual bool has_clock() const;
 
     //! Write audio frame.
+    //! @remarks
+    //!  If SenderConfig::async is set, copies samples to the queue and
+    //!  returns, or blocks or drops samples if the queue is full, depending
+    //!  on SenderConfig::async_overflow.
     virtual void write(audio::Frame& frame);
 
+    //! Get number of samples dropped because asynchronous queue was full.
+    size_t num_dropped_samples() const;
+
 private:
+    virtual void run();
+
+    void enqueue_(const audio::Frame& frame);
+    void process_(audio::Frame& frame);
+
+    void read_feedback_();
+    bool is_destination_(const packet::PacketPtr& packet) const;
+    void handle_fec_feedback_(const core::Slice<uint8_t>& data);
+    void handle_nack_(const core::Slice<uint8_t>& data);
+
     core::UniquePtr<SenderPort> source_port_;
     core::UniquePtr<SenderPort> repair_port_;
+    core::UniquePtr<SenderPort> rtx_port_;
+
+    core::UniquePtr<rtp::Retransmitter> retransmitter_;
 
     core::UniquePtr<packet::Router> router_;
 
@@ -73,6 +134,9 @@ private:
 
     core::UniquePtr<fec::IBlockEncoder> fec_encoder_;
     core::UniquePtr<fec::Writer> fec_writer_;
+    core::UniquePtr<fec::BlockAdapter> fec_adapter_;
+
+    packet::IReader* feedback_reader_;
 
     core::UniquePtr<audio::IFrameEncoder> payload_encoder_;
     core::UniquePtr<audio::Packetizer> packetizer_;
@@ -86,6 +150,17 @@ private:
 
     audio::IWriter* audio_writer_;
 
+    core::UniquePtr<audio::FrameRing> ring_;
+
+    core::Mutex async_mutex_;
+    core::Cond async_cond_;
+
+    core::Atomic reader_waiting_;
+    core::Atomic writer_waiting_;
+    core::Atomic stopping_;
+
+    size_t num_dropped_;
+
     SenderConfig config_;
 
     packet::timestamp_t timestamp_;
@@ -17,16 +17,21 @@ namespace pipeline {
 
 SenderPort::SenderPort(const PortConfig& config,
                        packet::IWriter& writer,
+                       packet::PacketPool& packet_pool,
                        core::IAllocator& allocator)
     : dst_address_(config.address)
     , writer_(writer)
-    , composer_(NULL) {
+    , composer_(NULL)
+    , packet_pool_(packet_pool)
+    , extra_addresses_(allocator) {
     packet::IComposer* composer = NULL;
 
     switch ((unsigned)config.protocol) {
     case Proto_RTP:
     case Proto_RTP_LDPC_Source:
     case Proto_RTP_RSm8_Source:
+    case Proto_RTP_XOR_Source:
+    case Proto_RTP_RTX:
         rtp_composer_.reset(new (allocator) rtp::Composer(NULL), allocator);
         if (!rtp_composer_) {
             return;
@@ -78,6 +83,28 @@ SenderPort::SenderPort(const PortConfig& config,
         }
         composer = fec_composer_.get();
         break;
+    case Proto_RTP_XOR_Source:
+        fec_composer_.reset(
+            new (allocator)
+                fec::Composer<fec::XOR_Source_PayloadID, fec::Source, fec::Footer>(
+                    composer),
+            allocator);
+        if (!fec_composer_) {
+            return;
+        }
+        composer = fec_composer_.get();
+        break;
+    case Proto_XOR_Repair:
+        fec_composer_.reset(
+            new (allocator)
+                fec::Composer<fec::XOR_Repair_PayloadID, fec::Repair, fec::Header>(
+                    composer),
+            allocator);
+        if (!fec_composer_) {
+            return;
+        }
+        composer = fec_composer_.get();
+        break;
     }
 
     composer_ = composer;
@@ -93,6 +120,36 @@ packet::IComposer& SenderPort::composer() {
     return *composer_;
 }
 
+bool SenderPort::add_address(const packet::Address& address) {
+    roc_panic_if(!valid());
+
+    if (!extra_addresses_.grow(extra_addresses_.size() + 1)) {
+        roc_log(LogError, "sender port: can't allocate address");
+        return false;
+    }
+
+    extra_addresses_.push_back(address);
+    return true;
+}
+
+size_t SenderPort::num_addresses() const {
+    return extra_addresses_.size() + 1;
+}
+
+bool SenderPort::has_host(const packet::Address& address) const {
+    if (dst_address_.same_ip(address)) {
+        return true;
+    }
+
+    for (size_t n = 0; n < extra_addresses_.size(); n++) {
+        if (extra_addresses_[n].same_ip(address)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void SenderPort::write(const packet::PacketPtr& packet) {
     roc_panic_if(!valid());
 
@@ -109,6 +166,23 @@ void SenderPort::write(const packet::PacketPtr& packet) {
         packet->add_flags(packet::Packet::FlagComposed);
     }
 
+    // every destination needs its own packet, because the packet holds udp
+    // headers and is enqueued by the writer, but the data is shared
+    for (size_t n = 0; n < extra_addresses_.size(); n++) {
+        packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+        if (!pp) {
+            roc_log(LogError, "sender port: can't allocate packet");
+            continue;
+        }
+
+        pp->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagComposed);
+        pp->udp()->src_addr = udp.src_addr;
+        pp->udp()->dst_addr = extra_addresses_[n];
+        pp->set_data(packet->data());
+
+        writer_.write(pp);
+    }
+
     writer_.write(packet);
 }
 
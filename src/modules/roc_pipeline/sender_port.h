@@ -12,11 +12,13 @@
 #ifndef ROC_PIPELINE_SENDER_PORT_H_
 #define ROC_PIPELINE_SENDER_PORT_H_
 
+#include "roc_core/array.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/unique_ptr.h"
 #include "roc_packet/icomposer.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
 #include "roc_pipeline/config.h"
 #include "roc_rtp/composer.h"
 
@@ -31,6 +33,7 @@ public:
     //! Initialize.
     SenderPort(const PortConfig& config,
                packet::IWriter& writer,
+               packet::PacketPool& packet_pool,
                core::IAllocator& allocator);
 
     //! Check if the port pipeline was succefully constructed.
@@ -39,6 +42,19 @@ public:
     //! Get packet composer.
     packet::IComposer& composer();
 
+    //! Add another destination address.
+    //! @remarks
+    //!  Every packet is composed once and then sent to every destination.
+    //!  For every additional destination, a new packet is allocated, which
+    //!  shares the composed data with the original packet.
+    bool add_address(const packet::Address& address);
+
+    //! Get number of destination addresses.
+    size_t num_addresses() const;
+
+    //! Check if @p address has the same IP as one of destination addresses.
+    bool has_host(const packet::Address& address) const;
+
     //! Write packet.
     void write(const packet::PacketPtr& packet);
 
@@ -48,6 +64,9 @@ private:
     packet::IWriter& writer_;
     packet::IComposer* composer_;
 
+    packet::PacketPool& packet_pool_;
+    core::Array<packet::Address> extra_addresses_;
+
     core::UniquePtr<rtp::Composer> rtp_composer_;
     core::UniquePtr<packet::IComposer> fec_composer_;
 };
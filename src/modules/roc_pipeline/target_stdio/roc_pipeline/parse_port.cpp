@@ -23,6 +23,8 @@ bool match_proto(PortType type, const char* str, PortProtocol& proto) {
             proto = Proto_RTP_RSm8_Source;
         } else if (strcmp(str, "rtp+ldpc") == 0) {
             proto = Proto_RTP_LDPC_Source;
+        } else if (strcmp(str, "rtp+xor") == 0) {
+            proto = Proto_RTP_XOR_Source;
         } else {
             roc_log(LogError, "parse port: '%s' is not a valid source port protocol",
                     str);
@@ -35,12 +37,24 @@ bool match_proto(PortType type, const char* str, PortProtocol& proto) {
             proto = Proto_RSm8_Repair;
         } else if (strcmp(str, "ldpc") == 0) {
             proto = Proto_LDPC_Repair;
+        } else if (strcmp(str, "xor") == 0) {
+            proto = Proto_XOR_Repair;
         } else {
             roc_log(LogError, "parse port: '%s' is not a valid repair port protocol",
                     str);
             return false;
         }
         return true;
+
+    case Port_AudioRetransmission:
+        if (strcmp(str, "rtx") == 0) {
+            proto = Proto_RTP_RTX;
+        } else {
+            roc_log(LogError,
+                    "parse port: '%s' is not a valid retransmission port protocol", str);
+            return false;
+        }
+        return true;
     }
 
     roc_log(LogError, "parse port: unsupported port type");
@@ -20,6 +20,8 @@ const char* port_type_to_str(PortType type) {
         return "source";
     case Port_AudioRepair:
         return "repair";
+    case Port_AudioRetransmission:
+        return "retransmission";
     }
     return "?";
 }
@@ -38,6 +40,12 @@ const char* port_proto_to_str(PortProtocol proto) {
         return "rtp+ldpc";
     case Proto_LDPC_Repair:
         return "ldpc";
+    case Proto_RTP_XOR_Source:
+        return "rtp+xor";
+    case Proto_XOR_Repair:
+        return "xor";
+    case Proto_RTP_RTX:
+        return "rtx";
     }
     return "?";
 }
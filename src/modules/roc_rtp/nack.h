@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/nack.h
+//! @brief RTCP Generic NACK.
+
+#ifndef ROC_RTP_NACK_H_
+#define ROC_RTP_NACK_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/endian.h"
+#include "roc_core/stddefs.h"
+#include "roc_rtp/headers.h"
+
+namespace roc {
+namespace rtp {
+
+//! RTCP Generic NACK header (RFC 4585).
+//! @remarks
+//!  Followed by one or more NackEntry.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |V=2|P| FMT=1   |    PT=205     |             length            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                  SSRC of packet sender                        |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                  SSRC of media source                         |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED NackHeader {
+private:
+    enum {
+        //! Version, padding flag and format.
+        Flags = (V2 << 6) | 1,
+
+        //! RTPFB packet type.
+        PacketType = 205
+    };
+
+    uint8_t flags_;
+    uint8_t packet_type_;
+    uint16_t length_;
+    uint32_t sender_ssrc_;
+    uint32_t media_ssrc_;
+
+public:
+    //! Clear header and set version, format and packet type.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+        flags_ = Flags;
+        packet_type_ = PacketType;
+    }
+
+    //! Check version, format and packet type.
+    bool valid() const {
+        return flags_ == Flags && packet_type_ == PacketType;
+    }
+
+    //! Get number of NACK entries following the header.
+    size_t num_entries() const {
+        const size_t len = core::ntoh16(length_);
+        return len >= 2 ? len - 2 : 0;
+    }
+
+    //! Set number of NACK entries following the header.
+    void set_num_entries(size_t n) {
+        length_ = core::hton16(uint16_t(n + 2));
+    }
+
+    //! Get SSRC of packet sender.
+    uint32_t sender_ssrc() const {
+        return core::ntoh32(sender_ssrc_);
+    }
+
+    //! Set SSRC of packet sender.
+    void set_sender_ssrc(uint32_t ssrc) {
+        sender_ssrc_ = core::hton32(ssrc);
+    }
+
+    //! Get SSRC of media source.
+    uint32_t media_ssrc() const {
+        return core::ntoh32(media_ssrc_);
+    }
+
+    //! Set SSRC of media source.
+    void set_media_ssrc(uint32_t ssrc) {
+        media_ssrc_ = core::hton32(ssrc);
+    }
+};
+
+//! RTCP Generic NACK entry.
+//! @remarks
+//!  PID is the sequence number of a lost packet, and BLP is a bitmask of
+//!  following lost packets, where bit i corresponds to PID + i + 1.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |            PID                |             BLP               |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+class ROC_ATTR_PACKED NackEntry {
+private:
+    uint16_t pid_;
+    uint16_t blp_;
+
+public:
+    //! Number of packets described by BLP.
+    enum { MaxBLP = 16 };
+
+    //! Get packet ID.
+    uint16_t pid() const {
+        return core::ntoh16(pid_);
+    }
+
+    //! Set packet ID.
+    void set_pid(uint16_t pid) {
+        pid_ = core::hton16(pid);
+    }
+
+    //! Get bitmask of following lost packets.
+    uint16_t blp() const {
+        return core::ntoh16(blp_);
+    }
+
+    //! Set bitmask of following lost packets.
+    void set_blp(uint16_t blp) {
+        blp_ = core::hton16(blp);
+    }
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_NACK_H_
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtp/nack_generator.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_rtp/nack.h"
+
+namespace roc {
+namespace rtp {
+
+NackGenerator::NackGenerator(packet::IWriter& writer,
+                             packet::IWriter& nack_writer,
+                             const packet::Address& dst_address,
+                             const NackConfig& config,
+                             core::nanoseconds_t latency,
+                             size_t sample_rate,
+                             packet::PacketPool& packet_pool,
+                             core::BufferPool<uint8_t>& buffer_pool,
+                             core::IAllocator& allocator)
+    : writer_(writer)
+    , nack_writer_(nack_writer)
+    , dst_address_(dst_address)
+    , packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , pending_(allocator)
+    , requested_(allocator)
+    , source_(0)
+    , last_seqnum_(0)
+    , started_(false)
+    , time_(0)
+    , retry_interval_(
+          (packet::timestamp_t)packet::timestamp_from_ns(config.retry_interval, sample_rate))
+    , latency_((packet::timestamp_t)packet::timestamp_from_ns(latency, sample_rate))
+    , config_(config)
+    , valid_(false) {
+    if (config.max_pending == 0 || config.max_retries == 0) {
+        roc_log(LogError, "nack generator: invalid config: max_pending=%lu max_retries=%lu",
+                (unsigned long)config.max_pending, (unsigned long)config.max_retries);
+        return;
+    }
+
+    if (!pending_.grow(config.max_pending) || !requested_.grow(config.max_pending)) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool NackGenerator::valid() const {
+    return valid_;
+}
+
+void NackGenerator::set_dst_address(const packet::Address& dst_address) {
+    dst_address_ = dst_address;
+}
+
+size_t NackGenerator::num_pending() const {
+    return pending_.size();
+}
+
+void NackGenerator::write(const packet::PacketPtr& pp) {
+    roc_panic_if(!valid());
+
+    if (const packet::RTP* rtp = pp->rtp()) {
+        if (!started_ || rtp->source != source_) {
+            source_ = rtp->source;
+            last_seqnum_ = rtp->seqnum;
+            started_ = true;
+            pending_.resize(0);
+        } else if (packet::seqnum_lt(last_seqnum_, rtp->seqnum)) {
+            add_pending_(packet::seqnum_t(last_seqnum_ + 1), rtp->seqnum);
+            last_seqnum_ = rtp->seqnum;
+        } else {
+            remove_pending_(rtp->seqnum);
+        }
+    }
+
+    writer_.write(pp);
+}
+
+void NackGenerator::update(packet::timestamp_t time) {
+    roc_panic_if(!valid());
+
+    time_ = time;
+
+    requested_.resize(0);
+
+    size_t n_kept = 0;
+
+    for (size_t n = 0; n < pending_.size(); n++) {
+        Entry& entry = pending_[n];
+
+        if (entry.n_sent >= config_.max_retries) {
+            continue;
+        }
+
+        const packet::timestamp_t deadline =
+            entry.detected_at + latency_ - retry_interval_;
+
+        if (packet::timestamp_lt(deadline, time)) {
+            continue;
+        }
+
+        if (entry.n_sent == 0 || packet::timestamp_le(entry.sent_at + retry_interval_, time)) {
+            entry.sent_at = time;
+            entry.n_sent++;
+            requested_.push_back(entry.seqnum);
+        }
+
+        pending_[n_kept++] = entry;
+    }
+
+    pending_.resize(n_kept);
+
+    if (requested_.size() != 0) {
+        send_nacks_();
+    }
+}
+
+void NackGenerator::add_pending_(packet::seqnum_t begin, packet::seqnum_t end) {
+    const size_t n_missing = (size_t)packet::seqnum_diff(end, begin);
+
+    if (n_missing == 0) {
+        return;
+    }
+
+    if (pending_.size() + n_missing > config_.max_pending) {
+        roc_log(LogDebug, "nack generator: ignoring too large gap: sn=%lu n_missing=%lu",
+                (unsigned long)begin, (unsigned long)n_missing);
+        return;
+    }
+
+    for (packet::seqnum_t sn = begin; sn != end; sn++) {
+        Entry entry;
+        entry.seqnum = sn;
+        entry.detected_at = time_;
+        entry.sent_at = time_;
+        entry.n_sent = 0;
+        pending_.push_back(entry);
+    }
+}
+
+void NackGenerator::remove_pending_(packet::seqnum_t seqnum) {
+    for (size_t n = 0; n < pending_.size(); n++) {
+        if (pending_[n].seqnum != seqnum) {
+            continue;
+        }
+        for (; n + 1 < pending_.size(); n++) {
+            pending_[n] = pending_[n + 1];
+        }
+        pending_.resize(pending_.size() - 1);
+        return;
+    }
+}
+
+void NackGenerator::send_nacks_() {
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "nack generator: can't allocate packet");
+        return;
+    }
+
+    core::Slice<uint8_t> data = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+    if (!data) {
+        roc_log(LogError, "nack generator: can't allocate buffer");
+        return;
+    }
+
+    const size_t max_entries =
+        (data.capacity() - sizeof(NackHeader)) / sizeof(NackEntry);
+
+    NackEntry* entries = (NackEntry*)(data.data() + sizeof(NackHeader));
+    size_t n_entries = 0;
+
+    for (size_t n = 0; n < requested_.size();) {
+        if (n_entries == max_entries) {
+            roc_log(LogDebug, "nack generator: too many nack entries, truncating");
+            break;
+        }
+
+        const packet::seqnum_t pid = requested_[n++];
+        uint16_t blp = 0;
+
+        for (; n < requested_.size(); n++) {
+            const packet::seqnum_diff_t off = packet::seqnum_diff(requested_[n], pid);
+            if (off < 1 || off > NackEntry::MaxBLP) {
+                break;
+            }
+            blp |= uint16_t(1 << (off - 1));
+        }
+
+        entries[n_entries].set_pid(pid);
+        entries[n_entries].set_blp(blp);
+        n_entries++;
+    }
+
+    data.resize(sizeof(NackHeader) + n_entries * sizeof(NackEntry));
+
+    NackHeader& header = *(NackHeader*)data.data();
+    header.clear();
+    header.set_num_entries(n_entries);
+    header.set_media_ssrc(source_);
+
+    pp->add_flags(packet::Packet::FlagUDP);
+    pp->udp()->dst_addr = dst_address_;
+    pp->set_data(data);
+
+    roc_log(LogDebug, "nack generator: sending nack: n_packets=%lu n_entries=%lu",
+            (unsigned long)requested_.size(), (unsigned long)n_entries);
+
+    nack_writer_.write(pp);
+}
+
+} // namespace rtp
+} // namespace roc
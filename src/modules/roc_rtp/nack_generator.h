@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/nack_generator.h
+//! @brief NACK generator.
+
+#ifndef ROC_RTP_NACK_GENERATOR_H_
+#define ROC_RTP_NACK_GENERATOR_H_
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/address.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace rtp {
+
+//! NACK generator parameters.
+struct NackConfig {
+    //! Interval between repeated NACKs for the same packet, nanoseconds.
+    core::nanoseconds_t retry_interval;
+
+    //! Maximum number of NACKs for the same packet.
+    size_t max_retries;
+
+    //! Maximum number of missing packets tracked at the same time.
+    //! @remarks
+    //!  Larger gaps are considered as stream restart and are ignored.
+    size_t max_pending;
+
+    NackConfig()
+        : retry_interval(20 * core::Millisecond)
+        , max_retries(3)
+        , max_pending(64) {
+    }
+};
+
+//! NACK generator.
+//! @remarks
+//!  Passes packets to the output writer and tracks gaps in sequence numbers.
+//!  For every missing packet, periodically writes RTCP Generic NACK packets
+//!  to the NACK writer, until the packet arrives, the retry limit is reached,
+//!  or there is no more time left to receive a retransmission before the
+//!  packet should be played.
+class NackGenerator : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p writer is used to write incoming packets
+    //!  - @p nack_writer is used to write NACK packets
+    //!  - @p dst_address is destination address of NACK packets
+    //!  - @p config defines generator parameters
+    //!  - @p latency defines how long a packet may be awaited, nanoseconds
+    //!  - @p sample_rate defines the units of timestamps passed to update()
+    NackGenerator(packet::IWriter& writer,
+                  packet::IWriter& nack_writer,
+                  const packet::Address& dst_address,
+                  const NackConfig& config,
+                  core::nanoseconds_t latency,
+                  size_t sample_rate,
+                  packet::PacketPool& packet_pool,
+                  core::BufferPool<uint8_t>& buffer_pool,
+                  core::IAllocator& allocator);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Set destination address of NACK packets.
+    void set_dst_address(const packet::Address& dst_address);
+
+    //! Write packet.
+    virtual void write(const packet::PacketPtr& packet);
+
+    //! Update generator state and send NACKs if needed.
+    void update(packet::timestamp_t time);
+
+    //! Get number of missing packets being tracked.
+    size_t num_pending() const;
+
+private:
+    struct Entry {
+        packet::seqnum_t seqnum;
+        packet::timestamp_t detected_at;
+        packet::timestamp_t sent_at;
+        size_t n_sent;
+    };
+
+    void add_pending_(packet::seqnum_t begin, packet::seqnum_t end);
+    void remove_pending_(packet::seqnum_t seqnum);
+    void send_nacks_();
+
+    packet::IWriter& writer_;
+    packet::IWriter& nack_writer_;
+
+    packet::Address dst_address_;
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+
+    core::Array<Entry> pending_;
+    core::Array<packet::seqnum_t> requested_;
+
+    packet::source_t source_;
+    packet::seqnum_t last_seqnum_;
+    bool started_;
+
+    packet::timestamp_t time_;
+
+    packet::timestamp_t retry_interval_;
+    packet::timestamp_t latency_;
+
+    const NackConfig config_;
+
+    bool valid_;
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_NACK_GENERATOR_H_
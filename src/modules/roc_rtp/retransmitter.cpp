@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtp/retransmitter.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_core/random.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/rtx.h"
+
+namespace roc {
+namespace rtp {
+
+Retransmitter::Retransmitter(packet::IWriter& writer,
+                             packet::IWriter& rtx_writer,
+                             size_t n_packets,
+                             packet::PacketPool& packet_pool,
+                             core::BufferPool<uint8_t>& buffer_pool,
+                             core::IAllocator& allocator)
+    : writer_(writer)
+    , rtx_writer_(rtx_writer)
+    , packet_pool_(packet_pool)
+    , buffer_pool_(buffer_pool)
+    , packets_(allocator)
+    , rtx_seqnum_((packet::seqnum_t)core::random(packet::seqnum_t(-1)))
+    , valid_(false) {
+    if (n_packets == 0) {
+        roc_log(LogError, "retransmitter: buffer size should be positive");
+        return;
+    }
+
+    // seqnum overflows at power of two, so the ring size should divide it
+    size_t ring_size = 1;
+    while (ring_size < n_packets) {
+        ring_size <<= 1;
+    }
+
+    if (!packets_.resize(ring_size)) {
+        roc_log(LogError, "retransmitter: can't allocate buffer: n_packets=%lu",
+                (unsigned long)n_packets);
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool Retransmitter::valid() const {
+    return valid_;
+}
+
+void Retransmitter::write(const packet::PacketPtr& pp) {
+    roc_panic_if(!valid());
+
+    writer_.write(pp);
+
+    const packet::RTP* rtp = pp->rtp();
+    if (!rtp || !pp->data()) {
+        return;
+    }
+
+    packets_[rtp->seqnum % packets_.size()] = pp;
+}
+
+bool Retransmitter::retransmit(packet::seqnum_t seqnum) {
+    roc_panic_if(!valid());
+
+    const packet::PacketPtr& orig = packets_[seqnum % packets_.size()];
+
+    if (!orig || orig->rtp()->seqnum != seqnum) {
+        roc_log(LogDebug, "retransmitter: packet is not in buffer: sn=%lu",
+                (unsigned long)seqnum);
+        return false;
+    }
+
+    packet::PacketPtr pp = make_rtx_packet_(*orig);
+    if (!pp) {
+        return false;
+    }
+
+    rtx_writer_.write(pp);
+    return true;
+}
+
+packet::PacketPtr Retransmitter::make_rtx_packet_(const packet::Packet& orig) {
+    const core::Slice<uint8_t>& orig_data = orig.data();
+    const size_t header_size = orig.rtp()->header.size();
+
+    if (header_size < sizeof(Header) || orig_data.size() < header_size) {
+        roc_log(LogError, "retransmitter: unexpected packet layout");
+        return NULL;
+    }
+
+    if (!rtx_supported_payload_type(orig.rtp()->payload_type)) {
+        roc_log(LogDebug, "retransmitter: no rtx payload type for pt=%u",
+                (unsigned)orig.rtp()->payload_type);
+        return NULL;
+    }
+
+    packet::PacketPtr pp = new (packet_pool_) packet::Packet(packet_pool_);
+    if (!pp) {
+        roc_log(LogError, "retransmitter: can't allocate packet");
+        return NULL;
+    }
+
+    core::Slice<uint8_t> data = new (buffer_pool_) core::Buffer<uint8_t>(buffer_pool_);
+    if (!data) {
+        roc_log(LogError, "retransmitter: can't allocate buffer");
+        return NULL;
+    }
+
+    if (data.capacity() < orig_data.size() + RtxHeaderSize) {
+        roc_log(LogDebug, "retransmitter: not enough space for rtx packet: cap=%lu",
+                (unsigned long)data.capacity());
+        return NULL;
+    }
+    data.resize(orig_data.size() + RtxHeaderSize);
+
+    const packet::seqnum_t osn = orig.rtp()->seqnum;
+
+    memcpy(data.data(), orig_data.data(), header_size);
+    data.data()[header_size] = uint8_t(osn >> 8);
+    data.data()[header_size + 1] = uint8_t(osn);
+    memcpy(data.data() + header_size + RtxHeaderSize, orig_data.data() + header_size,
+           orig_data.size() - header_size);
+
+    Header& header = *(Header*)data.data();
+    header.set_seqnum(rtx_seqnum_++);
+    header.set_payload_type(uint8_t(rtx_payload_type(header.payload_type())));
+
+    pp->add_flags(packet::Packet::FlagRTP | packet::Packet::FlagComposed);
+    pp->set_data(data);
+
+    return pp;
+}
+
+} // namespace rtp
+} // namespace roc
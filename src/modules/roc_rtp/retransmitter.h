@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/retransmitter.h
+//! @brief RTP retransmitter.
+
+#ifndef ROC_RTP_RETRANSMITTER_H_
+#define ROC_RTP_RETRANSMITTER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace rtp {
+
+//! RTP retransmitter.
+//! @remarks
+//!  Passes composed packets to the output writer and remembers the last
+//!  few of them, keyed by sequence number. When a packet is requested by
+//!  retransmit(), builds an RTX packet (RFC 4588, session multiplexing)
+//!  from it and writes it to the retransmission writer.
+class Retransmitter : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p writer is used to write original packets
+    //!  - @p rtx_writer is used to write retransmitted packets
+    //!  - @p n_packets defines how many recent packets are remembered, at least
+    Retransmitter(packet::IWriter& writer,
+                  packet::IWriter& rtx_writer,
+                  size_t n_packets,
+                  packet::PacketPool& packet_pool,
+                  core::BufferPool<uint8_t>& buffer_pool,
+                  core::IAllocator& allocator);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Write original packet.
+    //! @remarks
+    //!  The packet should be composed by @p writer.
+    virtual void write(const packet::PacketPtr& packet);
+
+    //! Retransmit packet.
+    //! @returns
+    //!  false if the packet is no longer remembered or can't be retransmitted.
+    bool retransmit(packet::seqnum_t seqnum);
+
+private:
+    packet::PacketPtr make_rtx_packet_(const packet::Packet& orig);
+
+    packet::IWriter& writer_;
+    packet::IWriter& rtx_writer_;
+
+    packet::PacketPool& packet_pool_;
+    core::BufferPool<uint8_t>& buffer_pool_;
+
+    core::Array<packet::PacketPtr> packets_;
+
+    packet::seqnum_t rtx_seqnum_;
+
+    bool valid_;
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_RETRANSMITTER_H_
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/rtx.h
+//! @brief RTP retransmission payload format.
+
+#ifndef ROC_RTP_RTX_H_
+#define ROC_RTP_RTX_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace rtp {
+
+//! Size of original sequence number (OSN) at the beginning of RTX payload.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                         RTP Header                            |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |            OSN                |                               |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+                               |
+//!   |                  Original RTP Packet Payload                  |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+const size_t RtxHeaderSize = 2;
+
+//! Offset between RTX payload type and original payload type.
+//! @remarks
+//!  RFC 4588 requires RTX stream to use a dynamic payload type associated
+//!  with the original one. Since there is no signaling, the association is
+//!  fixed: RTX payload type is the original one plus this offset.
+const unsigned int RtxPayloadTypeOffset = 96;
+
+//! Check if original payload type has RTX payload type.
+//! @remarks
+//!  RTP payload type is 7 bits, so only payload types lower than
+//!  128 - RtxPayloadTypeOffset can be retransmitted.
+inline bool rtx_supported_payload_type(unsigned int payload_type) {
+    return payload_type + RtxPayloadTypeOffset <= 127;
+}
+
+//! Get RTX payload type for original payload type.
+//! @pre
+//!  rtx_supported_payload_type() is true for @p payload_type.
+inline unsigned int rtx_payload_type(unsigned int payload_type) {
+    return payload_type + RtxPayloadTypeOffset;
+}
+
+//! Get original payload type for RTX payload type.
+//! @returns
+//!  false if @p rtx_payload_type is not an RTX payload type.
+inline bool rtx_associated_payload_type(unsigned int rtx_payload_type,
+                                        unsigned int& payload_type) {
+    if (rtx_payload_type < RtxPayloadTypeOffset) {
+        return false;
+    }
+    payload_type = rtx_payload_type - RtxPayloadTypeOffset;
+    return true;
+}
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_RTX_H_
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_rtp/rtx_parser.h"
+#include "roc_core/log.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/rtx.h"
+
+namespace roc {
+namespace rtp {
+
+RtxParser::RtxParser(packet::IParser* inner_parser)
+    : inner_parser_(inner_parser) {
+}
+
+bool RtxParser::parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer) {
+    if (buffer.size() < sizeof(Header)) {
+        roc_log(LogDebug, "rtx parser: bad packet, size < %d (rtp header)",
+                (int)sizeof(Header));
+        return false;
+    }
+
+    Header& header = *(Header*)buffer.data();
+
+    if (header.version() != V2) {
+        roc_log(LogDebug, "rtx parser: bad version, get %d, expected %d",
+                (int)header.version(), (int)V2);
+        return false;
+    }
+
+    size_t header_size = header.header_size();
+
+    if (header.has_extension()) {
+        if (buffer.size() < header_size + sizeof(ExtentionHeader)) {
+            roc_log(LogDebug, "rtx parser: bad packet, size < %d (rtp ext header)",
+                    (int)(header_size + sizeof(ExtentionHeader)));
+            return false;
+        }
+
+        const ExtentionHeader& extension =
+            *(const ExtentionHeader*)(buffer.data() + header_size);
+
+        header_size += sizeof(ExtentionHeader) + extension.data_size();
+    }
+
+    if (buffer.size() < header_size + RtxHeaderSize) {
+        roc_log(LogDebug, "rtx parser: bad packet, size < %d (rtp header + osn)",
+                (int)(header_size + RtxHeaderSize));
+        return false;
+    }
+
+    unsigned int payload_type = 0;
+    if (!rtx_associated_payload_type(header.payload_type(), payload_type)) {
+        roc_log(LogDebug, "rtx parser: unexpected payload type %u",
+                (unsigned)header.payload_type());
+        return false;
+    }
+
+    uint8_t* osn = buffer.data() + header_size;
+
+    header.set_seqnum(uint16_t((osn[0] << 8) | osn[1]));
+    header.set_payload_type(uint8_t(payload_type));
+
+    memmove(buffer.data() + RtxHeaderSize, buffer.data(), header_size);
+
+    packet.add_flags(packet::Packet::FlagRetransmitted);
+
+    if (inner_parser_) {
+        return inner_parser_->parse(packet, buffer.range(RtxHeaderSize, buffer.size()));
+    }
+
+    return true;
+}
+
+} // namespace rtp
+} // namespace roc
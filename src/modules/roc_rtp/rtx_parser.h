@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_rtp/rtx_parser.h
+//! @brief RTP retransmission payload parser.
+
+#ifndef ROC_RTP_RTX_PARSER_H_
+#define ROC_RTP_RTX_PARSER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_packet/iparser.h"
+
+namespace roc {
+namespace rtp {
+
+//! RTP retransmission payload parser.
+//!
+//! Restores the original packet from RTX packet (RFC 4588, session
+//! multiplexing) in-place: moves the original sequence number and the
+//! associated payload type into RTP header, removes the original sequence
+//! number from the payload, and marks the packet with FlagRetransmitted.
+//! The restored packet is byte-exact and starts at RtxHeaderSize offset
+//! of the original buffer, so it may be parsed later as a source packet.
+class RtxParser : public packet::IParser, public core::NonCopyable<> {
+public:
+    //! Initialization.
+    //!
+    //! @b Parameters
+    //!  - if @p inner_parser is not NULL, it is used to parse restored packet
+    explicit RtxParser(packet::IParser* inner_parser);
+
+    //! Parse RTX packet.
+    virtual bool parse(packet::Packet& packet, const core::Slice<uint8_t>& buffer);
+
+private:
+    packet::IParser* inner_parser_;
+};
+
+} // namespace rtp
+} // namespace roc
+
+#endif // ROC_RTP_RTX_PARSER_H_
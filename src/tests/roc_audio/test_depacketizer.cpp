@@ -459,6 +459,22 @@ TEST(depacketizer, frame_flags_drops) {
     }
 }
 
+TEST(depacketizer, frame_flags_beep) {
+    audio::PCMEncoder encoder(pcm_funcs);
+    audio::PCMDecoder decoder(pcm_funcs);
+
+    packet::Queue queue;
+    Depacketizer dp(queue, decoder, ChMask, true);
+
+    queue.write(new_packet(encoder, SamplesPerPacket * 1, 0.11f));
+    queue.write(new_packet(encoder, SamplesPerPacket * 3, 0.11f));
+
+    expect_flags(dp, SamplesPerPacket, 0);
+    expect_flags(dp, SamplesPerPacket,
+                 Frame::FlagIncomplete | Frame::FlagBlank | Frame::FlagBeep);
+    expect_flags(dp, SamplesPerPacket, 0);
+}
+
 TEST(depacketizer, timestamp) {
     enum {
         StartTimestamp = 1000,
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/frame_ring.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/panic.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { NumFrames = 4, FrameSize = 10, ManyFrames = 10000 };
+
+core::HeapAllocator allocator;
+
+sample_t nth_sample(size_t n) {
+    return sample_t(n % 1000) / 1000;
+}
+
+void fill_frame(sample_t* samples, size_t n_samples, size_t offset) {
+    for (size_t n = 0; n < n_samples; n++) {
+        samples[n] = nth_sample(offset + n);
+    }
+}
+
+class Producer : public core::Thread {
+public:
+    Producer(FrameRing& ring)
+        : ring_(ring) {
+    }
+
+private:
+    virtual void run() {
+        sample_t samples[FrameSize];
+
+        size_t offset = 0;
+
+        for (size_t nf = 0; nf < ManyFrames; nf++) {
+            const size_t n_samples = nf % FrameSize + 1;
+
+            fill_frame(samples, n_samples, offset);
+            offset += n_samples;
+
+            while (!ring_.push(samples, n_samples)) {
+            }
+        }
+    }
+
+    FrameRing& ring_;
+};
+
+} // namespace
+
+TEST_GROUP(frame_ring) {};
+
+TEST(frame_ring, empty) {
+    FrameRing ring(allocator, NumFrames, FrameSize);
+    CHECK(ring.valid());
+
+    UNSIGNED_LONGS_EQUAL(FrameSize, ring.frame_size());
+    UNSIGNED_LONGS_EQUAL(0, ring.size());
+
+    CHECK(ring.empty());
+    CHECK(!ring.full());
+
+    size_t n_samples = 0;
+    CHECK(!ring.front(n_samples));
+}
+
+TEST(frame_ring, push_pop) {
+    FrameRing ring(allocator, NumFrames, FrameSize);
+    CHECK(ring.valid());
+
+    sample_t samples[FrameSize];
+
+    size_t wr_offset = 0;
+    size_t rd_offset = 0;
+
+    for (size_t iter = 0; iter < NumFrames * 3; iter++) {
+        for (size_t nf = 0; nf < NumFrames; nf++) {
+            const size_t n_samples = FrameSize - nf;
+
+            fill_frame(samples, n_samples, wr_offset);
+            wr_offset += n_samples;
+
+            CHECK(ring.push(samples, n_samples));
+            UNSIGNED_LONGS_EQUAL(nf + 1, ring.size());
+        }
+
+        CHECK(ring.full());
+        CHECK(!ring.push(samples, FrameSize));
+
+        for (size_t nf = 0; nf < NumFrames; nf++) {
+            size_t n_samples = 0;
+            const sample_t* frame = ring.front(n_samples);
+
+            CHECK(frame);
+            UNSIGNED_LONGS_EQUAL(FrameSize - nf, n_samples);
+
+            for (size_t n = 0; n < n_samples; n++) {
+                DOUBLES_EQUAL((double)nth_sample(rd_offset), (double)frame[n], 0);
+                rd_offset++;
+            }
+
+            ring.pop();
+            UNSIGNED_LONGS_EQUAL(NumFrames - nf - 1, ring.size());
+        }
+
+        CHECK(ring.empty());
+    }
+}
+
+TEST(frame_ring, wraparound) {
+    FrameRing ring(allocator, NumFrames, FrameSize);
+    CHECK(ring.valid());
+
+    sample_t samples[FrameSize];
+
+    size_t wr_offset = 0;
+    size_t rd_offset = 0;
+
+    for (size_t nf = 0; nf < NumFrames - 1; nf++) {
+        fill_frame(samples, FrameSize, wr_offset);
+        wr_offset += FrameSize;
+        CHECK(ring.push(samples, FrameSize));
+    }
+
+    for (size_t nf = 0; nf < NumFrames * 10; nf++) {
+        fill_frame(samples, FrameSize, wr_offset);
+        wr_offset += FrameSize;
+        CHECK(ring.push(samples, FrameSize));
+
+        CHECK(ring.full());
+
+        size_t n_samples = 0;
+        const sample_t* frame = ring.front(n_samples);
+
+        CHECK(frame);
+        UNSIGNED_LONGS_EQUAL(FrameSize, n_samples);
+
+        for (size_t n = 0; n < n_samples; n++) {
+            DOUBLES_EQUAL((double)nth_sample(rd_offset), (double)frame[n], 0);
+            rd_offset++;
+        }
+
+        ring.pop();
+        UNSIGNED_LONGS_EQUAL(NumFrames - 1, ring.size());
+    }
+}
+
+TEST(frame_ring, concurrent) {
+    FrameRing ring(allocator, NumFrames, FrameSize);
+    CHECK(ring.valid());
+
+    Producer producer(ring);
+    CHECK(producer.start());
+
+    size_t offset = 0;
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        size_t n_samples = 0;
+        const sample_t* frame = NULL;
+
+        while (!(frame = ring.front(n_samples))) {
+        }
+
+        UNSIGNED_LONGS_EQUAL(nf % FrameSize + 1, n_samples);
+
+        for (size_t n = 0; n < n_samples; n++) {
+            DOUBLES_EQUAL((double)nth_sample(offset), (double)frame[n], 0);
+            offset++;
+        }
+
+        ring.pop();
+    }
+
+    producer.join();
+
+    CHECK(ring.empty());
+}
+
+} // namespace audio
+} // namespace roc
@@ -55,5 +55,21 @@ TEST(freq_estimator, small_queue_size) {
     } while (fe.freq_coeff() > 0.99f);
 }
 
+TEST(freq_estimator, set_target_latency) {
+    FreqEstimator fe(Target);
+
+    fe.set_target_latency(Target * 2);
+
+    do {
+        fe.update(Target);
+    } while (fe.freq_coeff() > 0.99f);
+
+    fe.set_target_latency(Target / 2);
+
+    do {
+        fe.update(Target);
+    } while (fe.freq_coeff() < 1.01f);
+}
+
 } // namespace audio
 } // namespace roc
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/depacketizer.h"
+#include "roc_audio/latency_monitor.h"
+#include "roc_audio/pcm_decoder.h"
+#include "roc_audio/pcm_encoder.h"
+#include "roc_audio/pcm_funcs.h"
+#include "roc_audio/resampler_reader.h"
+#include "roc_audio/time_stretch_reader.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/sorted_queue.h"
+#include "roc_rtp/composer.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    MaxBufSize = 4000,
+    SampleRate = 10000,
+    SamplesPerPacket = 100,
+    StartLatency = 1000,
+    TargetLatency = 2000,
+    NumCh = 2,
+    ChMask = 0x3
+};
+
+const core::nanoseconds_t NsPerSample = core::Second / SampleRate;
+
+core::HeapAllocator allocator;
+core::BufferPool<sample_t> sample_buffer_pool(allocator, MaxBufSize, true);
+core::BufferPool<uint8_t> byte_buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+rtp::Composer rtp_composer(NULL);
+
+const audio::PCMFuncs& pcm_funcs = audio::PCM_int16_2ch;
+
+} // namespace
+
+TEST_GROUP(latency_monitor) {
+    PCMEncoder* encoder;
+    PCMDecoder* decoder;
+
+    packet::SortedQueue* queue;
+    Depacketizer* depacketizer;
+    ResamplerReader* resampler;
+
+    LatencyMonitorConfig config;
+
+    void setup() {
+        encoder = new PCMEncoder(pcm_funcs);
+        decoder = new PCMDecoder(pcm_funcs);
+
+        queue = new packet::SortedQueue(0);
+        depacketizer = new Depacketizer(*queue, *decoder, ChMask, false);
+        resampler = new ResamplerReader(*depacketizer, sample_buffer_pool, allocator,
+                                        ResamplerConfig(), ChMask);
+        CHECK(resampler->valid());
+
+        config.min_latency = -TargetLatency * NsPerSample;
+        config.max_latency = TargetLatency * 2 * NsPerSample;
+    }
+
+    void teardown() {
+        delete resampler;
+        delete depacketizer;
+        delete queue;
+        delete decoder;
+        delete encoder;
+    }
+
+    void write_packets(packet::timestamp_t latency) {
+        for (packet::timestamp_t ts = 0; ts < latency; ts += SamplesPerPacket) {
+            write_packet(ts);
+        }
+    }
+
+    void write_packet(packet::timestamp_t ts) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        core::Slice<uint8_t> bp =
+            new (byte_buffer_pool) core::Buffer<uint8_t>(byte_buffer_pool);
+        CHECK(bp);
+
+        CHECK(rtp_composer.prepare(*pp, bp, encoder->encoded_size(SamplesPerPacket)));
+
+        pp->set_data(bp);
+
+        pp->rtp()->timestamp = ts;
+        pp->rtp()->duration = SamplesPerPacket;
+
+        sample_t samples[SamplesPerPacket * NumCh] = {};
+
+        encoder->begin(pp->rtp()->payload.data(), pp->rtp()->payload.size());
+        UNSIGNED_LONGS_EQUAL(SamplesPerPacket,
+                             encoder->write(samples, SamplesPerPacket, ChMask));
+        encoder->end();
+
+        CHECK(rtp_composer.compose(*pp));
+
+        queue->write(pp);
+    }
+
+    void start_playback() {
+        sample_t samples[NumCh] = {};
+        Frame frame(samples, NumCh);
+        depacketizer->read(frame);
+        CHECK(depacketizer->started());
+    }
+};
+
+TEST(latency_monitor, no_fast_start) {
+    LatencyMonitor monitor(*queue, *depacketizer, resampler, NULL, config,
+                           TargetLatency * NsPerSample, 0, SampleRate, SampleRate,
+                           allocator);
+    CHECK(monitor.valid());
+
+    write_packets(TargetLatency);
+    start_playback();
+
+    const packet::timestamp_t update_interval =
+        (packet::timestamp_t)(config.fe_update_interval / NsPerSample);
+
+    for (packet::timestamp_t pos = 0; pos < SampleRate * 100; pos += update_interval) {
+        CHECK(monitor.update(pos));
+        UNSIGNED_LONGS_EQUAL(TargetLatency, monitor.target_latency());
+    }
+}
+
+TEST(latency_monitor, fast_start) {
+    LatencyMonitor monitor(*queue, *depacketizer, resampler, NULL, config,
+                           TargetLatency * NsPerSample, StartLatency * NsPerSample,
+                           SampleRate, SampleRate, allocator);
+    CHECK(monitor.valid());
+
+    UNSIGNED_LONGS_EQUAL(StartLatency, monitor.target_latency());
+
+    write_packets(StartLatency);
+    start_playback();
+
+    const packet::timestamp_t update_interval =
+        (packet::timestamp_t)(config.fe_update_interval / NsPerSample);
+
+    // target should grow at half of the maximum drift rate
+    const float max_step = config.max_scaling_delta / 2 * update_interval;
+
+    packet::timestamp_t prev_target = monitor.target_latency();
+
+    for (packet::timestamp_t pos = 0; pos < SampleRate * 1000; pos += update_interval) {
+        CHECK(monitor.update(pos));
+
+        const packet::timestamp_t target = monitor.target_latency();
+
+        CHECK(target >= prev_target);
+        CHECK((float)(target - prev_target) <= max_step + 1);
+
+        prev_target = target;
+    }
+
+    UNSIGNED_LONGS_EQUAL(TargetLatency, monitor.target_latency());
+}
+
+TEST(latency_monitor, fast_start_without_resampler) {
+    LatencyMonitor monitor(*queue, *depacketizer, NULL, NULL, config,
+                           TargetLatency * NsPerSample, StartLatency * NsPerSample,
+                           SampleRate, SampleRate, allocator);
+    CHECK(!monitor.valid());
+}
+
+TEST(latency_monitor, start_latency_above_target) {
+    LatencyMonitor monitor(*queue, *depacketizer, NULL, NULL, config,
+                           TargetLatency * NsPerSample, TargetLatency * 2 * NsPerSample,
+                           SampleRate, SampleRate, allocator);
+    CHECK(monitor.valid());
+
+    UNSIGNED_LONGS_EQUAL(TargetLatency, monitor.target_latency());
+}
+
+TEST(latency_monitor, adaptive_latency_grows_under_jitter) {
+    enum { Jitter = 1500, Period = 80 };
+
+    config.adaptive_latency = true;
+    config.min_target_latency = TargetLatency / 2 * NsPerSample;
+    config.max_target_latency = config.max_latency;
+    config.jitter_window = config.fe_update_interval * Period * 4;
+
+    LatencyMonitor monitor(*queue, *depacketizer, resampler, NULL, config,
+                           TargetLatency * NsPerSample, 0, SampleRate, SampleRate,
+                           allocator);
+    CHECK(monitor.valid());
+
+    write_packets(TargetLatency);
+    start_playback();
+
+    const packet::timestamp_t update_interval =
+        (packet::timestamp_t)(config.fe_update_interval / NsPerSample);
+
+    packet::timestamp_t write_pos = TargetLatency;
+    packet::timestamp_t pos = 0;
+    packet::timestamp_t max_latency = 0;
+
+    for (size_t n = 0; n < 20000; n++) {
+        sample_t samples[MaxBufSize];
+        Frame frame(samples, update_interval * NumCh);
+        depacketizer->read(frame);
+
+        // latency follows the target and periodically jumps above it
+        const packet::timestamp_t jitter = (n % Period) < Period / 2 ? Jitter : 0;
+        const packet::timestamp_t latency = monitor.target_latency() + jitter;
+
+        while (write_pos < depacketizer->timestamp() + latency) {
+            write_packet(write_pos);
+            write_pos += SamplesPerPacket;
+        }
+
+        max_latency = std::max(max_latency, write_pos - depacketizer->timestamp());
+
+        CHECK(monitor.update(pos));
+        pos += update_interval;
+    }
+
+    // target was raised, and latency went above the configured maximum
+    CHECK(monitor.target_latency() > TargetLatency + Jitter / 2);
+    CHECK(max_latency > TargetLatency * 2);
+}
+
+TEST(latency_monitor, time_stretching) {
+    TimeStretchReader stretcher(*depacketizer, allocator, TimeStretchConfig(), SampleRate,
+                                ChMask);
+    CHECK(stretcher.valid());
+
+    LatencyMonitor monitor(*queue, *depacketizer, NULL, &stretcher, config,
+                           TargetLatency * NsPerSample, 0, SampleRate, SampleRate,
+                           allocator);
+    CHECK(monitor.valid());
+
+    const packet::timestamp_t threshold =
+        (packet::timestamp_t)(config.stretch_threshold / NsPerSample);
+
+    write_packets(TargetLatency + threshold * 2);
+    start_playback();
+
+    CHECK(monitor.update(0));
+    DOUBLES_EQUAL(1.0 + (double)config.max_stretch_delta, (double)stretcher.scaling(),
+                  1e-6);
+
+    // compensate latency by reading from stretcher
+    size_t n_read = 0;
+    while (stretcher.scaling() > 1.0f) {
+        sample_t samples[SamplesPerPacket * NumCh];
+        Frame frame(samples, SamplesPerPacket * NumCh);
+        stretcher.read(frame);
+
+        n_read += SamplesPerPacket;
+        CHECK(monitor.update((packet::timestamp_t)n_read));
+    }
+
+    // stretcher is disabled when deviation drops below half of threshold
+    const packet::timestamp_t head = depacketizer->timestamp();
+    CHECK(TargetLatency + threshold * 2 - head < TargetLatency + threshold / 2);
+    CHECK(TargetLatency + threshold * 2 - head > TargetLatency);
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/latency_tuner.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    Target = 1000,
+    MinTarget = 100,
+    MaxTarget = 2000,
+    Window = 10,
+    NumUpdates = 100000
+};
+
+const float MaxStep = 1.0f;
+
+long target_delta(packet::timestamp_t a, packet::timestamp_t b) {
+    return (long)a - (long)b;
+}
+
+} // namespace
+
+TEST_GROUP(latency_tuner) {};
+
+TEST(latency_tuner, initial) {
+    LatencyTuner tuner(Target, MinTarget, MaxTarget, Window, MaxStep);
+
+    UNSIGNED_LONGS_EQUAL(Target, tuner.target_latency());
+}
+
+TEST(latency_tuner, no_jitter) {
+    LatencyTuner tuner(Target, MinTarget, MaxTarget, Window, MaxStep);
+
+    for (size_t n = 0; n < NumUpdates; n++) {
+        const packet::timestamp_t prev = tuner.target_latency();
+
+        tuner.update(Target, 0);
+
+        CHECK(tuner.target_latency() <= prev);
+        CHECK(target_delta(prev, tuner.target_latency()) <= (long)MaxStep);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, tuner.jitter());
+    UNSIGNED_LONGS_EQUAL(MinTarget, tuner.target_latency());
+}
+
+TEST(latency_tuner, jitter) {
+    enum { Swing = 800 };
+
+    LatencyTuner tuner(Target, MinTarget, MaxTarget, Window, MaxStep);
+
+    for (size_t n = 0; n < NumUpdates; n++) {
+        const packet::timestamp_t prev = tuner.target_latency();
+
+        tuner.update(n % 2 ? Target - Swing / 2 : Target + Swing / 2, 0);
+
+        CHECK(tuner.target_latency() >= prev);
+        CHECK(target_delta(tuner.target_latency(), prev) <= (long)MaxStep);
+    }
+
+    UNSIGNED_LONGS_EQUAL(Swing, tuner.jitter());
+    UNSIGNED_LONGS_EQUAL(Swing * 2, tuner.target_latency());
+}
+
+TEST(latency_tuner, jitter_decrease) {
+    enum { LargeSwing = 900, SmallSwing = 200 };
+
+    LatencyTuner tuner(Target, MinTarget, MaxTarget, Window, MaxStep);
+
+    for (size_t n = 0; n < NumUpdates; n++) {
+        tuner.update(n % 2 ? Target - LargeSwing / 2 : Target + LargeSwing / 2, 0);
+    }
+
+    UNSIGNED_LONGS_EQUAL(LargeSwing * 2, tuner.target_latency());
+
+    for (size_t n = 0; n < NumUpdates; n++) {
+        tuner.update(n % 2 ? Target - SmallSwing / 2 : Target + SmallSwing / 2, 0);
+    }
+
+    UNSIGNED_LONGS_EQUAL(SmallSwing * 2, tuner.target_latency());
+}
+
+TEST(latency_tuner, max_target) {
+    enum { Swing = 1500 };
+
+    LatencyTuner tuner(Target, MinTarget, MaxTarget, Window, MaxStep);
+
+    for (size_t n = 0; n < NumUpdates; n++) {
+        tuner.update(n % 2 ? Target - Swing / 2 : Target + Swing / 2, 0);
+
+        CHECK(tuner.target_latency() <= MaxTarget);
+    }
+
+    UNSIGNED_LONGS_EQUAL(MaxTarget, tuner.target_latency());
+}
+
+TEST(latency_tuner, drops) {
+    LatencyTuner tuner(Target, MinTarget, MaxTarget, Window, MaxStep);
+
+    size_t dropped_packets = 0;
+
+    for (size_t n = 0; n < NumUpdates; n++) {
+        if (n % Window == 0) {
+            dropped_packets++;
+        }
+
+        const packet::timestamp_t prev = tuner.target_latency();
+
+        tuner.update(Target, dropped_packets);
+
+        CHECK(tuner.target_latency() >= prev);
+        CHECK(target_delta(tuner.target_latency(), prev) <= (long)MaxStep);
+    }
+
+    UNSIGNED_LONGS_EQUAL(MaxTarget, tuner.target_latency());
+}
+
+TEST(latency_tuner, drops_stopped) {
+    LatencyTuner tuner(Target, MinTarget, MaxTarget, Window, MaxStep);
+
+    for (size_t n = 0; n < Window * 2; n++) {
+        tuner.update(Target, 1);
+    }
+
+    CHECK(tuner.target_latency() > Target);
+
+    for (size_t n = 0; n < NumUpdates; n++) {
+        tuner.update(Target, 1);
+    }
+
+    UNSIGNED_LONGS_EQUAL(MinTarget, tuner.target_latency());
+}
+
+} // namespace audio
+} // namespace roc
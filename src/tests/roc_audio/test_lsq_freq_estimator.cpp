@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/lsq_freq_estimator.h"
+#include "roc_core/helpers.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    SampleRate = 48000,
+    PacketSize = 336,
+    UpdateInterval = 240,
+    NetworkDelay = 480,
+    Target = 9600,
+    Window = SampleRate * 30
+};
+
+const double Ppm = 1e-6;
+
+// Simulates sender and receiver with different clocks connected by network
+// with jitter. Time is measured in samples of the receiver clock.
+class ClockSim {
+public:
+    ClockSim(double drift, double jitter_ms, unsigned seed, bool arrival_time = true)
+        : drift_(drift)
+        , jitter_(jitter_ms * SampleRate / 1000)
+        , arrival_time_(arrival_time)
+        , seed_(seed)
+        , time_(0)
+        , next_packet_(0)
+        , next_arrival_(arrival_(0))
+        , last_arrival_(0)
+        , tail_(0)
+        , head_(0)
+        , started_(false) {
+    }
+
+    // Advance receiver clock by one update interval, consuming samples with
+    // given speed, and feed the estimator.
+    void step(LsqFreqEstimator& fe, float coeff) {
+        time_ += UpdateInterval;
+
+        bool received = false;
+
+        while (next_arrival_ <= time_) {
+            last_arrival_ = next_arrival_;
+            next_packet_++;
+            next_arrival_ = arrival_(next_packet_);
+            tail_ = (double)next_packet_ * PacketSize;
+            received = true;
+        }
+
+        if (!started_) {
+            if (!received) {
+                return;
+            }
+            head_ = tail_ - Target;
+            started_ = true;
+        }
+
+        head_ += UpdateInterval * (double)coeff;
+
+        if (arrival_time_) {
+            if (received) {
+                fe.add_arrival(last_arrival_, tail_);
+            }
+        } else {
+            fe.add_sample(time_, tail_);
+        }
+        fe.update((packet::timestamp_t)(tail_ - head_));
+    }
+
+    double latency() const {
+        return tail_ - head_;
+    }
+
+    void add_latency(double latency) {
+        head_ -= latency;
+    }
+
+private:
+    // Packets are delayed by queues for up to jitter, and most of them pass
+    // with delay close to the network floor.
+    double arrival_(size_t packet) {
+        const double queueing = random_() * random_();
+
+        return (double)(packet + 1) * PacketSize / (1 + drift_) + NetworkDelay
+            + queueing * jitter_;
+    }
+
+    double random_() {
+        seed_ = seed_ * 1103515245 + 12345;
+        return (double)((seed_ >> 8) & 0xffff) / 0xffff;
+    }
+
+    const double drift_;
+    const double jitter_;
+    const bool arrival_time_;
+    unsigned seed_;
+
+    double time_;
+    size_t next_packet_;
+    double next_arrival_;
+    double last_arrival_;
+    double tail_;
+    double head_;
+    bool started_;
+};
+
+size_t num_updates(size_t seconds) {
+    return seconds * SampleRate / UpdateInterval;
+}
+
+} // namespace
+
+TEST_GROUP(lsq_freq_estimator) {};
+
+TEST(lsq_freq_estimator, initial) {
+    LsqFreqEstimator fe(Target, UpdateInterval, Window);
+
+    DOUBLES_EQUAL(1.0, (double)fe.freq_coeff(), 0);
+    DOUBLES_EQUAL(1.0, fe.freq_ratio(), 0);
+}
+
+TEST(lsq_freq_estimator, measure_drift) {
+    const double drifts[] = { 0, 50 * Ppm, -50 * Ppm, 300 * Ppm, -300 * Ppm };
+
+    // seconds needed to measure drift with sub-ppm precision under given jitter
+    const double jitters[] = { 0.3, 1, 3 };
+    const size_t seconds[] = { 10, 20, 30 };
+
+    for (size_t nd = 0; nd < ROC_ARRAY_SIZE(drifts); nd++) {
+        for (size_t nj = 0; nj < ROC_ARRAY_SIZE(jitters); nj++) {
+            LsqFreqEstimator fe(Target, UpdateInterval, Window);
+            ClockSim sim(drifts[nd], jitters[nj], (unsigned)(nd * 10 + nj + 1));
+
+            for (size_t n = 0; n < num_updates(seconds[nj]); n++) {
+                sim.step(fe, fe.freq_coeff());
+            }
+            DOUBLES_EQUAL(1 + drifts[nd], fe.freq_ratio(), 1 * Ppm);
+
+            for (size_t n = 0; n < num_updates(60 - seconds[nj]); n++) {
+                sim.step(fe, fe.freq_coeff());
+            }
+            DOUBLES_EQUAL(1 + drifts[nd], fe.freq_ratio(), 0.2 * Ppm);
+        }
+    }
+}
+
+TEST(lsq_freq_estimator, measure_drift_without_arrival_time) {
+    const double drifts[] = { 0, 50 * Ppm, -50 * Ppm, 300 * Ppm, -300 * Ppm };
+    const double jitters[] = { 0.3, 1, 3 };
+
+    for (size_t nd = 0; nd < ROC_ARRAY_SIZE(drifts); nd++) {
+        for (size_t nj = 0; nj < ROC_ARRAY_SIZE(jitters); nj++) {
+            LsqFreqEstimator fe(Target, UpdateInterval, Window);
+            ClockSim sim(drifts[nd], jitters[nj], (unsigned)(nd * 10 + nj + 1), false);
+
+            // pairs are quantized by packet size and update interval
+            for (size_t n = 0; n < num_updates(10); n++) {
+                sim.step(fe, fe.freq_coeff());
+            }
+            DOUBLES_EQUAL(1 + drifts[nd], fe.freq_ratio(), 60 * Ppm);
+
+            for (size_t n = 0; n < num_updates(50); n++) {
+                sim.step(fe, fe.freq_coeff());
+            }
+            DOUBLES_EQUAL(1 + drifts[nd], fe.freq_ratio(), 5 * Ppm);
+        }
+    }
+}
+
+TEST(lsq_freq_estimator, aim_target_latency) {
+    LsqFreqEstimator fe(Target, UpdateInterval, Window);
+    ClockSim sim(100 * Ppm, 1, 1);
+
+    sim.add_latency(Target / 2);
+
+    double latency = 0;
+
+    for (size_t n = 0; n < num_updates(120); n++) {
+        sim.step(fe, fe.freq_coeff());
+        latency += (sim.latency() - latency) / 200;
+    }
+
+    // latency saws by packet size around its mean
+    DOUBLES_EQUAL(Target, latency, PacketSize);
+    DOUBLES_EQUAL(1 + 100 * Ppm, (double)fe.freq_coeff(), 20 * Ppm);
+}
+
+TEST(lsq_freq_estimator, set_target_latency) {
+    LsqFreqEstimator fe(Target, UpdateInterval, Window);
+    ClockSim sim(-100 * Ppm, 1, 1);
+
+    for (size_t n = 0; n < num_updates(60); n++) {
+        sim.step(fe, fe.freq_coeff());
+    }
+
+    fe.set_target_latency(Target * 2);
+
+    double latency = 0;
+
+    for (size_t n = 0; n < num_updates(120); n++) {
+        sim.step(fe, fe.freq_coeff());
+        latency += (sim.latency() - latency) / 200;
+    }
+
+    DOUBLES_EQUAL(Target * 2, latency, PacketSize);
+}
+
+} // namespace audio
+} // namespace roc
@@ -9,9 +9,12 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_audio/mixer.h"
+#include "roc_audio/mixer_kernel.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/worker_pool.h"
 
 #include "test_mock_reader.h"
 
@@ -36,7 +39,7 @@ TEST_GROUP(mixer) {
         return buf;
     }
 
-    void expect_output(Mixer& mixer, size_t sz, sample_t value) {
+    void expect_output(Mixer& mixer, size_t sz, sample_t value, unsigned flags = 0) {
         core::Slice<sample_t> buf = new_buffer(sz);
 
         Frame frame(buf.data(), buf.size());
@@ -45,23 +48,25 @@ TEST_GROUP(mixer) {
         for (size_t n = 0; n < sz; n++) {
             DOUBLES_EQUAL((double)value, (double)frame.data()[n], 0.0001);
         }
+
+        UNSIGNED_LONGS_EQUAL(flags, frame.flags());
     }
 };
 
 TEST(mixer, no_readers) {
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, allocator, MaxSz);
     CHECK(mixer.valid());
 
-    expect_output(mixer, BufSz, 0);
+    expect_output(mixer, BufSz, 0, Frame::FlagBlank);
 }
 
 TEST(mixer, one_reader) {
     MockReader reader;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, allocator, MaxSz);
     CHECK(mixer.valid());
 
-    mixer.add(reader);
+    CHECK(mixer.add(reader));
 
     reader.add(BufSz, 0.11f);
     expect_output(mixer, BufSz, 0.11f);
@@ -72,10 +77,10 @@ TEST(mixer, one_reader) {
 TEST(mixer, one_reader_large) {
     MockReader reader;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, allocator, MaxSz);
     CHECK(mixer.valid());
 
-    mixer.add(reader);
+    CHECK(mixer.add(reader));
 
     reader.add(MaxSz * 2, 0.11f);
     expect_output(mixer, MaxSz * 2, 0.11f);
@@ -87,11 +92,11 @@ TEST(mixer, two_readers) {
     MockReader reader1;
     MockReader reader2;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, allocator, MaxSz);
     CHECK(mixer.valid());
 
-    mixer.add(reader1);
-    mixer.add(reader2);
+    CHECK(mixer.add(reader1));
+    CHECK(mixer.add(reader2));
 
     reader1.add(BufSz, 0.11f);
     reader2.add(BufSz, 0.22f);
@@ -106,11 +111,11 @@ TEST(mixer, remove_reader) {
     MockReader reader1;
     MockReader reader2;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, allocator, MaxSz);
     CHECK(mixer.valid());
 
-    mixer.add(reader1);
-    mixer.add(reader2);
+    CHECK(mixer.add(reader1));
+    CHECK(mixer.add(reader2));
 
     reader1.add(BufSz, 0.11f);
     reader2.add(BufSz, 0.22f);
@@ -126,7 +131,7 @@ TEST(mixer, remove_reader) {
 
     reader1.add(BufSz, 0.77f);
     reader2.add(BufSz, 0.88f);
-    expect_output(mixer, BufSz, 0.0f);
+    expect_output(mixer, BufSz, 0.0f, Frame::FlagBlank);
 
     CHECK(reader1.num_unread() == BufSz);
     CHECK(reader2.num_unread() == BufSz * 2);
@@ -136,11 +141,11 @@ TEST(mixer, clamp) {
     MockReader reader1;
     MockReader reader2;
 
-    Mixer mixer(buffer_pool, MaxSz);
+    Mixer mixer(buffer_pool, allocator, MaxSz);
     CHECK(mixer.valid());
 
-    mixer.add(reader1);
-    mixer.add(reader2);
+    CHECK(mixer.add(reader1));
+    CHECK(mixer.add(reader2));
 
     reader1.add(BufSz, 0.900f);
     reader2.add(BufSz, 0.101f);
@@ -161,5 +166,315 @@ TEST(mixer, clamp) {
     CHECK(reader2.num_unread() == 0);
 }
 
+TEST(mixer, clamp_once) {
+    MockReader reader1;
+    MockReader reader2;
+    MockReader reader3;
+
+    Mixer mixer(buffer_pool, allocator, MaxSz);
+    CHECK(mixer.valid());
+
+    CHECK(mixer.add(reader1));
+    CHECK(mixer.add(reader2));
+    CHECK(mixer.add(reader3));
+
+    reader1.add(BufSz, 0.9f);
+    reader2.add(BufSz, 0.9f);
+    reader3.add(BufSz, -0.9f);
+
+    expect_output(mixer, BufSz, 0.9f);
+
+    reader1.add(BufSz, -0.8f);
+    reader2.add(BufSz, -0.8f);
+    reader3.add(BufSz, 0.7f);
+
+    expect_output(mixer, BufSz, -0.9f);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+    CHECK(reader3.num_unread() == 0);
+}
+
+TEST(mixer, gain) {
+    MockReader reader1;
+    MockReader reader2;
+
+    Mixer mixer(buffer_pool, allocator, MaxSz);
+    CHECK(mixer.valid());
+
+    CHECK(mixer.add(reader1));
+    CHECK(mixer.add(reader2));
+
+    mixer.set_gain(reader1, 0.5f);
+    mixer.set_gain(reader2, 2.0f);
+
+    reader1.add(BufSz, 0.4f);
+    reader2.add(BufSz, 0.1f);
+    expect_output(mixer, BufSz, 0.4f);
+
+    reader1.add(BufSz, 0.4f);
+    reader2.add(BufSz, 0.5f);
+    expect_output(mixer, BufSz, 1.0f);
+
+    mixer.set_gain(reader2, 1.0f);
+
+    reader1.add(BufSz, 0.4f);
+    reader2.add(BufSz, 0.1f);
+    expect_output(mixer, BufSz, 0.3f);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+}
+
+TEST(mixer, gain_one_reader) {
+    MockReader reader;
+
+    Mixer mixer(buffer_pool, allocator, MaxSz);
+    CHECK(mixer.valid());
+
+    CHECK(mixer.add(reader));
+
+    mixer.set_gain(reader, 0.25f);
+
+    reader.add(MaxSz * 2, 0.8f);
+    expect_output(mixer, MaxSz * 2, 0.2f);
+
+    mixer.set_gain(reader, 4.0f);
+
+    reader.add(BufSz, 0.8f);
+    expect_output(mixer, BufSz, 1.0f);
+
+    mixer.set_gain(reader, 1.0f);
+
+    reader.add(BufSz, 0.8f);
+    expect_output(mixer, BufSz, 0.8f);
+
+    CHECK(reader.num_unread() == 0);
+}
+
+TEST(mixer, many_readers) {
+    enum { NumReaders = 20 };
+
+    MockReader readers[NumReaders];
+
+    Mixer mixer(buffer_pool, allocator, MaxSz);
+    CHECK(mixer.valid());
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(mixer.add(readers[n]));
+        readers[n].add(BufSz, 0.01f);
+    }
+
+    expect_output(mixer, BufSz, 0.01f * NumReaders);
+
+    for (size_t n = 0; n < NumReaders; n += 2) {
+        mixer.remove(readers[n]);
+    }
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add(BufSz, 0.01f);
+    }
+
+    expect_output(mixer, BufSz, 0.01f * NumReaders / 2);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(readers[n].num_unread() == (n % 2 == 0 ? BufSz : 0));
+    }
+}
+
+TEST(mixer, blank_inputs) {
+    MockReader reader1;
+    MockReader reader2;
+    MockReader reader3;
+
+    Mixer mixer(buffer_pool, allocator, MaxSz);
+    CHECK(mixer.valid());
+
+    CHECK(mixer.add(reader1));
+    CHECK(mixer.add(reader2));
+    CHECK(mixer.add(reader3));
+
+    // blank frames are zero by definition, so their samples are not even read
+    reader1.set_flags(Frame::FlagBlank);
+    reader3.set_flags(Frame::FlagBlank);
+
+    reader1.add(BufSz, 0.5f);
+    reader2.add(BufSz, 0.2f);
+    reader3.add(BufSz, 0.5f);
+    expect_output(mixer, BufSz, 0.2f);
+
+    reader2.set_flags(Frame::FlagBlank);
+
+    reader1.add(MaxSz * 2, 0.5f);
+    reader2.add(MaxSz * 2, 0.5f);
+    reader3.add(MaxSz * 2, 0.5f);
+    expect_output(mixer, MaxSz * 2, 0.0f, Frame::FlagBlank);
+
+    reader3.set_flags(Frame::FlagIncomplete);
+
+    reader1.add(BufSz, 0.5f);
+    reader2.add(BufSz, 0.5f);
+    reader3.add(BufSz, 0.1f);
+    expect_output(mixer, BufSz, 0.1f);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+    CHECK(reader3.num_unread() == 0);
+}
+
+TEST(mixer, beep_inputs) {
+    MockReader reader1;
+    MockReader reader2;
+
+    Mixer mixer(buffer_pool, allocator, MaxSz);
+    CHECK(mixer.valid());
+
+    CHECK(mixer.add(reader1));
+    CHECK(mixer.add(reader2));
+
+    // blank frames filled with a beep are not zeros, so they are mixed
+    reader1.set_flags(Frame::FlagBlank | Frame::FlagBeep);
+    reader2.set_flags(Frame::FlagBlank);
+
+    reader1.add(BufSz, 0.3f);
+    reader2.add(BufSz, 0.5f);
+    expect_output(mixer, BufSz, 0.3f);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+}
+
+TEST(mixer, worker_pool) {
+    enum { NumReaders = 5, NumThreads = 3 };
+
+    core::WorkerPool worker_pool(NumThreads, allocator);
+    CHECK(worker_pool.valid());
+
+    MockReader readers[NumReaders];
+
+    Mixer mixer(buffer_pool, allocator, MaxSz);
+    CHECK(mixer.valid());
+
+    mixer.set_worker_pool(worker_pool);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(mixer.add(readers[n]));
+        mixer.set_gain(readers[n], 0.5f);
+    }
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add(MaxSz * 3 + BufSz, 0.1f * (n + 1));
+    }
+
+    expect_output(mixer, MaxSz * 3 + BufSz, 0.75f);
+
+    mixer.remove(readers[0]);
+    mixer.remove(readers[4]);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add(BufSz, 0.4f);
+    }
+
+    expect_output(mixer, BufSz, 0.6f);
+
+    for (size_t n = 1; n < NumReaders - 1; n++) {
+        CHECK(readers[n].num_unread() == 0);
+    }
+    CHECK(readers[0].num_unread() == BufSz);
+    CHECK(readers[4].num_unread() == BufSz);
+}
+
+TEST(mixer, worker_pool_same_output) {
+    enum { NumReaders = 7, NumSamples = MaxSz * 2 };
+
+    core::WorkerPool worker_pool(2, allocator);
+    CHECK(worker_pool.valid());
+
+    MockReader serial_readers[NumReaders];
+    MockReader parallel_readers[NumReaders];
+
+    Mixer serial_mixer(buffer_pool, allocator, MaxSz);
+    CHECK(serial_mixer.valid());
+
+    Mixer parallel_mixer(buffer_pool, allocator, MaxSz);
+    CHECK(parallel_mixer.valid());
+
+    parallel_mixer.set_worker_pool(worker_pool);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        CHECK(serial_mixer.add(serial_readers[n]));
+        CHECK(parallel_mixer.add(parallel_readers[n]));
+
+        serial_mixer.set_gain(serial_readers[n], 0.37f * (n + 1));
+        parallel_mixer.set_gain(parallel_readers[n], 0.37f * (n + 1));
+
+        for (size_t i = 0; i < NumSamples; i++) {
+            const sample_t value = (sample_t)((i * 7 + n * 13) % 29) / 29.0f - 0.5f;
+
+            serial_readers[n].add(1, value);
+            parallel_readers[n].add(1, value);
+        }
+    }
+
+    core::Slice<sample_t> serial_buf = new_buffer(NumSamples);
+    core::Slice<sample_t> parallel_buf = new_buffer(NumSamples);
+
+    Frame serial_frame(serial_buf.data(), serial_buf.size());
+    serial_mixer.read(serial_frame);
+
+    Frame parallel_frame(parallel_buf.data(), parallel_buf.size());
+    parallel_mixer.read(parallel_frame);
+
+    CHECK(memcmp(serial_buf.data(), parallel_buf.data(),
+                 NumSamples * sizeof(sample_t))
+          == 0);
+}
+
+TEST(mixer, kernels_match_scalar) {
+    enum { NumSamples = 203 };
+
+    const MixerKernel kernels[] = { MixerKernel_SSE, MixerKernel_AVX2,
+                                    MixerKernel_NEON };
+
+    const float gains[] = { 1.0f, 0.3f, 1.7f };
+
+    sample_t in[NumSamples];
+    sample_t expected[NumSamples];
+    sample_t actual[NumSamples];
+
+    for (size_t n = 0; n < NumSamples; n++) {
+        in[n] = (sample_t)(n % 17) / 8.0f - 1.0f;
+    }
+
+    for (size_t k = 0; k < ROC_ARRAY_SIZE(kernels); k++) {
+        const MixerKernelFuncs* funcs = mixer_kernel_funcs(kernels[k]);
+        if (!funcs) {
+            continue;
+        }
+
+        for (size_t g = 0; g < ROC_ARRAY_SIZE(gains); g++) {
+            for (size_t n = 0; n < NumSamples; n++) {
+                expected[n] = actual[n] = (sample_t)(n % 5) / 4.0f - 0.5f;
+            }
+
+            mixer_add_scalar(expected, in, NumSamples, gains[g]);
+            funcs->add(actual, in, NumSamples, gains[g]);
+
+            for (size_t n = 0; n < NumSamples; n++) {
+                DOUBLES_EQUAL((double)expected[n], (double)actual[n], 1e-6);
+            }
+
+            mixer_clamp_scalar(expected, NumSamples);
+            funcs->clamp(actual, NumSamples);
+
+            for (size_t n = 0; n < NumSamples; n++) {
+                DOUBLES_EQUAL((double)expected[n], (double)actual[n], 1e-6);
+                CHECK(actual[n] <= SampleMax);
+                CHECK(actual[n] >= SampleMin);
+            }
+        }
+    }
+}
+
 } // namespace audio
 } // namespace roc
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ROC_AUDIO_TEST_MOCK_WRITER_H_
+#define ROC_AUDIO_TEST_MOCK_WRITER_H_
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/iwriter.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+class MockWriter : public IWriter {
+public:
+    MockWriter()
+        : size_(0)
+        , n_writes_(0) {
+    }
+
+    virtual void write(Frame& frame) {
+        CHECK(size_ + frame.size() <= MaxSz);
+
+        memcpy(samples_ + size_, frame.data(), frame.size() * sizeof(sample_t));
+        size_ += frame.size();
+        n_writes_++;
+    }
+
+    size_t num_written() const {
+        return size_;
+    }
+
+    size_t num_writes() const {
+        return n_writes_;
+    }
+
+    sample_t get(size_t n) const {
+        CHECK(n < size_);
+        return samples_[n];
+    }
+
+private:
+    enum { MaxSz = 64 * 1024 };
+
+    sample_t samples_[MaxSz];
+    size_t size_;
+    size_t n_writes_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_TEST_MOCK_WRITER_H_
@@ -10,8 +10,10 @@
 
 #include "roc_audio/pcm_decoder.h"
 #include "roc_audio/pcm_encoder.h"
+#include "roc_audio/pcm_kernel.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
 
 namespace roc {
 namespace audio {
@@ -472,5 +474,74 @@ TEST(pcm_funcs, decode_truncate) {
     check(output, NumSamples, 0x3);
 }
 
+TEST(pcm_funcs, encode_saturate) {
+    enum { NumSamples = 21 };
+
+    use(PCM_int16_1ch);
+
+    core::Slice<uint8_t> bp = new_buffer(NumSamples);
+
+    audio::sample_t input[NumSamples];
+    for (size_t n = 0; n < NumSamples; n++) {
+        input[n] = (n % 2 == 0) ? 1.5f : -1.5f;
+    }
+
+    encode(bp, input, 0, NumSamples, 0x1);
+    decode(bp, 0, NumSamples, 0x1);
+
+    for (size_t n = 0; n < NumSamples; n++) {
+        input[n] = (n % 2 == 0) ? 32767.0f / 32768.0f : -1.0f;
+    }
+
+    check(input, NumSamples, 0x1);
+}
+
+TEST(pcm_funcs, kernels_match_scalar) {
+    enum { NumSamples = 1000 };
+
+    const PcmKernel kernels[] = { PcmKernel_SSE, PcmKernel_AVX2, PcmKernel_NEON };
+
+    audio::sample_t samples[NumSamples];
+    for (size_t n = 0; n < NumSamples; n++) {
+        // covers saturation, exact values, and truncation of both signs
+        samples[n] = ((audio::sample_t)n - NumSamples / 2) / (NumSamples / 3) + 1e-5f;
+    }
+
+    int16_t words[NumSamples];
+    for (size_t n = 0; n < NumSamples; n++) {
+        words[n] = (int16_t)(n * 997 % 65536);
+    }
+
+    for (size_t nk = 0; nk < ROC_ARRAY_SIZE(kernels); nk++) {
+        const PcmKernelFuncs* kernel_funcs = pcm_kernel_funcs(kernels[nk]);
+        if (!kernel_funcs) {
+            continue;
+        }
+
+        // check every tail length
+        for (size_t size = NumSamples - 33; size <= NumSamples; size++) {
+            int16_t expected_words[NumSamples] = {};
+            int16_t actual_words[NumSamples] = {};
+
+            pcm_encode_int16_be_scalar(expected_words, samples, size);
+            kernel_funcs->encode_int16_be(actual_words, samples, size);
+
+            for (size_t n = 0; n < NumSamples; n++) {
+                LONGS_EQUAL(expected_words[n], actual_words[n]);
+            }
+
+            audio::sample_t expected_samples[NumSamples] = {};
+            audio::sample_t actual_samples[NumSamples] = {};
+
+            pcm_decode_int16_be_scalar(expected_samples, words, size);
+            kernel_funcs->decode_int16_be(actual_samples, words, size);
+
+            for (size_t n = 0; n < NumSamples; n++) {
+                DOUBLES_EQUAL((double)expected_samples[n], (double)actual_samples[n], 0);
+            }
+        }
+    }
+}
+
 } // namespace audio
 } // namespace roc
@@ -9,16 +9,21 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_audio/resampler.h"
+#include "roc_audio/resampler_builder.h"
 #include "roc_audio/resampler_reader.h"
+#include "roc_audio/resampler_writer.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
 #include "roc_core/random.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/unique_ptr.h"
 
 #include "test_awgn.h"
 #include "test_fft.h"
 #include "test_median.h"
 #include "test_mock_reader.h"
+#include "test_mock_writer.h"
 
 namespace roc {
 namespace audio {
@@ -35,9 +40,51 @@ enum {
     InSamples = OutSamples + (FrameSize * 3)
 };
 
+const ResamplerKernel Kernels[] = { ResamplerKernel_SSE, ResamplerKernel_AVX2,
+                                     ResamplerKernel_NEON };
+
+const ResamplerKernel AllKernels[] = { ResamplerKernel_Scalar, ResamplerKernel_SSE,
+                                       ResamplerKernel_AVX2, ResamplerKernel_NEON };
+
+const ResamplerEngine Engines[] = { ResamplerEngine_Sinc, ResamplerEngine_Polyphase };
+
+const SincTableFormat Formats[] = { SincTableFormat_Float, SincTableFormat_Q15 };
+
 core::HeapAllocator allocator;
 core::BufferPool<sample_t> buffer_pool(allocator, MaxSize, true);
 
+// Produces silence followed by a sine. If flag_blank is set, frames which are
+// entirely silent are marked blank, like depacketizer does.
+class SilenceReader : public IReader {
+public:
+    SilenceReader(size_t silence_len, bool flag_blank)
+        : silence_len_(silence_len)
+        , flag_blank_(flag_blank)
+        , pos_(0) {
+    }
+
+    virtual void read(Frame& frame) {
+        for (size_t n = 0; n < frame.size(); n++) {
+            frame.data()[n] = pos_ + n < silence_len_
+                ? 0.0f
+                : (sample_t)std::sin(M_PI / 64 * double(pos_ + n));
+        }
+
+        if (flag_blank_ && pos_ + frame.size() <= silence_len_) {
+            frame.set_flags(Frame::FlagBlank);
+        } else {
+            frame.set_flags(0);
+        }
+
+        pos_ += frame.size();
+    }
+
+private:
+    const size_t silence_len_;
+    const bool flag_blank_;
+    size_t pos_;
+};
+
 } // namespace
 
 TEST_GROUP(resampler) {
@@ -54,6 +101,54 @@ TEST_GROUP(resampler) {
         return buf;
     }
 
+    // Resamples the same random signal using scalar and SIMD kernels and
+    // compares results.
+    void check_kernel_matches_scalar(ResamplerKernel kernel,
+                                     packet::channel_mask_t ch_mask, float scaling) {
+        enum { NumFrames = 20 };
+
+        ResamplerConfig scalar_config = config;
+        scalar_config.kernel = ResamplerKernel_Scalar;
+
+        ResamplerConfig simd_config = config;
+        simd_config.kernel = kernel;
+
+        MockReader scalar_reader;
+        MockReader simd_reader;
+
+        for (size_t n = 0; n < InSamples; n++) {
+            const sample_t s = (sample_t)core::random(0, 2000) / 1000 - 1;
+            scalar_reader.add(1, s);
+            simd_reader.add(1, s);
+        }
+
+        ResamplerReader scalar_rr(scalar_reader, buffer_pool, allocator, scalar_config,
+                                  ch_mask);
+        ResamplerReader simd_rr(simd_reader, buffer_pool, allocator, simd_config,
+                                ch_mask);
+
+        CHECK(scalar_rr.valid());
+        CHECK(simd_rr.valid());
+
+        CHECK(scalar_rr.set_scaling(scaling));
+        CHECK(simd_rr.set_scaling(scaling));
+
+        core::Slice<sample_t> scalar_buf = new_buffer(FrameSize);
+        core::Slice<sample_t> simd_buf = new_buffer(FrameSize);
+
+        for (size_t nf = 0; nf < NumFrames; nf++) {
+            Frame scalar_frame(scalar_buf.data(), scalar_buf.size());
+            Frame simd_frame(simd_buf.data(), simd_buf.size());
+
+            scalar_rr.read(scalar_frame);
+            simd_rr.read(simd_frame);
+
+            for (size_t n = 0; n < FrameSize; n++) {
+                DOUBLES_EQUAL(scalar_frame.data()[n], simd_frame.data()[n], 1e-4);
+            }
+        }
+    }
+
     // Reads signal from the resampler and puts its spectrum into @p spectrum.
     // Spectrum must have twice bigger space than the length of the input signal.
     void get_sample_spectrum1(IReader & reader, double* spectrum, const size_t sig_len) {
@@ -101,7 +196,7 @@ TEST(resampler, invalid_scaling) {
     enum { ChMask = 0x1, InvalidScaling = FrameSize };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
 
     CHECK(rr.valid());
 
@@ -113,7 +208,7 @@ TEST(resampler, upscaling_twice_single) {
     enum { ChMask = 0x1 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
 
     CHECK(rr.valid());
 
@@ -144,7 +239,7 @@ TEST(resampler, upscaling_twice_awgn) {
     enum { ChMask = 0x1 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
 
     CHECK(rr.valid());
     CHECK(rr.set_scaling(0.5f));
@@ -185,7 +280,7 @@ TEST(resampler, downsample) {
     enum { ChMask = 0x1 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
 
     CHECK(rr.valid());
     CHECK(rr.set_scaling(1.5f));
@@ -211,11 +306,68 @@ TEST(resampler, downsample) {
     }
 }
 
+// Check that compact sinc table doesn't noticeably degrade upsampling quality.
+TEST(resampler, upscaling_twice_q15) {
+    enum { ChMask = 0x1 };
+
+    config.sinc_format = SincTableFormat_Q15;
+
+    MockReader reader;
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
+
+    CHECK(rr.valid());
+    CHECK(rr.set_scaling(0.5f));
+
+    const size_t sig_len = 2048;
+    double buff[sig_len * 2];
+
+    for (size_t n = 0; n < InSamples; n++) {
+        const sample_t s = (sample_t)std::sin(M_PI / 4 * double(n));
+        reader.add(1, s);
+    }
+
+    get_sample_spectrum1(rr, buff, sig_len);
+
+    const size_t main_freq_index = sig_len / 8;
+    for (size_t n = 0; n < sig_len / 2; n += 2) {
+        CHECK((buff[n] - buff[main_freq_index]) <= -110 || n == main_freq_index);
+    }
+}
+
+// Check that compact sinc table doesn't noticeably degrade downsampling quality.
+TEST(resampler, downsample_q15) {
+    enum { ChMask = 0x1 };
+
+    config.sinc_format = SincTableFormat_Q15;
+
+    MockReader reader;
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
+
+    CHECK(rr.valid());
+    CHECK(rr.set_scaling(1.5f));
+
+    const size_t sig_len = 2048;
+    double buff[sig_len * 2];
+
+    for (size_t n = 0; n < InSamples; n++) {
+        const sample_t s = (sample_t)std::sin(M_PI / 4 * double(n));
+        reader.add(1, s);
+    }
+
+    get_sample_spectrum1(rr, buff, sig_len);
+
+    const size_t main_freq_index = (size_t)round(sig_len / 4 * 1.5);
+    for (size_t n = 0; n < sig_len / 2; n += 2) {
+        CHECK((buff[n] - buff[main_freq_index]) <= -110 || buff[n] < -200
+              || n == main_freq_index);
+    }
+}
+
 TEST(resampler, two_tones_sep_channels) {
     enum { ChMask = 0x3, nChannels = 2 };
 
     MockReader reader;
-    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask, FrameSize);
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
 
     CHECK(rr.valid());
     CHECK(rr.set_scaling(0.5f));
@@ -244,5 +396,319 @@ TEST(resampler, two_tones_sep_channels) {
     }
 }
 
+TEST(resampler, polyphase_invalid_scaling) {
+    enum { ChMask = 0x1 };
+
+    config.engine = ResamplerEngine_Polyphase;
+
+    MockReader reader;
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
+
+    CHECK(rr.valid());
+
+    // Doesn't fit into frame.
+    CHECK(!rr.set_scaling(FrameSize));
+
+    // Denominator is too large, like for clock drift compensation.
+    CHECK(!rr.set_scaling(1.00012f));
+
+    CHECK(rr.set_scaling(48000.0f / 44100.0f));
+}
+
+// Check the quality of upsampled sine-wave.
+TEST(resampler, polyphase_upscaling_twice) {
+    enum { ChMask = 0x1 };
+
+    config.engine = ResamplerEngine_Polyphase;
+
+    MockReader reader;
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
+
+    CHECK(rr.valid());
+    CHECK(rr.set_scaling(0.5f));
+
+    const size_t sig_len = 2048;
+    double buff[sig_len * 2];
+
+    for (size_t n = 0; n < InSamples; n++) {
+        const sample_t s = (sample_t)std::sin(M_PI / 4 * double(n));
+        reader.add(1, s);
+    }
+
+    get_sample_spectrum1(rr, buff, sig_len);
+
+    const size_t main_freq_index = sig_len / 8;
+    for (size_t n = 0; n < sig_len / 2; n += 2) {
+        CHECK((buff[n] - buff[main_freq_index]) <= -110 || n == main_freq_index);
+    }
+}
+
+// Check the quality of sine-wave converted from 48000 to 44100.
+TEST(resampler, polyphase_48000_to_44100) {
+    enum { ChMask = 0x1 };
+
+    config.engine = ResamplerEngine_Polyphase;
+
+    MockReader reader;
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
+
+    CHECK(rr.valid());
+    CHECK(rr.set_scaling(48000.0f / 44100.0f));
+
+    const size_t sig_len = 2048;
+    double buff[sig_len * 2];
+
+    // Input frequency is chosen so that output sine-wave has a period
+    // of 16 samples, i.e. fits FFT length exactly.
+    for (size_t n = 0; n < InSamples; n++) {
+        const sample_t s = (sample_t)std::sin(2 * M_PI * 147.0 / 2560.0 * double(n));
+        reader.add(1, s);
+    }
+
+    get_sample_spectrum1(rr, buff, sig_len);
+
+    // Since the ratio is exact, there is no leakage caused by rounding of the
+    // time position, and spurs come only from the filter itself.
+    const size_t main_freq_index = sig_len / 8;
+    for (size_t n = 0; n < sig_len / 2; n += 2) {
+        CHECK((buff[n] - buff[main_freq_index]) <= -95 || buff[n] < -200
+              || n == main_freq_index);
+    }
+}
+
+// Check that input is pulled in chunks sized to the filter window, not to
+// the output frame.
+TEST(resampler, reader_lookahead) {
+    enum { ChMask = 0x1, WindowSize = 32, OutSize = 10 };
+
+    config.window_size = WindowSize;
+
+    const size_t chunk_size = resampler_frame_size(config, ChMask, 1.0f);
+    CHECK(chunk_size < FrameSize);
+
+    MockReader reader;
+    reader.add(InSamples, 0);
+
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
+    CHECK(rr.valid());
+    CHECK(rr.set_scaling(1.0f));
+
+    core::Slice<sample_t> buf = new_buffer(OutSize);
+
+    Frame frame(buf.data(), buf.size());
+    rr.read(frame);
+
+    // Previous, current and next chunks.
+    LONGS_EQUAL(chunk_size * 3, InSamples - reader.num_unread());
+}
+
+// Check that chunks are grown for large scaling until reading is started.
+TEST(resampler, reader_grow_chunks) {
+    enum { ChMask = 0x1, WindowSize = 32 };
+
+    config.window_size = WindowSize;
+
+    MockReader reader;
+    reader.add(InSamples, 0);
+
+    ResamplerReader rr(reader, buffer_pool, allocator, config, ChMask);
+    CHECK(rr.valid());
+
+    CHECK(rr.set_scaling(4.0f));
+
+    core::Slice<sample_t> buf = new_buffer(FrameSize);
+
+    Frame frame(buf.data(), buf.size());
+    rr.read(frame);
+
+    CHECK(rr.set_scaling(4.0f));
+    CHECK(!rr.set_scaling(8.0f));
+
+    rr.read(frame);
+}
+
+// Check that blank input frames are not filtered, and that skipping them
+// doesn't change the output.
+TEST(resampler, reader_blank_frames) {
+    enum { ChMask = 0x3, SilenceLen = FrameSize * 10, NumFrames = 30 };
+
+    for (size_t ne = 0; ne < ROC_ARRAY_SIZE(Engines); ne++) {
+        config.engine = Engines[ne];
+        config.window_size = 32;
+
+        const float scaling = 0.97f;
+
+        SilenceReader blank_reader(SilenceLen, true);
+        ResamplerReader blank_rr(blank_reader, buffer_pool, allocator, config, ChMask);
+        CHECK(blank_rr.valid());
+        CHECK(blank_rr.set_scaling(scaling));
+
+        SilenceReader zero_reader(SilenceLen, false);
+        ResamplerReader zero_rr(zero_reader, buffer_pool, allocator, config, ChMask);
+        CHECK(zero_rr.valid());
+        CHECK(zero_rr.set_scaling(scaling));
+
+        core::Slice<sample_t> blank_buf = new_buffer(FrameSize);
+        core::Slice<sample_t> zero_buf = new_buffer(FrameSize);
+
+        size_t n_blank = 0;
+        bool got_signal = false;
+
+        for (size_t nf = 0; nf < NumFrames; nf++) {
+            Frame blank_frame(blank_buf.data(), blank_buf.size());
+            blank_rr.read(blank_frame);
+
+            Frame zero_frame(zero_buf.data(), zero_buf.size());
+            zero_rr.read(zero_frame);
+
+            CHECK(!(zero_frame.flags() & Frame::FlagBlank));
+
+            if (blank_frame.flags() & Frame::FlagBlank) {
+                CHECK(!got_signal);
+                n_blank++;
+            } else {
+                got_signal = true;
+            }
+
+            for (size_t n = 0; n < FrameSize; n++) {
+                DOUBLES_EQUAL((double)zero_frame.data()[n], (double)blank_frame.data()[n],
+                              0);
+            }
+        }
+
+        CHECK(n_blank > 0);
+        CHECK(got_signal);
+    }
+}
+
+// Check that writer produces expected number of samples when input and output
+// frame sizes are unrelated to chunk size.
+TEST(resampler, writer_arbitrary_frame_size) {
+    enum { ChMask = 0x3, NumCh = 2, InFrameSize = 346, OutFrameSize = 214 };
+
+    for (size_t ne = 0; ne < ROC_ARRAY_SIZE(Engines); ne++) {
+        config.engine = Engines[ne];
+        config.window_size = 32;
+
+        const float scaling = 48000.0f / 44100.0f;
+
+        MockWriter writer;
+        ResamplerWriter rw(writer, buffer_pool, allocator, config, ChMask,
+                           OutFrameSize);
+        CHECK(rw.valid());
+        CHECK(rw.set_scaling(scaling));
+
+        core::Slice<sample_t> buf = new_buffer(InFrameSize);
+
+        size_t n_written = 0;
+        while (n_written + InFrameSize <= InSamples) {
+            for (size_t n = 0; n < InFrameSize; n++) {
+                buf.data()[n] = (sample_t)std::sin(M_PI / 64 * double(n_written + n));
+            }
+            Frame frame(buf.data(), buf.size());
+            rw.write(frame);
+            n_written += InFrameSize;
+        }
+
+        const size_t chunk_size = resampler_frame_size(config, ChMask, scaling);
+
+        // All input except the last two chunks and an incomplete output frame.
+        const size_t expected_out =
+            size_t(double(n_written - chunk_size * 2) / NumCh / (double)scaling) * NumCh;
+
+        CHECK(writer.num_written() % OutFrameSize == 0);
+        CHECK(writer.num_written() <= expected_out + NumCh);
+        CHECK(writer.num_written() + OutFrameSize + chunk_size >= expected_out);
+    }
+}
+
+// Check that every SIMD kernel supported by the CPU gives the same result as
+// the scalar one, up to the floating point summation order, for every engine
+// and sinc table format.
+TEST(resampler, kernels_match_scalar) {
+    const packet::channel_mask_t ch_masks[] = { 0x1, 0x3 };
+    const float scalings[] = { 0.5f, 0.97f, 1.03f };
+
+    for (size_t ne = 0; ne < ROC_ARRAY_SIZE(Engines); ne++) {
+        for (size_t nt = 0; nt < ROC_ARRAY_SIZE(Formats); nt++) {
+            for (size_t nk = 0; nk < ROC_ARRAY_SIZE(Kernels); nk++) {
+                if (!resampler_kernel_funcs(Kernels[nk])) {
+                    continue;
+                }
+                for (size_t nc = 0; nc < ROC_ARRAY_SIZE(ch_masks); nc++) {
+                    for (size_t ns = 0; ns < ROC_ARRAY_SIZE(scalings); ns++) {
+                        config.engine = Engines[ne];
+                        config.sinc_format = Formats[nt];
+
+                        check_kernel_matches_scalar(Kernels[nk], ch_masks[nc],
+                                                    scalings[ns]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Check that every channel of a multichannel stream is resampled the same way
+// as a separate mono stream, i.e. coefficients shared between channels are right.
+TEST(resampler, multichannel_match_mono) {
+    enum { NumCh = 4, ChMask = 0xf, NumFrames = 20, WindowSize = 32 };
+
+    config.window_size = WindowSize;
+
+    for (size_t nk = 0; nk < ROC_ARRAY_SIZE(AllKernels); nk++) {
+        if (!resampler_kernel_funcs(AllKernels[nk])) {
+            continue;
+        }
+
+        config.kernel = AllKernels[nk];
+
+        MockReader multi_reader;
+        MockReader mono_readers[NumCh];
+
+        for (size_t n = 0; n < InSamples / NumCh; n++) {
+            for (size_t ch = 0; ch < NumCh; ch++) {
+                const sample_t s = (sample_t)core::random(0, 2000) / 1000 - 1;
+                multi_reader.add(1, s);
+                mono_readers[ch].add(1, s);
+            }
+        }
+
+        ResamplerReader multi_rr(multi_reader, buffer_pool, allocator, config, ChMask);
+        CHECK(multi_rr.valid());
+        CHECK(multi_rr.set_scaling(0.97f));
+
+        core::Slice<sample_t> multi_buf = new_buffer(FrameSize);
+
+        core::Slice<sample_t> mono_bufs[NumCh];
+        core::UniquePtr<ResamplerReader> mono_rrs[NumCh];
+
+        for (size_t ch = 0; ch < NumCh; ch++) {
+            mono_rrs[ch].reset(new (allocator) ResamplerReader(
+                                   mono_readers[ch], buffer_pool, allocator, config, 0x1),
+                               allocator);
+            CHECK(mono_rrs[ch]->valid());
+            CHECK(mono_rrs[ch]->set_scaling(0.97f));
+
+            mono_bufs[ch] = new_buffer(FrameSize / NumCh);
+        }
+
+        for (size_t nf = 0; nf < NumFrames; nf++) {
+            Frame multi_frame(multi_buf.data(), multi_buf.size());
+            multi_rr.read(multi_frame);
+
+            for (size_t ch = 0; ch < NumCh; ch++) {
+                Frame mono_frame(mono_bufs[ch].data(), mono_bufs[ch].size());
+                mono_rrs[ch]->read(mono_frame);
+
+                for (size_t n = 0; n < FrameSize / NumCh; n++) {
+                    DOUBLES_EQUAL(mono_frame.data()[n],
+                                  multi_frame.data()[n * NumCh + ch], 1e-5);
+                }
+            }
+        }
+    }
+}
+
 } // namespace audio
 } // namespace roc
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/resampler.h"
+#include "roc_audio/sinc_table_cache.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/shared_ptr.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum { WindowSize = 7, WindowInterp = 16, FrameSize = 256 };
+
+enum { NumThreads = 4, NumIterations = 2000 };
+
+core::HeapAllocator allocator;
+
+// Repeatedly acquires and releases the same table.
+class TableUser : public core::Thread {
+public:
+    TableUser()
+        : num_failures_(0) {
+    }
+
+    size_t num_failures() const {
+        return num_failures_;
+    }
+
+private:
+    virtual void run() {
+        for (size_t n = 0; n < NumIterations; n++) {
+            core::SharedPtr<SincTable> table =
+                SincTableCache::instance().get(WindowSize, WindowInterp * 3,
+                                               SincTableFormat_Float);
+            if (!table || table->getref() <= 0) {
+                num_failures_++;
+            }
+        }
+    }
+
+    size_t num_failures_;
+};
+
+} // namespace
+
+TEST_GROUP(sinc_table_cache) {};
+
+TEST(sinc_table_cache, same_params_shared) {
+    SincTableCache& cache = SincTableCache::instance();
+
+    const size_t n_tables = cache.num_tables();
+
+    {
+        core::SharedPtr<SincTable> t1 =
+            cache.get(WindowSize, WindowInterp, SincTableFormat_Float);
+        core::SharedPtr<SincTable> t2 =
+            cache.get(WindowSize, WindowInterp, SincTableFormat_Float);
+        core::SharedPtr<SincTable> t3 =
+            cache.get(WindowSize, WindowInterp * 2, SincTableFormat_Float);
+        core::SharedPtr<SincTable> t4 =
+            cache.get(WindowSize, WindowInterp, SincTableFormat_Q15);
+
+        CHECK(t1);
+        CHECK(t2);
+        CHECK(t3);
+        CHECK(t4);
+
+        CHECK(t1.get() == t2.get());
+        CHECK(t1.get() != t3.get());
+        CHECK(t1.get() != t4.get());
+
+        LONGS_EQUAL(2, t1->getref());
+        LONGS_EQUAL(1, t3->getref());
+        LONGS_EQUAL(1, t4->getref());
+
+        LONGS_EQUAL(n_tables + 3, cache.num_tables());
+    }
+
+    LONGS_EQUAL(n_tables, cache.num_tables());
+}
+
+TEST(sinc_table_cache, table_values) {
+    core::SharedPtr<SincTable> table =
+        SincTableCache::instance().get(WindowSize, WindowInterp, SincTableFormat_Float);
+    CHECK(table);
+
+    LONGS_EQUAL(WindowSize * WindowInterp + 2, table->size());
+
+    DOUBLES_EQUAL(1.0, table->data()[0], 1e-6);
+
+    // Zero crossings of sinc.
+    for (size_t n = 1; n < WindowSize; n++) {
+        DOUBLES_EQUAL(0.0, table->data()[n * WindowInterp], 1e-6);
+    }
+
+    DOUBLES_EQUAL(0.0, table->data()[table->size() - 2], 0);
+    DOUBLES_EQUAL(0.0, table->data()[table->size() - 1], 0);
+}
+
+TEST(sinc_table_cache, q15_table_values) {
+    core::SharedPtr<SincTable> float_table =
+        SincTableCache::instance().get(WindowSize, WindowInterp, SincTableFormat_Float);
+    core::SharedPtr<SincTable> q15_table =
+        SincTableCache::instance().get(WindowSize, WindowInterp, SincTableFormat_Q15);
+    CHECK(float_table);
+    CHECK(q15_table);
+
+    LONGS_EQUAL(float_table->size(), q15_table->size());
+
+    const double one = (double)ResamplerSincQ15One;
+
+    for (size_t n = 0; n < float_table->size(); n++) {
+        const double expected = (double)float_table->data()[n];
+        const double actual = (double)q15_table->data_q15()[n] / one;
+
+        DOUBLES_EQUAL(expected, actual, 0.5 / one);
+    }
+}
+
+TEST(sinc_table_cache, resamplers_share_table) {
+    SincTableCache& cache = SincTableCache::instance();
+
+    const size_t n_tables = cache.num_tables();
+
+    ResamplerConfig config;
+    config.window_size = WindowSize;
+    config.window_interp = WindowInterp;
+
+    {
+        Resampler r1(allocator, config, 0x1, FrameSize);
+        CHECK(r1.valid());
+
+        LONGS_EQUAL(n_tables + 1, cache.num_tables());
+
+        Resampler r2(allocator, config, 0x3, FrameSize);
+        CHECK(r2.valid());
+
+        LONGS_EQUAL(n_tables + 1, cache.num_tables());
+    }
+
+    LONGS_EQUAL(n_tables, cache.num_tables());
+}
+
+TEST(sinc_table_cache, concurrent_get_release) {
+    SincTableCache& cache = SincTableCache::instance();
+
+    const size_t n_tables = cache.num_tables();
+
+    TableUser users[NumThreads];
+
+    for (size_t n = 0; n < NumThreads; n++) {
+        CHECK(users[n].start());
+    }
+
+    for (size_t n = 0; n < NumThreads; n++) {
+        users[n].join();
+        LONGS_EQUAL(0, users[n].num_failures());
+    }
+
+    LONGS_EQUAL(n_tables, cache.num_tables());
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/time_stretch_reader.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    SampleRate = 8000,
+    ChMask = 0x3,
+    NumCh = 2,
+    FrameSize = 100,
+    NumFrames = 2000,
+    SineFreq = 400
+};
+
+core::HeapAllocator allocator;
+
+// Produces sine on all channels and counts produced samples.
+class SineReader : public IReader {
+public:
+    SineReader()
+        : pos_(0)
+        , flags_(0) {
+    }
+
+    virtual void read(Frame& frame) {
+        for (size_t n = 0; n < frame.size() / NumCh; n++) {
+            for (size_t ch = 0; ch < NumCh; ch++) {
+                frame.data()[n * NumCh + ch] = value(pos_);
+            }
+            pos_++;
+        }
+        frame.set_flags(flags_);
+    }
+
+    static sample_t value(size_t pos) {
+        return (sample_t)std::sin(2 * M_PI * SineFreq / SampleRate * (double)pos);
+    }
+
+    void set_flags(unsigned flags) {
+        flags_ = flags;
+    }
+
+    size_t pos() const {
+        return pos_;
+    }
+
+private:
+    size_t pos_;
+    unsigned flags_;
+};
+
+} // namespace
+
+TEST_GROUP(time_stretch_reader) {
+    TimeStretchConfig config;
+
+    sample_t samples[FrameSize * NumCh];
+
+    unsigned read_frame(TimeStretchReader & tsr) {
+        Frame frame(samples, FrameSize * NumCh);
+        tsr.read(frame);
+        return frame.flags();
+    }
+
+    size_t count_zero_crossings(TimeStretchReader & tsr, size_t num_frames) {
+        size_t crossings = 0;
+        sample_t prev = 0;
+
+        for (size_t n = 0; n < num_frames; n++) {
+            read_frame(tsr);
+            for (size_t i = 0; i < FrameSize; i++) {
+                const sample_t s = samples[i * NumCh];
+                if ((prev < 0 && s >= 0) || (prev >= 0 && s < 0)) {
+                    crossings++;
+                }
+                prev = s;
+            }
+        }
+
+        return crossings;
+    }
+};
+
+TEST(time_stretch_reader, passthrough) {
+    SineReader reader;
+    TimeStretchReader tsr(reader, allocator, config, SampleRate, ChMask);
+    CHECK(tsr.valid());
+
+    size_t pos = 0;
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        read_frame(tsr);
+
+        for (size_t i = 0; i < FrameSize; i++) {
+            for (size_t ch = 0; ch < NumCh; ch++) {
+                DOUBLES_EQUAL((double)SineReader::value(pos),
+                              (double)samples[i * NumCh + ch], 0);
+            }
+            pos++;
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(pos, reader.pos());
+}
+
+TEST(time_stretch_reader, compress) {
+    SineReader reader;
+    TimeStretchReader tsr(reader, allocator, config, SampleRate, ChMask);
+    CHECK(tsr.valid());
+
+    CHECK(tsr.set_scaling(1.1f));
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        read_frame(tsr);
+    }
+
+    const double expected = NumFrames * FrameSize * 1.1;
+    const double tolerance = (double)SampleRate / 10;
+
+    DOUBLES_EQUAL(expected, (double)reader.pos(), tolerance);
+}
+
+TEST(time_stretch_reader, expand) {
+    SineReader reader;
+    TimeStretchReader tsr(reader, allocator, config, SampleRate, ChMask);
+    CHECK(tsr.valid());
+
+    CHECK(tsr.set_scaling(0.9f));
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        read_frame(tsr);
+    }
+
+    const double expected = NumFrames * FrameSize * 0.9;
+    const double tolerance = (double)SampleRate / 10;
+
+    DOUBLES_EQUAL(expected, (double)reader.pos(), tolerance);
+}
+
+TEST(time_stretch_reader, preserve_pitch) {
+    const float scalings[] = { 0.9f, 1.1f };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(scalings); n++) {
+        SineReader reader;
+        TimeStretchReader tsr(reader, allocator, config, SampleRate, ChMask);
+        CHECK(tsr.valid());
+
+        CHECK(tsr.set_scaling(scalings[n]));
+
+        const size_t crossings = count_zero_crossings(tsr, NumFrames);
+
+        // sine has two zero crossings per period
+        const double expected =
+            2.0 * SineFreq * NumFrames * FrameSize / (double)SampleRate;
+
+        DOUBLES_EQUAL(expected, (double)crossings, expected * 0.02);
+    }
+}
+
+TEST(time_stretch_reader, stop_stretching) {
+    SineReader reader;
+    TimeStretchReader tsr(reader, allocator, config, SampleRate, ChMask);
+    CHECK(tsr.valid());
+
+    CHECK(tsr.set_scaling(1.1f));
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        read_frame(tsr);
+    }
+
+    CHECK(tsr.set_scaling(1.0f));
+
+    // drain buffered samples
+    for (size_t n = 0; n < NumFrames; n++) {
+        read_frame(tsr);
+    }
+
+    const size_t lag = reader.pos() - NumFrames * FrameSize * 2;
+
+    for (size_t n = 0; n < NumFrames; n++) {
+        read_frame(tsr);
+
+        UNSIGNED_LONGS_EQUAL(lag, reader.pos() - (NumFrames * 2 + n + 1) * FrameSize);
+    }
+}
+
+TEST(time_stretch_reader, passthrough_flags) {
+    SineReader reader;
+    TimeStretchReader tsr(reader, allocator, config, SampleRate, ChMask);
+    CHECK(tsr.valid());
+
+    reader.set_flags(Frame::FlagBlank);
+
+    UNSIGNED_LONGS_EQUAL(Frame::FlagBlank, read_frame(tsr));
+
+    CHECK(tsr.set_scaling(1.1f));
+
+    UNSIGNED_LONGS_EQUAL(0, read_frame(tsr));
+}
+
+TEST(time_stretch_reader, scaling_bounds) {
+    SineReader reader;
+    TimeStretchReader tsr(reader, allocator, config, SampleRate, ChMask);
+    CHECK(tsr.valid());
+
+    CHECK(!tsr.set_scaling(0.1f));
+    CHECK(!tsr.set_scaling(10.0f));
+
+    DOUBLES_EQUAL(1.0, (double)tsr.scaling(), 0);
+}
+
+} // namespace audio
+} // namespace roc
@@ -97,6 +97,7 @@ TEST_GROUP(watchdog) {
             for (size_t n = 0; n < frame.size(); n++) {
                 DOUBLES_EQUAL(0.0, (double)frame.data()[n], 0);
             }
+            CHECK(frame.flags() & Frame::FlagBlank);
         }
     }
 
@@ -40,5 +40,15 @@ TEST(atomic, inc_dec) {
     CHECK(a == 0);
 }
 
+TEST(atomic, compare_exchange) {
+    Atomic a(1);
+
+    CHECK(!a.compare_exchange(2, 3));
+    CHECK(a == 1);
+
+    CHECK(a.compare_exchange(1, 3));
+    CHECK(a == 3);
+}
+
 } // namespace core
 } // namespace roc
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/cpu_kernel.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+struct Funcs {
+    int id;
+};
+
+const Funcs scalar_funcs = { 1 };
+const Funcs sse_funcs = { 2 };
+
+} // namespace
+
+TEST_GROUP(cpu_kernel) {};
+
+TEST(cpu_kernel, scalar_only) {
+    const Funcs* const table[CpuKernel_Count] = { NULL, &scalar_funcs, NULL, NULL, NULL };
+
+    LONGS_EQUAL(CpuKernel_Scalar, cpu_kernel_best(table));
+
+    POINTERS_EQUAL(&scalar_funcs, cpu_kernel_funcs(table, CpuKernel_Auto));
+    POINTERS_EQUAL(&scalar_funcs, cpu_kernel_funcs(table, CpuKernel_Scalar));
+
+    POINTERS_EQUAL(NULL, cpu_kernel_funcs(table, CpuKernel_SSE));
+    POINTERS_EQUAL(NULL, cpu_kernel_funcs(table, CpuKernel_AVX2));
+    POINTERS_EQUAL(NULL, cpu_kernel_funcs(table, CpuKernel_NEON));
+}
+
+TEST(cpu_kernel, cpu_support) {
+    const Funcs* const table[CpuKernel_Count] = { NULL, &scalar_funcs, &sse_funcs, NULL,
+                                                  NULL };
+
+    if (cpu_kernel_supported(CpuKernel_SSE)) {
+        LONGS_EQUAL(CpuKernel_SSE, cpu_kernel_best(table));
+        POINTERS_EQUAL(&sse_funcs, cpu_kernel_funcs(table, CpuKernel_Auto));
+        POINTERS_EQUAL(&sse_funcs, cpu_kernel_funcs(table, CpuKernel_SSE));
+    } else {
+        LONGS_EQUAL(CpuKernel_Scalar, cpu_kernel_best(table));
+        POINTERS_EQUAL(&scalar_funcs, cpu_kernel_funcs(table, CpuKernel_Auto));
+        POINTERS_EQUAL(NULL, cpu_kernel_funcs(table, CpuKernel_SSE));
+    }
+}
+
+TEST(cpu_kernel, to_str) {
+    STRCMP_EQUAL("auto", cpu_kernel_to_str(CpuKernel_Auto));
+    STRCMP_EQUAL("scalar", cpu_kernel_to_str(CpuKernel_Scalar));
+    STRCMP_EQUAL("sse", cpu_kernel_to_str(CpuKernel_SSE));
+    STRCMP_EQUAL("avx2", cpu_kernel_to_str(CpuKernel_AVX2));
+    STRCMP_EQUAL("neon", cpu_kernel_to_str(CpuKernel_NEON));
+}
+
+} // namespace core
+} // namespace roc
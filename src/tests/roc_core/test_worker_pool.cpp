@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2020 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
+#include "roc_core/worker_pool.h"
+
+namespace roc {
+namespace core {
+
+namespace {
+
+enum { MaxTasks = 16 };
+
+int exec_order[MaxTasks];
+Atomic exec_count;
+
+struct TestTask : WorkerTask {
+    int id;
+    bool executed;
+
+    TestTask(int i)
+        : id(i)
+        , executed(false) {
+    }
+
+    virtual void execute() {
+        exec_order[exec_count] = id;
+        ++exec_count;
+        executed = true;
+    }
+};
+
+struct BlockingTask : WorkerTask {
+    Atomic started;
+    Atomic released;
+
+    virtual void execute() {
+        started = 1;
+        while (!released) {
+            sleep_for(Microsecond * 100);
+        }
+    }
+};
+
+void wait_started(BlockingTask& task) {
+    while (!task.started) {
+        sleep_for(Microsecond * 100);
+    }
+}
+
+void wait_finished(WorkerPool& pool, WorkerTask& task) {
+    while (pool.pending(task)) {
+        sleep_for(Microsecond * 100);
+    }
+}
+
+} // namespace
+
+TEST_GROUP(worker_pool) {
+    HeapAllocator allocator;
+
+    void setup() {
+        exec_count = 0;
+    }
+};
+
+TEST(worker_pool, schedule_wait) {
+    WorkerPool pool(2, allocator);
+    CHECK(pool.valid());
+
+    UNSIGNED_LONGS_EQUAL(2, pool.num_threads());
+
+    TestTask task(1);
+
+    pool.schedule(task, timestamp());
+    pool.wait(task);
+
+    CHECK(task.executed);
+    CHECK(!pool.pending(task));
+    LONGS_EQUAL(1, (long)exec_count);
+
+    task.executed = false;
+
+    pool.schedule(task, timestamp());
+    pool.wait(task);
+
+    CHECK(task.executed);
+    LONGS_EQUAL(2, (long)exec_count);
+}
+
+TEST(worker_pool, deadline_order) {
+    WorkerPool pool(1, allocator);
+    CHECK(pool.valid());
+
+    BlockingTask blocker;
+    pool.schedule(blocker, 0);
+    wait_started(blocker);
+
+    TestTask task1(1), task2(2), task3(3), task4(4);
+
+    pool.schedule(task3, 300);
+    pool.schedule(task1, 100);
+    pool.schedule(task4, 400);
+    pool.schedule(task2, 200);
+
+    blocker.released = 1;
+
+    wait_finished(pool, task1);
+    wait_finished(pool, task2);
+    wait_finished(pool, task3);
+    wait_finished(pool, task4);
+
+    LONGS_EQUAL(4, (long)exec_count);
+
+    LONGS_EQUAL(1, exec_order[0]);
+    LONGS_EQUAL(2, exec_order[1]);
+    LONGS_EQUAL(3, exec_order[2]);
+    LONGS_EQUAL(4, exec_order[3]);
+
+    pool.wait(blocker);
+}
+
+TEST(worker_pool, wait_executes_in_caller) {
+    WorkerPool pool(1, allocator);
+    CHECK(pool.valid());
+
+    BlockingTask blocker;
+    pool.schedule(blocker, 0);
+    wait_started(blocker);
+
+    TestTask task(1);
+    pool.schedule(task, 100);
+
+    CHECK(pool.pending(task));
+    CHECK(!task.executed);
+
+    pool.wait(task);
+
+    CHECK(task.executed);
+    CHECK(!pool.pending(task));
+    CHECK(pool.pending(blocker));
+
+    blocker.released = 1;
+    pool.wait(blocker);
+
+    CHECK(!pool.pending(blocker));
+}
+
+TEST(worker_pool, cancel) {
+    WorkerPool pool(1, allocator);
+    CHECK(pool.valid());
+
+    BlockingTask blocker;
+    pool.schedule(blocker, 0);
+    wait_started(blocker);
+
+    TestTask task(1);
+    pool.schedule(task, 100);
+
+    pool.cancel(task);
+
+    CHECK(!task.executed);
+    CHECK(!pool.pending(task));
+
+    blocker.released = 1;
+    pool.cancel(blocker);
+
+    CHECK(!pool.pending(blocker));
+    LONGS_EQUAL(0, (long)exec_count);
+}
+
+} // namespace core
+} // namespace roc
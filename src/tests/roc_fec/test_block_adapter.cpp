@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_fec/block_adapter.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/feedback.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/writer.h"
+#include "roc_fec/xor_encoder.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/headers.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t NumSourcePackets = 10;
+const size_t NumRepairPackets = 2;
+
+const size_t MinRepairPackets = 1;
+const size_t MaxRepairPackets = 8;
+
+const size_t FECPayloadSize = 193;
+const size_t MaxBuffSize = 500;
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBuffSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+rtp::Composer rtp_composer(NULL);
+Composer<XOR_Source_PayloadID, Source, Footer> source_composer(&rtp_composer);
+Composer<XOR_Repair_PayloadID, Repair, Header> repair_composer(NULL);
+
+Feedback make_feedback(float loss_rate, size_t max_burst) {
+    Feedback fb;
+    fb.loss_rate = loss_rate;
+    fb.max_burst = max_burst;
+    return fb;
+}
+
+} // namespace
+
+TEST_GROUP(block_adapter) {
+    CodecConfig codec_config;
+    WriterConfig writer_config;
+    BlockAdapterConfig adapter_config;
+
+    packet::seqnum_t seqnum;
+
+    void setup() {
+        codec_config.scheme = packet::FEC_XOR_Parity;
+
+        writer_config.n_source_packets = NumSourcePackets;
+        writer_config.n_repair_packets = NumRepairPackets;
+
+        adapter_config.min_repair_packets = MinRepairPackets;
+        adapter_config.max_repair_packets = MaxRepairPackets;
+
+        seqnum = 0;
+    }
+
+    packet::PacketPtr new_packet() {
+        const size_t rtp_payload_size = FECPayloadSize - sizeof(rtp::Header);
+
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        core::Slice<uint8_t> bp = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(bp);
+
+        CHECK(source_composer.prepare(*pp, bp, rtp_payload_size));
+        pp->set_data(bp);
+
+        pp->add_flags(packet::Packet::FlagAudio);
+        pp->rtp()->seqnum = seqnum++;
+
+        return pp;
+    }
+
+    // write one block and return the number of repair packets in it
+    size_t write_block(Writer & writer, packet::Queue & queue) {
+        for (size_t n = 0; n < NumSourcePackets; n++) {
+            writer.write(new_packet());
+        }
+
+        size_t n_source = 0, n_repair = 0;
+        while (packet::PacketPtr pp = queue.read()) {
+            if (pp->flags() & packet::Packet::FlagRepair) {
+                n_repair++;
+            } else {
+                n_source++;
+            }
+        }
+
+        UNSIGNED_LONGS_EQUAL(NumSourcePackets, n_source);
+        return n_repair;
+    }
+};
+
+TEST(block_adapter, disabled) {
+    adapter_config.max_repair_packets = 0;
+
+    XorEncoder encoder(codec_config, buffer_pool, allocator);
+    packet::Queue queue;
+    Writer writer(writer_config, codec_config.scheme, encoder, queue, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+    CHECK(writer.valid());
+
+    BlockAdapter adapter(adapter_config, writer_config, writer);
+    CHECK(!adapter.enabled());
+
+    UNSIGNED_LONGS_EQUAL(NumRepairPackets, write_block(writer, queue));
+
+    adapter.update(make_feedback(0.5f, 5));
+    UNSIGNED_LONGS_EQUAL(NumRepairPackets, adapter.n_repair_packets());
+
+    UNSIGNED_LONGS_EQUAL(NumRepairPackets, write_block(writer, queue));
+}
+
+TEST(block_adapter, grow_on_loss_rate) {
+    XorEncoder encoder(codec_config, buffer_pool, allocator);
+    packet::Queue queue;
+    Writer writer(writer_config, codec_config.scheme, encoder, queue, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+    CHECK(writer.valid());
+
+    BlockAdapter adapter(adapter_config, writer_config, writer);
+    CHECK(adapter.enabled());
+
+    UNSIGNED_LONGS_EQUAL(NumRepairPackets, write_block(writer, queue));
+
+    // 20% losses in 10 packets, with a 2x margin
+    adapter.update(make_feedback(0.2f, 1));
+    UNSIGNED_LONGS_EQUAL(4, adapter.n_repair_packets());
+
+    UNSIGNED_LONGS_EQUAL(4, write_block(writer, queue));
+}
+
+TEST(block_adapter, grow_on_burst) {
+    XorEncoder encoder(codec_config, buffer_pool, allocator);
+    packet::Queue queue;
+    Writer writer(writer_config, codec_config.scheme, encoder, queue, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+    CHECK(writer.valid());
+
+    BlockAdapter adapter(adapter_config, writer_config, writer);
+
+    UNSIGNED_LONGS_EQUAL(NumRepairPackets, write_block(writer, queue));
+
+    adapter.update(make_feedback(0.05f, 6));
+    UNSIGNED_LONGS_EQUAL(6, adapter.n_repair_packets());
+
+    UNSIGNED_LONGS_EQUAL(6, write_block(writer, queue));
+}
+
+TEST(block_adapter, shrink_gradually) {
+    XorEncoder encoder(codec_config, buffer_pool, allocator);
+    packet::Queue queue;
+    Writer writer(writer_config, codec_config.scheme, encoder, queue, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+    CHECK(writer.valid());
+
+    BlockAdapter adapter(adapter_config, writer_config, writer);
+
+    UNSIGNED_LONGS_EQUAL(NumRepairPackets, write_block(writer, queue));
+
+    adapter.update(make_feedback(0, 5));
+    UNSIGNED_LONGS_EQUAL(5, adapter.n_repair_packets());
+    UNSIGNED_LONGS_EQUAL(5, write_block(writer, queue));
+
+    for (size_t n = 4; n >= MinRepairPackets; n--) {
+        adapter.update(make_feedback(0, 0));
+        UNSIGNED_LONGS_EQUAL(n, adapter.n_repair_packets());
+        UNSIGNED_LONGS_EQUAL(n, write_block(writer, queue));
+    }
+
+    adapter.update(make_feedback(0, 0));
+    UNSIGNED_LONGS_EQUAL(MinRepairPackets, adapter.n_repair_packets());
+    UNSIGNED_LONGS_EQUAL(MinRepairPackets, write_block(writer, queue));
+}
+
+TEST(block_adapter, bounds) {
+    XorEncoder encoder(codec_config, buffer_pool, allocator);
+    packet::Queue queue;
+    Writer writer(writer_config, codec_config.scheme, encoder, queue, source_composer,
+                  repair_composer, packet_pool, buffer_pool, allocator);
+    CHECK(writer.valid());
+
+    BlockAdapter adapter(adapter_config, writer_config, writer);
+
+    UNSIGNED_LONGS_EQUAL(NumRepairPackets, write_block(writer, queue));
+
+    adapter.update(make_feedback(1, NumSourcePackets));
+    UNSIGNED_LONGS_EQUAL(MaxRepairPackets, adapter.n_repair_packets());
+    UNSIGNED_LONGS_EQUAL(MaxRepairPackets, write_block(writer, queue));
+}
+
+TEST(block_adapter, feedback_header) {
+    uint8_t buf[sizeof(FeedbackHeader)];
+    FeedbackHeader& header = *(FeedbackHeader*)buf;
+
+    header.clear();
+    CHECK(header.valid());
+
+    header.set_feedback(make_feedback(0.25f, 7));
+
+    Feedback fb = header.feedback();
+    DOUBLES_EQUAL(0.25, fb.loss_rate, 0.0001);
+    UNSIGNED_LONGS_EQUAL(7, fb.max_burst);
+
+    buf[0] ^= 0xff;
+    CHECK(!header.valid());
+}
+
+} // namespace fec
+} // namespace roc
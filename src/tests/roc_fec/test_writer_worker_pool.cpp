@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2020 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/atomic.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
+#include "roc_core/worker_pool.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/writer.h"
+#include "roc_fec/xor_encoder.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/headers.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { NumSourcePackets = 5, NumRepairPackets = 1, PayloadSize = 100 };
+
+const size_t MaxBuffSize = 500;
+
+const core::nanoseconds_t PacketInterval = core::Millisecond;
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBuffSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+rtp::Composer rtp_composer(NULL);
+Composer<XOR_Source_PayloadID, Source, Footer> source_composer(&rtp_composer);
+Composer<XOR_Repair_PayloadID, Repair, Header> repair_composer(NULL);
+
+// Counts encoded blocks.
+class CountingEncoder : public IBlockEncoder {
+public:
+    CountingEncoder(IBlockEncoder& encoder)
+        : encoder_(encoder) {
+    }
+
+    long num_blocks() const {
+        return num_blocks_;
+    }
+
+    virtual size_t alignment() const {
+        return encoder_.alignment();
+    }
+
+    virtual size_t max_block_length() const {
+        return encoder_.max_block_length();
+    }
+
+    virtual bool begin(size_t sblen, size_t rblen, size_t payload_size) {
+        return encoder_.begin(sblen, rblen, payload_size);
+    }
+
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer) {
+        encoder_.set(index, buffer);
+    }
+
+    virtual void fill() {
+        encoder_.fill();
+        ++num_blocks_;
+    }
+
+    virtual void end() {
+        encoder_.end();
+    }
+
+private:
+    IBlockEncoder& encoder_;
+    core::Atomic num_blocks_;
+};
+
+// Blocks worker thread until released.
+struct BlockingTask : core::WorkerTask {
+    core::Atomic started;
+    core::Atomic released;
+
+    virtual void execute() {
+        started = 1;
+        while (!released) {
+            core::sleep_for(core::Microsecond * 100);
+        }
+    }
+};
+
+// Remembers how many blocks were encoded before it was executed.
+struct ProbeTask : core::WorkerTask {
+    CountingEncoder& encoder;
+    core::Atomic executed;
+    long num_blocks;
+
+    ProbeTask(CountingEncoder& e)
+        : encoder(e)
+        , num_blocks(-1) {
+    }
+
+    virtual void execute() {
+        num_blocks = encoder.num_blocks();
+        executed = 1;
+    }
+};
+
+packet::PacketPtr new_packet(packet::seqnum_t sn) {
+    const size_t rtp_payload_size = PayloadSize - sizeof(rtp::Header);
+
+    packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+    CHECK(pp);
+
+    core::Slice<uint8_t> bp = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+    CHECK(bp);
+
+    CHECK(source_composer.prepare(*pp, bp, rtp_payload_size));
+
+    pp->set_data(bp);
+    pp->add_flags(packet::Packet::FlagAudio);
+
+    pp->rtp()->seqnum = sn;
+    pp->rtp()->timestamp = packet::timestamp_t(sn * 10);
+
+    return pp;
+}
+
+} // namespace
+
+TEST_GROUP(writer_worker_pool) {};
+
+TEST(writer_worker_pool, deadline_order) {
+    core::WorkerPool pool(1, allocator);
+    CHECK(pool.valid());
+
+    CodecConfig codec_config;
+    codec_config.scheme = packet::FEC_XOR_Parity;
+
+    XorEncoder xor_encoder(codec_config, buffer_pool, allocator);
+    CHECK(xor_encoder.valid());
+
+    CountingEncoder encoder(xor_encoder);
+
+    WriterConfig writer_config;
+    writer_config.n_source_packets = NumSourcePackets;
+    writer_config.n_repair_packets = NumRepairPackets;
+
+    packet::Queue queue;
+
+    Writer writer(writer_config, packet::FEC_XOR_Parity, encoder, queue,
+                  source_composer, repair_composer, packet_pool, buffer_pool,
+                  allocator);
+    CHECK(writer.valid());
+
+    writer.set_worker_pool(pool);
+
+    BlockingTask blocker;
+    pool.schedule(blocker, 0);
+
+    while (!blocker.started) {
+        core::sleep_for(core::Microsecond * 100);
+    }
+
+    // the first block is encoded in this thread when the second block begins,
+    // since the worker is busy; the second block is queued with a deadline
+    // one packet interval after its end
+    for (size_t n = 0; n < NumSourcePackets * 2; n++) {
+        core::sleep_for(PacketInterval);
+        writer.write(new_packet(packet::seqnum_t(n)));
+    }
+
+    LONGS_EQUAL(1, encoder.num_blocks());
+
+    // queued after the encoding task, but with an earlier deadline
+    ProbeTask probe(encoder);
+    pool.schedule(probe, core::timestamp());
+
+    blocker.released = 1;
+
+    while (!probe.executed) {
+        core::sleep_for(core::Microsecond * 100);
+    }
+
+    LONGS_EQUAL(1, probe.num_blocks);
+
+    pool.wait(blocker);
+    pool.wait(probe);
+}
+
+TEST(writer_worker_pool, flush_on_destroy) {
+    core::WorkerPool pool(1, allocator);
+    CHECK(pool.valid());
+
+    CodecConfig codec_config;
+    codec_config.scheme = packet::FEC_XOR_Parity;
+
+    XorEncoder encoder(codec_config, buffer_pool, allocator);
+    CHECK(encoder.valid());
+
+    WriterConfig writer_config;
+    writer_config.n_source_packets = NumSourcePackets;
+    writer_config.n_repair_packets = NumRepairPackets;
+
+    packet::Queue queue;
+
+    BlockingTask blocker;
+    pool.schedule(blocker, 0);
+
+    while (!blocker.started) {
+        core::sleep_for(core::Microsecond * 100);
+    }
+
+    {
+        Writer writer(writer_config, packet::FEC_XOR_Parity, encoder, queue,
+                      source_composer, repair_composer, packet_pool, buffer_pool,
+                      allocator);
+        CHECK(writer.valid());
+
+        writer.set_worker_pool(pool);
+
+        for (size_t n = 0; n < NumSourcePackets; n++) {
+            writer.write(new_packet(packet::seqnum_t(n)));
+        }
+
+        // the worker is busy, so the block is not encoded yet
+        UNSIGNED_LONGS_EQUAL(NumSourcePackets, queue.size());
+    }
+
+    // repair packets of the last block are written by the destructor
+    UNSIGNED_LONGS_EQUAL(NumSourcePackets + NumRepairPackets, queue.size());
+
+    blocker.released = 1;
+    pool.wait(blocker);
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/random.h"
+#include "roc_fec/xor_decoder.h"
+#include "roc_fec/xor_encoder.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { NumSourcePackets = 20, NumRepairPackets = 5, PayloadSize = 251 };
+
+const size_t MaxPayloadSize = 1024;
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxPayloadSize, true);
+
+} // namespace
+
+TEST_GROUP(xor_encoder_decoder) {
+    CodecConfig config;
+
+    core::Slice<uint8_t> buffers[NumSourcePackets + NumRepairPackets];
+
+    void setup() {
+        config.scheme = packet::FEC_XOR_Parity;
+    }
+
+    core::Slice<uint8_t> make_buffer() {
+        core::Slice<uint8_t> buf = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        buf.resize(PayloadSize);
+        for (size_t j = 0; j < buf.size(); ++j) {
+            buf.data()[j] = (uint8_t)core::random(0, 0xff);
+        }
+        return buf;
+    }
+
+    void encode() {
+        XorEncoder encoder(config, buffer_pool, allocator);
+        CHECK(encoder.valid());
+
+        CHECK(encoder.begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+        for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; ++i) {
+            buffers[i] = make_buffer();
+            encoder.set(i, buffers[i]);
+        }
+
+        encoder.fill();
+        encoder.end();
+    }
+
+    bool check_repaired(XorDecoder& decoder, size_t index) {
+        core::Slice<uint8_t> decoded = decoder.repair(index);
+        if (!decoded) {
+            return false;
+        }
+        UNSIGNED_LONGS_EQUAL(PayloadSize, decoded.size());
+        return memcmp(buffers[index].data(), decoded.data(), PayloadSize) == 0;
+    }
+};
+
+TEST(xor_encoder_decoder, without_loss) {
+    encode();
+
+    XorDecoder decoder(config, buffer_pool, allocator);
+    CHECK(decoder.valid());
+
+    CHECK(decoder.begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+    for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; ++i) {
+        decoder.set(i, buffers[i]);
+    }
+
+    for (size_t i = 0; i < NumSourcePackets; ++i) {
+        CHECK(check_repaired(decoder, i));
+    }
+
+    decoder.end();
+}
+
+TEST(xor_encoder_decoder, burst_loss) {
+    encode();
+
+    XorDecoder decoder(config, buffer_pool, allocator);
+    CHECK(decoder.valid());
+
+    for (size_t burst_start = 0; burst_start + NumRepairPackets <= NumSourcePackets;
+         burst_start++) {
+        CHECK(decoder.begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+        for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; ++i) {
+            if (i >= burst_start && i < burst_start + NumRepairPackets) {
+                continue;
+            }
+            decoder.set(i, buffers[i]);
+        }
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            CHECK(check_repaired(decoder, i));
+        }
+
+        decoder.end();
+    }
+}
+
+TEST(xor_encoder_decoder, two_losses_in_column) {
+    encode();
+
+    XorDecoder decoder(config, buffer_pool, allocator);
+    CHECK(decoder.valid());
+
+    CHECK(decoder.begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+    for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; ++i) {
+        if (i == 1 || i == 1 + NumRepairPackets) {
+            continue;
+        }
+        decoder.set(i, buffers[i]);
+    }
+
+    CHECK(!decoder.repair(1));
+    CHECK(!decoder.repair(1 + NumRepairPackets));
+
+    for (size_t i = 0; i < NumSourcePackets; ++i) {
+        if (i % NumRepairPackets != 1) {
+            CHECK(check_repaired(decoder, i));
+        }
+    }
+
+    decoder.end();
+}
+
+TEST(xor_encoder_decoder, lost_repair_packet) {
+    encode();
+
+    XorDecoder decoder(config, buffer_pool, allocator);
+    CHECK(decoder.valid());
+
+    CHECK(decoder.begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+    for (size_t i = 0; i < NumSourcePackets + NumRepairPackets; ++i) {
+        if (i == 2 || i == NumSourcePackets + 2) {
+            continue;
+        }
+        decoder.set(i, buffers[i]);
+    }
+
+    CHECK(!decoder.repair(2));
+
+    CHECK(decoder.repair(3));
+    CHECK(check_repaired(decoder, 3));
+
+    decoder.end();
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/random.h"
+#include "roc_fec/xor_funcs.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { MaxSize = 300, MaxOffset = 16 };
+
+} // namespace
+
+TEST_GROUP(xor_funcs) {};
+
+TEST(xor_funcs, matches_bytewise) {
+    uint8_t src[MaxSize + MaxOffset];
+    uint8_t dst[MaxSize + MaxOffset];
+    uint8_t expected[MaxSize + MaxOffset];
+
+    for (size_t offset = 0; offset < MaxOffset; offset += 3) {
+        for (size_t size = 0; size <= MaxSize; size += 7) {
+            for (size_t i = 0; i < MaxSize + MaxOffset; i++) {
+                src[i] = (uint8_t)core::random(0, 0xff);
+                dst[i] = (uint8_t)core::random(0, 0xff);
+                expected[i] = dst[i];
+            }
+
+            for (size_t i = 0; i < size; i++) {
+                expected[offset + i] ^= src[i];
+            }
+
+            xor_buffers(dst + offset, src, size);
+
+            for (size_t i = 0; i < MaxSize + MaxOffset; i++) {
+                UNSIGNED_LONGS_EQUAL(expected[i], dst[i]);
+            }
+        }
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -51,7 +51,29 @@ enum {
     Timeout = TotalSamples * 10
 };
 
-enum { FlagFEC = (1 << 0) };
+enum {
+    FlagFEC = (1 << 0),
+    FlagXOR = (1 << 1),
+    FlagFeedback = (1 << 2),
+    FlagRetransmission = (1 << 3),
+    FlagSeparateSessions = (1 << 4),
+    FlagAsync = (1 << 5),
+    FlagNetworkRouting = (1 << 6)
+};
+
+roc_protocol source_proto(unsigned flags) {
+    if (flags & FlagXOR) {
+        return ROC_PROTO_RTP_XOR_SOURCE;
+    }
+    return ROC_PROTO_RTP_RS8M_SOURCE;
+}
+
+roc_protocol repair_proto(unsigned flags) {
+    if (flags & FlagXOR) {
+        return ROC_PROTO_XOR_REPAIR;
+    }
+    return ROC_PROTO_RS8M_REPAIR;
+}
 
 core::HeapAllocator allocator;
 packet::PacketPool packet_pool(allocator, true);
@@ -98,16 +120,21 @@ public:
         CHECK(sndr_);
         CHECK(roc_sender_bind(sndr_, &addr) == 0);
         if (flags & FlagFEC) {
-            CHECK(roc_sender_connect(sndr_, ROC_PORT_AUDIO_SOURCE,
-                                     ROC_PROTO_RTP_RS8M_SOURCE, dst_source_addr)
+            CHECK(roc_sender_connect(sndr_, ROC_PORT_AUDIO_SOURCE, source_proto(flags),
+                                     dst_source_addr)
                   == 0);
-            CHECK(roc_sender_connect(sndr_, ROC_PORT_AUDIO_REPAIR, ROC_PROTO_RS8M_REPAIR,
+            CHECK(roc_sender_connect(sndr_, ROC_PORT_AUDIO_REPAIR, repair_proto(flags),
                                      dst_repair_addr)
                   == 0);
         } else {
             CHECK(roc_sender_connect(sndr_, ROC_PORT_AUDIO_SOURCE, ROC_PROTO_RTP,
                                      dst_source_addr)
                   == 0);
+            if (flags & FlagRetransmission) {
+                CHECK(roc_sender_connect(sndr_, ROC_PORT_AUDIO_RETRANSMISSION,
+                                         ROC_PROTO_RTP_RTX, dst_repair_addr)
+                      == 0);
+            }
         }
     }
 
@@ -115,6 +142,11 @@ public:
         roc_sender_close(sndr_);
     }
 
+    bool add_destination(const roc_address* dst_source_addr,
+                         const roc_address* dst_repair_addr) {
+        return roc_sender_add_destination(sndr_, dst_source_addr, dst_repair_addr) == 0;
+    }
+
 private:
     virtual void run() {
         for (size_t off = 0; off < total_samples_; off += frame_size_) {
@@ -149,22 +181,30 @@ public:
              unsigned flags)
         : samples_(samples)
         , total_samples_(total_samples)
-        , frame_size_(frame_size) {
+        , frame_size_(frame_size)
+        , separate_sessions_(flags & FlagSeparateSessions)
+        , session_(0)
+        , has_session_(false) {
         CHECK(roc_address_init(&source_addr_, ROC_AF_AUTO, "127.0.0.1", 0) == 0);
         CHECK(roc_address_init(&repair_addr_, ROC_AF_AUTO, "127.0.0.1", 0) == 0);
         recv_ = roc_receiver_open(context.get(), &config);
         CHECK(recv_);
         if (flags & FlagFEC) {
-            CHECK(roc_receiver_bind(recv_, ROC_PORT_AUDIO_SOURCE,
-                                    ROC_PROTO_RTP_RS8M_SOURCE, &source_addr_)
+            CHECK(roc_receiver_bind(recv_, ROC_PORT_AUDIO_SOURCE, source_proto(flags),
+                                    &source_addr_)
                   == 0);
-            CHECK(roc_receiver_bind(recv_, ROC_PORT_AUDIO_REPAIR, ROC_PROTO_RS8M_REPAIR,
+            CHECK(roc_receiver_bind(recv_, ROC_PORT_AUDIO_REPAIR, repair_proto(flags),
                                     &repair_addr_)
                   == 0);
         } else {
             CHECK(roc_receiver_bind(recv_, ROC_PORT_AUDIO_SOURCE, ROC_PROTO_RTP,
                                     &source_addr_)
                   == 0);
+            if (flags & FlagRetransmission) {
+                CHECK(roc_receiver_bind(recv_, ROC_PORT_AUDIO_RETRANSMISSION,
+                                        ROC_PROTO_RTP_RTX, &repair_addr_)
+                      == 0);
+            }
         }
     }
 
@@ -200,7 +240,7 @@ public:
             frame.samples = rx_buff;
             frame.samples_size = frame_size_ * sizeof(float);
 
-            roc_panic_if_not(roc_receiver_read(recv_, &frame) == 0);
+            read_(frame);
 
             if (seek_first) {
                 for (; i < frame_size_ && is_zero_(rx_buff[i]); i++, leading_zeros++) {
@@ -238,6 +278,28 @@ public:
     }
 
 private:
+    void read_(roc_frame& frame) {
+        // with automatic timing, roc_receiver_read() blocks until it's time to
+        // read the next frame, and returns silence if sessions are not mixed
+        roc_panic_if_not(roc_receiver_read(recv_, &frame) == 0);
+
+        if (!separate_sessions_) {
+            return;
+        }
+
+        if (!has_session_) {
+            size_t count = 1;
+            roc_panic_if_not(roc_receiver_get_sessions(recv_, &session_, &count) == 0);
+            roc_panic_if_not(count <= 1);
+            if (count == 0) {
+                return;
+            }
+            has_session_ = true;
+        }
+
+        roc_panic_if_not(roc_receiver_read_session(recv_, session_, &frame) == 0);
+    }
+
     static inline bool is_zero_(float s) {
         return fabs(double(s)) < 1e-9;
     }
@@ -250,6 +312,24 @@ private:
     const float* samples_;
     const size_t total_samples_;
     const size_t frame_size_;
+
+    const bool separate_sessions_;
+    roc_session_id session_;
+    bool has_session_;
+};
+
+class ReceiverThread : public core::Thread {
+public:
+    ReceiverThread(Receiver& receiver)
+        : receiver_(receiver) {
+    }
+
+private:
+    virtual void run() {
+        receiver_.run();
+    }
+
+    Receiver& receiver_;
 };
 
 class Proxy : private packet::IWriter {
@@ -388,12 +468,20 @@ TEST_GROUP(sender_receiver) {
         sender_conf.packet_length =
             PacketSamples * 1000000000ul / (SampleRate * NumChans);
         if (flags & FlagFEC) {
-            sender_conf.fec_code = ROC_FEC_RS8M;
+            sender_conf.fec_code = (flags & FlagXOR) ? ROC_FEC_XOR : ROC_FEC_RS8M;
             sender_conf.fec_block_source_packets = SourcePackets;
             sender_conf.fec_block_repair_packets = RepairPackets;
+            if (flags & FlagFeedback) {
+                sender_conf.fec_block_min_repair_packets = 1;
+                sender_conf.fec_block_max_repair_packets = RepairPackets;
+            }
         } else {
             sender_conf.fec_code = ROC_FEC_DISABLE;
         }
+        if (flags & FlagAsync) {
+            sender_conf.async_sending = 1;
+            sender_conf.async_overflow = ROC_ASYNC_OVERFLOW_BLOCK;
+        }
 
         memset(&receiver_conf, 0, sizeof(receiver_conf));
         receiver_conf.frame_sample_rate = SampleRate;
@@ -403,6 +491,15 @@ TEST_GROUP(sender_receiver) {
         receiver_conf.resampler_profile = ROC_RESAMPLER_DISABLE;
         receiver_conf.target_latency = Latency * 1000000000ul / SampleRate;
         receiver_conf.no_playback_timeout = Timeout * 1000000000ul / SampleRate;
+        if (flags & FlagFeedback) {
+            receiver_conf.fec_feedback_interval = sender_conf.packet_length * SourcePackets;
+        }
+        if (flags & FlagSeparateSessions) {
+            receiver_conf.separate_sessions = 1;
+        }
+        if (flags & FlagNetworkRouting) {
+            receiver_conf.network_routing = 1;
+        }
     }
 };
 
@@ -423,6 +520,169 @@ TEST(sender_receiver, bare_rtp) {
     sender.join();
 }
 
+TEST(sender_receiver, async_sending) {
+    enum { Flags = FlagAsync };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, retransmission) {
+    enum { Flags = FlagRetransmission };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, retransmission_many_destinations) {
+    enum { Flags = FlagRetransmission };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    CHECK(!sender.add_destination(receiver.source_addr(), receiver.repair_addr()));
+}
+
+TEST(sender_receiver, separate_sessions) {
+    enum { Flags = FlagSeparateSessions };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, fec_xor_network_routing) {
+    enum { Flags = FlagFEC | FlagXOR | FlagNetworkRouting };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, fec_xor_without_losses) {
+    enum { Flags = FlagFEC | FlagXOR };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, fec_xor_feedback) {
+    enum { Flags = FlagFEC | FlagXOR | FlagFeedback };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Sender sender(context, sender_conf, receiver.source_addr(), receiver.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
+TEST(sender_receiver, fec_xor_many_destinations) {
+    enum { Flags = FlagFEC | FlagXOR };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver1(context, receiver_conf, samples, TotalSamples, FrameSamples,
+                       Flags);
+    Receiver receiver2(context, receiver_conf, samples, TotalSamples, FrameSamples,
+                       Flags);
+
+    Sender sender(context, sender_conf, receiver1.source_addr(), receiver1.repair_addr(),
+                  samples, TotalSamples, FrameSamples, Flags);
+
+    CHECK(sender.add_destination(receiver2.source_addr(), receiver2.repair_addr()));
+
+    ReceiverThread receiver_thread(receiver2);
+
+    receiver_thread.start();
+    sender.start();
+    receiver1.run();
+    receiver_thread.join();
+    sender.join();
+}
+
+TEST(sender_receiver, fec_xor_with_losses) {
+    enum { Flags = FlagFEC | FlagXOR };
+
+    init_config(Flags);
+
+    Context context;
+
+    Receiver receiver(context, receiver_conf, samples, TotalSamples, FrameSamples, Flags);
+
+    Proxy proxy(receiver.source_addr(), receiver.repair_addr(), SourcePackets,
+                RepairPackets);
+
+    Sender sender(context, sender_conf, proxy.source_addr(), proxy.repair_addr(), samples,
+                  TotalSamples, FrameSamples, Flags);
+
+    sender.start();
+    receiver.run();
+    sender.join();
+}
+
 #ifdef ROC_TARGET_OPENFEC
 TEST(sender_receiver, fec_without_losses) {
     enum { Flags = FlagFEC };
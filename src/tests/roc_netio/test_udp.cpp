@@ -72,6 +72,8 @@ TEST_GROUP(udp) {
         CHECK(pp->udp()->src_addr == tx_addr);
         CHECK(pp->udp()->dst_addr == rx_addr);
 
+        CHECK(pp->udp()->receive_timestamp > 0);
+
         core::Slice<uint8_t> expected = new_buffer(value);
 
         UNSIGNED_LONGS_EQUAL(expected.size(), pp->data().size());
@@ -103,6 +105,31 @@ TEST(udp, one_sender_one_receiver_single_thread) {
     }
 }
 
+TEST(udp, sender_receives_inbound_packets) {
+    packet::ConcurrentQueue inbound_queue;
+
+    packet::Address tx_addr = new_address();
+    packet::Address peer_addr = new_address();
+
+    Transceiver trx(packet_pool, buffer_pool, allocator);
+    CHECK(trx.valid());
+
+    packet::IWriter* tx_sender = trx.add_udp_sender(tx_addr, inbound_queue);
+    CHECK(tx_sender);
+
+    packet::IWriter* peer_sender = trx.add_udp_sender(peer_addr);
+    CHECK(peer_sender);
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            peer_sender->write(new_packet(peer_addr, tx_addr, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(inbound_queue.read(), peer_addr, tx_addr, p);
+        }
+    }
+}
+
 TEST(udp, one_sender_one_receiver_separate_threads) {
     packet::ConcurrentQueue rx_queue;
 
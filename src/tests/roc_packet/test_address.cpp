@@ -127,6 +127,29 @@ TEST(address, eq_ipv6) {
     CHECK(addr1 != addr4);
 }
 
+TEST(address, same_ip) {
+    Address addr1;
+    CHECK(addr1.set_ipv4("1.2.3.4", 123));
+
+    Address addr2;
+    CHECK(addr2.set_ipv4("1.2.3.4", 456));
+
+    Address addr3;
+    CHECK(addr3.set_ipv4("1.2.4.3", 123));
+
+    Address addr4;
+    CHECK(addr4.set_ipv6("2001:db1::1", 123));
+
+    Address addr5;
+    CHECK(addr5.set_ipv6("2001:db1::1", 456));
+
+    CHECK(addr1.same_ip(addr2));
+    CHECK(!addr1.same_ip(addr3));
+    CHECK(!addr1.same_ip(addr4));
+    CHECK(addr4.same_ip(addr5));
+    CHECK(!addr1.same_ip(Address()));
+}
+
 TEST(address, multicast_ipv4) {
     {
         Address addr;
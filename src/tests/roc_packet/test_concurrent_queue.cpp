@@ -43,5 +43,33 @@ TEST(concurrent_queue, write_read) {
     CHECK(queue.read() == p2);
 }
 
+TEST(concurrent_queue, non_blocking) {
+    ConcurrentQueue queue(0, false);
+
+    CHECK(!queue.read());
+
+    PacketPtr p1 = new_packet();
+    queue.write(p1);
+
+    CHECK(queue.read() == p1);
+    CHECK(!queue.read());
+}
+
+TEST(concurrent_queue, max_size) {
+    ConcurrentQueue queue(2, false);
+
+    PacketPtr p1 = new_packet();
+    PacketPtr p2 = new_packet();
+    PacketPtr p3 = new_packet();
+
+    queue.write(p1);
+    queue.write(p2);
+    queue.write(p3);
+
+    CHECK(queue.read() == p1);
+    CHECK(queue.read() == p2);
+    CHECK(!queue.read());
+}
+
 } // namespace packet
 } // namespace roc
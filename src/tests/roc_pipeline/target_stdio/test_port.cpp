@@ -73,6 +73,33 @@ TEST(port, proto_ldpc_repair) {
     STRCMP_EQUAL("ldpc:1.2.3.4:123", port_to_str(port).c_str());
 }
 
+TEST(port, proto_xor_source) {
+    PortConfig port;
+    CHECK(parse_port(Port_AudioSource, "rtp+xor:1.2.3.4:123", port));
+
+    UNSIGNED_LONGS_EQUAL(Proto_RTP_XOR_Source, port.protocol);
+
+    STRCMP_EQUAL("rtp+xor:1.2.3.4:123", port_to_str(port).c_str());
+}
+
+TEST(port, proto_xor_repair) {
+    PortConfig port;
+    CHECK(parse_port(Port_AudioRepair, "xor:1.2.3.4:123", port));
+
+    UNSIGNED_LONGS_EQUAL(Proto_XOR_Repair, port.protocol);
+
+    STRCMP_EQUAL("xor:1.2.3.4:123", port_to_str(port).c_str());
+}
+
+TEST(port, proto_rtx) {
+    PortConfig port;
+    CHECK(parse_port(Port_AudioRetransmission, "rtx:1.2.3.4:123", port));
+
+    UNSIGNED_LONGS_EQUAL(Proto_RTP_RTX, port.protocol);
+
+    STRCMP_EQUAL("rtx:1.2.3.4:123", port_to_str(port).c_str());
+}
+
 TEST(port, addr_zero) {
     PortConfig port;
     CHECK(parse_port(Port_AudioSource, "rtp:0.0.0.0:0", port));
@@ -142,6 +169,17 @@ TEST(port, port_type) {
 
     CHECK(!parse_port(Port_AudioSource, "ldpc:1.2.3.4:123", port));
     CHECK(parse_port(Port_AudioRepair, "ldpc:1.2.3.4:123", port));
+
+    CHECK(parse_port(Port_AudioSource, "rtp+xor:1.2.3.4:123", port));
+    CHECK(!parse_port(Port_AudioRepair, "rtp+xor:1.2.3.4:123", port));
+
+    CHECK(!parse_port(Port_AudioSource, "xor:1.2.3.4:123", port));
+    CHECK(parse_port(Port_AudioRepair, "xor:1.2.3.4:123", port));
+
+    CHECK(!parse_port(Port_AudioSource, "rtx:1.2.3.4:123", port));
+    CHECK(!parse_port(Port_AudioRepair, "rtx:1.2.3.4:123", port));
+    CHECK(parse_port(Port_AudioRetransmission, "rtx:1.2.3.4:123", port));
+    CHECK(!parse_port(Port_AudioRetransmission, "rtp:1.2.3.4:123", port));
 }
 
 TEST(port, bad_format) {
@@ -11,6 +11,9 @@
 #include "roc_audio/pcm_funcs.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/helpers.h"
+#include "roc_core/time.h"
+#include "roc_core/worker_pool.h"
 #include "roc_fec/codec_map.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_pipeline/receiver.h"
@@ -47,6 +50,17 @@ enum {
     MaxTsJump = ManyPackets * 7 * SamplesPerPacket
 };
 
+struct SessionList {
+    session_id_t ids[2];
+    size_t count;
+};
+
+void list_session(void* arg, session_id_t id, const packet::Address&) {
+    SessionList& list = *(SessionList*)arg;
+    CHECK(list.count < ROC_ARRAY_SIZE(list.ids));
+    list.ids[list.count++] = id;
+}
+
 core::HeapAllocator allocator;
 core::BufferPool<audio::sample_t> sample_buffer_pool(allocator, MaxBufSize, true);
 core::BufferPool<uint8_t> byte_buffer_pool(allocator, MaxBufSize, true);
@@ -56,6 +70,13 @@ fec::CodecMap codec_map;
 rtp::FormatMap format_map;
 rtp::Composer rtp_composer(NULL);
 
+void wait_idle_sessions(Receiver& receiver, size_t num_sessions) {
+    for (size_t n = 0; receiver.num_idle_sessions() != num_sessions; n++) {
+        CHECK(n < 10000);
+        core::sleep_for(core::Microsecond * 100);
+    }
+}
+
 } // namespace
 
 TEST_GROUP(receiver) {
@@ -104,8 +125,8 @@ TEST_GROUP(receiver) {
 };
 
 TEST(receiver, no_sessions) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
 
@@ -119,8 +140,8 @@ TEST(receiver, no_sessions) {
 }
 
 TEST(receiver, no_ports) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
 
@@ -143,8 +164,8 @@ TEST(receiver, no_ports) {
 }
 
 TEST(receiver, one_session) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -170,8 +191,8 @@ TEST(receiver, one_session) {
 TEST(receiver, one_session_long_run) {
     enum { NumIterations = 10 };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -197,8 +218,8 @@ TEST(receiver, one_session_long_run) {
 }
 
 TEST(receiver, initial_latency) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -230,8 +251,8 @@ TEST(receiver, initial_latency) {
 }
 
 TEST(receiver, initial_latency_timeout) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -257,8 +278,8 @@ TEST(receiver, initial_latency_timeout) {
 }
 
 TEST(receiver, timeout) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -284,8 +305,8 @@ TEST(receiver, timeout) {
 }
 
 TEST(receiver, initial_trim) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -311,8 +332,8 @@ TEST(receiver, initial_trim) {
 }
 
 TEST(receiver, two_sessions_synchronous) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -345,8 +366,57 @@ TEST(receiver, two_sessions_synchronous) {
 }
 
 TEST(receiver, two_sessions_overlapping) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    packet_writer1.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    packet_writer2.set_offset(packet_writer1.offset() - Latency * NumCh);
+    packet_writer2.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 2);
+
+            UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
+TEST(receiver, two_sessions_parallel) {
+    core::WorkerPool worker_pool(2, allocator);
+    CHECK(worker_pool.valid());
+
+    config.common.parallel_sessions = true;
+
+    Receiver receiver(config, codec_map, format_map, &worker_pool, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -389,8 +459,8 @@ TEST(receiver, two_sessions_overlapping) {
 }
 
 TEST(receiver, two_sessions_two_ports) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
 
@@ -425,8 +495,8 @@ TEST(receiver, two_sessions_two_ports) {
 }
 
 TEST(receiver, two_sessions_same_address_same_stream) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
 
@@ -466,8 +536,8 @@ TEST(receiver, two_sessions_same_address_same_stream) {
 }
 
 TEST(receiver, two_sessions_same_address_different_streams) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
 
@@ -509,8 +579,8 @@ TEST(receiver, two_sessions_same_address_different_streams) {
 }
 
 TEST(receiver, seqnum_overflow) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -534,8 +604,8 @@ TEST(receiver, seqnum_overflow) {
 TEST(receiver, seqnum_small_jump) {
     enum { SmallJump = 5 };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -565,8 +635,8 @@ TEST(receiver, seqnum_small_jump) {
 }
 
 TEST(receiver, seqnum_large_jump) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -602,8 +672,8 @@ TEST(receiver, seqnum_large_jump) {
 TEST(receiver, seqnum_reorder) {
     enum { ReorderWindow = Latency / SamplesPerPacket };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -634,8 +704,8 @@ TEST(receiver, seqnum_reorder) {
 TEST(receiver, seqnum_late) {
     enum { DelayedPackets = 5 };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -682,8 +752,8 @@ TEST(receiver, seqnum_late) {
 }
 
 TEST(receiver, timestamp_overflow) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -709,8 +779,8 @@ TEST(receiver, timestamp_overflow) {
 TEST(receiver, timestamp_small_jump) {
     enum { ShiftedPackets = 5 };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -748,8 +818,8 @@ TEST(receiver, timestamp_small_jump) {
 }
 
 TEST(receiver, timestamp_large_jump) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -779,8 +849,8 @@ TEST(receiver, timestamp_large_jump) {
 TEST(receiver, timestamp_overlap) {
     enum { OverlappedSamples = SamplesPerPacket / 2 };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -804,8 +874,8 @@ TEST(receiver, timestamp_overlap) {
 }
 
 TEST(receiver, timestamp_reorder) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -851,8 +921,8 @@ TEST(receiver, timestamp_reorder) {
 TEST(receiver, timestamp_late) {
     enum { DelayedPackets = 5 };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -908,8 +978,8 @@ TEST(receiver, packet_size_small) {
         ManySmallPackets = Latency / SamplesPerSmallPacket * 10
     };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -937,8 +1007,8 @@ TEST(receiver, packet_size_large) {
         ManyLargePackets = Latency / SamplesPerLargePacket * 10
     };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -972,8 +1042,8 @@ TEST(receiver, packet_size_variable) {
         NumIterations = Latency / SamplesPerTwoPackets * 10
     };
 
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -998,8 +1068,8 @@ TEST(receiver, packet_size_variable) {
 }
 
 TEST(receiver, corrupted_packets_new_session) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -1025,8 +1095,8 @@ TEST(receiver, corrupted_packets_new_session) {
 }
 
 TEST(receiver, corrupted_packets_existing_session) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
@@ -1072,9 +1142,542 @@ TEST(receiver, corrupted_packets_existing_session) {
     }
 }
 
+TEST(receiver, idle_sessions) {
+    enum { PoolSize = 2 };
+
+    config.common.session_pool_size = PoolSize;
+
+    core::WorkerPool worker_pool(1, allocator);
+    CHECK(worker_pool.valid());
+
+    Receiver receiver(config, codec_map, format_map, &worker_pool, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    // parameters of idle sessions are not known until the first session
+    UNSIGNED_LONGS_EQUAL(0, receiver.num_idle_sessions());
+
+    for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+        frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+    }
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+    // idle sessions are constructed in background
+    packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+    wait_idle_sessions(receiver, PoolSize);
+
+    // second session is bound to one of the idle sessions
+    packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+    UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+
+    packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    wait_idle_sessions(receiver, PoolSize);
+}
+
+TEST(receiver, idle_sessions_default_payload_type) {
+    enum { PoolSize = 2 };
+
+    config.common.session_pool_size = PoolSize;
+    config.default_session.payload_type = PayloadType;
+
+    core::WorkerPool worker_pool(1, allocator);
+    CHECK(worker_pool.valid());
+
+    Receiver receiver(config, codec_map, format_map, &worker_pool, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    packet_writer.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    wait_idle_sessions(receiver, PoolSize);
+    UNSIGNED_LONGS_EQUAL(0, receiver.num_sessions());
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+
+        wait_idle_sessions(receiver, PoolSize);
+    }
+}
+
+TEST(receiver, idle_sessions_no_worker_pool) {
+    enum { PoolSize = 2 };
+
+    config.common.session_pool_size = PoolSize;
+    config.default_session.payload_type = PayloadType;
+
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    // receiver constructs idle sessions on its own thread
+    packet_writer1.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+    wait_idle_sessions(receiver, PoolSize);
+
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+    packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+    wait_idle_sessions(receiver, PoolSize);
+
+    // second session is bound to one of the idle sessions
+    packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+    UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+
+    packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    wait_idle_sessions(receiver, PoolSize);
+}
+
+TEST(receiver, separate_sessions) {
+    config.common.mixing = false;
+
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    // mixed output is silent
+    frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+
+    UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+
+    SessionList list;
+    list.count = 0;
+    receiver.iterate_sessions(list_session, &list);
+
+    UNSIGNED_LONGS_EQUAL(2, list.count);
+    CHECK(list.ids[0] != list.ids[1]);
+
+    core::Slice<audio::sample_t> samples(
+        new (sample_buffer_pool) core::Buffer<audio::sample_t>(sample_buffer_pool));
+    CHECK(samples);
+    samples.resize(SamplesPerFrame * NumCh);
+
+    uint8_t offsets[2] = { 0, 0 };
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            for (size_t ns = 0; ns < 2; ns++) {
+                audio::Frame frame(samples.data(), samples.size());
+                CHECK(receiver.read_session(list.ids[ns], frame));
+
+                for (size_t n = 0; n < frame.size(); n++) {
+                    DOUBLES_EQUAL((double)nth_sample(offsets[ns]),
+                                  (double)frame.data()[n], Epsilon);
+                    offsets[ns]++;
+                }
+            }
+
+            UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    {
+        audio::Frame frame(samples.data(), samples.size());
+        CHECK(!receiver.read_session(list.ids[0] + list.ids[1], frame));
+    }
+
+    // sessions are terminated when they are read after timeout
+    for (size_t nf = 0;; nf++) {
+        CHECK(nf < Timeout * 2 / SamplesPerFrame);
+
+        audio::Frame frame(samples.data(), samples.size());
+        if (!receiver.read_session(list.ids[0], frame)) {
+            break;
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+}
+
+TEST(receiver, separate_sessions_unread) {
+    config.common.mixing = false;
+
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+
+    SessionList list;
+    list.count = 0;
+    receiver.iterate_sessions(list_session, &list);
+
+    UNSIGNED_LONGS_EQUAL(2, list.count);
+
+    core::Slice<audio::sample_t> samples(
+        new (sample_buffer_pool) core::Buffer<audio::sample_t>(sample_buffer_pool));
+    CHECK(samples);
+    samples.resize(SamplesPerFrame * NumCh);
+
+    const core::nanoseconds_t read_timeout =
+        config.default_session.watchdog.no_playback_timeout;
+
+    // only the first session is read; the second one is removed after
+    // it was not read during the no playback timeout
+    for (size_t np = 0;; np++) {
+        CHECK(np < 100);
+
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            audio::Frame frame(samples.data(), samples.size());
+            CHECK(receiver.read_session(list.ids[0], frame));
+        }
+
+        if (receiver.num_sessions() == 1) {
+            break;
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+
+        core::sleep_for(read_timeout / 10);
+    }
+
+    audio::Frame frame(samples.data(), samples.size());
+    CHECK(receiver.read_session(list.ids[0], frame));
+    CHECK(!receiver.read_session(list.ids[1], frame));
+}
+
+TEST(receiver, route_on_write) {
+    config.common.route_on_write = true;
+
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port2.address);
+
+    // packets for unknown port are dropped on write
+    packet_writer2.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    CHECK(receiver.state() == sndio::ISource::Inactive);
+
+    packet_writer1.write_packets(Latency / SamplesPerPacket, SamplesPerPacket, ChMask);
+
+    CHECK(receiver.state() == sndio::ISource::Active);
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
+TEST(receiver, route_on_write_reorder) {
+    enum { ReorderWindow = Latency / SamplesPerPacket };
+
+    config.common.route_on_write = true;
+
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    size_t pos = 0;
+
+    for (size_t ni = 0; ni < ManyPackets / ReorderWindow; ni++) {
+        if (pos >= Latency / SamplesPerPacket) {
+            for (size_t nf = 0; nf < ReorderWindow * FramesPerPacket; nf++) {
+                frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+                UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+            }
+        }
+
+        for (ssize_t np = ReorderWindow - 1; np >= 0; np--) {
+            packet_writer.shift_to(pos + size_t(np), SamplesPerPacket, ChMask);
+            packet_writer.write_packets(1, SamplesPerPacket, ChMask);
+        }
+
+        pos += ReorderWindow;
+    }
+}
+
+TEST(receiver, max_sessions) {
+    config.common.max_sessions = 1;
+    config.common.reject_timeout = Timeout * 100 * core::Second / SampleRate;
+
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_rejected_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
+TEST(receiver, max_packet_rate) {
+    enum { MaxPackets = Latency / SamplesPerPacket };
+
+    config.common.max_packet_rate = MaxPackets;
+
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer(allocator, receiver, rtp_composer, format_map, packet_pool,
+                               byte_buffer_pool, PayloadType, src1, port1.address);
+
+    // packets exceeding the rate are dropped
+    packet_writer.write_packets(MaxPackets * 2, SamplesPerPacket, ChMask);
+
+    for (size_t np = 0; np < MaxPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+        }
+    }
+
+    for (size_t np = 0; np < MaxPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+}
+
+TEST(receiver, read_budget) {
+    config.common.read_budget = 1;
+    config.common.reject_timeout = Timeout * 100 * core::Second / SampleRate;
+
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    // first read exceeds the budget, newest session is shed
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 2);
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_shed_sessions());
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            if (np != 0 || nf != 0) {
+                frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+            }
+
+            // last session is never shed, and shed sender is ignored
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+            UNSIGNED_LONGS_EQUAL(1, receiver.num_shed_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+}
+
+TEST(receiver, read_budget_backoff) {
+    const core::nanoseconds_t RejectTimeout = 50 * core::Millisecond;
+
+    config.common.read_budget = 1;
+    config.common.reject_timeout = RejectTimeout;
+
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
+
+    CHECK(receiver.valid());
+    CHECK(receiver.add_port(port1));
+
+    FrameReader frame_reader(receiver, sample_buffer_pool);
+
+    PacketWriter packet_writer1(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src1,
+                                port1.address);
+
+    PacketWriter packet_writer2(allocator, receiver, rtp_composer, format_map,
+                                packet_pool, byte_buffer_pool, PayloadType, src2,
+                                port1.address);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, ChMask);
+        packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    }
+
+    // newest session is shed for reject timeout
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 2);
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_shed_sessions());
+
+    // shed sender is re-admitted after reject timeout and is shed again
+    core::sleep_for(RejectTimeout * 3 / 2);
+
+    packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+    UNSIGNED_LONGS_EQUAL(2, receiver.num_shed_sessions());
+
+    // now it is ignored for twice the reject timeout
+    core::sleep_for(RejectTimeout * 3 / 2);
+
+    packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+    UNSIGNED_LONGS_EQUAL(2, receiver.num_shed_sessions());
+
+    core::sleep_for(RejectTimeout);
+
+    packet_writer2.write_packets(1, SamplesPerPacket, ChMask);
+    frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+    UNSIGNED_LONGS_EQUAL(3, receiver.num_shed_sessions());
+}
+
 TEST(receiver, status) {
-    Receiver receiver(config, codec_map, format_map, packet_pool, byte_buffer_pool,
-                      sample_buffer_pool, allocator);
+    Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
+                      byte_buffer_pool, sample_buffer_pool, allocator);
 
     CHECK(receiver.valid());
     CHECK(receiver.add_port(port1));
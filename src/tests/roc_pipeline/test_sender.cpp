@@ -12,6 +12,7 @@
 #include "roc_audio/pcm_funcs.h"
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/mutex.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/queue.h"
 #include "roc_pipeline/sender.h"
@@ -51,6 +52,24 @@ fec::CodecMap codec_map;
 rtp::FormatMap format_map;
 rtp::Parser rtp_parser(format_map, NULL);
 
+// Blocks writes while the mutex is locked.
+class BlockingWriter : public packet::IWriter {
+public:
+    BlockingWriter(packet::IWriter& writer, core::Mutex& mutex)
+        : writer_(writer)
+        , mutex_(mutex) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        core::Mutex::Lock lock(mutex_);
+        writer_.write(pp);
+    }
+
+private:
+    packet::IWriter& writer_;
+    core::Mutex& mutex_;
+};
+
 } // namespace
 
 TEST_GROUP(sender) {
@@ -58,6 +77,7 @@ TEST_GROUP(sender) {
 
     PortConfig source_port;
     PortConfig repair_port;
+    PortConfig rtx_port;
 
     void setup() {
         source_port.address = new_address(1);
@@ -76,8 +96,9 @@ TEST_GROUP(sender) {
 TEST(sender, write) {
     packet::Queue queue;
 
-    Sender sender(config, source_port, queue, repair_port, queue, codec_map, format_map,
-                  packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+    Sender sender(config, source_port, queue, repair_port, queue, rtx_port, queue,
+                  codec_map, format_map, NULL, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
 
     CHECK(sender.valid());
 
@@ -106,8 +127,9 @@ TEST(sender, frame_size_small) {
 
     packet::Queue queue;
 
-    Sender sender(config, source_port, queue, repair_port, queue, codec_map, format_map,
-                  packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+    Sender sender(config, source_port, queue, repair_port, queue, rtx_port, queue,
+                  codec_map, format_map, NULL, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
 
     CHECK(sender.valid());
 
@@ -136,8 +158,9 @@ TEST(sender, frame_size_large) {
 
     packet::Queue queue;
 
-    Sender sender(config, source_port, queue, repair_port, queue, codec_map, format_map,
-                  packet_pool, byte_buffer_pool, sample_buffer_pool, allocator);
+    Sender sender(config, source_port, queue, repair_port, queue, rtx_port, queue,
+                  codec_map, format_map, NULL, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
 
     CHECK(sender.valid());
 
@@ -157,5 +180,158 @@ TEST(sender, frame_size_large) {
     CHECK(!queue.read());
 }
 
+TEST(sender, async) {
+    config.async = true;
+    config.async_queue_size = 2;
+    config.async_overflow = AsyncOverflow_Block;
+
+    packet::Queue queue;
+
+    {
+        Sender sender(config, source_port, queue, repair_port, queue, rtx_port, queue,
+                      codec_map, format_map, NULL, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+        CHECK(sender.valid());
+
+        FrameWriter frame_writer(sender, sample_buffer_pool);
+
+        for (size_t nf = 0; nf < ManyFrames; nf++) {
+            frame_writer.write_samples(SamplesPerFrame * NumCh);
+        }
+
+        UNSIGNED_LONGS_EQUAL(0, sender.num_dropped_samples());
+
+        // destructor waits until queued samples are sent
+    }
+
+    PacketReader packet_reader(allocator, queue, rtp_parser, format_map, packet_pool,
+                               PayloadType, source_port.address);
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet_reader.read_packet(SamplesPerPacket, ChMask);
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(sender, async_drop) {
+    enum { QueueSize = 3 };
+
+    config.async = true;
+    config.async_queue_size = QueueSize;
+    config.async_overflow = AsyncOverflow_Drop;
+
+    packet::Queue queue;
+    core::Mutex mutex;
+
+    BlockingWriter writer(queue, mutex);
+
+    size_t num_frames = 0;
+
+    {
+        Sender sender(config, source_port, writer, repair_port, writer, rtx_port, writer,
+                      codec_map, format_map, NULL, packet_pool, byte_buffer_pool,
+                      sample_buffer_pool, allocator);
+
+        CHECK(sender.valid());
+
+        FrameWriter frame_writer(sender, sample_buffer_pool);
+
+        {
+            core::Mutex::Lock lock(mutex);
+
+            // sender thread blocks on first packet, and the queue overflows
+            for (size_t nf = 0; nf < ManyFrames; nf++) {
+                frame_writer.write_samples(SamplesPerFrame * NumCh);
+            }
+
+            const size_t num_dropped = sender.num_dropped_samples();
+
+            CHECK(num_dropped % (SamplesPerFrame * NumCh) == 0);
+            num_frames = ManyFrames - num_dropped / (SamplesPerFrame * NumCh);
+
+            CHECK(num_frames >= QueueSize);
+            CHECK(num_frames <= QueueSize + FramesPerPacket);
+        }
+    }
+
+    PacketReader packet_reader(allocator, queue, rtp_parser, format_map, packet_pool,
+                               PayloadType, source_port.address);
+
+    // frames written before overflow are sent
+    for (size_t np = 0; np < num_frames / FramesPerPacket; np++) {
+        packet_reader.read_packet(SamplesPerPacket, ChMask);
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(sender, many_destinations) {
+    enum { NumDestinations = 3 };
+
+    packet::Queue queue;
+
+    Sender sender(config, source_port, queue, repair_port, queue, rtx_port, queue,
+                  codec_map, format_map, NULL, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+
+    packet::Address addresses[NumDestinations];
+    addresses[0] = source_port.address;
+
+    for (size_t nd = 1; nd < NumDestinations; nd++) {
+        addresses[nd] = new_address(int(nd + 1));
+        CHECK(sender.add_destination(addresses[nd], packet::Address()));
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumDestinations, sender.num_destinations());
+
+    FrameWriter frame_writer(sender, sample_buffer_pool);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet::PacketPtr packets[NumDestinations];
+
+        // additional destinations are written first
+        for (size_t nd = 0; nd < NumDestinations; nd++) {
+            packets[(nd + 1) % NumDestinations] = queue.read();
+            CHECK(packets[(nd + 1) % NumDestinations]);
+        }
+
+        for (size_t nd = 0; nd < NumDestinations; nd++) {
+            CHECK(packets[nd]->udp()->dst_addr == addresses[nd]);
+            CHECK(packets[nd]->flags() & packet::Packet::FlagComposed);
+
+            // packet is composed once and shared by all destinations
+            POINTERS_EQUAL(packets[0]->data().data(), packets[nd]->data().data());
+            UNSIGNED_LONGS_EQUAL(packets[0]->data().size(), packets[nd]->data().size());
+        }
+    }
+
+    CHECK(!queue.read());
+}
+
+TEST(sender, many_destinations_retransmission) {
+    rtx_port.address = new_address(2);
+    rtx_port.protocol = Proto_RTP_RTX;
+
+    packet::Queue queue;
+
+    Sender sender(config, source_port, queue, repair_port, queue, rtx_port, queue,
+                  codec_map, format_map, NULL, packet_pool, byte_buffer_pool,
+                  sample_buffer_pool, allocator);
+
+    CHECK(sender.valid());
+
+    CHECK(!sender.add_destination(new_address(3), packet::Address()));
+
+    UNSIGNED_LONGS_EQUAL(1, sender.num_destinations());
+}
+
 } // namespace pipeline
 } // namespace roc
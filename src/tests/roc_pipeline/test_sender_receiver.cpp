@@ -10,6 +10,8 @@
 
 #include "roc_core/buffer_pool.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_core/worker_pool.h"
 #include "roc_packet/packet_pool.h"
 #include "roc_packet/queue.h"
 #include "roc_pipeline/receiver.h"
@@ -65,7 +67,16 @@ enum {
     FlagReedSolomon = (1 << 4),
 
     // enable LDPC-Staircase FEC scheme on sender
-    FlagLDPC = (1 << 5)
+    FlagLDPC = (1 << 5),
+
+    // offload FEC encoding and decoding to worker pool
+    FlagWorkerPool = (1 << 6),
+
+    // enable XOR parity FEC scheme on sender
+    FlagXOR = (1 << 7),
+
+    // enable retransmission of lost packets
+    FlagRetransmission = (1 << 8)
 };
 
 core::HeapAllocator allocator;
@@ -75,22 +86,50 @@ packet::PacketPool packet_pool(allocator, true);
 fec::CodecMap codec_map;
 rtp::FormatMap format_map;
 
+// Sets source address of feedback packets, like the network would.
+class FeedbackWriter : public packet::IWriter {
+public:
+    FeedbackWriter(packet::IWriter& writer, const packet::Address& address)
+        : writer_(writer)
+        , address_(address) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        pp->udp()->src_addr = address_;
+        writer_.write(pp);
+    }
+
+private:
+    packet::IWriter& writer_;
+    const packet::Address address_;
+};
+
 } // namespace
 
 TEST_GROUP(sender_receiver) {
     void send_receive(int flags, size_t num_sessions) {
         packet::Queue queue;
 
+        core::UniquePtr<core::WorkerPool> worker_pool;
+        if (flags & FlagWorkerPool) {
+            worker_pool.reset(new (allocator) core::WorkerPool(2, allocator), allocator);
+            CHECK(worker_pool && worker_pool->valid());
+        }
+
         PortConfig source_port = sender_source_port(flags);
         PortConfig repair_port = sender_repair_port(flags);
+        PortConfig rtx_port = sender_rtx_port(flags);
 
         Sender sender(sender_config(flags),
                       source_port,
                       queue,
                       repair_port,
                       queue,
+                      rtx_port,
+                      queue,
                       codec_map,
                       format_map,
+                      worker_pool.get(),
                       packet_pool,
                       byte_buffer_pool,
                       sample_buffer_pool,
@@ -101,6 +140,7 @@ TEST_GROUP(sender_receiver) {
         Receiver receiver(receiver_config(),
                           codec_map,
                           format_map,
+                          worker_pool.get(),
                           packet_pool,
                           byte_buffer_pool,
                           sample_buffer_pool,
@@ -108,11 +148,18 @@ TEST_GROUP(sender_receiver) {
 
         CHECK(receiver.valid());
 
-        add_receiver_ports(receiver);
+        add_receiver_ports(receiver, flags);
 
         FrameWriter frame_writer(sender, sample_buffer_pool);
 
-        for (size_t nf = 0; nf < ManyFrames; nf++) {
+        size_t num_frames = ManyFrames;
+        if (flags & FlagWorkerPool) {
+            // repair packets of a block encoded in background are sent
+            // with one of the following packets, so write one more block
+            num_frames += FramesPerPacket * SourcePackets;
+        }
+
+        for (size_t nf = 0; nf < num_frames; nf++) {
             frame_writer.write_samples(SamplesPerFrame * NumCh);
         }
 
@@ -135,6 +182,118 @@ TEST_GROUP(sender_receiver) {
         }
     }
 
+    // returns the number of repair packets per block used by sender at the end
+    size_t send_receive_feedback(
+        int flags, const packet::Address& feedback_address = new_address(99)) {
+        packet::Queue queue;
+        packet::Queue feedback_queue;
+        FeedbackWriter feedback_writer(feedback_queue, feedback_address);
+
+        SenderConfig sndr_config = sender_config(flags);
+        sndr_config.fec_adapter.min_repair_packets = 1;
+        sndr_config.fec_adapter.max_repair_packets = RepairPackets;
+
+        Sender sender(sndr_config,
+                      sender_source_port(flags),
+                      queue,
+                      sender_repair_port(flags),
+                      queue,
+                      sender_rtx_port(flags),
+                      queue,
+                      codec_map,
+                      format_map,
+                      NULL,
+                      packet_pool,
+                      byte_buffer_pool,
+                      sample_buffer_pool,
+                      allocator);
+
+        CHECK(sender.valid());
+
+        sender.set_feedback_reader(feedback_queue);
+
+        ReceiverConfig recv_config = receiver_config();
+        recv_config.default_session.fec_feedback_interval =
+            SamplesPerPacket * SourcePackets * core::Second / SampleRate;
+        recv_config.default_session.nack.retry_interval =
+            SamplesPerPacket * 4 * core::Second / SampleRate;
+
+        Receiver receiver(recv_config,
+                          codec_map,
+                          format_map,
+                          NULL,
+                          packet_pool,
+                          byte_buffer_pool,
+                          sample_buffer_pool,
+                          allocator);
+
+        CHECK(receiver.valid());
+
+        receiver.set_feedback_writer(feedback_writer);
+
+        add_receiver_ports(receiver, flags);
+
+        FrameWriter frame_writer(sender, sample_buffer_pool);
+        FrameReader frame_reader(receiver, sample_buffer_pool);
+
+        PacketSender packet_sender(packet_pool, receiver);
+
+        size_t n_source = 0;
+        size_t n_repair = RepairPackets;
+
+        for (size_t nf = 0; nf < Latency / SamplesPerFrame; nf++) {
+            frame_writer.write_samples(SamplesPerFrame * NumCh);
+        }
+
+        forward_packets(flags, queue, packet_sender, n_source, n_repair);
+        packet_sender.deliver(Latency / SamplesPerPacket);
+
+        for (size_t np = 0; np < ManyFrames / FramesPerPacket * 2; np++) {
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                frame_reader.read_samples(SamplesPerFrame * NumCh, 1);
+
+                UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+            }
+
+            for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+                frame_writer.write_samples(SamplesPerFrame * NumCh);
+            }
+
+            forward_packets(flags, queue, packet_sender, n_source, n_repair);
+            packet_sender.deliver(1);
+        }
+
+        return n_repair;
+    }
+
+    void forward_packets(int flags,
+                         packet::IReader& reader,
+                         packet::IWriter& writer,
+                         size_t& n_source,
+                         size_t& n_repair) {
+        while (packet::PacketPtr pp = reader.read()) {
+            if (pp->fec()) {
+                n_repair = pp->fec()->block_length - pp->fec()->source_block_length;
+            }
+
+            if (pp->flags() & packet::Packet::FlagRepair) {
+                if (flags & FlagDropRepair) {
+                    continue;
+                }
+            } else if (pp->udp()->dst_addr != sender_rtx_port(flags).address) {
+                // one loss per block, starting from the second block, so that
+                // the initial latency is filled without losses
+                const size_t n = n_source++;
+                if ((flags & FlagLosses) && n >= SourcePackets
+                    && n % SourcePackets == 1) {
+                    continue;
+                }
+            }
+
+            writer.write(pp);
+        }
+    }
+
     void filter_packets(int flags, packet::IReader& reader, packet::IWriter& writer) {
         size_t counter = 0;
 
@@ -165,6 +324,9 @@ TEST_GROUP(sender_receiver) {
         } else if (flags & FlagLDPC) {
             port_config.address = new_address(30);
             port_config.protocol = Proto_RTP_LDPC_Source;
+        } else if (flags & FlagXOR) {
+            port_config.address = new_address(40);
+            port_config.protocol = Proto_RTP_XOR_Source;
         } else {
             port_config.address = new_address(10);
             port_config.protocol = Proto_RTP;
@@ -180,13 +342,27 @@ TEST_GROUP(sender_receiver) {
         } else if (flags & FlagLDPC) {
             port_config.address = new_address(31);
             port_config.protocol = Proto_LDPC_Repair;
+        } else if (flags & FlagXOR) {
+            port_config.address = new_address(41);
+            port_config.protocol = Proto_XOR_Repair;
         } else {
             port_config.protocol = Proto_None;
         }
         return port_config;
     }
 
-    void add_receiver_ports(Receiver& receiver) {
+    PortConfig sender_rtx_port(int flags) {
+        PortConfig port_config;
+        if (flags & FlagRetransmission) {
+            port_config.address = new_address(50);
+            port_config.protocol = Proto_RTP_RTX;
+        } else {
+            port_config.protocol = Proto_None;
+        }
+        return port_config;
+    }
+
+    void add_receiver_ports(Receiver& receiver, int flags) {
         PortConfig port_config;
 
         port_config.address = new_address(10);
@@ -208,6 +384,20 @@ TEST_GROUP(sender_receiver) {
         port_config.address = new_address(31);
         port_config.protocol = Proto_LDPC_Repair;
         CHECK(receiver.add_port(port_config));
+
+        port_config.address = new_address(40);
+        port_config.protocol = Proto_RTP_XOR_Source;
+        CHECK(receiver.add_port(port_config));
+
+        port_config.address = new_address(41);
+        port_config.protocol = Proto_XOR_Repair;
+        CHECK(receiver.add_port(port_config));
+
+        if (flags & FlagRetransmission) {
+            port_config.address = new_address(50);
+            port_config.protocol = Proto_RTP_RTX;
+            CHECK(receiver.add_port(port_config));
+        }
     }
 
     SenderConfig sender_config(int flags) {
@@ -225,6 +415,10 @@ TEST_GROUP(sender_receiver) {
             config.fec_encoder.scheme = packet::FEC_LDPC_Staircase;
         }
 
+        if (flags & FlagXOR) {
+            config.fec_encoder.scheme = packet::FEC_XOR_Parity;
+        }
+
         config.fec_writer.n_source_packets = SourcePackets;
         config.fec_writer.n_repair_packets = RepairPackets;
 
@@ -264,6 +458,60 @@ TEST(sender_receiver, interleaving) {
     send_receive(FlagInterleaving, 1);
 }
 
+TEST(sender_receiver, fec_xor) {
+    send_receive(FlagXOR, 1);
+}
+
+TEST(sender_receiver, fec_xor_interleaving) {
+    send_receive(FlagXOR | FlagInterleaving, 1);
+}
+
+TEST(sender_receiver, fec_xor_loss) {
+    send_receive(FlagXOR | FlagLosses, 1);
+}
+
+TEST(sender_receiver, fec_xor_loss_worker_pool) {
+    send_receive(FlagXOR | FlagLosses | FlagWorkerPool, 1);
+}
+
+TEST(sender_receiver, fec_xor_drop_source) {
+    send_receive(FlagXOR | FlagDropSource, 0);
+}
+
+TEST(sender_receiver, fec_xor_drop_repair) {
+    send_receive(FlagXOR | FlagDropRepair, 1);
+}
+
+TEST(sender_receiver, fec_feedback_no_losses) {
+    UNSIGNED_LONGS_EQUAL(1, send_receive_feedback(FlagXOR));
+}
+
+TEST(sender_receiver, fec_feedback_losses) {
+    // one loss per block, repair packets are reserved for twice as much
+    UNSIGNED_LONGS_EQUAL(2, send_receive_feedback(FlagXOR | FlagLosses));
+}
+
+TEST(sender_receiver, fec_feedback_unknown_address) {
+    packet::Address address;
+    CHECK(address.set_ipv4("127.0.0.2", 99));
+
+    // reports from hosts other than destinations are ignored
+    UNSIGNED_LONGS_EQUAL(RepairPackets,
+                         send_receive_feedback(FlagXOR | FlagLosses, address));
+}
+
+TEST(sender_receiver, retransmission) {
+    send_receive(FlagRetransmission, 1);
+}
+
+TEST(sender_receiver, retransmission_losses) {
+    send_receive_feedback(FlagRetransmission | FlagLosses);
+}
+
+TEST(sender_receiver, retransmission_fec_xor_losses) {
+    send_receive_feedback(FlagRetransmission | FlagXOR | FlagLosses | FlagDropRepair);
+}
+
 #ifdef ROC_TARGET_OPENFEC
 TEST(sender_receiver, fec_rs) {
     send_receive(FlagReedSolomon, 1);
@@ -281,6 +529,14 @@ TEST(sender_receiver, fec_loss) {
     send_receive(FlagReedSolomon | FlagLosses, 1);
 }
 
+TEST(sender_receiver, fec_loss_worker_pool) {
+    send_receive(FlagReedSolomon | FlagLosses | FlagWorkerPool, 1);
+}
+
+TEST(sender_receiver, fec_ldpc_loss_worker_pool) {
+    send_receive(FlagLDPC | FlagLosses | FlagWorkerPool, 1);
+}
+
 TEST(sender_receiver, fec_drop_source) {
     send_receive(FlagReedSolomon | FlagDropSource, 0);
 }
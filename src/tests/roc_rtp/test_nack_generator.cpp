@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/unique_ptr.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/nack.h"
+#include "roc_rtp/nack_generator.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+enum {
+    Src = 55,
+    SampleRate = 1000,
+    RetryInterval = 10,
+    Latency = 100,
+    MaxRetries = 3,
+    MaxPending = 20,
+    MaxBufSize = 100
+};
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(nack_generator) {
+    NackConfig config;
+    packet::Address address;
+
+    void setup() {
+        config.retry_interval = RetryInterval * core::Second / SampleRate;
+        config.max_retries = MaxRetries;
+        config.max_pending = MaxPending;
+    }
+
+    packet::PacketPtr new_packet(packet::seqnum_t sn) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        pp->add_flags(packet::Packet::FlagRTP);
+        pp->rtp()->source = Src;
+        pp->rtp()->seqnum = sn;
+
+        return pp;
+    }
+
+    NackGenerator* new_generator(packet::IWriter& writer, packet::IWriter& nack_writer) {
+        NackGenerator* gen = new (allocator)
+            NackGenerator(writer, nack_writer, address, config,
+                          Latency * core::Second / SampleRate, SampleRate, packet_pool,
+                          buffer_pool, allocator);
+        CHECK(gen);
+        CHECK(gen->valid());
+        return gen;
+    }
+
+    // returns requested seqnums as a bitmask relative to base
+    unsigned long read_nack(packet::IReader& reader, packet::seqnum_t base) {
+        packet::PacketPtr pp = reader.read();
+        CHECK(pp);
+        CHECK(pp->udp());
+
+        const core::Slice<uint8_t>& data = pp->data();
+        CHECK(data.size() >= sizeof(NackHeader));
+
+        const NackHeader& header = *(const NackHeader*)data.data();
+        CHECK(header.valid());
+        UNSIGNED_LONGS_EQUAL(Src, header.media_ssrc());
+
+        UNSIGNED_LONGS_EQUAL(sizeof(NackHeader)
+                                 + header.num_entries() * sizeof(NackEntry),
+                             data.size());
+
+        const NackEntry* entries = (const NackEntry*)(data.data() + sizeof(NackHeader));
+
+        unsigned long mask = 0;
+        for (size_t n = 0; n < header.num_entries(); n++) {
+            const packet::seqnum_t pid = entries[n].pid();
+            mask |= 1ul << packet::seqnum_t(pid - base);
+            for (size_t i = 0; i < NackEntry::MaxBLP; i++) {
+                if (entries[n].blp() & (1 << i)) {
+                    mask |= 1ul << packet::seqnum_t(pid + i + 1 - base);
+                }
+            }
+        }
+        return mask;
+    }
+};
+
+TEST(nack_generator, no_losses) {
+    packet::Queue queue;
+    packet::Queue nack_queue;
+
+    core::UniquePtr<NackGenerator> gen(new_generator(queue, nack_queue), allocator);
+
+    for (packet::seqnum_t sn = 0; sn < 10; sn++) {
+        gen->write(new_packet(sn));
+        gen->update(sn * RetryInterval);
+    }
+
+    UNSIGNED_LONGS_EQUAL(10, queue.size());
+    UNSIGNED_LONGS_EQUAL(0, nack_queue.size());
+    UNSIGNED_LONGS_EQUAL(0, gen->num_pending());
+}
+
+TEST(nack_generator, gap) {
+    packet::Queue queue;
+    packet::Queue nack_queue;
+
+    core::UniquePtr<NackGenerator> gen(new_generator(queue, nack_queue), allocator);
+
+    const packet::seqnum_t base = packet::seqnum_t(-3);
+
+    gen->write(new_packet(base));
+    gen->write(new_packet(packet::seqnum_t(base + 3)));
+    gen->write(new_packet(packet::seqnum_t(base + 5)));
+
+    UNSIGNED_LONGS_EQUAL(3, gen->num_pending());
+
+    gen->update(0);
+
+    UNSIGNED_LONGS_EQUAL(1, nack_queue.size());
+    UNSIGNED_LONGS_EQUAL((1 << 1) | (1 << 2) | (1 << 4), read_nack(nack_queue, base));
+
+    // retry is not sent until retry interval expires
+    gen->update(RetryInterval - 1);
+    UNSIGNED_LONGS_EQUAL(0, nack_queue.size());
+
+    // one of the packets arrives
+    gen->write(new_packet(packet::seqnum_t(base + 2)));
+    UNSIGNED_LONGS_EQUAL(2, gen->num_pending());
+
+    gen->update(RetryInterval);
+    UNSIGNED_LONGS_EQUAL((1 << 1) | (1 << 4), read_nack(nack_queue, base));
+
+    UNSIGNED_LONGS_EQUAL(4, queue.size());
+}
+
+TEST(nack_generator, max_retries) {
+    packet::Queue queue;
+    packet::Queue nack_queue;
+
+    core::UniquePtr<NackGenerator> gen(new_generator(queue, nack_queue), allocator);
+
+    gen->write(new_packet(1));
+    gen->write(new_packet(3));
+
+    for (packet::timestamp_t t = 0; t < RetryInterval * MaxRetries; t += RetryInterval) {
+        gen->update(t);
+        UNSIGNED_LONGS_EQUAL(1 << 1, read_nack(nack_queue, 1));
+    }
+
+    gen->update(RetryInterval * MaxRetries);
+    UNSIGNED_LONGS_EQUAL(0, nack_queue.size());
+    UNSIGNED_LONGS_EQUAL(0, gen->num_pending());
+}
+
+TEST(nack_generator, no_time_left) {
+    packet::Queue queue;
+    packet::Queue nack_queue;
+
+    config.max_retries = 100;
+
+    core::UniquePtr<NackGenerator> gen(new_generator(queue, nack_queue), allocator);
+
+    gen->write(new_packet(1));
+    gen->write(new_packet(3));
+
+    // last moment when retransmission may arrive in time
+    gen->update(Latency - RetryInterval);
+    UNSIGNED_LONGS_EQUAL(1 << 1, read_nack(nack_queue, 1));
+
+    gen->write(new_packet(4));
+    gen->write(new_packet(6));
+
+    UNSIGNED_LONGS_EQUAL(2, gen->num_pending());
+
+    // too late for the first gap, but not for the second one
+    gen->update(Latency - RetryInterval + 1);
+    UNSIGNED_LONGS_EQUAL(1 << 4, read_nack(nack_queue, 1));
+    UNSIGNED_LONGS_EQUAL(1, gen->num_pending());
+}
+
+TEST(nack_generator, large_gap) {
+    packet::Queue queue;
+    packet::Queue nack_queue;
+
+    core::UniquePtr<NackGenerator> gen(new_generator(queue, nack_queue), allocator);
+
+    gen->write(new_packet(1));
+    gen->write(new_packet(packet::seqnum_t(1 + MaxPending + 2)));
+
+    UNSIGNED_LONGS_EQUAL(0, gen->num_pending());
+
+    gen->update(0);
+    UNSIGNED_LONGS_EQUAL(0, nack_queue.size());
+}
+
+TEST(nack_generator, blp_overflow) {
+    packet::Queue queue;
+    packet::Queue nack_queue;
+
+    core::UniquePtr<NackGenerator> gen(new_generator(queue, nack_queue), allocator);
+
+    gen->write(new_packet(0));
+    gen->write(new_packet(NackEntry::MaxBLP + 3));
+
+    gen->update(0);
+
+    UNSIGNED_LONGS_EQUAL(((1ul << (NackEntry::MaxBLP + 2)) - 1) << 1,
+                         read_nack(nack_queue, 0));
+}
+
+} // namespace rtp
+} // namespace roc
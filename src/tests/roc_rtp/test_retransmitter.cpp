@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2019 Roc authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/buffer_pool.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_pool.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+#include "roc_rtp/retransmitter.h"
+#include "roc_rtp/rtx.h"
+#include "roc_rtp/rtx_parser.h"
+
+namespace roc {
+namespace rtp {
+
+namespace {
+
+enum { Src = 55, PayloadSize = 32, NumPackets = 16, MaxBufSize = 100 };
+
+core::HeapAllocator allocator;
+core::BufferPool<uint8_t> buffer_pool(allocator, MaxBufSize, true);
+packet::PacketPool packet_pool(allocator, true);
+
+} // namespace
+
+TEST_GROUP(retransmitter) {
+    packet::PacketPtr new_packet(packet::seqnum_t sn,
+                                 unsigned int pt = PayloadType_L16_Stereo) {
+        packet::PacketPtr pp = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pp);
+
+        core::Slice<uint8_t> data = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(data);
+
+        Composer composer(NULL);
+        CHECK(composer.prepare(*pp, data, PayloadSize));
+        pp->set_data(data);
+
+        pp->rtp()->source = Src;
+        pp->rtp()->seqnum = sn;
+        pp->rtp()->timestamp = packet::timestamp_t(sn * 100);
+        pp->rtp()->payload_type = pt;
+
+        for (size_t n = 0; n < PayloadSize; n++) {
+            pp->rtp()->payload.data()[n] = uint8_t(sn + n);
+        }
+
+        CHECK(composer.compose(*pp));
+        pp->add_flags(packet::Packet::FlagComposed);
+
+        return pp;
+    }
+
+    packet::PacketPtr copy_packet(const packet::PacketPtr& pa) {
+        packet::PacketPtr pb = new (packet_pool) packet::Packet(packet_pool);
+        CHECK(pb);
+
+        core::Slice<uint8_t> data = new (buffer_pool) core::Buffer<uint8_t>(buffer_pool);
+        CHECK(data);
+
+        data.resize(pa->data().size());
+        memcpy(data.data(), pa->data().data(), data.size());
+        pb->set_data(data);
+
+        return pb;
+    }
+};
+
+TEST(retransmitter, write) {
+    packet::Queue queue;
+    packet::Queue rtx_queue;
+
+    Retransmitter retransmitter(queue, rtx_queue, NumPackets, packet_pool, buffer_pool,
+                                allocator);
+    CHECK(retransmitter.valid());
+
+    for (packet::seqnum_t sn = 0; sn < NumPackets; sn++) {
+        packet::PacketPtr pp = new_packet(sn);
+        retransmitter.write(pp);
+        CHECK(queue.read() == pp);
+    }
+
+    UNSIGNED_LONGS_EQUAL(0, rtx_queue.size());
+}
+
+TEST(retransmitter, retransmit) {
+    packet::Queue queue;
+    packet::Queue rtx_queue;
+
+    Retransmitter retransmitter(queue, rtx_queue, NumPackets, packet_pool, buffer_pool,
+                                allocator);
+    CHECK(retransmitter.valid());
+
+    FormatMap format_map;
+    Parser rtp_parser(format_map, NULL);
+    RtxParser rtx_parser(&rtp_parser);
+
+    const packet::seqnum_t first_sn = packet::seqnum_t(-1) - NumPackets / 2;
+
+    for (packet::seqnum_t n = 0; n < NumPackets; n++) {
+        retransmitter.write(new_packet(packet::seqnum_t(first_sn + n)));
+    }
+
+    packet::seqnum_t prev_rtx_sn = 0;
+
+    for (packet::seqnum_t n = 0; n < NumPackets; n++) {
+        const packet::seqnum_t sn = packet::seqnum_t(first_sn + n);
+
+        CHECK(retransmitter.retransmit(sn));
+
+        packet::PacketPtr rtx = rtx_queue.read();
+        CHECK(rtx);
+        CHECK(rtx->flags() & packet::Packet::FlagComposed);
+
+        UNSIGNED_LONGS_EQUAL(queue.read()->data().size() + RtxHeaderSize,
+                             rtx->data().size());
+
+        const Header& header = *(const Header*)rtx->data().data();
+        UNSIGNED_LONGS_EQUAL(rtx_payload_type(PayloadType_L16_Stereo),
+                             header.payload_type());
+        UNSIGNED_LONGS_EQUAL(Src, header.ssrc());
+        if (n != 0) {
+            UNSIGNED_LONGS_EQUAL(packet::seqnum_t(prev_rtx_sn + 1), header.seqnum());
+        }
+        prev_rtx_sn = header.seqnum();
+
+        packet::PacketPtr pp = copy_packet(rtx);
+        CHECK(rtx_parser.parse(*pp, pp->data()));
+
+        CHECK(pp->flags() & packet::Packet::FlagRetransmitted);
+        CHECK(pp->flags() & packet::Packet::FlagAudio);
+
+        UNSIGNED_LONGS_EQUAL(Src, pp->rtp()->source);
+        UNSIGNED_LONGS_EQUAL(sn, pp->rtp()->seqnum);
+        UNSIGNED_LONGS_EQUAL(sn * 100, pp->rtp()->timestamp);
+        UNSIGNED_LONGS_EQUAL(PayloadType_L16_Stereo, pp->rtp()->payload_type);
+
+        UNSIGNED_LONGS_EQUAL(PayloadSize, pp->rtp()->payload.size());
+        for (size_t i = 0; i < PayloadSize; i++) {
+            UNSIGNED_LONGS_EQUAL(uint8_t(sn + i), pp->rtp()->payload.data()[i]);
+        }
+    }
+}
+
+TEST(retransmitter, forget_old_packets) {
+    packet::Queue queue;
+    packet::Queue rtx_queue;
+
+    Retransmitter retransmitter(queue, rtx_queue, NumPackets, packet_pool, buffer_pool,
+                                allocator);
+    CHECK(retransmitter.valid());
+
+    for (packet::seqnum_t sn = 0; sn < NumPackets * 2; sn++) {
+        retransmitter.write(new_packet(sn));
+    }
+
+    for (packet::seqnum_t sn = 0; sn < NumPackets; sn++) {
+        CHECK(!retransmitter.retransmit(sn));
+    }
+
+    for (packet::seqnum_t sn = NumPackets; sn < NumPackets * 2; sn++) {
+        CHECK(retransmitter.retransmit(sn));
+    }
+
+    CHECK(!retransmitter.retransmit(NumPackets * 2));
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, rtx_queue.size());
+}
+
+TEST(retransmitter, unsupported_payload_type) {
+    packet::Queue queue;
+    packet::Queue rtx_queue;
+
+    Retransmitter retransmitter(queue, rtx_queue, NumPackets, packet_pool, buffer_pool,
+                                allocator);
+    CHECK(retransmitter.valid());
+
+    CHECK(rtx_supported_payload_type(127 - RtxPayloadTypeOffset));
+    CHECK(!rtx_supported_payload_type(128 - RtxPayloadTypeOffset));
+
+    retransmitter.write(new_packet(1, 128 - RtxPayloadTypeOffset));
+
+    CHECK(!retransmitter.retransmit(1));
+    UNSIGNED_LONGS_EQUAL(0, rtx_queue.size());
+}
+
+TEST(retransmitter, bad_rtx_packet) {
+    FormatMap format_map;
+    Parser rtp_parser(format_map, NULL);
+    RtxParser rtx_parser(&rtp_parser);
+
+    packet::PacketPtr pp = copy_packet(new_packet(1));
+
+    // original payload type is not an RTX payload type
+    CHECK(!rtx_parser.parse(*pp, pp->data()));
+}
+
+} // namespace rtp
+} // namespace roc
@@ -91,6 +91,10 @@ int main(int argc, char** argv) {
         config.resampler = audio::resampler_profile(audio::ResamplerProfile_High);
         break;
 
+    case resampler_profile_arg_polyphase:
+        config.resampler = audio::resampler_profile(audio::ResamplerProfile_Polyphase);
+        break;
+
     default:
         break;
     }
@@ -96,6 +96,14 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (args.start_latency_given) {
+        if (!core::parse_duration(args.start_latency_arg,
+                                  config.default_session.start_latency)) {
+            roc_log(LogError, "invalid --start-latency");
+            return 1;
+        }
+    }
+
     if (args.min_latency_given) {
         if (!core::parse_duration(args.min_latency_arg,
                                   config.default_session.latency_monitor.min_latency)) {
@@ -145,6 +153,7 @@ int main(int argc, char** argv) {
     }
 
     config.common.resampling = !args.no_resampling_flag;
+    config.default_session.time_stretching = args.time_stretching_flag;
 
     switch ((unsigned)args.resampler_profile_arg) {
     case resampler_profile_arg_low:
@@ -239,7 +248,7 @@ int main(int argc, char** argv) {
     fec::CodecMap codec_map;
     rtp::FormatMap format_map;
 
-    pipeline::Receiver receiver(config, codec_map, format_map, packet_pool,
+    pipeline::Receiver receiver(config, codec_map, format_map, NULL, packet_pool,
                                 byte_buffer_pool, sample_buffer_pool, allocator);
     if (!receiver.valid()) {
         roc_log(LogError, "can't create receiver pipeline");
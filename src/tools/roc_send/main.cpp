@@ -149,6 +149,10 @@ int main(int argc, char** argv) {
         config.resampler = audio::resampler_profile(audio::ResamplerProfile_High);
         break;
 
+    case resampler_profile_arg_polyphase:
+        config.resampler = audio::resampler_profile(audio::ResamplerProfile_Polyphase);
+        break;
+
     default:
         roc_panic("unexpected resampler profile");
     }
@@ -232,9 +236,12 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    pipeline::PortConfig rtx_port;
+
     pipeline::Sender sender(config, source_port, *udp_sender, repair_port, *udp_sender,
-                            codec_map, format_map, packet_pool, byte_buffer_pool,
-                            sample_buffer_pool, allocator);
+                            rtx_port, *udp_sender, codec_map, format_map, NULL,
+                            packet_pool, byte_buffer_pool, sample_buffer_pool,
+                            allocator);
     if (!sender.valid()) {
         roc_log(LogError, "can't create sender pipeline");
         return 1;